@@ -18,6 +18,7 @@ layout (std140) uniform VXL_Time_1
 	vec4 VXL_time;
 	vec4 VXL_sinTime;
 	vec4 VXL_cosTime;
+	vec4 VXL_fixedTime; // Interpolation alpha between fixed steps, seconds per step, steps this frame
 };
 
 // [ FBO Size]
@@ -39,4 +40,26 @@ uniform vec3  VXL_color 			= vec3(0.0);
 uniform vec3  VXL_tint 				= vec3(1.0);
 uniform float VXL_alpha 			= 1.0;
 uniform vec4  VXL_output 			= vec4(1.0);
-uniform vec4  VXL_colorID 			= vec4(0.0);
\ No newline at end of file
+uniform vec4  VXL_colorID 			= vec4(0.0);
+uniform bool  VXL_packedVertex 		= false;
+uniform vec3  VXL_positionOffset 	= vec3(0.0);
+uniform vec3  VXL_positionScale 	= vec3(1.0);
+
+// [ Packed Vertices (Mesh::setPacked) ]
+// Quantized positions are [0, 1] across the mesh bounds, offset/scale are identity otherwise
+vec3 VXL_unpackPosition(vec3 p)
+{
+	return VXL_positionOffset + p * VXL_positionScale;
+}
+// Normals/tangents are octahedral [xy only], same decode as VertexPacking::OctDecode
+vec3 VXL_unpackDirection(vec3 d)
+{
+	if(!VXL_packedVertex)
+		return d;
+
+	vec3 n = vec3(d.xy, 1.0 - abs(d.x) - abs(d.y));
+	float t = max(-n.z, 0.0);
+	n.x += n.x >= 0.0 ? -t : t;
+	n.y += n.y >= 0.0 ? -t : t;
+	return normalize(n);
+}
\ No newline at end of file
@@ -18,6 +18,8 @@
 #include "input/Input.h"
 #include "input/XGamePad.h"
 
+#include "math/AABBTree.h"
+#include "math/Affine.h"
 #include "math/Color.h"
 #include "math/Lerp.h"
 #include "math/Collision.h"
@@ -26,11 +28,16 @@
 #include "math/Matrix3x3.h"
 #include "math/Matrix4x4.h"
 #include "math/MatrixStack.h"
+#include "math/MeshCache.h"
 #include "math/Model.h"
 #include "math/Quaternion.h"
 #include "math/Random.h"
+#include "math/SIMD.h"
 #include "math/Transform.h"
+#include "math/TransformManager.h"
 #include "math/Vector.h"
+#include "math/VertexPacking.h"
+#include "math/VertexWeld.h"
 
 #include "modules/Component.h"
 #include "modules/Entity.h"
@@ -48,10 +55,17 @@
 #include "rendering/FramebufferObject.h"
 #include "rendering/Primitives.h"
 #include "rendering/Graphics.h"
+#include "rendering/GraphicsBackend.h"
+#include "rendering/MaterialParameters.h"
 #include "rendering/Mesh.h"
 #include "rendering/MeshBuffer.h"
 #include "rendering/RenderBuffer.h"
+#include "rendering/RenderQueue.h"
 #include "rendering/Shader.h"
+#include "rendering/ShaderCache.h"
+#include "rendering/ShaderPreprocessor.h"
+#include "rendering/ShaderReloader.h"
+#include "rendering/TextureBindingTable.h"
 #include "rendering/UBO.h"
 #include "rendering/Uniform.h"
 #include "rendering/VBO.h"
@@ -63,11 +77,16 @@
 #include "textures/RenderTexture.h"
 
 #include "utilities/Asset.h"
+#include "utilities/AssetLoader.h"
+#include "utilities/Benchmark.h"
 #include "utilities/Types.h"
 #include "utilities/FileIO.h"
+#include "utilities/FileWatcher.h"
+#include "utilities/JobSystem.h"
 #include "utilities/Macros.h"
 #include "utilities/Logger.h"
 #include "utilities/Macros.h"
+#include "utilities/Profiler.h"
 #include "utilities/singleton.h"
 #include "utilities/stringUtil.h"
 #include "utilities/Time.h"
@@ -14,7 +14,10 @@
 
 #include "../game/Scene_Game.h"
 
+#include "../math/MeshCache.h"
+#include "../math/Model.h"
 #include "../math/Transform.h"
+#include "../math/VertexWeld.h"
 
 #include "../modules/Entity.h"
 
@@ -26,13 +29,199 @@
 #include "../textures/Texture2D.h"
 
 #include "../utilities/Asset.h"
+#include "../utilities/AssetLoader.h"
 #include "../utilities/Time.h"
 #include "../utilities/Util.h"
+#include "../utilities/stringUtil.h"
 
 #include "../window/window.h"
 
+#include <chrono>
+#include <filesystem>
+
+namespace fs = std::experimental::filesystem;
+
 namespace Vxl
 {
+	// Repeats the lookups done by the render loop [Entity -> Mesh/Material] with the
+	// asset storage, and with std::map copies of the same data for comparison
+	void DevConsole::Run_LookupBenchmark()
+	{
+		const uint32_t Frames = 1000;
+
+		const auto& entities = Assets.getAllEntity();
+
+		std::map<uint32_t, Entity*>		entityMap;
+		std::map<uint32_t, Mesh*>		meshMap;
+		std::map<uint32_t, Material*>	materialMap;
+		std::vector<EntityIndex>		entityIDs;
+		for (const auto& entity : entities)
+		{
+			entityMap[entity.first] = entity.second;
+			entityIDs.push_back(entity.first);
+		}
+		for (const auto& mesh : Assets.getAllMesh())
+			meshMap[mesh.first] = mesh.second;
+		for (const auto& material : Assets.getAllMaterial())
+			materialMap[material.first] = material.second;
+
+		auto mapGet = [](auto& map, uint32_t id) -> decltype(map.begin()->second)
+		{
+			auto it = map.find(id);
+			return it != map.end() ? it->second : nullptr;
+		};
+
+		// Prevents the lookups from being optimized out
+		volatile uintptr_t sink = 0;
+
+		auto start = std::chrono::steady_clock::now();
+		for (uint32_t frame = 0; frame < Frames; frame++)
+		{
+			for (EntityIndex id : entityIDs)
+			{
+				Entity* entity = Assets.getEntity(id);
+				sink = sink + (uintptr_t)Assets.getMesh(entity->getMesh());
+				sink = sink + (uintptr_t)Assets.getMaterial(entity->getMaterial());
+			}
+		}
+		auto end = std::chrono::steady_clock::now();
+		m_lookupTime_IDStorage = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)Frames;
+
+		start = std::chrono::steady_clock::now();
+		for (uint32_t frame = 0; frame < Frames; frame++)
+		{
+			for (EntityIndex id : entityIDs)
+			{
+				Entity* entity = mapGet(entityMap, id);
+				sink = sink + (uintptr_t)mapGet(meshMap, entity->getMesh());
+				sink = sink + (uintptr_t)mapGet(materialMap, entity->getMaterial());
+			}
+		}
+		end = std::chrono::steady_clock::now();
+		m_lookupTime_map = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)Frames;
+
+		m_lookupsPerFrame = (uint32_t)entityIDs.size() * 3;
+	}
+
+	// Welds every model in assets/models expanded to a triangle soup [worst case for smoothing]
+	// and compares it to the old brute force neighbor search used by smooth normals
+	void DevConsole::Run_WeldBenchmark()
+	{
+		const uint32_t BruteForceLimit = 20000;
+		const float Tolerance = 0.01f;
+
+		m_weldResults.clear();
+
+		for (const auto& file : fs::directory_iterator("./assets/models/"))
+		{
+			std::string filePath = file.path().string();
+			std::vector<Model*> models = Model::LoadFromAssimp(filePath, true, false);
+
+			for (Model* model : models)
+			{
+				std::vector<Vector3> soup;
+				soup.reserve(model->indices.size());
+				for (uint32_t index : model->indices)
+					soup.push_back(model->positions[index]);
+
+				uint32_t count = (uint32_t)soup.size();
+
+				WeldBenchmarkResult result;
+				result.name = stringUtil::nameFromFilepath(filePath);
+				result.vertices = count;
+				result.bruteForceTime = -1.0;
+				result.matching = true;
+
+				std::vector<uint32_t> remap;
+				auto start = std::chrono::steady_clock::now();
+				result.groups = WeldVertices(soup.data(), count, Tolerance, remap);
+				auto end = std::chrono::steady_clock::now();
+				result.weldTime = (double)std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+
+				// Brute force, every vertex checks every group before it
+				if (count <= BruteForceLimit)
+				{
+					std::vector<uint32_t> groups;
+					start = std::chrono::steady_clock::now();
+					for (uint32_t i = 0; i < count; i++)
+					{
+						bool found = false;
+						for (uint32_t group : groups)
+						{
+							if (Vector3::Distance(soup[i], soup[group]) < Tolerance)
+							{
+								found = true;
+								break;
+							}
+						}
+						if (!found)
+							groups.push_back(i);
+					}
+					end = std::chrono::steady_clock::now();
+					result.bruteForceTime = (double)std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+					result.matching = (groups.size() == result.groups);
+				}
+
+				m_weldResults.push_back(result);
+				delete model;
+			}
+		}
+	}
+
+	// Imports every model in assets/models with assimp, then again from its cache file
+	// Cached time includes mapping, validation and copying into vectors [what Mesh::set does]
+	void DevConsole::Run_MeshCacheBenchmark()
+	{
+		m_meshCacheResults.clear();
+
+		for (const auto& file : fs::directory_iterator("./assets/models/"))
+		{
+			std::string filePath = file.path().string();
+
+			MeshCacheBenchmarkResult result;
+			result.name = stringUtil::nameFromFilepath(filePath);
+			result.vertices = 0;
+
+			// Cold
+			auto start = std::chrono::steady_clock::now();
+			std::vector<Model*> models = Model::LoadFromAssimp(filePath, false, false);
+			auto end = std::chrono::steady_clock::now();
+			result.importTime = (double)std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+
+			for (Model* model : models)
+				delete model;
+
+			// Make sure cache exists
+			if (!MeshCache::Load(filePath, false, 1.0f))
+				continue;
+
+			// Cached
+			start = std::chrono::steady_clock::now();
+			auto cache = MeshCache::Open(filePath, false, 1.0f);
+			if (cache)
+			{
+				for (uint32_t i = 0; i < cache->getMeshCount(); i++)
+				{
+					const MeshCacheView& view = cache->getMesh(i);
+					std::vector<Vector3> positions(view.positions, view.positions + view.vertexCount);
+					std::vector<uint32_t> indices(view.indices, view.indices + view.indexCount);
+					if (view.uvs)
+						std::vector<Vector2> uvs(view.uvs, view.uvs + view.vertexCount);
+					if (view.normals)
+						std::vector<Vector3> normals(view.normals, view.normals + view.vertexCount);
+					if (view.tangents)
+						std::vector<Vector3> tangents(view.tangents, view.tangents + view.vertexCount);
+
+					result.vertices += view.vertexCount;
+				}
+			}
+			end = std::chrono::steady_clock::now();
+			result.cacheTime = (double)std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+
+			m_meshCacheResults.push_back(result);
+		}
+	}
+
 	void DevConsole::Draw_Master(Scene* scene)
 	{
 		Scene_Game* Game = dynamic_cast<Scene_Game*>(scene);
@@ -41,10 +230,11 @@ namespace Vxl
 
 		ImGui::Text("FPS: %f", Time.GetFPS());
 		ImGui::Text("Time: %f", Time.GetTime());
+		ImGui::Text("Loading Assets: %u [%u workers]", AssetLoader.getPendingCount(), AssetLoader.getWorkerCount());
 
 		const float* _fpsGraph = Time.GetFPSHistogram();
 		UINT _fpsGraphSize = Time.GetFPSHistogramSize();
-		ImGui::PlotHistogram("FPS Histogram", _fpsGraph, _fpsGraphSize, 0, NULL, 0.0f, 100.0f, ImVec2(0, 70));
+		ImGui::PlotHistogram("FPS Histogram", _fpsGraph, _fpsGraphSize, Time.GetFPSHistogramOffset(), NULL, 0.0f, 100.0f, ImVec2(0, 70));
 
 		ImGui::Separator();
 
@@ -188,6 +378,43 @@ namespace Vxl
 			ImGui::EndChild();
 		}
 
+		if (ImGui::CollapsingHeader("Asset Lookup Benchmark"))
+		{
+			if (ImGui::Button("Run"))
+				Run_LookupBenchmark();
+
+			ImGui::Text("Lookups per frame: %u", m_lookupsPerFrame);
+			ImGui::Text("IDStorage: %.1f [ns/frame]", m_lookupTime_IDStorage);
+			ImGui::Text("std::map: %.1f [ns/frame]", m_lookupTime_map);
+		}
+
+		if (ImGui::CollapsingHeader("Vertex Weld Benchmark"))
+		{
+			if (ImGui::Button("Run##Weld"))
+				Run_WeldBenchmark();
+
+			for (const auto& result : m_weldResults)
+			{
+				ImGui::Text("%s: %u vertices -> %u", result.name.c_str(), result.vertices, result.groups);
+				if (result.bruteForceTime < 0.0)
+					ImGui::Text("  Spatial Hash: %.2f [ms], Brute Force: skipped", result.weldTime);
+				else
+					ImGui::Text("  Spatial Hash: %.2f [ms], Brute Force: %.2f [ms] %s", result.weldTime, result.bruteForceTime, result.matching ? "" : "[MISMATCH]");
+			}
+		}
+
+		if (ImGui::CollapsingHeader("Mesh Cache Benchmark"))
+		{
+			if (ImGui::Button("Run##MeshCache"))
+				Run_MeshCacheBenchmark();
+
+			for (const auto& result : m_meshCacheResults)
+			{
+				ImGui::Text("%s: %u vertices", result.name.c_str(), result.vertices);
+				ImGui::Text("  Assimp: %.2f [ms], Cache: %.2f [ms]", result.importTime, result.cacheTime);
+			}
+		}
+
 		ImGui::Separator();
 
 		if (GamePad1.IsConnected())
@@ -503,6 +730,78 @@ namespace Vxl
 		ImGui::PopItemWidth();
 	}
 
+	void DevConsole::Draw_Log()
+	{
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			ImGui::Checkbox(Logger::GetName((LogLevel)i), &m_logLevels[i]);
+			ImGui::SameLine();
+		}
+		ImGui::Checkbox("Auto Scroll", &m_logAutoScroll);
+
+		uint64_t lost = Logger.getLostCount();
+		if (lost > 0)
+		{
+			ImGui::SameLine();
+			ImGui::TextColored(ImGuiColor::RedLight, "Lost: %llu", (unsigned long long)lost);
+		}
+		ImGui::Separator();
+
+		// Only indices are gathered, visible rows copy their text out of the ring
+		m_logRows.clear();
+		uint64_t head = Logger.getHead();
+		for (uint64_t index = Logger.getTail(); index < head; index++)
+		{
+			const LogEntry* entry = Logger.getEntry(index);
+			if (entry && m_logLevels[(uint32_t)entry->level])
+				m_logRows.push_back(index);
+		}
+
+		ImGui::BeginChild("LogEntries", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
+
+		char text[LOGGER_ENTRY_SIZE];
+		ImGuiListClipper clipper((int)m_logRows.size());
+		while (clipper.Step())
+		{
+			for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+			{
+				// Entries can be replaced by other threads at any time, copy then skip those that changed during the copy
+				const LogEntry* entry = Logger.getEntry(m_logRows[i]);
+				LogLevel level = LogLevel::Info;
+				uint16_t length = 0;
+				if (entry)
+				{
+					level = entry->level;
+					length = entry->length;
+					memcpy(text, entry->text, length);
+				}
+				if (!entry || !Logger.isStillValid(m_logRows[i], entry))
+				{
+					ImGui::TextUnformatted("");
+					continue;
+				}
+
+				ImVec4 color = ImGuiColor::White;
+				switch (level)
+				{
+				case LogLevel::Debug:	color = ImGuiColor::Grey; break;
+				case LogLevel::Warning:	color = ImGuiColor::Yellow; break;
+				case LogLevel::Error:	color = ImGuiColor::RedLight; break;
+				default: break;
+				}
+
+				ImGui::PushStyleColor(ImGuiCol_Text, color);
+				ImGui::TextUnformatted(text, text + length);
+				ImGui::PopStyleColor();
+			}
+		}
+
+		if (m_logAutoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
+			ImGui::SetScrollHereY(1.0f);
+
+		ImGui::EndChild();
+	}
+
 	void DevConsole::Draw()
 	{
 		// Menu
@@ -516,6 +815,8 @@ namespace Vxl
 					m_State = MenuState::EDIT_DATA;
 				if (ImGui::MenuItem("Show Data", NULL, m_State == MenuState::SHOW_DATA, m_State != MenuState::SHOW_DATA))
 					m_State = MenuState::SHOW_DATA;
+				if (ImGui::MenuItem("Log", NULL, m_State == MenuState::LOG, m_State != MenuState::LOG))
+					m_State = MenuState::LOG;
 
 				ImGui::EndMenu();
 			}
@@ -537,6 +838,9 @@ namespace Vxl
 		case MenuState::SHOW_DATA:
 			Draw_ShowValues();
 			break;
+		case MenuState::LOG:
+			Draw_Log();
+			break;
 		}
 
 	}
@@ -13,6 +13,7 @@
 
 #include <map>
 #include <utility>
+#include <vector>
 
 namespace Vxl
 {
@@ -40,13 +41,51 @@ namespace Vxl
 		{
 			MASTER,
 			EDIT_DATA,
-			SHOW_DATA
+			SHOW_DATA,
+			LOG
 		};
 		MenuState m_State = MenuState::MASTER;
+
+		// Asset lookup benchmark [ns per frame of render loop lookups]
+		uint32_t m_lookupsPerFrame = 0;
+		double	 m_lookupTime_IDStorage = 0.0;
+		double	 m_lookupTime_map = 0.0;
+		void Run_LookupBenchmark();
+
+		// Vertex welding benchmark [assets/models as triangle soups, smooth normal tolerance]
+		struct WeldBenchmarkResult
+		{
+			std::string name;
+			uint32_t	vertices;
+			uint32_t	groups;
+			double		weldTime;		// ms
+			double		bruteForceTime;	// ms [negative if skipped]
+			bool		matching;
+		};
+		std::vector<WeldBenchmarkResult> m_weldResults;
+		void Run_WeldBenchmark();
+
+		// Mesh cache benchmark [assets/models, assimp import vs mapped cache]
+		struct MeshCacheBenchmarkResult
+		{
+			std::string name;
+			uint32_t	vertices;
+			double		importTime;	// ms
+			double		cacheTime;	// ms
+		};
+		std::vector<MeshCacheBenchmarkResult> m_meshCacheResults;
+		void Run_MeshCacheBenchmark();
+
 		// Draw Menu Section
 		void Draw_Master(Scene* scene);
 		void Draw_ShowValues();
 		void Draw_EditValues();
+
+		// Log [rows point into the Logger ring]
+		bool					m_logLevels[4] = { true, true, true, true };
+		bool					m_logAutoScroll = true;
+		std::vector<uint64_t>	m_logRows;
+		void Draw_Log();
 	public:
 
 		// custom data
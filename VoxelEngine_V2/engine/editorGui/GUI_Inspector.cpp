@@ -399,14 +399,11 @@ namespace Vxl
 				// Texture Index
 				TextureIndex index = 0;
 
-				// Find texture
-				//
-				// Shared Material Textures
-				if (_material->m_sharedTextures)
-					index = _material->m_textures[level];
-				// Entity Texture
-				else
-					index = _entity->m_textures[level];
+				// Find texture [without inserting, textures maps are versioned]
+				const std::map<TextureLevel, TextureIndex>& textures = _material->m_sharedTextures ? _material->m_textures : _entity->m_textures;
+				auto textureIt = textures.find(level);
+				if (textureIt != textures.end())
+					index = textureIt->second;
 
 				// Check Texture Type
 				BaseTexture* texture = Assets.getBaseTexture(index);
@@ -669,6 +666,76 @@ namespace Vxl
 				//
 				}
 			}
+
+			// Section
+			ImGui::Separator();
+			ImGui::Text("Parameters");
+			ImGui::Separator();
+
+			// Parameter Block Values [layout is copied, a reload can replace it while editing]
+			std::shared_ptr<const ParameterLayout> _parameterLayout = _material->getParameters().getLayout();
+			if (_parameterLayout)
+			{
+				for (const auto& member : _parameterLayout->getMembers())
+				{
+					ParameterHandle handle(member.name);
+					switch (member.type)
+					{
+					//
+					case UniformType::FLOAT:
+					{
+						float value;
+						if (_material->getParameter(handle, value) && ImGui::DragFloat(member.name.c_str(), &value, 0.01f))
+							_material->setParameter(handle, value);
+						break;
+					}
+					//
+					case UniformType::FLOAT_VEC2:
+					{
+						Vector2 value;
+						if (_material->getParameter(handle, value) && ImGui::DragFloat2(member.name.c_str(), value.GetStartPointer(), 0.01f))
+							_material->setParameter(handle, value);
+						break;
+					}
+					//
+					case UniformType::FLOAT_VEC3:
+					{
+						Vector3 value;
+						if (_material->getParameter(handle, value) && ImGui::DragFloat3(member.name.c_str(), value.GetStartPointer(), 0.01f))
+							_material->setParameter(handle, value);
+						break;
+					}
+					//
+					case UniformType::FLOAT_VEC4:
+					{
+						Vector4 value;
+						if (_material->getParameter(handle, value) && ImGui::DragFloat4(member.name.c_str(), value.GetStartPointer(), 0.01f))
+							_material->setParameter(handle, value);
+						break;
+					}
+					//
+					case UniformType::INT:
+					{
+						int value;
+						if (_material->getParameter(handle, value) && ImGui::DragInt(member.name.c_str(), &value))
+							_material->setParameter(handle, value);
+						break;
+					}
+					//
+					case UniformType::BOOL:
+					{
+						bool value;
+						if (_material->getParameter(handle, value) && ImGui::Checkbox(member.name.c_str(), &value))
+							_material->setParameter(handle, value);
+						break;
+					}
+					//
+					default:
+						ImGui::Text("%s %s", ParameterLayout::GetTypeName(member.type), member.name.c_str());
+						break;
+					}
+				}
+			}
 		}
 	}
 }
@@ -9,16 +9,32 @@
 
 #include "../input/Input.h"
 
+#include "../utilities/Profiler.h"
 #include "../utilities/Time.h"
 
+#include "../rendering/RenderManager.h"
+
+#include <algorithm>
+#include <cstring>
+
+#undef max
+#undef min
+
 namespace Vxl
 {
+	static ImU32 GetZoneColor(uint32_t hash)
+	{
+		return ImColor::HSV((float)(hash & 0xFF) / 255.0f, 0.5f, 0.7f);
+	}
+
 	void Performance::Draw()
 	{
 		if (m_mode == Mode::GPU)
 			ImGui::TextColored(ImGuiColor::Orange, "[GPU]");
 		else if (m_mode == Mode::CPU)
 			ImGui::TextColored(ImGuiColor::Orange, "[CPU]");
+		else if (m_mode == Mode::FLAME)
+			ImGui::TextColored(ImGuiColor::Orange, "[Flame Graph]");
 
 		ImGui::SameLine();
 
@@ -27,71 +43,207 @@ namespace Vxl
 		ImGui::SameLine();
 		if (ImGui::SmallButton("CPU"))
 			m_mode = Mode::CPU;
+		ImGui::SameLine();
+		if (ImGui::SmallButton("Flame Graph"))
+			m_mode = Mode::FLAME;
+
+		// Frustum Culling
+		ImGui::Checkbox("Frustum Culling", &RenderManager.m_frustumCulling);
+		ImGui::SameLine();
+		ImGui::TextColored(ImGuiColor::Yellow, "Visible: %u", RenderManager.getVisibleEntityCount());
+		ImGui::SameLine();
+		ImGui::TextColored(ImGuiColor::Yellow, "Culled: %u", RenderManager.getCulledEntityCount());
+		// Batching
+		ImGui::Checkbox("Instanced Batching", &RenderManager.m_instancedBatching);
+		ImGui::SameLine();
+		ImGui::TextColored(ImGuiColor::Yellow, "Draw Calls: %u", RenderManager.getDrawCallCount());
+		ImGui::SameLine();
+		ImGui::TextColored(ImGuiColor::Yellow, "Batched: %u", RenderManager.getBatchedEntityCount());
+		// Textures
+		ImGui::TextColored(ImGuiColor::Yellow, "Texture Binds: %u", RenderManager.getTextureBindCount());
+		ImGui::SameLine();
+		ImGui::TextColored(ImGuiColor::Yellow, "Skipped: %u", RenderManager.getSkippedTextureBindCount());
+		// Selection
+		ImGui::Checkbox("ColorID Picking", &RenderManager.m_colorIDPicking);
+		// Profiler
+		ImGui::Checkbox("Profiler", &Profiler.m_enabled);
+		ImGui::SameLine();
+		if (!Profiler.isCapturing())
+		{
+			if (ImGui::SmallButton("Start Capture"))
+				Profiler.StartCapture();
+		}
+		else
+		{
+			if (ImGui::SmallButton("Stop Capture"))
+				Profiler.StopCapture("./profiler/trace_" + std::to_string(Time.GetFrameCount()) + ".json");
+			ImGui::SameLine();
+			ImGui::TextColored(ImGuiColor::Red, "Recording: %u zones", Profiler.getCaptureSize());
+		}
+		ImGui::SameLine();
+		if (ImGui::SmallButton("Reset Peaks"))
+			Profiler.ResetStats();
+		ImGui::SameLine();
+		ImGui::TextColored(ImGuiColor::Yellow, "Dropped: %u", Profiler.GetDroppedCount());
+		// Frame Times
+		const FrameTimeHistogram& frameTimes = Time.GetFrameTimes();
+		FrameTimeHistogram::Percentiles percentiles = frameTimes.getPercentiles();
+		ImGui::TextColored(ImGuiColor::Yellow, "Frame ms p50: %.2f p95: %.2f p99: %.2f max: %.2f", percentiles.p50, percentiles.p95, percentiles.p99, percentiles.max);
+		ImGui::PlotLines("##FrameTimes", frameTimes.getSamples(), (int)frameTimes.getCount(), (int)frameTimes.getOffset(), nullptr, 0.0f, FLT_MAX, ImVec2(0, 50));
+		// Fixed Steps
+		ImGui::TextColored(ImGuiColor::Yellow, "Fixed Steps: %u/%u", Time.GetFixedStepCount(), Time.GetMaxFixedSteps());
+		ImGui::SameLine();
+		ImGui::TextColored(ImGuiColor::Yellow, "Dropped Steps: %u", Time.GetDroppedFixedSteps());
+		ImGui::SameLine();
+		ImGui::TextColored(ImGuiColor::Yellow, "Alpha: %.2f", Time.GetFixedAlpha());
+		ImGui::Separator();
 
 		if (m_mode == Mode::GPU)
 		{
 #ifdef GLOBAL_GPU_TIMERS
-			ImGui::Columns(2, "GPUTimers"); // 4-ways, with border
-			ImGui::Text("Name"); ImGui::NextColumn();
-			ImGui::Text("Miliseconds"); ImGui::NextColumn();
-			ImGui::Separator();
+			DrawStats("GPUZones", true);
+#else
+			ImGui::TextColored(ImGuiColor::Orange, "[Disabled]");
+#endif
+		}
+		else if (m_mode == Mode::CPU)
+		{
+			DrawStats("CPUZones", false);
+		}
+		else if (m_mode == Mode::FLAME)
+		{
+			DrawFlameGraph();
+		}
+	}
 
-			double MS_TOTAL = 0.0f;
+	void Performance::DrawStats(const char* name, bool gpu)
+	{
+		const auto& stats = gpu ? Profiler.getGPUStats() : Profiler.getStats();
+
+		// Alphabetical
+		std::vector<std::pair<uint32_t, const ProfileStats*>> sorted;
+		sorted.reserve(stats.size());
+		for (const auto& stat : stats)
+			sorted.push_back({ stat.first, &stat.second });
+		std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b)
+		{
+			return strcmp(a.second->name, b.second->name) < 0;
+		});
+
+		ImGui::Columns(5, name);
+		ImGui::Text("Name"); ImGui::NextColumn();
+		ImGui::Text("Last (ms)"); ImGui::NextColumn();
+		ImGui::Text("Average (ms)"); ImGui::NextColumn();
+		ImGui::Text("Peak (ms)"); ImGui::NextColumn();
+		ImGui::Text("Calls"); ImGui::NextColumn();
+		ImGui::Separator();
+
+		for (const auto& stat : sorted)
+		{
+			if (ImGui::Selectable(stat.second->name, m_selectedZone == stat.first, ImGuiSelectableFlags_SpanAllColumns))
+				m_selectedZone = stat.first;
+
+			ImGui::NextColumn();
+			ImGui::Text("%.4f", stat.second->last);
+			ImGui::NextColumn();
+			ImGui::Text("%.4f", stat.second->average);
+			ImGui::NextColumn();
+			ImGui::Text("%.4f", stat.second->peak);
+			ImGui::NextColumn();
+			ImGui::Text("%u", stat.second->calls);
+			ImGui::NextColumn();
+		}
 
-			for (auto _gputimer : GPUTimer::m_timers)
-			{
-				MS_TOTAL += _gputimer.second->m_elapsedTime_MS_average;
+		ImGui::Columns(1);
+		ImGui::Separator();
+	}
 
-				if (ImGui::Selectable(_gputimer.first.c_str(), m_GPUTimerselected == _gputimer.second, ImGuiSelectableFlags_SpanAllColumns))
-					m_GPUTimerselected = _gputimer.second;
-				//bool hovered = ImGui::IsItemHovered();
+	void Performance::DrawFlameGraph()
+	{
+		int64_t frameStart = Profiler.getLastFrameStart();
+		int64_t frameEnd = Profiler.getLastFrameEnd();
+		if (frameEnd <= frameStart)
+		{
+			ImGui::TextColored(ImGuiColor::Orange, "[No Frames]");
+			return;
+		}
 
-				ImGui::NextColumn();
-				ImGui::Text("%.4f", _gputimer.second->m_elapsedTime_MS_average);
-				ImGui::NextColumn();
-			}
+		double frameLength = (double)(frameEnd - frameStart);
+		ImGui::TextColored(ImGuiColor::Yellow, "Frame: %.3f ms", frameLength / 1000000.0);
 
-			ImGui::Separator();
+		// One section per thread that recorded zones
+		const std::vector<ProfileEvent>& events = Profiler.getLastFrame();
+		std::vector<uint32_t> threads;
+		for (const ProfileEvent& event : events)
+		{
+			if (std::find(threads.begin(), threads.end(), event.thread) == threads.end())
+				threads.push_back(event.thread);
+		}
+		std::sort(threads.begin(), threads.end());
 
-			ImGui::TextColored(ImGuiColor::Yellow, "TOTAL"); ImGui::NextColumn();
-			ImGui::TextColored(ImGuiColor::Yellow, "%.4f", MS_TOTAL); ImGui::NextColumn();
+		for (uint32_t thread : threads)
+			DrawFlameRows(events, thread, frameStart, frameLength);
 
-			ImGui::Columns(1);
-			ImGui::Separator();
-#else
-			ImGui::TextColored(ImGuiColor::Orange, "[Disabled]");
-#endif
-		}
-		else if (m_mode == Mode::CPU)
+		// GPU frame is older, aligned to its own start
+		const std::vector<ProfileEvent>& gpuEvents = Profiler.getLastGPUFrame();
+		if (!gpuEvents.empty())
+			DrawFlameRows(gpuEvents, Profiler.GPUThread, gpuEvents[0].zone.start, frameLength);
+	}
+	void Performance::DrawFlameRows(const std::vector<ProfileEvent>& events, uint32_t thread, int64_t frameStart, double frameLength)
+	{
+		uint32_t depthCount = 0;
+		for (const ProfileEvent& event : events)
 		{
-			ImGui::Columns(2, "CPUTimers"); // 4-ways, with border
-			ImGui::Text("Name"); ImGui::NextColumn();
-			ImGui::Text("Miliseconds"); ImGui::NextColumn();
-			ImGui::Separator();
+			if (event.thread == thread)
+				depthCount = std::max(depthCount, event.zone.depth + 1);
+		}
+		if (depthCount == 0)
+			return;
 
-			double MS_TOTAL = 0.0f;
+		ImGui::TextColored(ImGuiColor::Orange, "%s", Profiler.GetThreadName(thread).c_str());
 
-			for (auto _gputimer : CPUTimer::m_timers)
-			{
-				MS_TOTAL += _gputimer.second->m_elapsedTime_MS_average;
+		const float RowHeight = ImGui::GetTextLineHeight() + 2.0f;
+		float width = ImGui::GetContentRegionAvailWidth();
+		float height = RowHeight * (float)depthCount;
+		ImVec2 origin = ImGui::GetCursorScreenPos();
 
-				if (ImGui::Selectable(_gputimer.first.c_str(), m_CPUTimerselected == _gputimer.second, ImGuiSelectableFlags_SpanAllColumns))
-					m_CPUTimerselected = _gputimer.second;
-				//bool hovered = ImGui::IsItemHovered();
+		ImDrawList* drawList = ImGui::GetWindowDrawList();
+		drawList->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + height), IM_COL32(30, 30, 30, 255));
 
-				ImGui::NextColumn();
-				ImGui::Text("%.4f", _gputimer.second->m_elapsedTime_MS_average);
-				ImGui::NextColumn();
-			}
+		for (const ProfileEvent& event : events)
+		{
+			if (event.thread != thread)
+				continue;
 
-			ImGui::Separator();
+			// Zones that started in a previous frame are clamped to the left edge
+			float x0 = (float)((double)(event.zone.start - frameStart) / frameLength) * width;
+			float x1 = (float)((double)(event.zone.end - frameStart) / frameLength) * width;
+			x0 = std::max(0.0f, std::min(x0, width));
+			x1 = std::max(x0 + 1.0f, std::min(x1, width));
 
-			ImGui::TextColored(ImGuiColor::Yellow, "TOTAL"); ImGui::NextColumn();
-			ImGui::TextColored(ImGuiColor::Yellow, "%.4f", MS_TOTAL); ImGui::NextColumn();
+			ImVec2 min(origin.x + x0, origin.y + RowHeight * (float)event.zone.depth);
+			ImVec2 max(origin.x + x1, min.y + RowHeight - 1.0f);
 
-			ImGui::Columns(1);
-			ImGui::Separator();
+			ImU32 color = (event.zone.hash == m_selectedZone) ? IM_COL32(255, 200, 0, 255) : GetZoneColor(event.zone.hash);
+			drawList->AddRectFilled(min, max, color);
+
+			// Label if it fits
+			if (max.x - min.x > 20.0f)
+			{
+				drawList->PushClipRect(min, max, true);
+				drawList->AddText(ImVec2(min.x + 2.0f, min.y + 1.0f), IM_COL32(255, 255, 255, 255), event.zone.name);
+				drawList->PopClipRect();
+			}
+
+			if (ImGui::IsMouseHoveringRect(min, max))
+			{
+				ImGui::SetTooltip("%s\n%.4f ms", event.zone.name, (double)(event.zone.end - event.zone.start) / 1000000.0);
+				if (ImGui::IsMouseClicked(0))
+					m_selectedZone = event.zone.hash;
+			}
 		}
+
+		ImGui::Dummy(ImVec2(width, height));
 	}
 }
 #endif
\ No newline at end of file
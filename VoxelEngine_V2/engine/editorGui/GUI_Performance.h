@@ -6,9 +6,11 @@
 #include "../utilities/singleton.h"
 #include "../utilities/Macros.h"
 
+#include <vector>
+
 namespace Vxl
 {
-	class GPUTimer;
+	struct ProfileEvent;
 
 	static class Performance : public Singleton<class Performance>, public GuiWindow
 	{
@@ -17,12 +19,17 @@ namespace Vxl
 		enum Mode
 		{
 			GPU,
-			CPU
+			CPU,
+			FLAME
 		};
 		Mode m_mode = Mode::GPU;
 
-		GPUTimer* m_GPUTimerselected = nullptr;
-		CPUTimer* m_CPUTimerselected = nullptr;
+		uint32_t m_selectedZone = 0; // Zone hash
+
+		void DrawStats(const char* name, bool gpu);
+		void DrawFlameGraph();
+		// Rows of zones for one thread, frameStart = left edge
+		void DrawFlameRows(const std::vector<ProfileEvent>& events, uint32_t thread, int64_t frameStart, double frameLength);
 	public:
 		// Draw
 		void Draw() override;
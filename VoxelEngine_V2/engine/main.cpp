@@ -5,16 +5,24 @@
 #include "input/Input.h"
 
 #include "editor/Editor.h"
+#include "math/MeshCache.h"
 #include "math/Random.h"
 #include "modules/Material.h"
 #include "rendering/RenderManager.h"
+#include "rendering/ShaderReloader.h"
+#include "utilities/AssetLoader.h"
+#include "utilities/Benchmark.h"
+#include "utilities/JobSystem.h"
 #include "utilities/Logger.h"
+#include "utilities/Profiler.h"
 #include "utilities/Time.h"
 #include "utilities/Macros.h"
 #include "utilities/stringUtil.h"
 
 #include "../game/Scene_Game.h"
 
+#include <shellapi.h>
+
 // Force Discrete Graphics Card
 extern "C"
 {
@@ -26,6 +34,29 @@ extern "C"
 using namespace Vxl;
 using namespace std;
 
+// Arguments without the executable [UTF-8]
+static vector<string> GetCommandLineArgs()
+{
+	vector<string> args;
+
+	int argc = 0;
+	LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+	if (!argv)
+		return args;
+
+	for (int i = 1; i < argc; i++)
+	{
+		int length = WideCharToMultiByte(CP_UTF8, 0, argv[i], -1, nullptr, 0, nullptr, nullptr);
+		string arg(length > 0 ? length - 1 : 0, '\0');
+		if (length > 1)
+			WideCharToMultiByte(CP_UTF8, 0, argv[i], -1, &arg[0], length, nullptr, nullptr);
+		args.push_back(arg);
+	}
+
+	LocalFree(argv);
+	return args;
+}
+
 #ifdef GLOBAL_OUTPUT_CONSOLE
 int main()
 #else
@@ -36,8 +67,20 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance
 	// String Hash Test
 	static_assert(StringHash32("a") == 3826002220U);
 
+	// Console output is optional, the file always gets every message
+	Logger.setFile("./logs/log.txt");
+
+	// Offline tools [no window]
+	vector<string> args = GetCommandLineArgs();
+	if (MeshCache::RunCommandLine(args))
+		return 0;
+	if (Benchmark::RunCommandLine(args))
+		return 0;
+
 	// Misc CPU Setup
 	Random.init();
+	Profiler.SetThreadName("Main");
+	JobSystem.Init();
 
 	// Window
 	Window.Setup("Vxl Engine", SCREEN_WIDTH, SCREEN_HEIGHT);
@@ -47,6 +90,7 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance
 	/* Initial Call */
 	Editor.init();
 	RenderManager.InitGlobalGLResources();
+	ShaderReloader.Init();
 
 	Scene_Game* _scene = new Scene_Game();
 	RenderManager.SetNewScene(_scene);
@@ -58,6 +102,8 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance
 	/* ~ */
 	while (!Window.GetClosed())
 	{
+		Profiler.BeginFrame();
+
 		if(RenderManager.m_globalVAO)
 			Graphics::VAO::bind(10);
 
@@ -82,29 +128,38 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance
 		Window.StartFrame();
 
 		// Scene Update/Render
-		while (TimeController.GetTotalDeltaTime() >= 1.0)
+		while (TimeController.StepFixed())
 		{
 			RenderManager.UpdateFixed();
-			TimeController.DecreaseTotalDeltaTime();
 		}
 		RenderManager.Update();
 		RenderManager.Draw();
 
 		// End of frame update
-		Editor.update();
+		{
+			VXL_PROFILE_SCOPE("Editor::update");
+			Editor.update();
+		}
 		Input.Update();
 		XGamePadManager.Update();
-		Window.EndFrame();
+		{
+			VXL_PROFILE_SCOPE("Window::EndFrame");
+			Window.EndFrame();
+		}
 		TimeController.EndFrame();
 
 		// Special
 #if _DEBUG
 		Graphics::GetRuntimeGLValues();
 #endif
-		
+
+		Profiler.EndFrame();
 	}
 
 	// Cleanup
+	ShaderReloader.Shutdown();
+	AssetLoader.Shutdown();
+	JobSystem.Shutdown();
 	RenderManager.SetNewScene(nullptr);
 	RenderManager.DestroyGlobalGLResources();
 	RenderManager.DestroySceneGLResources();
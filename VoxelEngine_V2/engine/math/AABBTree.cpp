@@ -0,0 +1,318 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "AABBTree.h"
+
+namespace Vxl
+{
+	uint32_t AABBTree::allocateNode()
+	{
+		// Grow pool
+		if (m_freeList == NullNode)
+		{
+			m_nodes.emplace_back();
+			return (uint32_t)m_nodes.size() - 1;
+		}
+
+		// Re-use free node
+		uint32_t node = m_freeList;
+		m_freeList = m_nodes[node].parent;
+
+		m_nodes[node] = Node();
+		return node;
+	}
+	void AABBTree::freeNode(uint32_t node)
+	{
+		m_nodes[node].parent = m_freeList;
+		m_nodes[node].height = -1;
+		m_freeList = node;
+	}
+
+	uint32_t AABBTree::insert(const AABB& aabb, uint32_t userData)
+	{
+		uint32_t leaf = allocateNode();
+
+		Vector3 margin(m_margin);
+		m_nodes[leaf].aabb = AABB(aabb.min - margin, aabb.max + margin);
+		m_nodes[leaf].userData = userData;
+		m_nodes[leaf].height = 0;
+
+		insertLeaf(leaf);
+		m_leafCount++;
+
+		return leaf;
+	}
+	void AABBTree::remove(uint32_t proxy)
+	{
+		VXL_ASSERT(proxy < m_nodes.size() && m_nodes[proxy].isLeaf(), "AABBTree invalid proxy");
+
+		removeLeaf(proxy);
+		freeNode(proxy);
+		m_leafCount--;
+	}
+	bool AABBTree::update(uint32_t proxy, const AABB& aabb)
+	{
+		VXL_ASSERT(proxy < m_nodes.size() && m_nodes[proxy].isLeaf(), "AABBTree invalid proxy");
+
+		// Still inside fat AABB, nothing to do
+		if (m_nodes[proxy].aabb.contains(aabb))
+			return false;
+
+		removeLeaf(proxy);
+
+		Vector3 margin(m_margin);
+		m_nodes[proxy].aabb = AABB(aabb.min - margin, aabb.max + margin);
+
+		insertLeaf(proxy);
+		return true;
+	}
+	void AABBTree::clear()
+	{
+		m_nodes.clear();
+		m_root = NullNode;
+		m_freeList = NullNode;
+		m_leafCount = 0;
+	}
+
+	void AABBTree::insertLeaf(uint32_t leaf)
+	{
+		if (m_root == NullNode)
+		{
+			m_root = leaf;
+			m_nodes[m_root].parent = NullNode;
+			return;
+		}
+
+		// Find best sibling using surface area heuristic
+		AABB leafAABB = m_nodes[leaf].aabb;
+		uint32_t index = m_root;
+		while (!m_nodes[index].isLeaf())
+		{
+			uint32_t child1 = m_nodes[index].child1;
+			uint32_t child2 = m_nodes[index].child2;
+
+			float area = m_nodes[index].aabb.getSurfaceArea();
+			float combinedArea = AABB::merge(m_nodes[index].aabb, leafAABB).getSurfaceArea();
+
+			// Cost of creating a new parent for this node and the new leaf
+			float cost = 2.0f * combinedArea;
+			// Minimum cost of pushing the leaf further down the tree
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			// Cost of descending into each child
+			float cost1 = AABB::merge(leafAABB, m_nodes[child1].aabb).getSurfaceArea() + inheritanceCost;
+			if (!m_nodes[child1].isLeaf())
+				cost1 -= m_nodes[child1].aabb.getSurfaceArea();
+
+			float cost2 = AABB::merge(leafAABB, m_nodes[child2].aabb).getSurfaceArea() + inheritanceCost;
+			if (!m_nodes[child2].isLeaf())
+				cost2 -= m_nodes[child2].aabb.getSurfaceArea();
+
+			if (cost < cost1 && cost < cost2)
+				break;
+
+			index = (cost1 < cost2) ? child1 : child2;
+		}
+		uint32_t sibling = index;
+
+		// Create new parent [allocateNode may move m_nodes]
+		uint32_t oldParent = m_nodes[sibling].parent;
+		uint32_t newParent = allocateNode();
+		m_nodes[newParent].parent = oldParent;
+		m_nodes[newParent].aabb = AABB::merge(leafAABB, m_nodes[sibling].aabb);
+		m_nodes[newParent].height = m_nodes[sibling].height + 1;
+		m_nodes[newParent].child1 = sibling;
+		m_nodes[newParent].child2 = leaf;
+		m_nodes[sibling].parent = newParent;
+		m_nodes[leaf].parent = newParent;
+
+		if (oldParent != NullNode)
+		{
+			if (m_nodes[oldParent].child1 == sibling)
+				m_nodes[oldParent].child1 = newParent;
+			else
+				m_nodes[oldParent].child2 = newParent;
+		}
+		else
+			m_root = newParent;
+
+		// Refit ancestors
+		index = m_nodes[leaf].parent;
+		while (index != NullNode)
+		{
+			index = balance(index);
+
+			uint32_t child1 = m_nodes[index].child1;
+			uint32_t child2 = m_nodes[index].child2;
+
+			m_nodes[index].height = 1 + MacroMax(m_nodes[child1].height, m_nodes[child2].height);
+			m_nodes[index].aabb = AABB::merge(m_nodes[child1].aabb, m_nodes[child2].aabb);
+
+			index = m_nodes[index].parent;
+		}
+	}
+
+	void AABBTree::removeLeaf(uint32_t leaf)
+	{
+		if (leaf == m_root)
+		{
+			m_root = NullNode;
+			return;
+		}
+
+		uint32_t parent = m_nodes[leaf].parent;
+		uint32_t grandParent = m_nodes[parent].parent;
+		uint32_t sibling = (m_nodes[parent].child1 == leaf) ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+		if (grandParent != NullNode)
+		{
+			// Connect sibling to grandparent and remove parent
+			if (m_nodes[grandParent].child1 == parent)
+				m_nodes[grandParent].child1 = sibling;
+			else
+				m_nodes[grandParent].child2 = sibling;
+
+			m_nodes[sibling].parent = grandParent;
+			freeNode(parent);
+
+			// Refit ancestors
+			uint32_t index = grandParent;
+			while (index != NullNode)
+			{
+				index = balance(index);
+
+				uint32_t child1 = m_nodes[index].child1;
+				uint32_t child2 = m_nodes[index].child2;
+
+				m_nodes[index].aabb = AABB::merge(m_nodes[child1].aabb, m_nodes[child2].aabb);
+				m_nodes[index].height = 1 + MacroMax(m_nodes[child1].height, m_nodes[child2].height);
+
+				index = m_nodes[index].parent;
+			}
+		}
+		else
+		{
+			m_root = sibling;
+			m_nodes[sibling].parent = NullNode;
+			freeNode(parent);
+		}
+	}
+
+	// Rotate subtree if it's imbalanced, returns new root of subtree
+	uint32_t AABBTree::balance(uint32_t iA)
+	{
+		Node& A = m_nodes[iA];
+		if (A.isLeaf() || A.height < 2)
+			return iA;
+
+		uint32_t iB = A.child1;
+		uint32_t iC = A.child2;
+		Node& B = m_nodes[iB];
+		Node& C = m_nodes[iC];
+
+		int32_t heightDifference = C.height - B.height;
+
+		// Rotate C up
+		if (heightDifference > 1)
+		{
+			uint32_t iF = C.child1;
+			uint32_t iG = C.child2;
+			Node& F = m_nodes[iF];
+			Node& G = m_nodes[iG];
+
+			// Swap A and C
+			C.child1 = iA;
+			C.parent = A.parent;
+			A.parent = iC;
+
+			// A's old parent should point to C
+			if (C.parent != NullNode)
+			{
+				if (m_nodes[C.parent].child1 == iA)
+					m_nodes[C.parent].child1 = iC;
+				else
+					m_nodes[C.parent].child2 = iC;
+			}
+			else
+				m_root = iC;
+
+			// Rotate
+			if (F.height > G.height)
+			{
+				C.child2 = iF;
+				A.child2 = iG;
+				G.parent = iA;
+				A.aabb = AABB::merge(B.aabb, G.aabb);
+				C.aabb = AABB::merge(A.aabb, F.aabb);
+
+				A.height = 1 + MacroMax(B.height, G.height);
+				C.height = 1 + MacroMax(A.height, F.height);
+			}
+			else
+			{
+				C.child2 = iG;
+				A.child2 = iF;
+				F.parent = iA;
+				A.aabb = AABB::merge(B.aabb, F.aabb);
+				C.aabb = AABB::merge(A.aabb, G.aabb);
+
+				A.height = 1 + MacroMax(B.height, F.height);
+				C.height = 1 + MacroMax(A.height, G.height);
+			}
+
+			return iC;
+		}
+
+		// Rotate B up
+		if (heightDifference < -1)
+		{
+			uint32_t iD = B.child1;
+			uint32_t iE = B.child2;
+			Node& D = m_nodes[iD];
+			Node& E = m_nodes[iE];
+
+			// Swap A and B
+			B.child1 = iA;
+			B.parent = A.parent;
+			A.parent = iB;
+
+			// A's old parent should point to B
+			if (B.parent != NullNode)
+			{
+				if (m_nodes[B.parent].child1 == iA)
+					m_nodes[B.parent].child1 = iB;
+				else
+					m_nodes[B.parent].child2 = iB;
+			}
+			else
+				m_root = iB;
+
+			// Rotate
+			if (D.height > E.height)
+			{
+				B.child2 = iD;
+				A.child1 = iE;
+				E.parent = iA;
+				A.aabb = AABB::merge(C.aabb, E.aabb);
+				B.aabb = AABB::merge(A.aabb, D.aabb);
+
+				A.height = 1 + MacroMax(C.height, E.height);
+				B.height = 1 + MacroMax(A.height, D.height);
+			}
+			else
+			{
+				B.child2 = iE;
+				A.child1 = iD;
+				D.parent = iA;
+				A.aabb = AABB::merge(C.aabb, D.aabb);
+				B.aabb = AABB::merge(A.aabb, E.aabb);
+
+				A.height = 1 + MacroMax(C.height, D.height);
+				B.height = 1 + MacroMax(A.height, E.height);
+			}
+
+			return iB;
+		}
+
+		return iA;
+	}
+}
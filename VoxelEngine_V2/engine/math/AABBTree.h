@@ -0,0 +1,222 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "Collision.h"
+
+#include "../utilities/Macros.h"
+
+#include <vector>
+
+namespace Vxl
+{
+	// Dynamic AABB Tree [Leaves store fattened AABBs so small movements don't require re-insertion]
+	// No dependencies on GL, can be used for culling, picking and proximity checks
+	class AABBTree
+	{
+		DISALLOW_COPY_AND_ASSIGN(AABBTree);
+	public:
+		static const uint32_t NullNode = (uint32_t)-1;
+
+	private:
+		struct Node
+		{
+			AABB	 aabb;
+			uint32_t userData = 0;
+			uint32_t parent = NullNode; // Also used as next free node
+			uint32_t child1 = NullNode;
+			uint32_t child2 = NullNode;
+			int32_t	 height = -1; // leaf = 0, free = -1
+
+			inline bool isLeaf(void) const
+			{
+				return child1 == NullNode;
+			}
+		};
+
+		std::vector<Node>	  m_nodes;
+		uint32_t			  m_root = NullNode;
+		uint32_t			  m_freeList = NullNode;
+		uint32_t			  m_leafCount = 0;
+		float				  m_margin;
+
+		// Traversal stack reused between queries
+		mutable std::vector<uint32_t> m_stack;
+
+		uint32_t allocateNode();
+		void	 freeNode(uint32_t node);
+
+		void	 insertLeaf(uint32_t leaf);
+		void	 removeLeaf(uint32_t leaf);
+		uint32_t balance(uint32_t node);
+
+	public:
+		AABBTree(float margin = 0.1f)
+			: m_margin(margin)
+		{}
+
+		// Returns proxy ID used for updating/removing
+		uint32_t insert(const AABB& aabb, uint32_t userData);
+		void	 remove(uint32_t proxy);
+		// Returns true if the leaf was re-inserted
+		bool	 update(uint32_t proxy, const AABB& aabb);
+		void	 clear();
+
+		// Getters
+		inline uint32_t getUserData(uint32_t proxy) const
+		{
+			VXL_ASSERT(proxy < m_nodes.size() && m_nodes[proxy].isLeaf(), "AABBTree invalid proxy");
+			return m_nodes[proxy].userData;
+		}
+		inline const AABB& getFatAABB(uint32_t proxy) const
+		{
+			VXL_ASSERT(proxy < m_nodes.size() && m_nodes[proxy].isLeaf(), "AABBTree invalid proxy");
+			return m_nodes[proxy].aabb;
+		}
+		inline uint32_t getLeafCount(void) const
+		{
+			return m_leafCount;
+		}
+		inline int32_t getHeight(void) const
+		{
+			return m_root == NullNode ? 0 : m_nodes[m_root].height;
+		}
+		inline float getMargin(void) const
+		{
+			return m_margin;
+		}
+
+		// ~ Queries ~ //
+		// Callback signature: bool(uint32_t userData), return false to stop the query
+		// Callbacks must not query the same tree (traversal stack is shared)
+
+		template<typename Callback>
+		void queryAABB(const AABB& aabb, Callback callback) const
+		{
+			if (m_root == NullNode)
+				return;
+
+			m_stack.clear();
+			m_stack.push_back(m_root);
+			while (!m_stack.empty())
+			{
+				const Node& node = m_nodes[m_stack.back()];
+				m_stack.pop_back();
+
+				if (!node.aabb.overlaps(aabb))
+					continue;
+
+				if (node.isLeaf())
+				{
+					if (!callback(node.userData))
+						return;
+				}
+				else
+				{
+					m_stack.push_back(node.child1);
+					m_stack.push_back(node.child2);
+				}
+			}
+		}
+
+		template<typename Callback>
+		void querySphere(const Vector3& center, float radius, Callback callback) const
+		{
+			if (m_root == NullNode)
+				return;
+
+			float radiusSqr = radius * radius;
+
+			m_stack.clear();
+			m_stack.push_back(m_root);
+			while (!m_stack.empty())
+			{
+				const Node& node = m_nodes[m_stack.back()];
+				m_stack.pop_back();
+
+				if (node.aabb.distanceSqr(center) > radiusSqr)
+					continue;
+
+				if (node.isLeaf())
+				{
+					if (!callback(node.userData))
+						return;
+				}
+				else
+				{
+					m_stack.push_back(node.child1);
+					m_stack.push_back(node.child2);
+				}
+			}
+		}
+
+		template<typename Callback>
+		void queryFrustum(const Frustum& frustum, Callback callback) const
+		{
+			if (m_root == NullNode)
+				return;
+
+			m_stack.clear();
+			m_stack.push_back(m_root);
+			while (!m_stack.empty())
+			{
+				const Node& node = m_nodes[m_stack.back()];
+				m_stack.pop_back();
+
+				if (!frustum.isInside(node.aabb))
+					continue;
+
+				if (node.isLeaf())
+				{
+					if (!callback(node.userData))
+						return;
+				}
+				else
+				{
+					m_stack.push_back(node.child1);
+					m_stack.push_back(node.child2);
+				}
+			}
+		}
+
+		// Callback signature: float(uint32_t userData, float maxDistance)
+		// Return value clips the ray: 0 = stop, maxDistance = continue, anything in between = new max distance
+		template<typename Callback>
+		void queryRay(const Ray& ray, float maxDistance, Callback callback) const
+		{
+			if (m_root == NullNode)
+				return;
+
+			Vector3 invDirection(
+				1.0f / ray.m_direction.x,
+				1.0f / ray.m_direction.y,
+				1.0f / ray.m_direction.z
+			);
+
+			m_stack.clear();
+			m_stack.push_back(m_root);
+			while (!m_stack.empty())
+			{
+				const Node& node = m_nodes[m_stack.back()];
+				m_stack.pop_back();
+
+				float distance;
+				if (!node.aabb.intersects(ray.m_origin, invDirection, maxDistance, distance))
+					continue;
+
+				if (node.isLeaf())
+				{
+					float value = callback(node.userData, maxDistance);
+					if (value <= 0.0f)
+						return;
+
+					maxDistance = value;
+				}
+				else
+				{
+					m_stack.push_back(node.child1);
+					m_stack.push_back(node.child2);
+				}
+			}
+		}
+	};
+}
\ No newline at end of file
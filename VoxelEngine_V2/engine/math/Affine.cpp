@@ -0,0 +1,66 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "Affine.h"
+
+#include "Matrix4x4.h"
+#include "MathCore.h"
+
+namespace Vxl
+{
+	// Constructors
+	Affine::Affine(void)
+		: m_linear(Matrix3x3::Identity), m_translation(Vector3::ZERO)
+	{}
+	Affine::Affine(const Matrix4x4& m)
+		: m_linear(m), m_translation(m[0x3], m[0x7], m[0xB])
+	{}
+	Affine::Affine(const Matrix3x3& linear, const Vector3& translation)
+		: m_linear(linear), m_translation(translation)
+	{}
+
+	Matrix4x4 Affine::GetMatrix4x4(void) const
+	{
+		return Matrix4x4(m_linear, m_translation);
+	}
+
+	// Inverse
+	Affine Affine::Inverse(void) const
+	{
+		Vector3 r0 = m_linear.GetRow(0);
+		Vector3 r1 = m_linear.GetRow(1);
+		Vector3 r2 = m_linear.GetRow(2);
+
+		// Columns of the inverse are cross products of the rows
+		Vector3 c0 = Vector3::Cross(r1, r2);
+		Vector3 c1 = Vector3::Cross(r2, r0);
+		Vector3 c2 = Vector3::Cross(r0, r1);
+
+		float det = r0.Dot(c0);
+		if (abs(det) < MATRIX_INVERSE_EPSILON)
+			return *this;
+
+		Matrix3x3 inverse = Matrix3x3::createFromColumns(c0, c1, c2) * (1.0f / det);
+		return Affine(inverse, -(inverse * m_translation));
+	}
+	Affine Affine::InverseUniformScale(float scale) const
+	{
+		// (sR)^-1 = R^T / s = (sR)^T / s^2
+		Matrix3x3 inverse = m_linear.Transpose() * (1.0f / (scale * scale));
+		return Affine(inverse, -(inverse * m_translation));
+	}
+
+	// Transform
+	Vector3 Affine::TransformPoint(const Vector3& point) const
+	{
+		return m_linear * point + m_translation;
+	}
+	Vector3 Affine::TransformDirection(const Vector3& direction) const
+	{
+		return m_linear * direction;
+	}
+
+	Affine Affine::operator*(const Affine& a) const
+	{
+		return Affine(m_linear * a.m_linear, m_linear * a.m_translation + m_translation);
+	}
+}
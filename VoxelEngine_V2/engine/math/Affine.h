@@ -0,0 +1,38 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "Matrix3x3.h"
+#include "Vector.h"
+
+namespace Vxl
+{
+	class Matrix4x4;
+
+	// 3x3 linear part + translation [bottom row of the 4x4 equivalent is always 0 0 0 1]
+	class Affine
+	{
+	public:
+		// Data
+		Matrix3x3	m_linear;
+		Vector3		m_translation;
+
+		// Constructors
+		Affine(void);
+		explicit Affine(const Matrix4x4& m);
+		explicit Affine(const Matrix3x3& linear, const Vector3& translation);
+
+		Matrix4x4 GetMatrix4x4(void) const;
+
+		// General inverse [returns self if the linear part is singular]
+		Affine Inverse(void) const;
+		// Linear part must be rotation * uniform scale, no general inverse needed [scale = 1 for rigid transforms]
+		Affine InverseUniformScale(float scale) const;
+
+		// Applies translation
+		Vector3 TransformPoint(const Vector3& point) const;
+		// Ignores translation
+		Vector3 TransformDirection(const Vector3& direction) const;
+
+		Affine operator*(const Affine&) const;
+	};
+}
@@ -4,10 +4,13 @@
 
 #include "Matrix3x3.h"
 #include "Matrix4x4.h"
+#include "SIMD.h"
 #include "Transform.h"
 
 #include "../rendering/Debug.h"
 
+#include <xmmintrin.h>
+
 namespace Vxl
 {
 	std::vector<Vector3> OBB::generatePoints()
@@ -41,17 +44,21 @@ namespace Vxl
 
 	AABB OBB::generateAABB()
 	{
-		AABB aabb(
-			Vector3::MAX,
-			Vector3::MIN
+		// Unit cube through a matrix whose columns are the OBB axes
+		Matrix4x4 axes = Matrix4x4::createFromColumns(
+			Vector4(right, 0.0f),
+			Vector4(up, 0.0f),
+			Vector4(forward, 0.0f),
+			Vector4(position, 1.0f)
 		);
-		std::vector<Vector3> positions = generatePoints();
-		for (const auto& pos : positions)
-		{
-			aabb.min = Vector3::Min(aabb.min, pos);
-			aabb.max = Vector3::Max(aabb.max, pos);
-		}
-		return aabb;
+		return AABB(Vector3(-0.5f), Vector3(0.5f)).transform(axes);
+	}
+
+	AABB AABB::transform(const Matrix4x4& model) const
+	{
+		AABB result;
+		SIMD::TransformAABB(model.GetStartPointer(), &min.x, &max.x, &result.min.x, &result.max.x);
+		return result;
 	}
 
 	OBB::OBB(const Matrix4x4& model, const Vector3& right, const Vector3& up, const Vector3& forward, const Vector3& meshMin, const Vector3& meshMax)
@@ -96,6 +103,135 @@ namespace Vxl
 		this->forward	= forward * FuzzyScale.z;
 	}
 
+	bool AABB::intersects(const Vector3& origin, const Vector3& invDirection, float maxDistance, float& distance) const
+	{
+		float t1 = (min.x - origin.x) * invDirection.x;
+		float t2 = (max.x - origin.x) * invDirection.x;
+		float tmin = MacroMin(t1, t2);
+		float tmax = MacroMax(t1, t2);
+
+		t1 = (min.y - origin.y) * invDirection.y;
+		t2 = (max.y - origin.y) * invDirection.y;
+		tmin = MacroMax(tmin, MacroMin(t1, t2));
+		tmax = MacroMin(tmax, MacroMax(t1, t2));
+
+		t1 = (min.z - origin.z) * invDirection.z;
+		t2 = (max.z - origin.z) * invDirection.z;
+		tmin = MacroMax(tmin, MacroMin(t1, t2));
+		tmax = MacroMin(tmax, MacroMax(t1, t2));
+
+		// Origin inside box
+		tmin = MacroMax(tmin, 0.0f);
+
+		distance = tmin;
+		return tmax >= tmin && tmin <= maxDistance;
+	}
+
+	void Frustum::extract(const Matrix4x4& viewProjection)
+	{
+		// Gribb/Hartmann plane extraction [Row major, column vectors]
+		Vector4 row0 = viewProjection.GetRow(0);
+		Vector4 row1 = viewProjection.GetRow(1);
+		Vector4 row2 = viewProjection.GetRow(2);
+		Vector4 row3 = viewProjection.GetRow(3);
+
+		m_planes[0] = row3 + row0; // Left
+		m_planes[1] = row3 - row0; // Right
+		m_planes[2] = row3 + row1; // Bottom
+		m_planes[3] = row3 - row1; // Top
+		m_planes[4] = row3 + row2; // Near
+		m_planes[5] = row3 - row2; // Far
+
+		// Normalize so distances are in world units
+		for (int i = 0; i < 6; i++)
+		{
+			float length = Vector3::Length(m_planes[i].x, m_planes[i].y, m_planes[i].z);
+			if (length > FLT_EPSILON)
+				m_planes[i] /= length;
+		}
+	}
+
+	bool Frustum::isInside(const AABB& aabb) const
+	{
+		for (int i = 0; i < 6; i++)
+		{
+			const Vector4& plane = m_planes[i];
+
+			// Corner furthest along the plane normal
+			Vector3 positive(
+				plane.x > 0.0f ? aabb.max.x : aabb.min.x,
+				plane.y > 0.0f ? aabb.max.y : aabb.min.y,
+				plane.z > 0.0f ? aabb.max.z : aabb.min.z
+			);
+
+			if (plane.x * positive.x + plane.y * positive.y + plane.z * positive.z + plane.w < 0.0f)
+				return false;
+		}
+		return true;
+	}
+
+	uint32_t FrustumCullAABBs(const Frustum& _frustum, const AABB* _aabbs, uint32_t _count, uint8_t* _visible)
+	{
+		uint32_t visibleCount = 0;
+		uint32_t batchCount = _count & ~3u;
+
+		// Broadcast planes once
+		__m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+		for (int p = 0; p < 6; p++)
+		{
+			planeX[p] = _mm_set1_ps(_frustum.m_planes[p].x);
+			planeY[p] = _mm_set1_ps(_frustum.m_planes[p].y);
+			planeZ[p] = _mm_set1_ps(_frustum.m_planes[p].z);
+			planeW[p] = _mm_set1_ps(_frustum.m_planes[p].w);
+		}
+
+		for (uint32_t i = 0; i < batchCount; i += 4)
+		{
+			const AABB& a = _aabbs[i + 0];
+			const AABB& b = _aabbs[i + 1];
+			const AABB& c = _aabbs[i + 2];
+			const AABB& d = _aabbs[i + 3];
+
+			// Swizzle 4 AABBs into SoA form
+			__m128 minX = _mm_set_ps(d.min.x, c.min.x, b.min.x, a.min.x);
+			__m128 minY = _mm_set_ps(d.min.y, c.min.y, b.min.y, a.min.y);
+			__m128 minZ = _mm_set_ps(d.min.z, c.min.z, b.min.z, a.min.z);
+			__m128 maxX = _mm_set_ps(d.max.x, c.max.x, b.max.x, a.max.x);
+			__m128 maxY = _mm_set_ps(d.max.y, c.max.y, b.max.y, a.max.y);
+			__m128 maxZ = _mm_set_ps(d.max.z, c.max.z, b.max.z, a.max.z);
+
+			__m128 outside = _mm_setzero_ps();
+			for (int p = 0; p < 6; p++)
+			{
+				// max(n * min, n * max) picks the corner furthest along the normal without branching
+				__m128 distX = _mm_max_ps(_mm_mul_ps(planeX[p], minX), _mm_mul_ps(planeX[p], maxX));
+				__m128 distY = _mm_max_ps(_mm_mul_ps(planeY[p], minY), _mm_mul_ps(planeY[p], maxY));
+				__m128 distZ = _mm_max_ps(_mm_mul_ps(planeZ[p], minZ), _mm_mul_ps(planeZ[p], maxZ));
+				__m128 dist = _mm_add_ps(_mm_add_ps(distX, distY), _mm_add_ps(distZ, planeW[p]));
+
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, _mm_setzero_ps()));
+			}
+
+			int mask = _mm_movemask_ps(outside);
+			for (uint32_t j = 0; j < 4; j++)
+			{
+				uint8_t visible = (mask & (1 << j)) ? 0 : 1;
+				_visible[i + j] = visible;
+				visibleCount += visible;
+			}
+		}
+
+		// Remainder
+		for (uint32_t i = batchCount; i < _count; i++)
+		{
+			uint8_t visible = _frustum.isInside(_aabbs[i]) ? 1 : 0;
+			_visible[i] = visible;
+			visibleCount += visible;
+		}
+
+		return visibleCount;
+	}
+
 	RayHit Intersection(const Ray& _ray, const Plane& _plane)
 	{
 		RayHit		hit;
@@ -116,6 +252,44 @@ namespace Vxl
 
 		return hit;
 	}
+	// Moller-Trumbore
+	RayHit Intersection(const Ray& _ray, const Vector3& _a, const Vector3& _b, const Vector3& _c)
+	{
+		RayHit hit;
+		hit.m_distance = 0.0f;
+		hit.m_location = Vector3::ZERO;
+		hit.m_missed = true;
+
+		Vector3 edge1 = _b - _a;
+		Vector3 edge2 = _c - _a;
+		Vector3 p = Vector3::Cross(_ray.m_direction, edge2);
+		float	det = edge1.Dot(p);
+
+		// Parallel to triangle
+		if (fabs(det) < 1e-8f)
+			return hit;
+
+		float	invDet = 1.0f / det;
+		Vector3 s = _ray.m_origin - _a;
+		float	u = s.Dot(p) * invDet;
+		if (u < 0.0f || u > 1.0f)
+			return hit;
+
+		Vector3 q = Vector3::Cross(s, edge1);
+		float	v = _ray.m_direction.Dot(q) * invDet;
+		if (v < 0.0f || u + v > 1.0f)
+			return hit;
+
+		float t = edge2.Dot(q) * invDet;
+		// Behind ray
+		if (t < 0.0f)
+			return hit;
+
+		hit.m_distance = t;
+		hit.m_location = _ray.m_origin + _ray.m_direction * t;
+		hit.m_missed = false;
+		return hit;
+	}
 
 	// Finds the shortest distance between two lines
 	float ShortestDistance(Ray& _ray1, Ray& _ray2)
@@ -22,6 +22,45 @@ namespace Vxl
 			min = _min;
 			max = _max;
 		}
+
+		inline Vector3 getCenter(void) const
+		{
+			return (min + max) * 0.5f;
+		}
+		inline float getSurfaceArea(void) const
+		{
+			Vector3 size = max - min;
+			return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}
+		// Smallest AABB containing both
+		static inline AABB merge(const AABB& a, const AABB& b)
+		{
+			return AABB(Vector3::Min(a.min, b.min), Vector3::Max(a.max, b.max));
+		}
+		inline bool overlaps(const AABB& other) const
+		{
+			return	min.x <= other.max.x && max.x >= other.min.x &&
+					min.y <= other.max.y && max.y >= other.min.y &&
+					min.z <= other.max.z && max.z >= other.min.z;
+		}
+		inline bool contains(const AABB& other) const
+		{
+			return	min.x <= other.min.x && max.x >= other.max.x &&
+					min.y <= other.min.y && max.y >= other.max.y &&
+					min.z <= other.min.z && max.z >= other.max.z;
+		}
+		// Squared distance from point to box (0 if inside)
+		inline float distanceSqr(const Vector3& point) const
+		{
+			float dx = point.x < min.x ? min.x - point.x : (point.x > max.x ? point.x - max.x : 0.0f);
+			float dy = point.y < min.y ? min.y - point.y : (point.y > max.y ? point.y - max.y : 0.0f);
+			float dz = point.z < min.z ? min.z - point.z : (point.z > max.z ? point.z - max.z : 0.0f);
+			return dx * dx + dy * dy + dz * dz;
+		}
+		// Slab test, invDirection = 1 / ray direction. Distance = entry distance along ray
+		bool intersects(const Vector3& origin, const Vector3& invDirection, float maxDistance, float& distance) const;
+		// Bounds of this box after an affine transform
+		AABB transform(const Matrix4x4& model) const;
 	};
 
 	struct OBB
@@ -68,6 +107,25 @@ namespace Vxl
 		{}
 	};
 
+	struct Frustum
+	{
+		// Planes stored as [normal.xyz, distance], normals point inwards
+		// Order: Left, Right, Bottom, Top, Near, Far
+		Vector4 m_planes[6];
+
+		Frustum() {}
+		Frustum(const Matrix4x4& viewProjection)
+		{
+			extract(viewProjection);
+		}
+
+		// Acquire planes from a (Projection * View) matrix
+		void extract(const Matrix4x4& viewProjection);
+
+		// Check if AABB is inside or intersecting the frustum
+		bool isInside(const AABB& aabb) const;
+	};
+
 	struct Ray
 	{
 		Vector3 m_origin;
@@ -88,6 +146,12 @@ namespace Vxl
 
 	// Finds where a Ray hits a plane
 	RayHit Intersection(const Ray& _ray, const Plane& _plane);
+	// Finds where a Ray hits a triangle [double sided, ray direction doesn't need to be normalized]
+	RayHit Intersection(const Ray& _ray, const Vector3& _a, const Vector3& _b, const Vector3& _c);
+
+	// Tests a batch of AABBs against a frustum, 4 at a time [SSE]
+	// _visible[i] = 1 if inside/intersecting, 0 if culled. Returns amount visible
+	uint32_t FrustumCullAABBs(const Frustum& _frustum, const AABB* _aabbs, uint32_t _count, uint8_t* _visible);
 
 	// Finds the shortest distance between two lines
 	float ShortestDistance(Ray& _ray1, Ray& _ray2);
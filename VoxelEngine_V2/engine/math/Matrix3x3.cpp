@@ -349,7 +349,7 @@ namespace Vxl
 		return Matrix3x3(
 			_Val[4] * _Val[8] - _Val[7] * _Val[5],
 			_Val[6] * _Val[5] - _Val[3] * _Val[8],
-			_Val[3] * _Val[7] - _Val[6] * _Val[6],
+			_Val[3] * _Val[7] - _Val[6] * _Val[4],
 			_Val[7] * _Val[2] - _Val[1] * _Val[8],
 			_Val[0] * _Val[8] - _Val[6] * _Val[2],
 			_Val[6] * _Val[1] - _Val[0] * _Val[7],
@@ -6,6 +6,7 @@
 #include "Vector.h"
 #include "MathCore.h"
 #include "Lerp.h"
+#include "SIMD.h"
 
 #include "../utilities/Macros.h"
 
@@ -555,55 +556,54 @@ namespace Vxl
 	// Inverse
 	Matrix4x4 Matrix4x4::Inverse() const
 	{
-		float det = Determinant();
+		Matrix4x4 Result;
+		float det = SIMD::Inverse(_Val, Result._Val);
 		if (abs(det) < MATRIX_INVERSE_EPSILON)
 			return *this;
 
-		float inva = 1.0f / det;
-		return Matrix4x4(
-			_Val[0x6] * _Val[0xB] * _Val[0xD] - _Val[0x7] * _Val[0xA] * _Val[0xD] + _Val[0x7] * _Val[0x9] * _Val[0xE] - _Val[0x5] * _Val[0xB] * _Val[0xE] - _Val[0x6] * _Val[0x9] * _Val[0xF] + _Val[0x5] * _Val[0xA] * _Val[0xF],
-			_Val[0x3] * _Val[0xA] * _Val[0xD] - _Val[0x2] * _Val[0xB] * _Val[0xD] - _Val[0x3] * _Val[0x9] * _Val[0xE] + _Val[0x1] * _Val[0xB] * _Val[0xE] + _Val[0x2] * _Val[0x9] * _Val[0xF] - _Val[0x1] * _Val[0xA] * _Val[0xF],
-			_Val[0x2] * _Val[0x7] * _Val[0xD] - _Val[0x3] * _Val[0x6] * _Val[0xD] + _Val[0x3] * _Val[0x5] * _Val[0xE] - _Val[0x1] * _Val[0x7] * _Val[0xE] - _Val[0x2] * _Val[0x5] * _Val[0xF] + _Val[0x1] * _Val[0x6] * _Val[0xF],
-			_Val[0x3] * _Val[0x6] * _Val[0x9] - _Val[0x2] * _Val[0x7] * _Val[0x9] - _Val[0x3] * _Val[0x5] * _Val[0xA] + _Val[0x1] * _Val[0x7] * _Val[0xA] + _Val[0x2] * _Val[0x5] * _Val[0xB] - _Val[0x1] * _Val[0x6] * _Val[0xB],
-			_Val[0x7] * _Val[0xA] * _Val[0xC] - _Val[0x6] * _Val[0xB] * _Val[0xC] - _Val[0x7] * _Val[0x8] * _Val[0xE] + _Val[0x4] * _Val[0xB] * _Val[0xE] + _Val[0x6] * _Val[0x8] * _Val[0xF] - _Val[0x4] * _Val[0xA] * _Val[0xF],
-			_Val[0x2] * _Val[0xB] * _Val[0xC] - _Val[0x3] * _Val[0xA] * _Val[0xC] + _Val[0x3] * _Val[0x8] * _Val[0xE] - _Val[0x0] * _Val[0xB] * _Val[0xE] - _Val[0x2] * _Val[0x8] * _Val[0xF] + _Val[0x0] * _Val[0xA] * _Val[0xF],
-			_Val[0x3] * _Val[0x6] * _Val[0xC] - _Val[0x2] * _Val[0x7] * _Val[0xC] - _Val[0x3] * _Val[0x4] * _Val[0xE] + _Val[0x0] * _Val[0x7] * _Val[0xE] + _Val[0x2] * _Val[0x4] * _Val[0xF] - _Val[0x0] * _Val[0x6] * _Val[0xF],
-			_Val[0x2] * _Val[0x7] * _Val[0x8] - _Val[0x3] * _Val[0x6] * _Val[0x8] + _Val[0x3] * _Val[0x4] * _Val[0xA] - _Val[0x0] * _Val[0x7] * _Val[0xA] - _Val[0x2] * _Val[0x4] * _Val[0xB] + _Val[0x0] * _Val[0x6] * _Val[0xB],
-			_Val[0x5] * _Val[0xB] * _Val[0xC] - _Val[0x7] * _Val[0x9] * _Val[0xC] + _Val[0x7] * _Val[0x8] * _Val[0xD] - _Val[0x4] * _Val[0xB] * _Val[0xD] - _Val[0x5] * _Val[0x8] * _Val[0xF] + _Val[0x4] * _Val[0x9] * _Val[0xF],
-			_Val[0x3] * _Val[0x9] * _Val[0xC] - _Val[0x1] * _Val[0xB] * _Val[0xC] - _Val[0x3] * _Val[0x8] * _Val[0xD] + _Val[0x0] * _Val[0xB] * _Val[0xD] + _Val[0x1] * _Val[0x8] * _Val[0xF] - _Val[0x0] * _Val[0x9] * _Val[0xF],
-			_Val[0x1] * _Val[0x7] * _Val[0xC] - _Val[0x3] * _Val[0x5] * _Val[0xC] + _Val[0x3] * _Val[0x4] * _Val[0xD] - _Val[0x0] * _Val[0x7] * _Val[0xD] - _Val[0x1] * _Val[0x4] * _Val[0xF] + _Val[0x0] * _Val[0x5] * _Val[0xF],
-			_Val[0x3] * _Val[0x5] * _Val[0x8] - _Val[0x1] * _Val[0x7] * _Val[0x8] - _Val[0x3] * _Val[0x4] * _Val[0x9] + _Val[0x0] * _Val[0x7] * _Val[0x9] + _Val[0x1] * _Val[0x4] * _Val[0xB] - _Val[0x0] * _Val[0x5] * _Val[0xB],
-			_Val[0x6] * _Val[0x9] * _Val[0xC] - _Val[0x5] * _Val[0xA] * _Val[0xC] - _Val[0x6] * _Val[0x8] * _Val[0xD] + _Val[0x4] * _Val[0xA] * _Val[0xD] + _Val[0x5] * _Val[0x8] * _Val[0xE] - _Val[0x4] * _Val[0x9] * _Val[0xE],
-			_Val[0x1] * _Val[0xA] * _Val[0xC] - _Val[0x2] * _Val[0x9] * _Val[0xC] + _Val[0x2] * _Val[0x8] * _Val[0xD] - _Val[0x0] * _Val[0xA] * _Val[0xD] - _Val[0x1] * _Val[0x8] * _Val[0xE] + _Val[0x0] * _Val[0x9] * _Val[0xE],
-			_Val[0x2] * _Val[0x5] * _Val[0xC] - _Val[0x1] * _Val[0x6] * _Val[0xC] - _Val[0x2] * _Val[0x4] * _Val[0xD] + _Val[0x0] * _Val[0x6] * _Val[0xD] + _Val[0x1] * _Val[0x4] * _Val[0xE] - _Val[0x0] * _Val[0x5] * _Val[0xE],
-			_Val[0x1] * _Val[0x6] * _Val[0x8] - _Val[0x2] * _Val[0x5] * _Val[0x8] + _Val[0x2] * _Val[0x4] * _Val[0x9] - _Val[0x0] * _Val[0x6] * _Val[0x9] - _Val[0x1] * _Val[0x4] * _Val[0xA] + _Val[0x0] * _Val[0x5] * _Val[0xA]
-		) * inva;
+		return Result;
 	}
 	// Inverse Self
 	Matrix4x4& Matrix4x4::InverseSelf()
 	{
 		return (*this = this->Inverse());
 	}
+	// Affine Inverse
+	Matrix4x4 Matrix4x4::AffineInverse() const
+	{
+		VXL_ASSERT(_Val[0xC] == 0.0f && _Val[0xD] == 0.0f && _Val[0xE] == 0.0f && _Val[0xF] == 1.0f, "AffineInverse requires a bottom row of [0 0 0 1]");
+
+		Matrix4x4 Result;
+		float det = SIMD::InverseAffine(_Val, Result._Val);
+		if (abs(det) < MATRIX_INVERSE_EPSILON)
+			return *this;
+
+		return Result;
+	}
 
 	// Multiply
 	Matrix4x4 Matrix4x4::Multiply(const Matrix4x4& m) const
 	{
 		Matrix4x4 Result;
-
-		for (int y = 0; y < Matrix4x4_Length; y++)
-		{
-			for (int x = 0; x < Matrix4x4_Length; x++)
-			{
-				Result[x + y * Matrix4x4_Length] = Vector4::Dot(GetRow(y), m.GetColumn(x));
-			}
-		}
-
+		SIMD::Multiply(_Val, m._Val, Result._Val);
 		return Result;
 	}
 	Matrix4x4 Matrix4x4::Multiply(const Matrix4x4& m1, const Matrix4x4& m2)
 	{
 		return m1.Multiply(m2);
 	}
+	void Matrix4x4::MultiplyBatch(const Matrix4x4& left, const Matrix4x4* right, Matrix4x4* out, uint32_t count)
+	{
+		static_assert(sizeof(Matrix4x4) == sizeof(float) * 16, "Matrix4x4 must be tightly packed for batches");
+		SIMD::MultiplyBatch(left._Val, reinterpret_cast<const float*>(right), reinterpret_cast<float*>(out), count);
+	}
+
+	// Transform
+	void Matrix4x4::TransformPoints(const Matrix4x4& m, const Vector3* points, Vector3* out, uint32_t count)
+	{
+		static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3 must be tightly packed for batches");
+		SIMD::TransformPoints(m._Val, reinterpret_cast<const float*>(points), reinterpret_cast<float*>(out), count);
+	}
 
 	// Compare
 	bool Matrix4x4::Compare(const Matrix4x4& m) const
@@ -128,10 +128,17 @@ namespace Vxl
 		Matrix4x4 Inverse() const;
 		// Inverse Self
 		Matrix4x4& InverseSelf();
+		// Inverse for matrices with a bottom row of [0 0 0 1]
+		Matrix4x4 AffineInverse() const;
 
 		// Multiply
 				Matrix4x4 Multiply(const Matrix4x4&) const;
 		static	Matrix4x4 Multiply(const Matrix4x4&, const Matrix4x4&);
+		// out[i] = left * right[i] [out may alias right]
+		static	void MultiplyBatch(const Matrix4x4& left, const Matrix4x4* right, Matrix4x4* out, uint32_t count);
+
+		// Transform points [w = 1, no perspective divide]
+		static	void TransformPoints(const Matrix4x4&, const Vector3* points, Vector3* out, uint32_t count);
 
 		// Compare
 				bool Compare(const Matrix4x4&) const;
@@ -0,0 +1,292 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "MeshCache.h"
+
+#include "Model.h"
+
+#include "../utilities/AssetLoader.h"
+#include "../utilities/FileIO.h"
+#include "../utilities/Logger.h"
+#include "../utilities/stringUtil.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace fs = std::experimental::filesystem;
+
+namespace Vxl
+{
+	// ~ File Layout ~ //
+	// [CacheHeader] [CacheEntry x meshCount] [arrays, 16 byte aligned]
+
+	struct CacheHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t importFlags;
+		uint32_t normalize;
+		float	 normalizeScale;
+		uint32_t meshCount;
+		uint64_t sourceSize;
+		int64_t	 sourceTime;
+	};
+	struct CacheEntry
+	{
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		Vector3	 min;
+		Vector3	 max;
+		// Offsets from start of file [0 = missing]
+		uint64_t positions;
+		uint64_t uvs;
+		uint64_t normals;
+		uint64_t tangents;
+		uint64_t indices;
+	};
+	static_assert(sizeof(Vector2) == 8 && sizeof(Vector3) == 12, "Mesh cache expects tightly packed vectors");
+
+	static bool GetSourceStamp(const std::string& filePath, uint64_t& size, int64_t& time)
+	{
+		std::error_code error;
+		size = (uint64_t)fs::file_size(filePath, error);
+		if (error)
+			return false;
+
+		time = (int64_t)fs::last_write_time(filePath, error).time_since_epoch().count();
+		return !error;
+	}
+
+	std::string MeshCache::GetCachePath(const std::string& filePath, bool normalize, float normalizeScale)
+	{
+		std::string key = filePath + '|' + std::to_string(normalize) + '|' + std::to_string(normalizeScale);
+		uint64_t hash = hash_64_fnv1a(key.data(), key.size());
+
+		char hashText[17];
+		snprintf(hashText, sizeof(hashText), "%016llx", (unsigned long long)hash);
+
+		return "./cache/meshes/" + stringUtil::nameFromFilepath(filePath) + '_' + hashText + ".vxmesh";
+	}
+
+	std::unique_ptr<MeshCacheFile> MeshCache::Open(const std::string& filePath, bool normalize, float normalizeScale)
+	{
+		auto cache = std::make_unique<MeshCacheFile>();
+		if (!cache->m_file.open(GetCachePath(filePath, normalize, normalizeScale)))
+			return nullptr;
+
+		const uint8_t* data = cache->m_file.getData();
+		uint64_t dataSize = cache->m_file.getSize();
+
+		if (dataSize < sizeof(CacheHeader))
+			return nullptr;
+
+		// Settings
+		const CacheHeader* header = reinterpret_cast<const CacheHeader*>(data);
+		if (header->magic != Magic ||
+			header->version != Version ||
+			header->importFlags != Model::ImportFlags ||
+			header->normalize != (uint32_t)normalize ||
+			header->normalizeScale != normalizeScale)
+			return nullptr;
+
+		// Source changed [cache is trusted if source is missing, allows shipping cooked files only]
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		if (GetSourceStamp(filePath, sourceSize, sourceTime) &&
+			(header->sourceSize != sourceSize || header->sourceTime != sourceTime))
+			return nullptr;
+
+		if (dataSize < sizeof(CacheHeader) + sizeof(CacheEntry) * (uint64_t)header->meshCount)
+			return nullptr;
+
+		auto getArray = [data, dataSize](uint64_t offset, uint64_t bytes) -> const void*
+		{
+			if (offset == 0 || offset + bytes > dataSize)
+				return nullptr;
+			return data + offset;
+		};
+
+		// Views into mapping
+		const CacheEntry* entries = reinterpret_cast<const CacheEntry*>(data + sizeof(CacheHeader));
+		cache->m_meshes.resize(header->meshCount);
+		for (uint32_t i = 0; i < header->meshCount; i++)
+		{
+			const CacheEntry& entry = entries[i];
+			MeshCacheView& view = cache->m_meshes[i];
+
+			view.vertexCount = entry.vertexCount;
+			view.indexCount = entry.indexCount;
+			view.min = entry.min;
+			view.max = entry.max;
+			view.positions	= (const Vector3*)getArray(entry.positions, entry.vertexCount * sizeof(Vector3));
+			view.uvs		= (const Vector2*)getArray(entry.uvs, entry.vertexCount * sizeof(Vector2));
+			view.normals	= (const Vector3*)getArray(entry.normals, entry.vertexCount * sizeof(Vector3));
+			view.tangents	= (const Vector3*)getArray(entry.tangents, entry.vertexCount * sizeof(Vector3));
+			view.indices	= (const uint32_t*)getArray(entry.indices, entry.indexCount * sizeof(uint32_t));
+
+			// Corrupt
+			if (!view.positions || (entry.indexCount && !view.indices))
+				return nullptr;
+		}
+
+		return cache;
+	}
+	std::unique_ptr<MeshCacheFile> MeshCache::Load(const std::string& filePath, bool normalize, float normalizeScale)
+	{
+		auto cache = Open(filePath, normalize, normalizeScale);
+		if (cache)
+			return cache;
+
+		if (!Cook(filePath, normalize, normalizeScale))
+			return nullptr;
+
+		return Open(filePath, normalize, normalizeScale);
+	}
+	bool MeshCache::Cook(const std::string& filePath, bool normalize, float normalizeScale)
+	{
+		std::vector<Model*> models = Model::LoadFromAssimp(filePath, false, normalize, normalizeScale);
+		if (models.empty())
+			return false;
+
+		bool result = Write(GetCachePath(filePath, normalize, normalizeScale), filePath, normalize, normalizeScale, models);
+
+		for (Model* model : models)
+			delete model;
+
+		return result;
+	}
+
+	bool MeshCache::Write(const std::string& cachePath, const std::string& filePath, bool normalize, float normalizeScale, const std::vector<Model*>& models)
+	{
+		CacheHeader header;
+		header.magic = Magic;
+		header.version = Version;
+		header.importFlags = Model::ImportFlags;
+		header.normalize = (uint32_t)normalize;
+		header.normalizeScale = normalizeScale;
+		header.meshCount = (uint32_t)models.size();
+		if (!GetSourceStamp(filePath, header.sourceSize, header.sourceTime))
+			return false;
+
+		// Layout
+		uint64_t offset = sizeof(CacheHeader) + sizeof(CacheEntry) * models.size();
+		auto reserve = [&offset](uint64_t bytes) -> uint64_t
+		{
+			if (bytes == 0)
+				return 0;
+
+			offset = (offset + 15) & ~15ull;
+			uint64_t start = offset;
+			offset += bytes;
+			return start;
+		};
+
+		std::vector<CacheEntry> entries(models.size());
+		for (size_t i = 0; i < models.size(); i++)
+		{
+			const Model& model = *models[i];
+			CacheEntry& entry = entries[i];
+			uint32_t vertexCount = (uint32_t)model.positions.size();
+
+			entry.vertexCount = vertexCount;
+			entry.indexCount = (uint32_t)model.indices.size();
+			entry.min = Vector3::MAX;
+			entry.max = Vector3::MIN;
+			for (const Vector3& position : model.positions)
+			{
+				entry.min = Vector3::Min(entry.min, position);
+				entry.max = Vector3::Max(entry.max, position);
+			}
+
+			// Attributes that don't cover every vertex are dropped
+			entry.positions = reserve(vertexCount * sizeof(Vector3));
+			entry.uvs		= (model.uvs.size() == vertexCount) ? reserve(vertexCount * sizeof(Vector2)) : 0;
+			entry.normals	= (model.normals.size() == vertexCount) ? reserve(vertexCount * sizeof(Vector3)) : 0;
+			entry.tangents	= (model.tangents.size() == vertexCount) ? reserve(vertexCount * sizeof(Vector3)) : 0;
+			entry.indices	= reserve(entry.indexCount * sizeof(uint32_t));
+		}
+
+		// Write to temporary file first, other threads might be reading the old cache
+		FileIO::EnsureDirectory(cachePath);
+		std::string tempPath = cachePath + '.' + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			AssetLoader::ReportError("Unable to write mesh cache: " + cachePath);
+			return false;
+		}
+
+		uint64_t written = 0;
+		auto writeAt = [&file, &written](uint64_t at, const void* data, uint64_t bytes)
+		{
+			if (at == 0)
+				return;
+
+			static const char Padding[16] = {};
+			file.write(Padding, at - written);
+			file.write((const char*)data, bytes);
+			written = at + bytes;
+		};
+
+		file.write((const char*)&header, sizeof(CacheHeader));
+		file.write((const char*)entries.data(), sizeof(CacheEntry) * entries.size());
+		written = sizeof(CacheHeader) + sizeof(CacheEntry) * entries.size();
+
+		for (size_t i = 0; i < models.size(); i++)
+		{
+			const Model& model = *models[i];
+			const CacheEntry& entry = entries[i];
+
+			writeAt(entry.positions, model.positions.data(), entry.vertexCount * sizeof(Vector3));
+			writeAt(entry.uvs, model.uvs.data(), entry.vertexCount * sizeof(Vector2));
+			writeAt(entry.normals, model.normals.data(), entry.vertexCount * sizeof(Vector3));
+			writeAt(entry.tangents, model.tangents.data(), entry.vertexCount * sizeof(Vector3));
+			writeAt(entry.indices, model.indices.data(), entry.indexCount * sizeof(uint32_t));
+		}
+
+		bool result = file.good();
+		file.close();
+
+		// Swap in [fails if another thread has the old cache mapped, that copy is just as valid]
+		std::error_code error;
+		if (result)
+		{
+			fs::remove(cachePath, error);
+			fs::rename(tempPath, cachePath, error);
+		}
+		if (!result || error)
+			fs::remove(tempPath, error);
+
+		return result;
+	}
+
+	bool MeshCache::RunCommandLine(const std::vector<std::string>& args)
+	{
+		if (args.empty() || args[0] != "--cook")
+			return false;
+
+		bool normalize = false;
+		float normalizeScale = 1.0f;
+
+		for (size_t i = 1; i < args.size(); i++)
+		{
+			// Applies to all following files
+			if (args[i] == "--normalize" && i + 1 < args.size())
+			{
+				normalize = true;
+				normalizeScale = std::strtof(args[++i].c_str(), nullptr);
+				continue;
+			}
+
+			if (Cook(args[i], normalize, normalizeScale))
+				Logger.log("Cooked: " + args[i] + " -> " + GetCachePath(args[i], normalize, normalizeScale));
+			else
+				Logger.error("Unable to cook: " + args[i]);
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "Vector.h"
+
+#include "../utilities/FileIO.h"
+#include "../utilities/Macros.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Vxl
+{
+	class Model;
+
+	// One mesh inside a cache file [pointers go straight into the mapped file]
+	struct MeshCacheView
+	{
+		uint32_t		vertexCount = 0;
+		uint32_t		indexCount = 0;
+		const Vector3*	positions = nullptr;
+		const Vector2*	uvs = nullptr;		// nullptr if missing
+		const Vector3*	normals = nullptr;	// nullptr if missing
+		const Vector3*	tangents = nullptr;	// nullptr if missing
+		const uint32_t* indices = nullptr;	// nullptr if missing
+		Vector3			min;
+		Vector3			max;
+	};
+
+	// Memory mapped cache file, stays mapped while this object lives
+	class MeshCacheFile
+	{
+		DISALLOW_COPY_AND_ASSIGN(MeshCacheFile);
+		friend class MeshCache;
+	private:
+		MappedFile					m_file;
+		std::vector<MeshCacheView>	m_meshes;
+
+	public:
+		MeshCacheFile() {}
+
+		inline uint32_t				getMeshCount(void) const
+		{
+			return (uint32_t)m_meshes.size();
+		}
+		inline const MeshCacheView& getMesh(uint32_t index) const
+		{
+			VXL_ASSERT(index < m_meshes.size(), "MeshCacheFile index out of bounds");
+			return m_meshes[index];
+		}
+	};
+
+	// Binary cache of imported models [./cache/meshes/]
+	// Files are keyed by source path + import settings, and are re-cooked when the source size or write time changes
+	class MeshCache
+	{
+	public:
+		static const uint32_t Magic = 0x434D5856; // "VXMC"
+		static const uint32_t Version = 1;
+
+		// Cache location for a source file and its import settings
+		static std::string GetCachePath(const std::string& filePath, bool normalize, float normalizeScale);
+
+		// Maps cache file, nullptr if missing or stale
+		static std::unique_ptr<MeshCacheFile> Open(const std::string& filePath, bool normalize, float normalizeScale);
+		// Maps cache file, imports source with assimp and writes the cache first if needed [thread safe]
+		static std::unique_ptr<MeshCacheFile> Load(const std::string& filePath, bool normalize, float normalizeScale);
+		// Imports source and writes cache file, returns false if import failed
+		static bool Cook(const std::string& filePath, bool normalize, float normalizeScale);
+
+		// Cook tool [--cook [--normalize scale] file1 file2 ...], returns false if arguments aren't a cook command
+		static bool RunCommandLine(const std::vector<std::string>& args);
+
+	private:
+		static bool Write(const std::string& cachePath, const std::string& filePath, bool normalize, float normalizeScale, const std::vector<Model*>& models);
+	};
+}
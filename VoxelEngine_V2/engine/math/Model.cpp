@@ -7,12 +7,16 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include "MeshCache.h"
+
 #include "../rendering/Mesh.h"
+#include "../rendering/RenderManager.h"
 
 #include "../utilities/stringUtil.h"
 #include "../utilities/Logger.h"
 #include "../utilities/Types.h"
 #include "../utilities/Asset.h"
+#include "../utilities/AssetLoader.h"
 
 namespace Vxl
 {
@@ -29,21 +33,21 @@ namespace Vxl
 		return Vector2(vec.x, vec.y);
 	}
 
+	const unsigned int Model::ImportFlags = aiProcessPreset_TargetRealtime_MaxQuality;
+
 	std::vector<Model*> Model::LoadFromAssimp(
 		const std::string& filePath,
 		bool mergeMeshes,
 		bool normalize,
 		float normalizeScale
 	) {
-		unsigned int flags = aiProcessPreset_TargetRealtime_MaxQuality;
-
-		const aiScene* scene = aiImportFile(filePath.c_str(), flags);
+		const aiScene* scene = aiImportFile(filePath.c_str(), ImportFlags);
 
 		if (!scene)
 		{
 			// Error
 			auto Name = stringUtil::nameFromFilepath(filePath);
-			Logger.error("Unable to load Model: " + Name);
+			AssetLoader::ReportError("Unable to load Model: " + Name);
 			return std::vector<Model*>();
 		}
 
@@ -158,11 +162,12 @@ namespace Vxl
 		const std::string& name,
 		const std::string& filePath,
 		bool normalize,
-		float normalizeScale
+		float normalizeScale,
+		bool packed
 	) {
 		std::vector<MeshIndex> _meshes;
-		std::vector<Model*> Models = Model::LoadFromAssimp(filePath, false, normalize, normalizeScale);
-		UINT _modelCount = (UINT)Models.size();
+		auto Cache = MeshCache::Load(filePath, normalize, normalizeScale);
+		UINT _modelCount = Cache ? Cache->getMeshCount() : 0;
 
 		if (_modelCount == 0)
 		{
@@ -182,7 +187,8 @@ namespace Vxl
 
 			// Mesh Data
 			Mesh* _mesh = SceneAssets.getMesh(NewMeshIndex);
-			_mesh->set(*Models[i]);
+			_mesh->setPacked(packed);
+			_mesh->set(Cache->getMesh(i));
 			_mesh->setGLName(_name);
 		}
 
@@ -192,18 +198,57 @@ namespace Vxl
 		const std::string& name,
 		const std::string& filePath,
 		bool normalize,
-		float normalizeScale
+		float normalizeScale,
+		bool packed
 	)
 	{
-		std::vector<Model*> Models = Model::LoadFromAssimp(filePath, false, normalize, normalizeScale);
-		if (Models.size() == 0)
+		auto Cache = MeshCache::Load(filePath, normalize, normalizeScale);
+		if (!Cache || Cache->getMeshCount() == 0)
 			return -1;
 
 		MeshIndex NewMeshIndex = SceneAssets.createMesh(DrawType::TRIANGLES);
 		Mesh* _mesh = SceneAssets.getMesh(NewMeshIndex);
-		_mesh->set(*Models[0]);
+		_mesh->setPacked(packed);
+		_mesh->set(Cache->getMesh(0));
 		_mesh->setGLName(name);
 
 		return NewMeshIndex;
 	}
+	LoadHandle Model::LoadMeshAsync(
+		const std::string& name,
+		const std::string& filePath,
+		bool normalize,
+		float normalizeScale,
+		bool packed
+	)
+	{
+		MeshIndex NewMeshIndex = SceneAssets.createMesh(DrawType::TRIANGLES);
+
+		// Owned by the load, file stays mapped until the last lambda is gone
+		auto Cache = std::make_shared<std::unique_ptr<MeshCacheFile>>();
+
+		return AssetLoader.Submit(NewMeshIndex, filePath,
+			// Worker [cooks cache if needed]
+			[Cache, filePath, normalize, normalizeScale]()
+			{
+				*Cache = MeshCache::Load(filePath, normalize, normalizeScale);
+				return *Cache && (*Cache)->getMeshCount() > 0;
+			},
+			// Render thread [mesh is gone if its scene was destroyed meanwhile]
+			[Cache, name, NewMeshIndex, packed]()
+			{
+				Mesh* _mesh = Assets.getMesh(NewMeshIndex);
+				if (!_mesh)
+					return LoadState::CANCELLED;
+
+				_mesh->setPacked(packed);
+				_mesh->set((*Cache)->getMesh(0));
+				_mesh->setGLName(name);
+
+				// Entities were given the mesh while it was empty
+				RenderManager.UpdateMeshBounds(NewMeshIndex);
+				return LoadState::COMPLETE;
+			}
+		);
+	}
 }
\ No newline at end of file
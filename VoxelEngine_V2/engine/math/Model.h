@@ -12,12 +12,18 @@
 namespace Vxl
 {
 	class Mesh;
+	class LoadHandle;
 
 	class Model
 	{
 		friend class Loader;
 		friend class Mesh;
+		friend class DevConsole;
+		friend class MeshCache;
 	private:
+		// Assimp post process flags [part of the mesh cache key]
+		static const unsigned int ImportFlags;
+
 		// Load ASSIMP
 		static std::vector<Model*> LoadFromAssimp(
 			const std::string& filePath,
@@ -39,19 +45,31 @@ namespace Vxl
 		unsigned int indexCount = 0;
 
 	public:
-		// Load all meshes from a file
+		// Load all meshes from a file [goes through the mesh cache, source is only imported when the cache is stale]
+		// Packed meshes use Mesh::setPacked [less than half the GPU memory, see VertexPacking]
 		static std::vector<MeshIndex> LoadMeshes(
 			const std::string& name,
 			const std::string& filePath,
 			bool normalize,
-			float normalizeScale = 1.0f
+			float normalizeScale = 1.0f,
+			bool packed = false
 		);
 		// Load all meshes and combine them into one mesh
 		static MeshIndex LoadMesh(
 			const std::string& name,
 			const std::string& filePath,
 			bool normalize,
-			float normalizeScale = 1.0f
+			float normalizeScale = 1.0f,
+			bool packed = false
+		);
+		// Same as LoadMesh, but parsing happens on the AssetLoader workers
+		// Mesh index is valid immediately, mesh is empty until the upload
+		static LoadHandle LoadMeshAsync(
+			const std::string& name,
+			const std::string& filePath,
+			bool normalize,
+			float normalizeScale = 1.0f,
+			bool packed = false
 		);
 
 		// Merge
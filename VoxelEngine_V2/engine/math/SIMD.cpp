@@ -0,0 +1,552 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "SIMD.h"
+
+#include <math.h>
+
+#if defined(VXL_SIMD_AVX)
+#include <immintrin.h>
+#elif defined(VXL_SIMD_SSE)
+#include <emmintrin.h>
+#elif defined(VXL_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace Vxl
+{
+	namespace SIMD
+	{
+		// ~ 4 wide operations, kernels below are written once against these ~ //
+		struct ScalarOps
+		{
+			struct F4
+			{
+				float v[4];
+			};
+
+			static inline F4	Load(const float* p)
+			{
+				return { { p[0], p[1], p[2], p[3] } };
+			}
+			static inline void	Store(float* p, const F4& a)
+			{
+				p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3];
+			}
+			static inline F4	Set(float x, float y, float z, float w)
+			{
+				return { { x, y, z, w } };
+			}
+			static inline F4	Splat(float f)
+			{
+				return { { f, f, f, f } };
+			}
+			static inline F4	Add(const F4& a, const F4& b)
+			{
+				return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } };
+			}
+			static inline F4	Sub(const F4& a, const F4& b)
+			{
+				return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } };
+			}
+			static inline F4	Mul(const F4& a, const F4& b)
+			{
+				return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } };
+			}
+			static inline F4	Div(const F4& a, const F4& b)
+			{
+				return { { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] } };
+			}
+			static inline F4	Abs(const F4& a)
+			{
+				return { { fabsf(a.v[0]), fabsf(a.v[1]), fabsf(a.v[2]), fabsf(a.v[3]) } };
+			}
+			static inline F4	Neg(const F4& a)
+			{
+				return { { -a.v[0], -a.v[1], -a.v[2], -a.v[3] } };
+			}
+			// (a[X], a[Y], a[Z], a[W])
+			template<int X, int Y, int Z, int W>
+			static inline F4	Swizzle(const F4& a)
+			{
+				return { { a.v[X], a.v[Y], a.v[Z], a.v[W] } };
+			}
+			// (a[X], a[Y], b[Z], b[W])
+			template<int X, int Y, int Z, int W>
+			static inline F4	Shuffle(const F4& a, const F4& b)
+			{
+				return { { a.v[X], a.v[Y], b.v[Z], b.v[W] } };
+			}
+			static inline float	First(const F4& a)
+			{
+				return a.v[0];
+			}
+		};
+
+#if defined(VXL_SIMD_SSE)
+		struct NativeOps
+		{
+			typedef __m128 F4;
+
+			static inline F4	Load(const float* p)
+			{
+				return _mm_loadu_ps(p);
+			}
+			static inline void	Store(float* p, F4 a)
+			{
+				_mm_storeu_ps(p, a);
+			}
+			static inline F4	Set(float x, float y, float z, float w)
+			{
+				return _mm_setr_ps(x, y, z, w);
+			}
+			static inline F4	Splat(float f)
+			{
+				return _mm_set1_ps(f);
+			}
+			static inline F4	Add(F4 a, F4 b)
+			{
+				return _mm_add_ps(a, b);
+			}
+			static inline F4	Sub(F4 a, F4 b)
+			{
+				return _mm_sub_ps(a, b);
+			}
+			static inline F4	Mul(F4 a, F4 b)
+			{
+				return _mm_mul_ps(a, b);
+			}
+			static inline F4	Div(F4 a, F4 b)
+			{
+				return _mm_div_ps(a, b);
+			}
+			static inline F4	Abs(F4 a)
+			{
+				return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+			}
+			static inline F4	Neg(F4 a)
+			{
+				return _mm_xor_ps(_mm_set1_ps(-0.0f), a);
+			}
+			template<int X, int Y, int Z, int W>
+			static inline F4	Swizzle(F4 a)
+			{
+				return _mm_shuffle_ps(a, a, _MM_SHUFFLE(W, Z, Y, X));
+			}
+			template<int X, int Y, int Z, int W>
+			static inline F4	Shuffle(F4 a, F4 b)
+			{
+				return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+			}
+			static inline float	First(F4 a)
+			{
+				return _mm_cvtss_f32(a);
+			}
+		};
+#elif defined(VXL_SIMD_NEON)
+		struct NativeOps
+		{
+			typedef float32x4_t F4;
+
+			static inline F4	Load(const float* p)
+			{
+				return vld1q_f32(p);
+			}
+			static inline void	Store(float* p, F4 a)
+			{
+				vst1q_f32(p, a);
+			}
+			static inline F4	Set(float x, float y, float z, float w)
+			{
+				float v[4] = { x, y, z, w };
+				return vld1q_f32(v);
+			}
+			static inline F4	Splat(float f)
+			{
+				return vdupq_n_f32(f);
+			}
+			static inline F4	Add(F4 a, F4 b)
+			{
+				return vaddq_f32(a, b);
+			}
+			static inline F4	Sub(F4 a, F4 b)
+			{
+				return vsubq_f32(a, b);
+			}
+			static inline F4	Mul(F4 a, F4 b)
+			{
+				return vmulq_f32(a, b);
+			}
+			static inline F4	Div(F4 a, F4 b)
+			{
+				return vdivq_f32(a, b);
+			}
+			static inline F4	Abs(F4 a)
+			{
+				return vabsq_f32(a);
+			}
+			static inline F4	Neg(F4 a)
+			{
+				return vnegq_f32(a);
+			}
+			// Generic lane moves, only used by inverses
+			template<int X, int Y, int Z, int W>
+			static inline F4	Swizzle(F4 a)
+			{
+				float v[4];
+				vst1q_f32(v, a);
+				return Set(v[X], v[Y], v[Z], v[W]);
+			}
+			template<int X, int Y, int Z, int W>
+			static inline F4	Shuffle(F4 a, F4 b)
+			{
+				float va[4];
+				float vb[4];
+				vst1q_f32(va, a);
+				vst1q_f32(vb, b);
+				return Set(va[X], va[Y], vb[Z], vb[W]);
+			}
+			static inline float	First(F4 a)
+			{
+				return vgetq_lane_f32(a, 0);
+			}
+		};
+#else
+		typedef ScalarOps NativeOps;
+#endif
+
+		// ~ Kernels ~ //
+		template<typename Ops>
+		struct Kernels
+		{
+			typedef typename Ops::F4 F4;
+
+			// 2x2 row major blocks stored as (m00, m01, m10, m11)
+			static inline F4 Mat2Mul(F4 a, F4 b)
+			{
+				return Ops::Add(
+					Ops::Mul(a, Ops::template Swizzle<0, 3, 0, 3>(b)),
+					Ops::Mul(Ops::template Swizzle<1, 0, 3, 2>(a), Ops::template Swizzle<2, 1, 2, 1>(b))
+				);
+			}
+			// Adjugate(a) * b
+			static inline F4 Mat2AdjMul(F4 a, F4 b)
+			{
+				return Ops::Sub(
+					Ops::Mul(Ops::template Swizzle<3, 3, 0, 0>(a), b),
+					Ops::Mul(Ops::template Swizzle<1, 1, 2, 2>(a), Ops::template Swizzle<2, 3, 0, 1>(b))
+				);
+			}
+			// a * Adjugate(b)
+			static inline F4 Mat2MulAdj(F4 a, F4 b)
+			{
+				return Ops::Sub(
+					Ops::Mul(a, Ops::template Swizzle<3, 0, 3, 0>(b)),
+					Ops::Mul(Ops::template Swizzle<1, 0, 3, 2>(a), Ops::template Swizzle<2, 1, 2, 1>(b))
+				);
+			}
+			static inline F4 Cross(F4 a, F4 b)
+			{
+				return Ops::Sub(
+					Ops::Mul(Ops::template Swizzle<1, 2, 0, 3>(a), Ops::template Swizzle<2, 0, 1, 3>(b)),
+					Ops::Mul(Ops::template Swizzle<2, 0, 1, 3>(a), Ops::template Swizzle<1, 2, 0, 3>(b))
+				);
+			}
+			// Columns of m, used to transform points
+			static inline void LoadColumns(const float* m, F4& c0, F4& c1, F4& c2, F4& c3)
+			{
+				c0 = Ops::Set(m[0x0], m[0x4], m[0x8], m[0xC]);
+				c1 = Ops::Set(m[0x1], m[0x5], m[0x9], m[0xD]);
+				c2 = Ops::Set(m[0x2], m[0x6], m[0xA], m[0xE]);
+				c3 = Ops::Set(m[0x3], m[0x7], m[0xB], m[0xF]);
+			}
+			static inline void Store3(float* p, F4 a)
+			{
+				float v[4];
+				Ops::Store(v, a);
+				p[0] = v[0];
+				p[1] = v[1];
+				p[2] = v[2];
+			}
+
+			static inline void Multiply(const float* a, const float* b, float* out)
+			{
+				F4 b0 = Ops::Load(b + 0x0);
+				F4 b1 = Ops::Load(b + 0x4);
+				F4 b2 = Ops::Load(b + 0x8);
+				F4 b3 = Ops::Load(b + 0xC);
+
+				// Row i of result = sum of rows of b weighted by row i of a
+				F4 rows[4];
+				for (int i = 0; i < 4; i++)
+				{
+					const float* row = a + i * 4;
+					rows[i] = Ops::Add(Ops::Add(Ops::Add(
+						Ops::Mul(Ops::Splat(row[0]), b0),
+						Ops::Mul(Ops::Splat(row[1]), b1)),
+						Ops::Mul(Ops::Splat(row[2]), b2)),
+						Ops::Mul(Ops::Splat(row[3]), b3)
+					);
+				}
+
+				for (int i = 0; i < 4; i++)
+					Ops::Store(out + i * 4, rows[i]);
+			}
+
+			// Block inverse with 2x2 sub matrices
+			// M = | A B |
+			//     | C D |
+			static inline float Inverse(const float* m, float* out)
+			{
+				F4 r0 = Ops::Load(m + 0x0);
+				F4 r1 = Ops::Load(m + 0x4);
+				F4 r2 = Ops::Load(m + 0x8);
+				F4 r3 = Ops::Load(m + 0xC);
+
+				F4 A = Ops::template Shuffle<0, 1, 0, 1>(r0, r1);
+				F4 B = Ops::template Shuffle<2, 3, 2, 3>(r0, r1);
+				F4 C = Ops::template Shuffle<0, 1, 0, 1>(r2, r3);
+				F4 D = Ops::template Shuffle<2, 3, 2, 3>(r2, r3);
+
+				// (|A|, |B|, |C|, |D|)
+				F4 detSub = Ops::Sub(
+					Ops::Mul(Ops::template Shuffle<0, 2, 0, 2>(r0, r2), Ops::template Shuffle<1, 3, 1, 3>(r1, r3)),
+					Ops::Mul(Ops::template Shuffle<1, 3, 1, 3>(r0, r2), Ops::template Shuffle<0, 2, 0, 2>(r1, r3))
+				);
+				F4 detA = Ops::template Swizzle<0, 0, 0, 0>(detSub);
+				F4 detB = Ops::template Swizzle<1, 1, 1, 1>(detSub);
+				F4 detC = Ops::template Swizzle<2, 2, 2, 2>(detSub);
+				F4 detD = Ops::template Swizzle<3, 3, 3, 3>(detSub);
+
+				F4 D_C = Mat2AdjMul(D, C);
+				F4 A_B = Mat2AdjMul(A, B);
+
+				// Adjugates of result blocks
+				F4 X_ = Ops::Sub(Ops::Mul(detD, A), Mat2Mul(B, D_C));
+				F4 W_ = Ops::Sub(Ops::Mul(detA, D), Mat2Mul(C, A_B));
+				F4 Y_ = Ops::Sub(Ops::Mul(detB, C), Mat2MulAdj(D, A_B));
+				F4 Z_ = Ops::Sub(Ops::Mul(detC, B), Mat2MulAdj(A, D_C));
+
+				// |M| = |A||D| + |B||C| - trace((A#B)(D#C))
+				F4 detM = Ops::Add(Ops::Mul(detA, detD), Ops::Mul(detB, detC));
+				F4 trace = Ops::Mul(A_B, Ops::template Swizzle<0, 2, 1, 3>(D_C));
+				trace = Ops::Add(trace, Ops::template Swizzle<2, 3, 0, 1>(trace));
+				trace = Ops::Add(trace, Ops::template Swizzle<1, 0, 3, 2>(trace));
+				detM = Ops::Sub(detM, trace);
+
+				F4 invDet = Ops::Div(Ops::Set(1.0f, -1.0f, -1.0f, 1.0f), detM);
+				X_ = Ops::Mul(X_, invDet);
+				Y_ = Ops::Mul(Y_, invDet);
+				Z_ = Ops::Mul(Z_, invDet);
+				W_ = Ops::Mul(W_, invDet);
+
+				// Adjugate and store
+				Ops::Store(out + 0x0, Ops::template Shuffle<3, 1, 3, 1>(X_, Y_));
+				Ops::Store(out + 0x4, Ops::template Shuffle<2, 0, 2, 0>(X_, Y_));
+				Ops::Store(out + 0x8, Ops::template Shuffle<3, 1, 3, 1>(Z_, W_));
+				Ops::Store(out + 0xC, Ops::template Shuffle<2, 0, 2, 0>(Z_, W_));
+
+				return Ops::First(detM);
+			}
+
+			// Inverse rotation/scale from cross products, translation = -inverse * translation
+			static inline float InverseAffine(const float* m, float* out)
+			{
+				F4 r0 = Ops::Set(m[0x0], m[0x1], m[0x2], 0.0f);
+				F4 r1 = Ops::Set(m[0x4], m[0x5], m[0x6], 0.0f);
+				F4 r2 = Ops::Set(m[0x8], m[0x9], m[0xA], 0.0f);
+				float tx = m[0x3];
+				float ty = m[0x7];
+				float tz = m[0xB];
+
+				// Columns of the adjugate
+				F4 c0 = Cross(r1, r2);
+				F4 c1 = Cross(r2, r0);
+				F4 c2 = Cross(r0, r1);
+
+				F4 dot = Ops::Mul(r0, c0);
+				F4 det = Ops::Add(Ops::Add(dot, Ops::template Swizzle<1, 1, 1, 1>(dot)), Ops::template Swizzle<2, 2, 2, 2>(dot));
+				F4 invDet = Ops::Div(Ops::Splat(1.0f), Ops::template Swizzle<0, 0, 0, 0>(det));
+
+				c0 = Ops::Mul(c0, invDet);
+				c1 = Ops::Mul(c1, invDet);
+				c2 = Ops::Mul(c2, invDet);
+				F4 t = Ops::Neg(Ops::Add(Ops::Add(
+					Ops::Mul(c0, Ops::Splat(tx)),
+					Ops::Mul(c1, Ops::Splat(ty))),
+					Ops::Mul(c2, Ops::Splat(tz))
+				));
+
+				// Transpose columns into rows
+				F4 t0 = Ops::template Shuffle<0, 1, 0, 1>(c0, c1);
+				F4 t1 = Ops::template Shuffle<2, 3, 2, 3>(c0, c1);
+				F4 t2 = Ops::template Shuffle<0, 1, 0, 1>(c2, t);
+				F4 t3 = Ops::template Shuffle<2, 3, 2, 3>(c2, t);
+
+				Ops::Store(out + 0x0, Ops::template Shuffle<0, 2, 0, 2>(t0, t2));
+				Ops::Store(out + 0x4, Ops::template Shuffle<1, 3, 1, 3>(t0, t2));
+				Ops::Store(out + 0x8, Ops::template Shuffle<0, 2, 0, 2>(t1, t3));
+				Ops::Store(out + 0xC, Ops::Set(0.0f, 0.0f, 0.0f, 1.0f));
+
+				return Ops::First(det);
+			}
+
+			static inline void TransformPoints(const float* m, const float* points, float* out, uint32_t count)
+			{
+				F4 c0, c1, c2, c3;
+				LoadColumns(m, c0, c1, c2, c3);
+
+				for (uint32_t i = 0; i < count; i++)
+				{
+					const float* p = points + i * 3;
+					F4 result = Ops::Add(Ops::Add(Ops::Add(
+						Ops::Mul(c0, Ops::Splat(p[0])),
+						Ops::Mul(c1, Ops::Splat(p[1]))),
+						Ops::Mul(c2, Ops::Splat(p[2]))),
+						c3
+					);
+					Store3(out + i * 3, result);
+				}
+			}
+
+			// Transformed center +/- extents projected on absolute axes
+			static inline void TransformAABB(const float* m, const float* min, const float* max, float* outMin, float* outMax)
+			{
+				F4 c0, c1, c2, c3;
+				LoadColumns(m, c0, c1, c2, c3);
+
+				float center[3];
+				float extent[3];
+				for (int i = 0; i < 3; i++)
+				{
+					center[i] = (min[i] + max[i]) * 0.5f;
+					extent[i] = (max[i] - min[i]) * 0.5f;
+				}
+
+				F4 newCenter = Ops::Add(Ops::Add(Ops::Add(
+					Ops::Mul(c0, Ops::Splat(center[0])),
+					Ops::Mul(c1, Ops::Splat(center[1]))),
+					Ops::Mul(c2, Ops::Splat(center[2]))),
+					c3
+				);
+				F4 newExtent = Ops::Add(Ops::Add(
+					Ops::Mul(Ops::Abs(c0), Ops::Splat(extent[0])),
+					Ops::Mul(Ops::Abs(c1), Ops::Splat(extent[1]))),
+					Ops::Mul(Ops::Abs(c2), Ops::Splat(extent[2]))
+				);
+
+				Store3(outMin, Ops::Sub(newCenter, newExtent));
+				Store3(outMax, Ops::Add(newCenter, newExtent));
+			}
+		};
+
+#if defined(VXL_SIMD_AVX)
+		// Two rows per register, same operation order as the 4 wide kernel
+		static inline void MultiplyAVX(const float* a, const float* b, float* out)
+		{
+			__m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 0x0));
+			__m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 0x4));
+			__m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 0x8));
+			__m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 0xC));
+
+			__m256 a01 = _mm256_loadu_ps(a + 0x0);
+			__m256 a23 = _mm256_loadu_ps(a + 0x8);
+
+			__m256 r01 = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x00), b0),
+				_mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x55), b1)),
+				_mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0xAA), b2)),
+				_mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0xFF), b3)
+			);
+			__m256 r23 = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x00), b0),
+				_mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x55), b1)),
+				_mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0xAA), b2)),
+				_mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0xFF), b3)
+			);
+
+			_mm256_storeu_ps(out + 0x0, r01);
+			_mm256_storeu_ps(out + 0x8, r23);
+		}
+#endif
+
+		// ~ Native ~ //
+		const char* GetInstructionSet(void)
+		{
+#if defined(VXL_SIMD_AVX)
+			return "AVX";
+#elif defined(VXL_SIMD_SSE)
+			return "SSE";
+#elif defined(VXL_SIMD_NEON)
+			return "NEON";
+#else
+			return "Scalar";
+#endif
+		}
+
+		void Multiply(const float* a, const float* b, float* out)
+		{
+#if defined(VXL_SIMD_AVX)
+			MultiplyAVX(a, b, out);
+#else
+			Kernels<NativeOps>::Multiply(a, b, out);
+#endif
+		}
+		void MultiplyBatch(const float* left, const float* right, float* out, uint32_t count)
+		{
+			for (uint32_t i = 0; i < count; i++)
+			{
+#if defined(VXL_SIMD_AVX)
+				MultiplyAVX(left, right + i * 16, out + i * 16);
+#else
+				Kernels<NativeOps>::Multiply(left, right + i * 16, out + i * 16);
+#endif
+			}
+		}
+		float Inverse(const float* m, float* out)
+		{
+			return Kernels<NativeOps>::Inverse(m, out);
+		}
+		float InverseAffine(const float* m, float* out)
+		{
+			return Kernels<NativeOps>::InverseAffine(m, out);
+		}
+		void TransformPoints(const float* m, const float* points, float* out, uint32_t count)
+		{
+			Kernels<NativeOps>::TransformPoints(m, points, out, count);
+		}
+		void TransformAABB(const float* m, const float* min, const float* max, float* outMin, float* outMax)
+		{
+			Kernels<NativeOps>::TransformAABB(m, min, max, outMin, outMax);
+		}
+
+		// ~ Scalar Reference ~ //
+		namespace Scalar
+		{
+			void Multiply(const float* a, const float* b, float* out)
+			{
+				Kernels<ScalarOps>::Multiply(a, b, out);
+			}
+			void MultiplyBatch(const float* left, const float* right, float* out, uint32_t count)
+			{
+				for (uint32_t i = 0; i < count; i++)
+					Kernels<ScalarOps>::Multiply(left, right + i * 16, out + i * 16);
+			}
+			float Inverse(const float* m, float* out)
+			{
+				return Kernels<ScalarOps>::Inverse(m, out);
+			}
+			float InverseAffine(const float* m, float* out)
+			{
+				return Kernels<ScalarOps>::InverseAffine(m, out);
+			}
+			void TransformPoints(const float* m, const float* points, float* out, uint32_t count)
+			{
+				Kernels<ScalarOps>::TransformPoints(m, points, out, count);
+			}
+			void TransformAABB(const float* m, const float* min, const float* max, float* outMin, float* outMax)
+			{
+				Kernels<ScalarOps>::TransformAABB(m, min, max, outMin, outMax);
+			}
+		}
+	}
+}
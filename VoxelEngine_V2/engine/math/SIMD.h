@@ -0,0 +1,55 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include <stdint.h>
+
+// ~ Instruction set, chosen at compile time ~ //
+// Define VXL_SIMD_FORCE_SCALAR to test the fallback on any platform
+#if defined(VXL_SIMD_FORCE_SCALAR)
+#define VXL_SIMD_SCALAR
+#elif defined(__AVX__)
+#define VXL_SIMD_AVX
+#define VXL_SIMD_SSE
+#elif defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VXL_SIMD_SSE
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define VXL_SIMD_NEON
+#else
+#define VXL_SIMD_SCALAR
+#endif
+
+namespace Vxl
+{
+	// Matrix kernels on raw floats [row major 4x4 = 16 floats, points = 3 floats]
+	// Every instruction set runs the same operations in the same order as the scalar
+	// reference, results match it exactly unless the compiler fuses multiply-adds
+	namespace SIMD
+	{
+		// Name of the compiled instruction set
+		const char* GetInstructionSet(void);
+
+		// out = a * b [out may alias a or b]
+		void	Multiply(const float* a, const float* b, float* out);
+		// out[i] = left * right[i]
+		void	MultiplyBatch(const float* left, const float* right, float* out, uint32_t count);
+		// Returns determinant, out is only meaningful if it isn't ~0
+		float	Inverse(const float* m, float* out);
+		// Bottom row must be [0 0 0 1]. Returns determinant of the 3x3 part
+		float	InverseAffine(const float* m, float* out);
+		// out[i] = m * (points[i], 1) [no perspective divide]
+		void	TransformPoints(const float* m, const float* points, float* out, uint32_t count);
+		// Bounds of the transformed box [bottom row must be 0 0 0 1]
+		void	TransformAABB(const float* m, const float* min, const float* max, float* outMin, float* outMax);
+
+		// Reference versions, always compiled
+		namespace Scalar
+		{
+			void	Multiply(const float* a, const float* b, float* out);
+			void	MultiplyBatch(const float* left, const float* right, float* out, uint32_t count);
+			float	Inverse(const float* m, float* out);
+			float	InverseAffine(const float* m, float* out);
+			void	TransformPoints(const float* m, const float* points, float* out, uint32_t count);
+			void	TransformAABB(const float* m, const float* min, const float* max, float* outMin, float* outMax);
+		}
+	}
+}
@@ -2,6 +2,7 @@
 #include "Precompiled.h"
 
 #include "Transform.h"
+#include "TransformManager.h"
 #include "../math/Matrix3x3.h"
 #include "../Math/Matrix4x4.h"
 #include "../math/MathCore.h"
@@ -11,83 +12,19 @@
 
 namespace Vxl
 {
-	void Transform::updateValues()
-	{
-		// If dirty is true, update values
-		if (isDirty)
-		{
-			// Make sure Euler Rotations stay in range of [-360, +360]
-			m_euler_rotation.x = (m_euler_rotation.x > 360.0f) ? std::fmod(m_euler_rotation.x, 360.0f) : m_euler_rotation.x;
-			m_euler_rotation.y = (m_euler_rotation.y > 360.0f) ? std::fmod(m_euler_rotation.y, 360.0f) : m_euler_rotation.y;
-			m_euler_rotation.z = (m_euler_rotation.z > 360.0f) ? std::fmod(m_euler_rotation.z, 360.0f) : m_euler_rotation.z;
-
-			m_euler_rotation.x = (m_euler_rotation.x < -360.0f) ? -std::fmod(-m_euler_rotation.x, 360.0f) : m_euler_rotation.x;
-			m_euler_rotation.y = (m_euler_rotation.y < -360.0f) ? -std::fmod(-m_euler_rotation.y, 360.0f) : m_euler_rotation.y;
-			m_euler_rotation.z = (m_euler_rotation.z < -360.0f) ? -std::fmod(-m_euler_rotation.z, 360.0f) : m_euler_rotation.z;
-
-			// Acquire Rotation
-			if(m_rotationOrder == EulerRotationOrder::ZYX)
-				m_worldRotation = Quaternion::ToQuaternion_ZYX(ToRadians(m_euler_rotation.x), ToRadians(m_euler_rotation.y), ToRadians(m_euler_rotation.z));
-			else
-				m_worldRotation = Quaternion::ToQuaternion_YXZ(ToRadians(m_euler_rotation.x), ToRadians(m_euler_rotation.y), ToRadians(m_euler_rotation.z));
-
-			// Base Model Matrix
-			m_modelMatrix = Matrix4x4(m_worldRotation.GetMatrix3x3() * Matrix3x3::GetScale(m_scale), m_position);
-
-			// Add Rotation / Model Matrix from parent
-			Transform* parent = m_parent;
-			if (parent != nullptr)
-			{
-				m_worldRotation = parent->getWorldRotation() * m_worldRotation;
-				m_modelMatrix = parent->getModel() * m_modelMatrix;
-			}
-
-			// Calculate Normal Matrix
-			m_normalMatrix = Matrix3x3(m_modelMatrix).Inverse();
-
-			// Calculate Axis Directions
-			Matrix3x3 m_rotation_matrix = m_worldRotation.GetMatrix3x3();
-			m_right		= m_rotation_matrix.GetColumn(0).NormalizeAccurate();
-			m_up		= m_rotation_matrix.GetColumn(1).NormalizeAccurate();
-			m_forward	= m_rotation_matrix.GetColumn(2).NormalizeAccurate();
-
-			// Update World position
-			m_worldPosition = Vector3(m_modelMatrix.GetColumn(3));
-
-			// Update World Scale
-			m_lossyScale.x = Vector3::Length(m_modelMatrix[0], m_modelMatrix[4], m_modelMatrix[8]);
-			m_lossyScale.y = Vector3::Length(m_modelMatrix[1], m_modelMatrix[5], m_modelMatrix[9]);
-			m_lossyScale.z = Vector3::Length(m_modelMatrix[2], m_modelMatrix[6], m_modelMatrix[10]);
-
-			// Clean
-			isDirty = false;
-
-			// Use callback
-			UseCallback();
-		}
-	}
-
 	void Transform::UseCallback()
 	{
 		if(m_sceneNode)
-			callback_updater(*m_sceneNode);
+			m_sceneNode->TransformChanged();
 	}
 
 	Transform::Transform()
 	{
-		m_position = Vector3(0, 0, 0);
-		m_euler_rotation = Vector3(0, 0, 0);
-		m_scale = Vector3(1, 1, 1);
-
-		callback_updater = &SceneNode::TransformChanged;
+		m_handle = TransformManager.create(this, Vector3(0, 0, 0), Vector3(0, 0, 0), Vector3(1, 1, 1));
 	}
 	Transform::Transform(const Vector3& position, const Vector3& euler_rotation, const Vector3& scale)
 	{
-		m_position = position;
-		m_euler_rotation = euler_rotation;
-		m_scale = scale;
-
-		callback_updater = &SceneNode::TransformChanged;
+		m_handle = TransformManager.create(this, position, euler_rotation, scale);
 	}
 	Transform::~Transform()
 	{
@@ -114,6 +51,8 @@ namespace Vxl
 			m_parent->SimpleRemoveChild(this);
 			m_parent->UseCallback();
 		}
+
+		TransformManager.destroy(m_handle);
 	}
 
 	Transform& Transform::setWorldPosition(const Vector3& position)
@@ -125,8 +64,8 @@ namespace Vxl
 			return *this;
 		}
 
-		// Apply inverse of parentmatrix on model matrix to figure out correct local position
-		m_position = m_parent->getModel().Inverse() * position;
+		// Apply inverse of parent model to figure out correct local position
+		localPosition() = m_parent->getInverseModel().TransformPoint(position);
 
 		SetDirty();
 		return *this;
@@ -155,16 +94,16 @@ namespace Vxl
 
 		if (Nforward.CompareFuzzy(Vector3::UP))
 		{
-			m_euler_rotation.x = 90;
-			m_euler_rotation.y = 0;
-			m_euler_rotation.z = 0; // This should never change
+			localEuler().x = 90;
+			localEuler().y = 0;
+			localEuler().z = 0; // This should never change
 			return *this;
 		}
 		else if (Nforward.CompareFuzzy(Vector3::DOWN))
 		{
-			m_euler_rotation.x = -90;
-			m_euler_rotation.y = 0;
-			m_euler_rotation.z = 0; // This should never change
+			localEuler().x = -90;
+			localEuler().y = 0;
+			localEuler().z = 0; // This should never change
 			return *this;
 		}
 
@@ -173,7 +112,7 @@ namespace Vxl
 			yaw = -yaw;
 		float pitch = Vector3::GetAngleDegrees(Vector3::UP, Nforward);
 
-		m_euler_rotation = Vector3(-pitch + 90.0f, yaw, 0);
+		localEuler() = Vector3(-pitch + 90.0f, yaw, 0);
 
 		SetDirty();
 		return *this;
@@ -182,10 +121,10 @@ namespace Vxl
 	Transform& Transform::setRotation(const Quaternion& quat)
 	{
 		float pitch, yaw, roll;
-		VXL_ASSERT(m_rotationOrder == EulerRotationOrder::ZYX, "ToEuler is using incorrect Rotation Order");
+		VXL_ASSERT(TransformManager.m_rotationOrder[index()] == EulerRotationOrder::ZYX, "ToEuler is using incorrect Rotation Order");
 		Quaternion::ToEuler_ZYX(quat, roll, pitch, yaw);
 
-		m_euler_rotation = Vector3(ToDegrees(pitch), ToDegrees(yaw), ToDegrees(roll));
+		localEuler() = Vector3(ToDegrees(pitch), ToDegrees(yaw), ToDegrees(roll));
 
 		SetDirty();
 		return *this;
@@ -193,19 +132,16 @@ namespace Vxl
 
 	Transform& Transform::rotateAroundAxis(const Vector3& axis, float degrees)
 	{
-		// Make sure Rotation is up to date
-		updateValues();
-
 		// Rotation Quaternion too apply
 		Quaternion Rotation(ToRadians(degrees), axis.Normalize());
 
 		// Apply NewRotation on current rotation
-		m_worldRotation = Rotation * m_worldRotation;
+		Quaternion worldRotation = Rotation * getWorldRotation();
 		if (m_parent != nullptr)
 			// Apply inverse of parent to cancel out additional rotation
-			m_worldRotation = m_parent->getWorldRotation().Inverse() * m_worldRotation;
+			worldRotation = m_parent->getWorldRotation().Inverse() * worldRotation;
 
-		setRotation(m_worldRotation);
+		setRotation(worldRotation);
 		return *this;
 	}
 }
\ No newline at end of file
@@ -3,24 +3,18 @@
 
 #include <assert.h>
 #include <vector>
-#include <functional>
 
 #include "Matrix2x2.h"
 #include "Matrix3x3.h"
 #include "Matrix4x4.h"
 #include "Vector.h"
 #include "Quaternion.h"
+#include "TransformManager.h"
 
 #include "../utilities/Macros.h"
 
 namespace Vxl
 {
-	enum class EulerRotationOrder
-	{
-		YXZ,
-		ZYX
-	};
-
 	class SceneNode;
 
 	class Transform
@@ -30,30 +24,28 @@ namespace Vxl
 		friend class Hierarchy;
 		friend class _Assets;
 		friend class Entity;
+		friend class TransformManager;
+		DISALLOW_COPY_AND_ASSIGN(Transform);
 	protected:
-		// Model for transformations
-		Matrix4x4	m_modelMatrix;  // World Transformations - Row Major
-		
-		// Model for normals
-		Matrix3x3	m_normalMatrix; // Normal Transformations - Row Major
-
-		// Local Space
-		Vector3		m_position;			// Local Position
-		Vector3		m_euler_rotation;	// Local Euler
-		Vector3		m_scale;			// Local Scale
-		
-		// World Space
-		Vector3		m_worldPosition;	// World Position
-		Quaternion	m_worldRotation;	// World Rotation Quaternion
-		Vector3		m_lossyScale;		// World Scale (Not supper accurate)
-		
-		// Rotation Order
-		EulerRotationOrder m_rotationOrder = EulerRotationOrder::ZYX;
+		// Handle into TransformManager [all local/world values live there]
+		uint32_t	m_handle;
 
-		// Direction Space [ World Direction ]
-		Vector3		m_forward	= Vector3::FORWARD;
-		Vector3     m_up		= Vector3::UP;
-		Vector3     m_right		= Vector3::RIGHT;
+		inline uint32_t		index(void) const
+		{
+			return TransformManager.dense(m_handle);
+		}
+		inline Vector3&		localPosition(void) const
+		{
+			return TransformManager.m_position[index()];
+		}
+		inline Vector3&		localEuler(void) const
+		{
+			return TransformManager.m_euler[index()];
+		}
+		inline Vector3&		localScale(void) const
+		{
+			return TransformManager.m_scale[index()];
+		}
 
 		// Parent/Child relationships
 		Transform*				m_parent = nullptr;
@@ -61,9 +53,14 @@ namespace Vxl
 		u_int					m_totalChildren = 0;
 
 		// Parent / Child Functionality
+		void assignParent(Transform* parent)
+		{
+			m_parent = parent;
+			TransformManager.setParent(m_handle, parent ? parent->m_handle : TransformManager::NullHandle);
+		}
 		void simpleRemoveParent()
 		{
-			m_parent = nullptr;
+			assignParent(nullptr);
 		}
 		void SimpleRemoveChild(int index)
 		{
@@ -95,17 +92,17 @@ namespace Vxl
 			}
 			m_children.clear();
 			m_totalChildren = 0;
-			m_parent = nullptr;
+			assignParent(nullptr);
 		}
 
-		// Update Flag
-		bool isDirty = true;
-		void updateValues();
+		// Update world values of this transform and its parents if needed
+		inline void updateValues()
+		{
+			TransformManager.updateChain(index());
+		}
 
 		// Scene Node (used if transform is inside scene graph)
 		SceneNode* m_sceneNode = nullptr;
-		// Update pointer
-		std::function<void(SceneNode&)> callback_updater;
 		// Send update
 		void UseCallback();
 
@@ -114,12 +111,17 @@ namespace Vxl
 		Transform(const Vector3& position, const Vector3& euler_rotation = Vector3(0,0,0), const Vector3& scale = Vector3(1,1,1));
 		~Transform();
 
-		// Dirty Setter
+		// Dirty Setter [children notice through the manager, no need to visit them]
 		void SetDirty()
 		{
-			isDirty = true;
-			for (Transform* child : m_children)
-				child->SetDirty();
+			TransformManager.m_dirty[index()] = 1;
+		}
+
+		// Rotation Order
+		void setRotationOrder(EulerRotationOrder order)
+		{
+			TransformManager.m_rotationOrder[index()] = order;
+			SetDirty();
 		}
 
 		// Returns index of child in list of children (-1 = child does not exist)
@@ -197,7 +199,7 @@ namespace Vxl
 				m_parent->removeChild(this);
 
 			// Set Parent
-			m_parent = parent;
+			assignParent(parent);
 
 			// Make sure parent has child
 			if(m_parent)
@@ -238,7 +240,7 @@ namespace Vxl
 			child->removeParent();
 
 			// Child now treats this class as its parent
-			child->m_parent = this;
+			child->assignParent(this);
 
 			// Add child
 			SimpleAddChild(child);
@@ -256,7 +258,7 @@ namespace Vxl
 			m_parent->SimpleRemoveChild(this);
 
 			// Child removes parent
-			m_parent = nullptr;
+			assignParent(nullptr);
 
 			// Flag
 			SetDirty();
@@ -286,43 +288,43 @@ namespace Vxl
 
 		inline Transform& setPosition(float x, float y, float z)
 		{
-			m_position = Vector3(x, y, z);
+			localPosition() = Vector3(x, y, z);
 			SetDirty();
 			return *this;
 		}
 		inline Transform& setPosition(const Vector3& position)
 		{
-			m_position = position;
+			localPosition() = position;
 			SetDirty();
 			return *this;
 		}
 		inline Transform& setRotation(float euler_x, float euler_y, float euler_z)
 		{
-			m_euler_rotation = Vector3(euler_x, euler_y, euler_z);
+			localEuler() = Vector3(euler_x, euler_y, euler_z);
 			SetDirty();
 			return *this;
 		}
 		inline Transform& setRotation(const Vector3& euler_rotation)
 		{
-			m_euler_rotation = euler_rotation;
+			localEuler() = euler_rotation;
 			SetDirty();
 			return *this;
 		}
 		inline Transform& setScale(float scaleAll)
 		{
-			m_scale = Vector3(scaleAll);
+			localScale() = Vector3(scaleAll);
 			SetDirty();
 			return *this;
 		}
 		inline Transform& setScale(float x, float y, float z)
 		{
-			m_scale = Vector3(x, y, z);
+			localScale() = Vector3(x, y, z);
 			SetDirty();
 			return *this;
 		}
 		inline Transform& setScale(const Vector3 scale)
 		{
-			m_scale = scale;
+			localScale() = scale;
 			SetDirty();
 			return *this;
 		}
@@ -330,57 +332,57 @@ namespace Vxl
 		// Specific Setters
 		inline Transform& setPositionX(float x)
 		{
-			m_position.x = x;
+			localPosition().x = x;
 			SetDirty();
 			return *this;
 		}
 		inline Transform& setPositionY(float y)
 		{
-			m_position.y = y;
+			localPosition().y = y;
 			SetDirty();
 			return *this;
 		}
 		inline Transform& setPositionZ(float z)
 		{
-			m_position.z = z;
+			localPosition().z = z;
 			SetDirty();
 			return *this;
 		}
 
 		inline Transform& setRotationX(float x)
 		{
-			m_euler_rotation.x = x;
+			localEuler().x = x;
 			SetDirty();
 			return *this;
 		}
 		inline Transform& setRotationY(float y)
 		{
-			m_euler_rotation.y = y;
+			localEuler().y = y;
 			SetDirty();
 			return *this;
 		}
 		inline Transform& setRotationZ(float z)
 		{
-			m_euler_rotation.z = z;
+			localEuler().z = z;
 			SetDirty();
 			return *this;
 		}
 
 		inline Transform& setScaleX(float x)
 		{
-			m_scale.x = x;
+			localScale().x = x;
 			SetDirty();
 			return *this;
 		}
 		inline Transform& setScaleY(float y)
 		{
-			m_scale.y = y;
+			localScale().y = y;
 			SetDirty();
 			return *this;
 		}
 		inline Transform& setScaleZ(float z)
 		{
-			m_scale.z = z;
+			localScale().z = z;
 			SetDirty();
 			return *this;
 		}
@@ -418,45 +420,45 @@ namespace Vxl
 
 		inline Transform& increasePosition(float x, float y, float z)
 		{
-			m_position += Vector3(x, y, z);
+			localPosition() += Vector3(x, y, z);
 			SetDirty();
 			return *this;
 		}
 		inline Transform& increasePosition(const Vector3& translate)
 		{
-			m_position += translate;
+			localPosition() += translate;
 			SetDirty();
 			return *this;
 		}
 
 		inline Transform& increaseRotation(float x, float y, float z)
 		{
-			m_euler_rotation += Vector3(x, y, z);
+			localEuler() += Vector3(x, y, z);
 			SetDirty();
 			return *this;
 		}
 		inline Transform& increaseRotation(const Vector3& euler_increase)
 		{
-			m_euler_rotation += euler_increase;
+			localEuler() += euler_increase;
 			SetDirty();
 			return *this;
 		}
 
 		inline Transform& increaseScale(float x, float y, float z)
 		{
-			m_scale += Vector3(x, y, z);
+			localScale() += Vector3(x, y, z);
 			SetDirty();
 			return *this;
 		}
 		inline Transform& increaseScale(const Vector3& scaler)
 		{
-			m_scale += scaler;
+			localScale() += scaler;
 			SetDirty();
 			return *this;
 		}
 		inline Transform& increaseScale(float scaleAll)
 		{
-			m_scale += scaleAll;
+			localScale() += scaleAll;
 			SetDirty();
 			return *this;
 		}
@@ -464,57 +466,57 @@ namespace Vxl
 		// Specific Increasers
 		inline Transform& increasePositionX(float x)
 		{
-			m_position.x += x;
+			localPosition().x += x;
 			SetDirty();
 			return *this;
 		}
 		inline Transform& increasePositionY(float y)
 		{
-			m_position.y += y;
+			localPosition().y += y;
 			SetDirty();
 			return *this;
 		}
 		inline Transform& increasePositionZ(float z)
 		{
-			m_position.z += z;
+			localPosition().z += z;
 			SetDirty();
 			return *this;
 		}
 
 		inline Transform& increaseRotationX(float x)
 		{
-			m_euler_rotation.x += x;
+			localEuler().x += x;
 			SetDirty();
 			return *this;
 		}
 		inline Transform& increaseRotationY(float y)
 		{
-			m_euler_rotation.y += y;
+			localEuler().y += y;
 			SetDirty();
 			return *this;
 		}
 		inline Transform& increaseRotationZ(float z)
 		{
-			m_euler_rotation.z += z;
+			localEuler().z += z;
 			SetDirty();
 			return *this;
 		}
 
 		inline Transform& increaseScaleX(float x)
 		{
-			m_scale.x += x;
+			localScale().x += x;
 			SetDirty();
 			return *this;
 		}
 		inline Transform& increaseScaleY(float y)
 		{
-			m_scale.y += y;
+			localScale().y += y;
 			SetDirty();
 			return *this;
 		}
 		inline Transform& increaseScaleZ(float z)
 		{
-			m_scale.z += z;
+			localScale().z += z;
 			SetDirty();
 			return *this;
 		}
@@ -535,81 +537,97 @@ namespace Vxl
 		inline const Matrix4x4&		getModel(void)
 		{
 			updateValues();
-			return m_modelMatrix;
+			return TransformManager.m_model[index()];
 		}
 		inline const Matrix3x3&		getNormalMatrix(void)
 		{
 			updateValues();
-			return m_normalMatrix;
+			return TransformManager.m_normal[index()];
+		}
+		inline const Affine&		getInverseModel(void)
+		{
+			updateValues();
+			return TransformManager.inverseModel(index());
+		}
+		// Changes every time world values are recalculated
+		inline uint64_t				getStamp(void)
+		{
+			updateValues();
+			return TransformManager.m_stamp[index()];
+		}
+		inline bool					hasUniformScale(void)
+		{
+			updateValues();
+			return TransformManager.m_uniformScale[index()] != 0;
 		}
 		inline const Vector3&		getWorldPosition(void)
 		{
 			updateValues();
-			return m_worldPosition;
+			return TransformManager.m_worldPosition[index()];
 		}
 		inline const Vector3&		getPosition(void) const
 		{
-			return m_position;
+			return localPosition();
 		}
 		inline const Vector3&		getRotationEuler(void) const
 		{
-			return m_euler_rotation;
+			return localEuler();
 		}
 		inline const Vector3&		getWorldScale(void)
 		{
 			updateValues();
-			return m_lossyScale;
+			return TransformManager.m_lossyScale[index()];
 		}
 		inline const Vector3&		getScale(void) const
 		{
-			return m_scale;
+			return localScale();
 		}
 		inline const Quaternion&	getWorldRotation(void)
 		{
 			updateValues();
-			return m_worldRotation;
+			return TransformManager.m_worldRotation[index()];
 		}	
 		inline const Vector3& getForward(void)
 		{
 			updateValues();
-			return m_forward;
+			return TransformManager.m_forward[index()];
 		}
 		inline const Vector3& getUp(void)
 		{
 			updateValues();
-			return m_up;
+			return TransformManager.m_up[index()];
 		}
 		inline const Vector3& getRight(void)
 		{
 			updateValues();
-			return m_right;
+			return TransformManager.m_right[index()];
 		}
 		Vector3 getBackwards(void)
 		{
 			updateValues();
-			return -m_forward;
+			return -TransformManager.m_forward[index()];
 		}
 		Vector3 getDown(void)
 		{
 			updateValues();
-			return -m_up;
+			return -TransformManager.m_up[index()];
 		}
 		Vector3 getLeft(void)
 		{
 			updateValues();
-			return -m_right;
+			return -TransformManager.m_right[index()];
 		}
 
 		// Since Camera Forward is flipped, this helps with readability
 		Vector3 getCameraForward(void)
 		{
 			updateValues();
-			return -m_forward;
+			return -TransformManager.m_forward[index()];
 		}
 		const Vector3& getCameraBackwards(void)
 		{
 			updateValues();
-			return m_forward;
+			return TransformManager.m_forward[index()];
 		}
 
 	};
@@ -0,0 +1,299 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "TransformManager.h"
+
+#include "Transform.h"
+#include "MathCore.h"
+
+#include "../utilities/JobSystem.h"
+
+namespace Vxl
+{
+	template<typename Func>
+	void TransformManager::forEachArray(Func func)
+	{
+		func(m_handle);
+		func(m_owner);
+		func(m_parent);
+		func(m_dirty);
+		func(m_stamp);
+		func(m_changed);
+		func(m_uniformScale);
+		func(m_position);
+		func(m_euler);
+		func(m_scale);
+		func(m_rotationOrder);
+		func(m_model);
+		func(m_normal);
+		func(m_worldRotation);
+		func(m_worldPosition);
+		func(m_lossyScale);
+		func(m_forward);
+		func(m_up);
+		func(m_right);
+		func(m_inverse);
+		func(m_inverseStamp);
+	}
+
+	uint32_t TransformManager::create(Transform* owner, const Vector3& position, const Vector3& euler, const Vector3& scale)
+	{
+		uint32_t handle;
+		if (m_freeHandles.empty())
+		{
+			handle = (uint32_t)m_sparse.size();
+			m_sparse.push_back(NullHandle);
+		}
+		else
+		{
+			handle = m_freeHandles.back();
+			m_freeHandles.pop_back();
+		}
+
+		m_sparse[handle] = (uint32_t)m_handle.size();
+
+		m_handle.push_back(handle);
+		m_owner.push_back(owner);
+		m_parent.push_back(NullHandle);
+		m_dirty.push_back(1);
+		m_stamp.push_back(0);
+		m_changed.push_back(0);
+		m_uniformScale.push_back(1);
+		m_position.push_back(position);
+		m_euler.push_back(euler);
+		m_scale.push_back(scale);
+		m_rotationOrder.push_back(EulerRotationOrder::ZYX);
+		m_model.emplace_back();
+		m_normal.emplace_back();
+		m_worldRotation.emplace_back();
+		m_worldPosition.emplace_back();
+		m_lossyScale.push_back(scale);
+		m_forward.push_back(Vector3::FORWARD);
+		m_up.push_back(Vector3::UP);
+		m_right.push_back(Vector3::RIGHT);
+		m_inverse.emplace_back();
+		m_inverseStamp.push_back(UINT64_MAX);
+
+		// New roots are placed at the end
+		m_orderDirty = true;
+
+		return handle;
+	}
+	void TransformManager::destroy(uint32_t handle)
+	{
+		uint32_t index = dense(handle);
+		uint32_t last = (uint32_t)m_handle.size() - 1;
+
+		// Swap with last and pop
+		forEachArray([index, last](auto& data)
+		{
+			if (index != last)
+				data[index] = std::move(data[last]);
+			data.pop_back();
+		});
+
+		if (index != last)
+			m_sparse[m_handle[index]] = index;
+
+		m_sparse[handle] = NullHandle;
+		m_freeHandles.push_back(handle);
+
+		m_orderDirty = true;
+	}
+	void TransformManager::setParent(uint32_t handle, uint32_t parentHandle)
+	{
+		uint32_t index = dense(handle);
+		m_parent[index] = parentHandle;
+		m_dirty[index] = 1;
+
+		m_orderDirty = true;
+	}
+
+	void TransformManager::calculate(uint32_t index, uint64_t stamp)
+	{
+		Vector3& euler = m_euler[index];
+
+		// Make sure Euler Rotations stay in range of [-360, +360]
+		euler.x = (euler.x > 360.0f) ? std::fmod(euler.x, 360.0f) : euler.x;
+		euler.y = (euler.y > 360.0f) ? std::fmod(euler.y, 360.0f) : euler.y;
+		euler.z = (euler.z > 360.0f) ? std::fmod(euler.z, 360.0f) : euler.z;
+
+		euler.x = (euler.x < -360.0f) ? -std::fmod(-euler.x, 360.0f) : euler.x;
+		euler.y = (euler.y < -360.0f) ? -std::fmod(-euler.y, 360.0f) : euler.y;
+		euler.z = (euler.z < -360.0f) ? -std::fmod(-euler.z, 360.0f) : euler.z;
+
+		// Acquire Rotation
+		Quaternion& worldRotation = m_worldRotation[index];
+		if (m_rotationOrder[index] == EulerRotationOrder::ZYX)
+			worldRotation = Quaternion::ToQuaternion_ZYX(ToRadians(euler.x), ToRadians(euler.y), ToRadians(euler.z));
+		else
+			worldRotation = Quaternion::ToQuaternion_YXZ(ToRadians(euler.x), ToRadians(euler.y), ToRadians(euler.z));
+
+		// Base Model Matrix
+		Matrix4x4& model = m_model[index];
+		model = Matrix4x4(worldRotation.GetMatrix3x3() * Matrix3x3::GetScale(m_scale[index]), m_position[index]);
+
+		// Uniform scale stays uniform through rotations, a single non uniform parent breaks it
+		const Vector3& scale = m_scale[index];
+		uint8_t uniformScale = scale.x == scale.y && scale.x == scale.z;
+
+		// Add Rotation / Model Matrix from parent
+		uint32_t parent = m_parent[index];
+		if (parent != NullHandle)
+		{
+			uint32_t parentIndex = m_sparse[parent];
+			worldRotation = m_worldRotation[parentIndex] * worldRotation;
+			model = m_model[parentIndex] * model;
+			uniformScale &= m_uniformScale[parentIndex];
+		}
+
+		// Calculate Normal Matrix [transpose of inverse]
+		// Uniform: (sR)^-T = R / s = (sR) / s^2
+		float scaleSqr = model[0] * model[0] + model[4] * model[4] + model[8] * model[8];
+		if (uniformScale && scaleSqr > MATRIX_INVERSE_EPSILON)
+			m_normal[index] = Matrix3x3(model) * (1.0f / scaleSqr);
+		else
+			m_normal[index] = Matrix3x3(model).Inverse();
+
+		m_uniformScale[index] = uniformScale;
+
+		// Calculate Axis Directions
+		Matrix3x3 rotationMatrix = worldRotation.GetMatrix3x3();
+		m_right[index]		= rotationMatrix.GetColumn(0).NormalizeAccurate();
+		m_up[index]			= rotationMatrix.GetColumn(1).NormalizeAccurate();
+		m_forward[index]	= rotationMatrix.GetColumn(2).NormalizeAccurate();
+
+		// Update World position
+		m_worldPosition[index] = Vector3(model.GetColumn(3));
+
+		// Update World Scale
+		m_lossyScale[index].x = Vector3::Length(model[0], model[4], model[8]);
+		m_lossyScale[index].y = Vector3::Length(model[1], model[5], model[9]);
+		m_lossyScale[index].z = Vector3::Length(model[2], model[6], model[10]);
+
+		// Clean
+		m_dirty[index] = 0;
+		m_stamp[index] = stamp;
+	}
+	void TransformManager::calculateRange(uint32_t begin, uint32_t end, uint64_t stamp)
+	{
+		for (uint32_t i = begin; i < end; i++)
+		{
+			if (isStale(i))
+			{
+				calculate(i, stamp);
+				m_changed[i] = 1;
+			}
+		}
+	}
+
+	void TransformManager::updateChain(uint32_t index)
+	{
+		// Parents first
+		uint32_t parent = m_parent[index];
+		if (parent != NullHandle)
+			updateChain(m_sparse[parent]);
+
+		if (isStale(index))
+		{
+			calculate(index, ++m_stampCounter);
+			m_owner[index]->UseCallback();
+		}
+	}
+
+	const Affine& TransformManager::inverseModel(uint32_t index)
+	{
+		if (m_inverseStamp[index] != m_stamp[index])
+		{
+			Affine model(m_model[index]);
+			m_inverse[index] = m_uniformScale[index] ? model.InverseUniformScale(m_lossyScale[index].x) : model.Inverse();
+			m_inverseStamp[index] = m_stamp[index];
+		}
+		return m_inverse[index];
+	}
+
+	void TransformManager::sortByDepth()
+	{
+		uint32_t count = (uint32_t)m_handle.size();
+
+		// Acquire depth of every transform
+		std::vector<uint32_t> depths(count);
+		uint32_t maxDepth = 0;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint32_t depth = 0;
+			for (uint32_t parent = m_parent[i]; parent != NullHandle; parent = m_parent[m_sparse[parent]])
+				depth++;
+
+			depths[i] = depth;
+			maxDepth = MacroMax(maxDepth, depth);
+		}
+
+		// Counting sort [stable, keeps siblings next to each other]
+		m_levels.assign(maxDepth + 2, 0);
+		for (uint32_t i = 0; i < count; i++)
+			m_levels[depths[i] + 1]++;
+		for (uint32_t d = 1; d < m_levels.size(); d++)
+			m_levels[d] += m_levels[d - 1];
+
+		std::vector<uint32_t> order(count);
+		std::vector<uint32_t> offsets(m_levels.begin(), m_levels.end() - 1);
+		for (uint32_t i = 0; i < count; i++)
+			order[offsets[depths[i]]++] = i;
+
+		// Move data into sorted order
+		forEachArray([&order](auto& data)
+		{
+			std::remove_reference_t<decltype(data)> sorted;
+			sorted.reserve(data.size());
+			for (uint32_t i : order)
+				sorted.push_back(std::move(data[i]));
+			data.swap(sorted);
+		});
+
+		for (uint32_t i = 0; i < count; i++)
+			m_sparse[m_handle[i]] = i;
+
+		m_orderDirty = false;
+	}
+
+	void TransformManager::Update()
+	{
+		if (m_orderDirty)
+			sortByDepth();
+
+		uint64_t stamp = ++m_stampCounter;
+
+		// Each depth only reads from the previous one, so a level can be split freely
+		for (uint32_t d = 0; d + 1 < m_levels.size(); d++)
+		{
+			uint32_t begin = m_levels[d];
+			uint32_t end = m_levels[d + 1];
+			uint32_t count = end - begin;
+
+			if (count < m_parallelThreshold)
+			{
+				calculateRange(begin, end, stamp);
+				continue;
+			}
+
+			// A few batches per thread, workers that finish early steal the rest
+			uint32_t threadCount = JobSystem.getWorkerCount() + 1;
+			uint32_t batch = MacroMax(m_parallelBatch, count / (threadCount * 4));
+			JobSystem.ParallelFor(count, batch, [this, begin, stamp](uint32_t first, uint32_t last)
+			{
+				calculateRange(begin + first, begin + last, stamp);
+			});
+		}
+
+		// Callbacks aren't thread safe, send them after the pass
+		uint32_t count = (uint32_t)m_handle.size();
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (m_changed[i])
+			{
+				m_changed[i] = 0;
+				m_owner[i]->UseCallback();
+			}
+		}
+	}
+}
@@ -0,0 +1,122 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include <vector>
+
+#include "Affine.h"
+#include "Matrix3x3.h"
+#include "Matrix4x4.h"
+#include "Vector.h"
+#include "Quaternion.h"
+
+#include "../utilities/singleton.h"
+#include "../utilities/Macros.h"
+
+namespace Vxl
+{
+	class Transform;
+
+	enum class EulerRotationOrder
+	{
+		YXZ,
+		ZYX
+	};
+
+	// Structure of Arrays storage for every Transform [Transforms only hold a handle]
+	// Data is kept sorted by hierarchy depth, so parents always come before their children
+	// and a single linear pass updates every dirty subtree
+	static class TransformManager : public Singleton<class TransformManager>
+	{
+		DISALLOW_COPY_AND_ASSIGN(TransformManager);
+		friend class Transform;
+	public:
+		static const uint32_t NullHandle = (uint32_t)-1;
+
+	private:
+		// Handle -> Dense index
+		std::vector<uint32_t>	m_sparse;
+		std::vector<uint32_t>	m_freeHandles;
+
+		// ~ Dense Data ~ //
+		std::vector<uint32_t>	m_handle;
+		std::vector<Transform*>	m_owner;
+		std::vector<uint32_t>	m_parent;	// Parent handle
+		std::vector<uint8_t>	m_dirty;	// Local values changed
+		std::vector<uint64_t>	m_stamp;	// When world values were calculated [child is stale if parent stamp is newer]
+		std::vector<uint8_t>	m_changed;	// Calculated during last Update
+		std::vector<uint8_t>	m_uniformScale; // Scale is uniform here and in every parent [model = rotation * scale]
+
+		// Local Space
+		std::vector<Vector3>	m_position;
+		std::vector<Vector3>	m_euler;
+		std::vector<Vector3>	m_scale;
+		std::vector<EulerRotationOrder> m_rotationOrder;
+
+		// World Space
+		std::vector<Matrix4x4>	m_model;
+		std::vector<Matrix3x3>	m_normal;
+		std::vector<Quaternion>	m_worldRotation;
+		std::vector<Vector3>	m_worldPosition;
+		std::vector<Vector3>	m_lossyScale;
+		std::vector<Vector3>	m_forward;
+		std::vector<Vector3>	m_up;
+		std::vector<Vector3>	m_right;
+
+		// Inverse model, only calculated when requested [valid if its stamp matches]
+		std::vector<Affine>		m_inverse;
+		std::vector<uint64_t>	m_inverseStamp;
+
+		// Dense ranges for each depth [only valid if order isn't dirty]
+		std::vector<uint32_t>	m_levels;
+		bool					m_orderDirty = false;
+		uint64_t				m_stampCounter = 0;
+
+		inline uint32_t	dense(uint32_t handle) const
+		{
+			VXL_ASSERT(handle < m_sparse.size() && m_sparse[handle] != NullHandle, "TransformManager invalid handle");
+			return m_sparse[handle];
+		}
+		inline bool		isStale(uint32_t index) const
+		{
+			uint32_t parent = m_parent[index];
+			return m_dirty[index] || (parent != NullHandle && m_stamp[m_sparse[parent]] > m_stamp[index]);
+		}
+
+		uint32_t	create(Transform* owner, const Vector3& position, const Vector3& euler, const Vector3& scale);
+		void		destroy(uint32_t handle);
+		void		setParent(uint32_t handle, uint32_t parentHandle);
+
+		// Calculate world values for dense index [parent must be up to date]
+		void		calculate(uint32_t index, uint64_t stamp);
+		void		calculateRange(uint32_t begin, uint32_t end, uint64_t stamp);
+		// Lazy update from the first stale ancestor down to this dense index
+		void		updateChain(uint32_t index);
+		// Inverse model of dense index [must be up to date]
+		const Affine& inverseModel(uint32_t index);
+		void		sortByDepth();
+
+		// Apply function to every dense array
+		template<typename Func>
+		void		forEachArray(Func func);
+
+	public:
+		TransformManager() {}
+
+		// Depth levels with more transforms than this are split into JobSystem batches
+		uint32_t m_parallelThreshold = 4096;
+		uint32_t m_parallelBatch = 512;
+
+		// Updates all dirty transforms in depth order and sends their callbacks
+		void Update();
+
+		inline uint32_t getTransformCount(void) const
+		{
+			return (uint32_t)m_handle.size();
+		}
+		inline uint32_t getDepthCount(void) const
+		{
+			return m_levels.empty() ? 0 : (uint32_t)m_levels.size() - 1;
+		}
+
+	} SingletonInstance(TransformManager);
+}
@@ -0,0 +1,225 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "VertexPacking.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace Vxl
+{
+	namespace VertexPacking
+	{
+		uint16_t FloatToHalf(float value)
+		{
+			uint32_t bits;
+			memcpy(&bits, &value, sizeof(bits));
+
+			uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+			uint32_t exponent = (bits >> 23) & 0xFF;
+			uint32_t mantissa = bits & 0x7FFFFF;
+
+			// Infinity or NaN [NaN keeps a mantissa bit]
+			if (exponent == 0xFF)
+				return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+
+			int32_t halfExponent = (int32_t)exponent - 127 + 15;
+
+			// Overflow
+			if (halfExponent >= 31)
+				return sign | 0x7C00;
+
+			// Subnormal or zero
+			if (halfExponent <= 0)
+			{
+				if (halfExponent < -10)
+					return sign;
+
+				// Restore implicit bit, then shift into the subnormal range
+				mantissa |= 0x800000;
+				uint32_t shift = (uint32_t)(14 - halfExponent);
+				uint32_t half = mantissa >> shift;
+				uint32_t remainder = mantissa & ((1u << shift) - 1);
+				uint32_t halfway = 1u << (shift - 1);
+				if (remainder > halfway || (remainder == halfway && (half & 1)))
+					half++;
+				return sign | (uint16_t)half;
+			}
+
+			uint32_t half = ((uint32_t)halfExponent << 10) | (mantissa >> 13);
+			uint32_t remainder = mantissa & 0x1FFF;
+			// Carry can roll into the exponent, which also handles rounding up to infinity
+			if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+				half++;
+			return sign | (uint16_t)half;
+		}
+		float HalfToFloat(uint16_t value)
+		{
+			uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+			uint32_t exponent = (value >> 10) & 0x1F;
+			uint32_t mantissa = value & 0x3FF;
+
+			uint32_t bits;
+			if (exponent == 0x1F)
+			{
+				bits = sign | 0x7F800000 | (mantissa << 13);
+			}
+			else if (exponent == 0)
+			{
+				// Subnormals are exact in float, zero stays zero
+				float result = std::ldexp((float)mantissa, -24);
+				return sign ? -result : result;
+			}
+			else
+			{
+				bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+			}
+
+			float result;
+			memcpy(&result, &bits, sizeof(result));
+			return result;
+		}
+
+		int16_t FloatToSnorm16(float value)
+		{
+			if (!(value > -1.0f))
+				return -32767;
+			if (value >= 1.0f)
+				return 32767;
+			return (int16_t)std::lround(value * 32767.0f);
+		}
+		float Snorm16ToFloat(int16_t value)
+		{
+			float result = (float)value / 32767.0f;
+			return result < -1.0f ? -1.0f : result;
+		}
+		uint16_t FloatToUnorm16(float value)
+		{
+			if (!(value > 0.0f))
+				return 0;
+			if (value >= 1.0f)
+				return 65535;
+			return (uint16_t)std::lround(value * 65535.0f);
+		}
+		float Unorm16ToFloat(uint16_t value)
+		{
+			return (float)value / 65535.0f;
+		}
+
+		Vector2 OctEncode(const Vector3& direction)
+		{
+			float length = fabs(direction.x) + fabs(direction.y) + fabs(direction.z);
+			// Degenerate vectors point forward
+			if (length <= 0.0f)
+				return Vector2(0.0f, 0.0f);
+
+			float x = direction.x / length;
+			float y = direction.y / length;
+
+			// Lower hemisphere folds over the diagonals
+			if (direction.z < 0.0f)
+			{
+				float foldX = (1.0f - fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+				float foldY = (1.0f - fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+				x = foldX;
+				y = foldY;
+			}
+			return Vector2(x, y);
+		}
+		Vector3 OctDecode(const Vector2& encoded)
+		{
+			Vector3 direction(encoded.x, encoded.y, 1.0f - fabs(encoded.x) - fabs(encoded.y));
+
+			// Unfold lower hemisphere [same as the shader version]
+			float t = direction.z < 0.0f ? -direction.z : 0.0f;
+			direction.x += direction.x >= 0.0f ? -t : t;
+			direction.y += direction.y >= 0.0f ? -t : t;
+
+			return direction.Normalize();
+		}
+		void PackDirection(const Vector3& direction, int16_t out[2])
+		{
+			Vector2 encoded = OctEncode(direction);
+			out[0] = FloatToSnorm16(encoded.x);
+			out[1] = FloatToSnorm16(encoded.y);
+		}
+		Vector3 UnpackDirection(const int16_t packed[2])
+		{
+			return OctDecode(Vector2(Snorm16ToFloat(packed[0]), Snorm16ToFloat(packed[1])));
+		}
+
+		void PackPosition(const Vector3& position, const Vector3& min, const Vector3& max, uint16_t out[4])
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				float extent = max[i] - min[i];
+				out[i] = extent > 0.0f ? FloatToUnorm16((position[i] - min[i]) / extent) : 0;
+			}
+			out[3] = 0;
+		}
+		Vector3 UnpackPosition(const uint16_t packed[4], const Vector3& min, const Vector3& max)
+		{
+			Vector3 scale = max - min;
+			return Vector3(
+				min.x + Unorm16ToFloat(packed[0]) * scale.x,
+				min.y + Unorm16ToFloat(packed[1]) * scale.y,
+				min.z + Unorm16ToFloat(packed[2]) * scale.z
+			);
+		}
+
+		uint32_t GetStride(bool quantizePositions)
+		{
+			return (quantizePositions ? 8 : 12) + 4 + 4 + 4;
+		}
+		void PackVertices(
+			std::vector<uint8_t>& out,
+			const Vector3* positions, uint32_t count,
+			const Vector2* uvs, const Vector3* normals, const Vector3* tangents,
+			bool quantizePositions, const Vector3& min, const Vector3& max
+		){
+			uint32_t stride = GetStride(quantizePositions);
+			out.assign((size_t)count * stride, 0);
+
+			uint8_t* vertex = out.data();
+			for (uint32_t i = 0; i < count; i++, vertex += stride)
+			{
+				uint8_t* data = vertex;
+
+				if (quantizePositions)
+				{
+					uint16_t position[4];
+					PackPosition(positions[i], min, max, position);
+					memcpy(data, position, sizeof(position));
+					data += sizeof(position);
+				}
+				else
+				{
+					float position[3] = { positions[i].x, positions[i].y, positions[i].z };
+					memcpy(data, position, sizeof(position));
+					data += sizeof(position);
+				}
+
+				if (uvs)
+				{
+					uint16_t uv[2] = { FloatToHalf(uvs[i].x), FloatToHalf(uvs[i].y) };
+					memcpy(data, uv, sizeof(uv));
+				}
+				data += 4;
+
+				if (normals)
+				{
+					int16_t normal[2];
+					PackDirection(normals[i], normal);
+					memcpy(data, normal, sizeof(normal));
+				}
+				data += 4;
+
+				if (tangents)
+				{
+					int16_t tangent[2];
+					PackDirection(tangents[i], tangent);
+					memcpy(data, tangent, sizeof(tangent));
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,49 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "Vector.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace Vxl
+{
+	// Conversions for packed vertex attributes [no GL, usable without a context]
+	// Each pack has an unpack that matches what the GPU reads back from the same bits
+	namespace VertexPacking
+	{
+		// IEEE half precision, round to nearest even [overflow becomes infinity]
+		uint16_t	FloatToHalf(float value);
+		float		HalfToFloat(uint16_t value);
+
+		// [-1, 1] <-> signed normalized 16 bit [GL rule: max(v / 32767, -1)]
+		int16_t		FloatToSnorm16(float value);
+		float		Snorm16ToFloat(int16_t value);
+		// [0, 1] <-> unsigned normalized 16 bit
+		uint16_t	FloatToUnorm16(float value);
+		float		Unorm16ToFloat(uint16_t value);
+
+		// Octahedral mapping, unit sphere <-> [-1, 1] square [input doesn't need to be normalized]
+		Vector2		OctEncode(const Vector3& direction);
+		Vector3		OctDecode(const Vector2& encoded);
+		// Direction stored as 2 snorm16 values [4 bytes instead of 12]
+		void		PackDirection(const Vector3& direction, int16_t out[2]);
+		Vector3		UnpackDirection(const int16_t packed[2]);
+
+		// Position relative to the bounds as 3 unorm16 values [out[3] is padding]
+		// Decoding is min + value * (max - min), flat axes decode to min
+		void		PackPosition(const Vector3& position, const Vector3& min, const Vector3& max, uint16_t out[4]);
+		Vector3		UnpackPosition(const uint16_t packed[4], const Vector3& min, const Vector3& max);
+
+		// Interleaved vertex used by Mesh::setPacked [20 bytes, 24 with float positions]
+		// position: 4 unorm16 relative to the bounds or 3 floats | uv: 2 half | normal, tangent: 2 snorm16 octahedral
+		uint32_t	GetStride(bool quantizePositions);
+		// Missing attributes [nullptr] are stored as zero [directions decode to +Z]
+		void		PackVertices(
+			std::vector<uint8_t>& out,
+			const Vector3* positions, uint32_t count,
+			const Vector2* uvs, const Vector3* normals, const Vector3* tangents,
+			bool quantizePositions, const Vector3& min, const Vector3& max
+		);
+	}
+}
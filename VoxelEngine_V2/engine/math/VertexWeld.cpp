@@ -0,0 +1,107 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "VertexWeld.h"
+
+#include "../utilities/Macros.h"
+
+#include <cmath>
+#include <unordered_map>
+
+namespace Vxl
+{
+	static const uint32_t NullVertex = (uint32_t)-1;
+
+	// 21 bits per axis, cells wrap around [collisions only cost extra comparisons]
+	static inline uint64_t WeldCellKey(int64_t x, int64_t y, int64_t z)
+	{
+		const uint64_t Mask = (1ull << 21) - 1;
+		return ((uint64_t)x & Mask) | (((uint64_t)y & Mask) << 21) | (((uint64_t)z & Mask) << 42);
+	}
+
+	uint32_t WeldVertices(
+		const Vector3* positions, uint32_t count,
+		float positionTolerance,
+		std::vector<uint32_t>& remap,
+		const Vector2* uvs,
+		const Vector3* normals,
+		float attributeTolerance
+	){
+		remap.resize(count);
+		if (positions == nullptr || count == 0)
+			return 0;
+
+		VXL_ASSERT(positionTolerance > 0.0f, "Weld tolerance must be above zero");
+
+		float invCellSize = 1.0f / positionTolerance;
+		float toleranceSqr = positionTolerance * positionTolerance;
+
+		auto attributesMatch = [&](uint32_t a, uint32_t b)
+		{
+			if (uvs &&
+				(fabs(uvs[a].x - uvs[b].x) > attributeTolerance ||
+				 fabs(uvs[a].y - uvs[b].y) > attributeTolerance))
+				return false;
+
+			if (normals &&
+				(fabs(normals[a].x - normals[b].x) > attributeTolerance ||
+				 fabs(normals[a].y - normals[b].y) > attributeTolerance ||
+				 fabs(normals[a].z - normals[b].z) > attributeTolerance))
+				return false;
+
+			return true;
+		};
+
+		// Cell -> first representative, representatives in the same cell are chained
+		std::unordered_map<uint64_t, uint32_t> cells;
+		cells.reserve(count);
+		std::vector<uint32_t> next(count, NullVertex);
+
+		uint32_t groupCount = 0;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const Vector3& P = positions[i];
+			int64_t cx = (int64_t)std::floor(P.x * invCellSize);
+			int64_t cy = (int64_t)std::floor(P.y * invCellSize);
+			int64_t cz = (int64_t)std::floor(P.z * invCellSize);
+
+			// Search neighbor cells for an existing group
+			uint32_t found = NullVertex;
+			for (int64_t x = cx - 1; x <= cx + 1 && found == NullVertex; x++)
+			for (int64_t y = cy - 1; y <= cy + 1 && found == NullVertex; y++)
+			for (int64_t z = cz - 1; z <= cz + 1 && found == NullVertex; z++)
+			{
+				auto cell = cells.find(WeldCellKey(x, y, z));
+				if (cell == cells.end())
+					continue;
+
+				for (uint32_t j = cell->second; j != NullVertex; j = next[j])
+				{
+					if ((positions[j] - P).LengthSqr() < toleranceSqr && attributesMatch(i, j))
+					{
+						found = j;
+						break;
+					}
+				}
+			}
+
+			if (found != NullVertex)
+			{
+				remap[i] = found;
+				continue;
+			}
+
+			// New group
+			remap[i] = i;
+			groupCount++;
+
+			auto cell = cells.emplace(WeldCellKey(cx, cy, cz), i);
+			if (!cell.second)
+			{
+				next[i] = cell.first->second;
+				cell.first->second = i;
+			}
+		}
+
+		return groupCount;
+	}
+}
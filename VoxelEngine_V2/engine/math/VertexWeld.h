@@ -0,0 +1,22 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "Vector.h"
+
+#include <vector>
+
+namespace Vxl
+{
+	// Groups coincident vertices using a spatial hash [cell size = positionTolerance]
+	// Every vertex only checks the 27 cells around it, so welding stays O(n)
+	// Optional attributes must also match [within attributeTolerance] for vertices to share a group
+	// remap[i] = first vertex of its group [remap[i] <= i], returns amount of groups
+	uint32_t WeldVertices(
+		const Vector3* positions, uint32_t count,
+		float positionTolerance,
+		std::vector<uint32_t>& remap,
+		const Vector2* uvs = nullptr,
+		const Vector3* normals = nullptr,
+		float attributeTolerance = 0.0001f
+	);
+}
@@ -34,6 +34,8 @@ namespace Vxl
 	}
 	Entity::~Entity()
 	{
+		if (m_treeProxy != AABBTree::NullNode)
+			RenderManager.m_entityTree.remove(m_treeProxy);
 	}
 
 	// Mesh
@@ -108,6 +110,30 @@ namespace Vxl
 
 			//
 			col_AABB = col_OBB.generateAABB();
+
+			// Instances can be far from the base model, tree bounds must contain all of them for picking
+			AABB treeAABB = col_AABB;
+			if (!_mesh->m_instances.isEmpty())
+			{
+				AABB meshAABB(_mesh->getVertexMin(), _mesh->getVertexMax());
+				for (const Matrix4x4& instance : _mesh->m_instances.vertices)
+				{
+					AABB instanceAABB = meshAABB.transform(m_transform.getModel() * instance.Transpose());
+					treeAABB = AABB::merge(treeAABB, instanceAABB);
+				}
+			}
+
+			// Refit spatial tree
+			if (m_treeProxy == AABBTree::NullNode)
+				m_treeProxy = RenderManager.m_entityTree.insert(treeAABB, m_uniqueID);
+			else
+				RenderManager.m_entityTree.update(m_treeProxy, treeAABB);
+		}
+		// No mesh = no bounds
+		else if (m_treeProxy != AABBTree::NullNode)
+		{
+			RenderManager.m_entityTree.remove(m_treeProxy);
+			m_treeProxy = AABBTree::NullNode;
 		}
 	}
 }
@@ -42,10 +42,18 @@ namespace Vxl
 		MeshIndex		m_mesh = -1;
 		MaterialIndex	m_material = -1;
 		std::map<TextureLevel, TextureIndex> m_textures;
+		uint32_t		m_texturesVersion = 0; // Changes with m_textures
+		TextureBindingTable m_textureBindings[2]; // [ShaderMaterialType], used when material doesn't share textures
 		
 		// Bounding Boxes
 		AABB	col_AABB;
 		OBB		col_OBB;
+		uint32_t m_treeProxy = -1; // RenderManager entity tree
+
+		// Cached main camera MVP, valid while stamp matches RenderManager's and the transform hasn't moved since
+		Matrix4x4 m_mvp;
+		uint32_t m_mvpStamp = -1;
+		uint64_t m_mvpModelStamp = 0; // Transform stamp m_mvp was built from
 
 		// Obb except the sizes are non-uniform (used to calculate real bounding boxes)
 		Vector3 obbFuzzy[8];
@@ -88,6 +96,7 @@ namespace Vxl
 		void setTexture(TextureIndex tex, TextureLevel level)
 		{
 			m_textures[level] = tex;
+			m_texturesVersion++;
 		}
 		TextureIndex eraseTexture(TextureLevel level)
 		{
@@ -97,11 +106,13 @@ namespace Vxl
 
 			TextureIndex index = m_textures[level];
 			m_textures.erase(level);
+			m_texturesVersion++;
 			return index;
 		}
 		void eraseAllTextures(void)
 		{
 			m_textures.clear();
+			m_texturesVersion++;
 		}
 
 		// Components
@@ -66,8 +66,15 @@ namespace Vxl
 		if (_shaderMat)
 		{
 			m_shaderMaterial = index;
+			syncParameters();
 		}
 	}
+	void Material::syncParameters(void)
+	{
+		ShaderMaterial* _shaderMat = Assets.getShaderMaterial(m_shaderMaterial);
+		if (_shaderMat)
+			m_parameters.setLayout(_shaderMat->m_parameters);
+	}
 
 	//	Graphics::Uniform Material::getUniform(const std::string& name)
 	//	{
@@ -133,6 +140,11 @@ namespace Vxl
 		}
 		return false;
 	}
+	void Material::bindParameters(void)
+	{
+		syncParameters();
+		m_parameters.bind();
+	}
 	void Material::bindProgramStates(ShaderMaterialType type)
 	{
 		// Gl States
@@ -174,67 +186,24 @@ namespace Vxl
 		ShaderMaterial* _shaderMaterial = Assets.getShaderMaterial(m_shaderMaterial);
 		if (_shaderMaterial)
 		{
-			// Acquire Target Levels
-			std::vector<std::pair<std::string, TextureLevel>> _targetLevels;
-			switch (type)
-			{
-			case ShaderMaterialType::CORE:
-			{
-				ShaderProgram* _program = Assets.getShaderProgram(_shaderMaterial->m_coreProgram);
-				if (_program)
-					_targetLevels = _program->m_targetLevels;
-				break;
-			}
-			//
-			case ShaderMaterialType::COLORID:
+			ShaderProgramIndex _programIndex = (type == ShaderMaterialType::CORE) ? _shaderMaterial->m_coreProgram : _shaderMaterial->m_colorIDProgram;
+
+			// Entity textures or material textures
+			TextureBindingTable& _table = _entity ? _entity->m_textureBindings[(int)type] : m_textureBindings[(int)type];
+			const std::map<TextureLevel, TextureIndex>& _textures = _entity ? _entity->m_textures : m_textures;
+			uint32_t _texturesVersion = _entity ? _entity->m_texturesVersion : m_texturesVersion;
+
+			// Resolve only when something changed [missing textures bind null images]
+			if (!_table.isValid(_programIndex, _texturesVersion))
 			{
-				ShaderProgram* _program = Assets.getShaderProgram(_shaderMaterial->m_colorIDProgram);
+				ShaderProgram* _program = Assets.getShaderProgram(_programIndex);
 				if (_program)
-					_targetLevels = _program->m_targetLevels;
-				break;
-			}
-			}
-			
-			// Acquire Textures that are stored
-			std::map<TextureLevel, TextureIndex> _textures;
-			
-			if (_entity)
-				_textures = _entity->m_textures;
-			else
-				_textures = m_textures;
-
-			for (const auto& pair : _targetLevels)
-			{
-				TextureLevel level = pair.second;
-
-				// Check if entity doesn't have the texture location
-				if (_textures.find(level) == _textures.end())
-				{
-					if (level == TextureLevel::LEVEL0)
-						GlobalAssets.get_Tex2DNullImageCheckerboard()->bind(level);
-					else
-						GlobalAssets.get_Tex2DNullImageBlack()->bind(level);
-				}
+					_table.build(_programIndex, _program->m_targetLevels, _textures, _texturesVersion);
 				else
-				{
-					TextureIndex index = _textures[level];
-					BaseTexture* _tex = Assets.getBaseTexture(index);
-
-					// bind error texture
-					if (_tex == nullptr || !_tex->isLoaded())
-					{
-						if (level == TextureLevel::LEVEL0)
-							GlobalAssets.get_Tex2DNullImageCheckerboard()->bind(level);
-						else
-							GlobalAssets.get_Tex2DNullImageBlack()->bind(level);
-					}
-					// bind texture normally
-					else
-					{
-						_tex->bind(level);
-					}
-				}
+					_table.clear();
 			}
+
+			_table.bind();
 		}
 	}
 
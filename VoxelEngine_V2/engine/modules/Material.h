@@ -5,6 +5,7 @@
 
 #include "../rendering/Graphics.h"
 #include "../rendering/Shader.h"
+#include "../rendering/TextureBindingTable.h"
 #include "../utilities/Types.h"
 #include "../utilities/Asset.h"
 
@@ -35,13 +36,21 @@ namespace Vxl
 		friend class _Assets;
 		friend class ShaderProgram;
 		friend class Inspector;
+		friend class RenderManager;
 	private:
 		// Data
 		std::string					m_name;
 		ShaderMaterialIndex			m_shaderMaterial = -1;
 		uint32_t					m_sequenceNumber = -1;
+		uint32_t					m_sequenceRank = -1; // Position in sequence order [set by RenderManager]
 		static std::set<uint32_t>	m_allSequenceNumbers;
 		std::map<TextureLevel, TextureIndex> m_textures;
+		uint32_t					m_texturesVersion = 0; // Changes with m_textures
+		TextureBindingTable			m_textureBindings[2]; // [ShaderMaterialType]
+		ParameterBlock				m_parameters;
+
+		// Follows the ShaderMaterial's layout [changes when a reload edits #Parameters]
+		void syncParameters(void);
 
 		// Protected
 		Material(const std::string& name) 
@@ -61,6 +70,7 @@ namespace Vxl
 		void setTexture(TextureIndex tex, TextureLevel level)
 		{
 			m_textures[level] = tex;
+			m_texturesVersion++;
 		}
 		TextureIndex eraseTexture(TextureLevel level)
 		{
@@ -70,11 +80,13 @@ namespace Vxl
 
 			TextureIndex index = m_textures[level];
 			m_textures.erase(level);
+			m_texturesVersion++;
 			return index;
 		}
 		void eraseAllTextures(void)
 		{
 			m_textures.clear();
+			m_texturesVersion++;
 		}
 
 		// Which pass for rendering
@@ -135,6 +147,25 @@ namespace Vxl
 			}
 		}
 
+		// #Parameters values, false if the material has no such parameter
+		// ex: material->setParameter("reflectivity", Color4F(1, 1, 1, 1));
+		template<typename Type>
+		bool setParameter(ParameterHandle handle, const Type& value)
+		{
+			syncParameters();
+			return m_parameters.set(handle, value);
+		}
+		template<typename Type>
+		bool getParameter(ParameterHandle handle, Type& value)
+		{
+			syncParameters();
+			return m_parameters.get(handle, value);
+		}
+		inline const ParameterBlock& getParameters(void) const
+		{
+			return m_parameters;
+		}
+
 		//
 		ShaderProgram* getProgram(ShaderMaterialType type);
 
@@ -143,6 +174,8 @@ namespace Vxl
 
 		// Shader Uniform Binding
 		bool bindProgramUniforms(ShaderMaterialType type, EntityIndex _entity);
+		// Parameter block binding [once per material, not per entity]
+		void bindParameters(void);
 
 		// GL States
 		void bindProgramStates(ShaderMaterialType type);
@@ -64,7 +64,7 @@ namespace Vxl
 
 	void Camera::update()
 	{
-		m_view = Matrix4x4::LookAt(m_transform.m_position, m_transform.getForward(), m_transform.getRight(), m_transform.getUp());
+		m_view = Matrix4x4::LookAt(m_transform.getPosition(), m_transform.getForward(), m_transform.getRight(), m_transform.getUp());
 		m_viewInverse = m_view.Inverse();
 		
 		UpdateViewProjection();
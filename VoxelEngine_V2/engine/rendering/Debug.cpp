@@ -7,12 +7,31 @@
 #include "../modules/Entity.h"
 #include "../rendering/Primitives.h"
 #include "../rendering/Mesh.h"
+#include "../rendering/Shader.h"
 #include "../textures/Texture2D.h"
 #include "../utilities/Asset.h"
 #include "../utilities/Time.h"
 
 namespace Vxl
 {
+	// Matches the instance layout [mat4 + vec4]
+	static_assert(sizeof(Debug::Object) == sizeof(float) * 20, "Debug::Object must stay tightly packed");
+
+	// Box edges as corner pairs, corners are indexed by bits [1 = +x, 2 = +y, 4 = +z]
+	static const uint8_t BoxEdges[24] =
+	{
+		0, 1,  2, 3,  4, 5,  6, 7, // X
+		0, 2,  1, 3,  4, 6,  5, 7, // Y
+		0, 4,  1, 5,  2, 6,  3, 7  // Z
+	};
+
+	void Debug::ReserveLines(uint32_t lineCount)
+	{
+		LineMesh3D* LineSet = Assets.getLineMesh3D(m_worldLines);
+		if (LineSet)
+			LineSet->reserveLines(lineCount);
+	}
+
 	void Debug::DrawLine(
 		const Vector3& P1, const Vector3& P2,
 		float Width,
@@ -23,6 +42,24 @@ namespace Vxl
 		if (LineSet)
 			LineSet->addLine(P1, P2, Width, C1, C2);
 	}
+	void Debug::DrawLines(
+		const Vector3* points, uint32_t lineCount,
+		float Width,
+		const Color3F& C
+	)
+	{
+		LineMesh3D* LineSet = Assets.getLineMesh3D(m_worldLines);
+		if (LineSet)
+			LineSet->addLines(points, lineCount, Width, C);
+	}
+	void Debug::DrawLineBox(const Vector3* corners, float width, const Color3F& C)
+	{
+		Vector3 points[24];
+		for (uint32_t i = 0; i < 24; i++)
+			points[i] = corners[BoxEdges[i]];
+
+		DrawLines(points, 12, width, C);
+	}
 	void Debug::DrawLineNoDepth(
 		const Vector3& P1, const Vector3& P2,
 		float Width,
@@ -63,13 +100,14 @@ namespace Vxl
 		const Color3F& C
 	)
 	{
-		Object _object;
 		Quaternion rotation = Quaternion::ToQuaternion_ZYX(ToRadians(eulerRotation.x), ToRadians(eulerRotation.y), ToRadians(eulerRotation.z));
-		_object.model = Matrix4x4(rotation.GetMatrix3x3() * Matrix3x3::GetScale(scale), position);
-		_object.color = C;
-		_object.width = width;
+		Matrix3x3 rotScale = rotation.GetMatrix3x3() * Matrix3x3::GetScale(scale);
 
-		m_cubesLines.push_back(_object);
+		Vector3 corners[8];
+		for (uint32_t i = 0; i < 8; i++)
+			corners[i] = position + rotScale * Vector3((i & 1) ? 0.5f : -0.5f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 0.5f : -0.5f);
+
+		DrawLineBox(corners, width, C);
 	}
 	void Debug::DrawLineSphere(
 		const Vector3& position,
@@ -79,7 +117,7 @@ namespace Vxl
 	)
 	{
 		Object _object;
-		_object.model = Matrix4x4(Matrix3x3::GetScale(scale), position);
+		_object.model = Matrix4x4(Matrix3x3::GetScale(scale), position).Transpose();
 		_object.color = C;
 		_object.width = width;
 
@@ -92,41 +130,36 @@ namespace Vxl
 		const Color3F& C
 	)
 	{
-		Object _object;
-		_object.model = Matrix4x4(Matrix3x3::GetScale(Max - Min), (Min + Max) * 0.5f);
-		_object.color = C;
-		_object.width = width;
+		Vector3 corners[8];
+		for (uint32_t i = 0; i < 8; i++)
+			corners[i] = Vector3((i & 1) ? Max.x : Min.x, (i & 2) ? Max.y : Min.y, (i & 4) ? Max.z : Min.z);
 
-		m_cubesLines.push_back(_object);
+		DrawLineBox(corners, width, C);
 	}
-	Debug::Object& Debug::DrawLineAABB(
+	void Debug::DrawLineAABB(
 		const AABB& aabb,
 		float width,
 		const Color3F& C
 	)
 	{
-		Object _object;
-		_object.model = Matrix4x4(Matrix3x3::GetScale(aabb.max - aabb.min), (aabb.max + aabb.min) * 0.5f);
-		_object.color = C;
-		_object.width = width;
-
-		m_cubesLines.push_back(_object);
-		return m_cubesLines[m_cubesLines.size() - 1];
+		DrawLineAABB(aabb.min, aabb.max, width, C);
 	}
-	Debug::Object& Debug::DrawLineOBB(
+	void Debug::DrawLineOBB(
 		const OBB& obb,
 		float Width,
 		const Color3F& C
 	)
 	{
-		Object _object;
-		Matrix3x3 rotScale = Matrix3x3::createFromColumns(obb.right, obb.up, obb.forward);
-		_object.model = Matrix4x4(rotScale, obb.position);
-		_object.color = C;
-		_object.width = Width;
+		// Axes are full extents
+		Vector3 right = obb.right * 0.5f;
+		Vector3 up = obb.up * 0.5f;
+		Vector3 forward = obb.forward * 0.5f;
 
-		m_cubesLines.push_back(_object);
-		return m_cubesLines[m_cubesLines.size() - 1];
+		Vector3 corners[8];
+		for (uint32_t i = 0; i < 8; i++)
+			corners[i] = obb.position + ((i & 1) ? right : -right) + ((i & 2) ? up : -up) + ((i & 4) ? forward : -forward);
+
+		DrawLineBox(corners, Width, C);
 	}
 	void Debug::DrawLineArrow(
 		const Vector3& p1, const Vector3& p2,
@@ -156,7 +189,7 @@ namespace Vxl
 		Quaternion QY = Quaternion::AngleAxis(YrotationRad, Vector3::UP);
 		Quaternion QX = Quaternion::AngleAxis(XrotationRad, Vector3::RIGHT);
 
-		_object.model = Matrix4x4((QY * QX).GetMatrix3x3() * Matrix3x3::GetScale(ArrowTipSize), p2);
+		_object.model = Matrix4x4((QY * QX).GetMatrix3x3() * Matrix3x3::GetScale(ArrowTipSize), p2).Transpose();
 		_object.color = C;
 		_object.width = Width;
 
@@ -172,8 +205,9 @@ namespace Vxl
 	{
 		Object _object;
 		Quaternion rotation = Quaternion::ToQuaternion_ZYX(ToRadians(eulerRotation.x), ToRadians(eulerRotation.y), ToRadians(eulerRotation.z));
-		_object.model = Matrix4x4(rotation.GetMatrix3x3() * Matrix3x3::GetScale(scale), position);
+		_object.model = Matrix4x4(rotation.GetMatrix3x3() * Matrix3x3::GetScale(scale), position).Transpose();
 		_object.color = C;
+		_object.width = 1.0f;
 
 		m_cubes.push_back(_object);
 	}
@@ -183,8 +217,9 @@ namespace Vxl
 	)
 	{
 		Object _object;
-		_object.model = model;
+		_object.model = model.Transpose();
 		_object.color = C;
+		_object.width = 1.0f;
 
 		m_cubes.push_back(_object);
 	}
@@ -197,8 +232,9 @@ namespace Vxl
 	{
 		Object _object;
 		Quaternion rotation = Quaternion::ToQuaternion_ZYX(ToRadians(eulerRotation.x), ToRadians(eulerRotation.y), ToRadians(eulerRotation.z));
-		_object.model = Matrix4x4(rotation.GetMatrix3x3() * Matrix3x3::GetScale(scale), position);
+		_object.model = Matrix4x4(rotation.GetMatrix3x3() * Matrix3x3::GetScale(scale), position).Transpose();
 		_object.color = C;
+		_object.width = 1.0f;
 
 		m_spheres.push_back(_object);
 	}
@@ -208,12 +244,47 @@ namespace Vxl
 	)
 	{
 		Object _object;
-		_object.model = model;
+		_object.model = model.Transpose();
 		_object.color = C;
+		_object.width = 1.0f;
 
 		m_spheres.push_back(_object);
 	}
 
+	void Debug::RenderInstances(const std::vector<Object>& objects, MeshIndex meshIndex)
+	{
+		Mesh* mesh = Assets.getMesh(meshIndex);
+		if (!mesh || objects.empty() || !m_instances)
+			return;
+
+		uint32_t count = (uint32_t)objects.size();
+		m_instances->SetVertices(objects.data(), count);
+		mesh->drawInstanced(*m_instances, count);
+	}
+
+	void Debug::RenderShapes(ShaderProgram* program)
+	{
+		// Model is identity and mvp is the camera's viewProjection
+		program->bindBatchUniforms();
+
+		RenderInstances(m_spheres, Primitives.GetSphereUV_Cheap());
+		RenderInstances(m_cubes, Primitives.GetCube());
+		RenderInstances(m_arrowLines, Primitives.GetArrowZNoTail());
+
+		if (program->m_uniform_useInstancing.has_value())
+			program->m_uniform_useInstancing.value().send(false);
+	}
+
+	void Debug::RenderShapeOutlines(ShaderProgram* program)
+	{
+		program->bindBatchUniforms();
+
+		RenderInstances(m_spheresLines, Primitives.GetLines_CircleAllAxis_Unit());
+
+		if (program->m_uniform_useInstancing.has_value())
+			program->m_uniform_useInstancing.value().send(false);
+	}
+
 	void Debug::RenderWorldLines()
 	{
 		LineMesh3D* LineSet = Assets.getLineMesh3D(m_worldLines);
@@ -262,7 +333,6 @@ namespace Vxl
 		m_cubes.clear();
 
 		m_spheresLines.clear();
-		m_cubesLines.clear();
 
 		m_arrowLines.clear();
 	}
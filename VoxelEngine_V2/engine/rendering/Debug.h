@@ -18,6 +18,7 @@
 namespace Vxl
 {
 	class Texture2D;
+	class ShaderProgram;
 	struct OBB;
 	struct AABB;
 
@@ -26,27 +27,32 @@ namespace Vxl
 		friend class RenderManager;
 
 	public:
-		// Debug Object
+		// Debug Object [uploaded as is for instancing, model is stored transposed like Mesh::m_instances]
 		struct Object
 		{
-			Color3F		color;
 			Matrix4x4	model;
+			Color3F		color;
 			float		width;
 		};
 
-		// Storage
+		// Storage [one instanced draw per shape type]
 		std::vector<Object> m_spheres;
 		std::vector<Object> m_spheresLines;
 		std::vector<Object> m_cubes;
-		std::vector<Object> m_cubesLines;
 		std::vector<Object> m_arrowLines;
 
 	private:
-		// Debug Lines in world space
+		// Debug Lines in world space [cube/aabb/obb outlines are written here as 12 lines]
 		LineMesh3DIndex m_worldLines;
 		LineMesh3DIndex m_worldLinesNoDepth;
 		// Debug Lines in screen space
 		LineMesh2DIndex m_screenLines;
+		// Object instances of all shape types
+		StreamVBO* m_instances = nullptr;
+
+		// Corners are indexed by bits [1 = +x, 2 = +y, 4 = +z]
+		void DrawLineBox(const Vector3* corners, float width, const Color3F& C);
+		void RenderInstances(const std::vector<Object>& objects, MeshIndex meshIndex);
 
 	public:
 		void InitGLResources()
@@ -54,14 +60,30 @@ namespace Vxl
 			m_worldLines = GlobalAssets.createLineMesh3D(DrawType::LINES);
 			m_worldLinesNoDepth = GlobalAssets.createLineMesh3D(DrawType::LINES);
 			m_screenLines = GlobalAssets.createLineMesh2D(DrawType::LINES);
+
+			m_instances = new StreamVBO();
+			m_instances->SetLayout(BufferLayout(
+				{
+					{AttributeLocation::LOC8, AttributeType::VEC4, false, 1},
+					{AttributeLocation::LOC9, AttributeType::VEC4, false, 1},
+					{AttributeLocation::LOC10, AttributeType::VEC4, false, 1},
+					{AttributeLocation::LOC11, AttributeType::VEC4, false, 1},
+					{AttributeLocation::LOC12, AttributeType::VEC4, false, 1} // Color + Width
+				}));
 		}
 		void DestroyGLResources()
 		{
 			GlobalAssets.deleteLineMesh3D(m_worldLines);
 			GlobalAssets.deleteLineMesh3D(m_worldLinesNoDepth);
 			GlobalAssets.deleteLineMesh2D(m_screenLines);
+
+			delete m_instances;
+			m_instances = nullptr;
 		}
 
+		// Pre-sizes world lines for this frame [storage is kept between frames]
+		void ReserveLines(uint32_t lineCount);
+
 		// Line Drawing
 		void DrawLine(
 			const Vector3& P1, const Vector3& P2,
@@ -78,6 +100,12 @@ namespace Vxl
 			float Width,
 			const Color3F& C1 = Color3F(1, 1, 1), const Color3F& C2 = Color3F(1, 1, 1)
 		);
+		// Points are consecutive pairs, written in one go
+		void DrawLines(
+			const Vector3* points, uint32_t lineCount,
+			float Width,
+			const Color3F& C = Color3F(1, 1, 1)
+		);
 		void DrawLineSquareScreenSpace(
 			const Vector2& P, const Vector2& Size,
 			float LineWidth,
@@ -102,12 +130,12 @@ namespace Vxl
 			float width,
 			const Color3F& C = Color3F(1, 1, 1)
 		);
-		Object& DrawLineAABB(
+		void DrawLineAABB(
 			const AABB& aabb,
 			float width,
 			const Color3F& C = Color3F(1, 1, 1)
 		);
-		Object& DrawLineOBB(
+		void DrawLineOBB(
 			const OBB& obb,
 			float Width,
 			const Color3F& C = Color3F(1, 1, 1)
@@ -143,6 +171,9 @@ namespace Vxl
 
 		
 		// Rendering
+		// Solid shapes with debugRender, outlines with lineRender [program must be bound]
+		void RenderShapes(ShaderProgram* program);
+		void RenderShapeOutlines(ShaderProgram* program);
 		void RenderWorldLines();
 		void RenderWorldLinesNoDepth();
 		void RenderScreenLines();
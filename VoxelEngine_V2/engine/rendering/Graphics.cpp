@@ -5,6 +5,7 @@
 #include <GL/gl3w.h>
 
 #include "FramebufferObject.h"
+#include "GraphicsBackend.h"
 #include "Shader.h"
 #include "RenderBuffer.h"
 
@@ -43,6 +44,7 @@ namespace Vxl
 	float Graphics::GLMaxAnisotropy = -1;
 	int Graphics::GLMaxFBOColorAttachments = -1;
 	int Graphics::GLMaxUniformBindings = -1;
+	int Graphics::GLUniformBufferOffsetAlignment = -1;
 	int Graphics::GLMaxAttributes = -1;
 
 	std::string Graphics::Gpu_Renderer;
@@ -75,7 +77,9 @@ namespace Vxl
 	BlendEquation		gl_blendequation = BlendEquation::NONE;
 	DepthPassRule		gl_depthpassrule = DepthPassRule::NONE;
 	GLsizei				gl_viewport[4] = { -1, -1, -1, -1 };
-	std::map<TextureLevel, TextureID> gl_activeTextureIds;
+	TextureID			gl_activeTextureIds[(int)TextureLevel::TOTAL];
+	uint32_t			gl_textureBindCount = 0;
+	uint32_t			gl_textureSkippedBindCount = 0;
 	RenderBufferID		gl_activeBufferId = 0;
 	TextureLevel		gl_activeTextureLayer = TextureLevel::NONE;
 	FramebufferObjectID gl_activeFBO = 0;
@@ -724,6 +728,10 @@ namespace Vxl
 	// ~ Setup ~ //
 	bool Graphics::Setup()
 	{
+#ifdef GLOBAL_GRAPHICS_NULL
+		GraphicsBackend::Install();
+		Logger.log("Graphics Backend: " + std::string(GraphicsBackend::GetName()));
+#else
 		// Init Glew
 		if (gl3wInit())
 		{
@@ -731,11 +739,13 @@ namespace Vxl
 			std::system("pause");
 			return false;
 		}
+#endif
 
 		// Acquire Version
 		glGetIntegerv(GL_MAJOR_VERSION, &GLVersionMajor);
 		glGetIntegerv(GL_MINOR_VERSION, &GLVersionMinor);
 
+#ifndef GLOBAL_GRAPHICS_NULL
 		// Check GL Version
 		if (!gl3wIsSupported(GLVersionMajor, GLVersionMinor))
 		{
@@ -743,6 +753,7 @@ namespace Vxl
 			std::system("pause");
 			return false;
 		}
+#endif
 
 		// Acquire GPU info
 		Gpu_Renderer = std::string((reinterpret_cast<char const*>(glGetString(GL_RENDERER))));
@@ -764,6 +775,7 @@ namespace Vxl
 		glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &GLMaxAnisotropy);
 		glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS, &GLMaxFBOColorAttachments);
 		glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &GLMaxUniformBindings);
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &GLUniformBufferOffsetAlignment);
 		glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &GLMaxAttributes);
 
 		// VRAM Maximum
@@ -793,12 +805,13 @@ namespace Vxl
 			gl_viewport[i] = -1;
 		gl_lineWidth = 1.0f;
 
-		gl_activeTextureIds.clear();
-		for (int i = 1; i < (int)TextureLevel::TOTAL; i++)
+		for (int i = 0; i < (int)TextureLevel::TOTAL; i++)
 		{
-			gl_activeTextureIds[(TextureLevel)i] = 0;
+			gl_activeTextureIds[i] = 0;
 		}
 		gl_activeTextureLayer = TextureLevel::NONE;
+		gl_textureBindCount = 0;
+		gl_textureSkippedBindCount = 0;
 
 		gl_activeBufferId = 0;
 
@@ -1180,6 +1193,32 @@ namespace Vxl
 			return 0;
 		}
 	}
+	uint32_t Graphics::GetSize(DataType type)
+	{
+		switch (type)
+		{
+		case DataType::BYTE:
+		case DataType::UNSIGNED_BYTE:
+			return 1;
+		case DataType::SHORT:
+		case DataType::UNSIGNED_SHORT:
+		case DataType::HALF_FLOAT:
+			return 2;
+		case DataType::INT:
+		case DataType::UNSIGNED_INT:
+		case DataType::FLOAT:
+		case DataType::FIXED:
+		case DataType::INT_2_10_10_10_REV:
+		case DataType::UNSIGNED_INT_2_10_10_10_REV:
+		case DataType::UNSIGNED_INT_10F_11F_11F_REV:
+			return 4;
+		case DataType::DOUBLE:
+			return 8;
+		default:
+			VXL_ASSERT(false, "Invalid DataType");
+			return 0;
+		}
+	}
 	DataType Graphics::GetDataType(AttributeType type)
 	{
 		switch (type)
@@ -1994,6 +2033,45 @@ namespace Vxl
 			return std::string(error.begin(), error.end() - 1);
 		}
 	}
+	bool Graphics::ShaderProgram::SupportsBinary(void)
+	{
+		if (GLVersionMajor < 4 || (GLVersionMajor == 4 && GLVersionMinor < 1) || !glProgramBinary)
+			return false;
+
+		int formatCount = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+		return formatCount > 0;
+	}
+	void Graphics::ShaderProgram::SetBinaryRetrievable(ShaderProgramID program)
+	{
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+	bool Graphics::ShaderProgram::GetBinary(ShaderProgramID program, uint32_t& format, std::vector<uint8_t>& binary)
+	{
+		int length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0)
+			return false;
+
+		binary.resize(length);
+
+		GLenum binaryFormat = 0;
+		glGetProgramBinary(program, length, &length, &binaryFormat, binary.data());
+		binary.resize(length);
+		format = binaryFormat;
+
+		return length > 0;
+	}
+	bool Graphics::ShaderProgram::LoadBinary(ShaderProgramID program, uint32_t format, const void* binary, uint32_t size)
+	{
+		glProgramBinary(program, format, binary, size);
+
+		// Rejected binaries only fail the link status, no GL error
+		int status = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+		return (bool)status;
+	}
 	std::map<std::string, Graphics::Uniform> Graphics::ShaderProgram::AcquireUniforms(ShaderProgramID id)
 	{
 		const GLsizei bufSize = 128; // maximum name length
@@ -2243,6 +2321,16 @@ namespace Vxl
 		glBufferSubData(GL_ARRAY_BUFFER, OffsetBytes, SizeBytes, data);
 	}
 
+	void* Graphics::VBO::BindStorageMapped(ptrdiff_t length)
+	{
+		if (GLVersionMajor < 4 || (GLVersionMajor == 4 && GLVersionMinor < 4) || !glBufferStorage)
+			return nullptr;
+
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_ARRAY_BUFFER, length, nullptr, flags);
+		return glMapBufferRange(GL_ARRAY_BUFFER, 0, length, flags);
+	}
+
 	void Graphics::VBO::SetVertexAttribState(uint32_t bufferIndex, bool state)
 	{
 		if (state)
@@ -2325,26 +2413,64 @@ namespace Vxl
 		VXL_ASSERT(id != -1, "GL ERROR: glDeleteTextures()");
 
 		glDeleteTextures(1, &id);
+
+		// GL unbinds deleted textures from every unit, a new texture reusing the id must not look bound
+		for (int i = 0; i < (int)TextureLevel::TOTAL; i++)
+		{
+			if (gl_activeTextureIds[i] == id)
+				gl_activeTextureIds[i] = 0;
+		}
 	}
 	void Graphics::Texture::bind(TextureType type, TextureID textureID)
 	{
-		if(gl_activeTextureIds[gl_activeTextureLayer] == textureID)
+		if (gl_activeTextureIds[(int)gl_activeTextureLayer] == textureID)
+		{
+			gl_textureSkippedBindCount++;
 			return;
+		}
 
 		glBindTexture(GL_TextureType[(int)type], textureID);
-		gl_activeTextureIds[gl_activeTextureLayer] = textureID;
+		gl_activeTextureIds[(int)gl_activeTextureLayer] = textureID;
+		gl_textureBindCount++;
 	}
 	void Graphics::Texture::Unbind(TextureType type)
 	{
-		if (gl_activeTextureIds[gl_activeTextureLayer] == 0)
+		if (gl_activeTextureIds[(int)gl_activeTextureLayer] == 0)
 			return;
 
 		glBindTexture(GL_TextureType[(int)type], 0);
-		gl_activeTextureIds[gl_activeTextureLayer] = 0;
+		gl_activeTextureIds[(int)gl_activeTextureLayer] = 0;
+	}
+	void Graphics::Texture::BindToLevel(TextureLevel level, TextureType type, TextureID textureID)
+	{
+		// Unit already holds the texture, the active unit doesn't need to change either
+		if (gl_activeTextureIds[(int)level] == textureID)
+		{
+			gl_textureSkippedBindCount++;
+			return;
+		}
+
+		SetActiveLevel(level);
+		glBindTexture(GL_TextureType[(int)type], textureID);
+		gl_activeTextureIds[(int)level] = textureID;
+		gl_textureBindCount++;
 	}
 	TextureID Graphics::Texture::GetCurrentlyBound(void)
 	{
-		return gl_activeTextureIds[gl_activeTextureLayer];
+		return gl_activeTextureIds[(int)gl_activeTextureLayer];
+	}
+	uint32_t Graphics::Texture::GetBindCount(void)
+	{
+		return gl_textureBindCount;
+	}
+	uint32_t Graphics::Texture::GetSkippedBindCount(void)
+	{
+		return gl_textureSkippedBindCount;
+	}
+	void Graphics::Texture::ResetBindCounts(void)
+	{
+		gl_textureBindCount = 0;
+		gl_textureSkippedBindCount = 0;
 	}
 	void Graphics::Texture::SetActiveLevel(TextureLevel level)
 	{
@@ -2763,6 +2889,10 @@ namespace Vxl
 	{
 		glBufferSubData(GL_UNIFORM_BUFFER, offset, totalBytes, buffer);
 	}
+	void Graphics::UBO::BindRange(uint32_t slot, UBOID id, uint32_t offset, uint32_t size)
+	{
+		glBindBufferRange(GL_UNIFORM_BUFFER, slot, id, offset, size);
+	}
 
 	// ~ Queries ~ //
 	QueryID Graphics::Query::Create(void)
@@ -2797,6 +2927,10 @@ namespace Vxl
 		glEndQuery(GL_QueryType[(int)type]);
 		gl_QueryStatus[type] = false;
 	}
+	void Graphics::Query::Timestamp(QueryID id)
+	{
+		glQueryCounter(id, GL_TIMESTAMP);
+	}
 	bool Graphics::Query::CheckFinished(QueryID id)
 	{
 		int ready = 0;
@@ -2809,4 +2943,30 @@ namespace Vxl
 		glGetQueryObjectui64v(id, GL_QUERY_RESULT, &result);
 		return result;
 	}
+
+	// ~ Sync ~ //
+	FenceID Graphics::Sync::CreateFence(void)
+	{
+		return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+	void Graphics::Sync::DeleteFence(FenceID id)
+	{
+		if (id)
+			glDeleteSync((GLsync)id);
+	}
+	bool Graphics::Sync::WaitFence(FenceID id, uint64_t timeoutNs)
+	{
+		if (!id)
+			return true;
+
+		// Flush on the first try, otherwise the fence might never reach the GPU
+		GLenum result = glClientWaitSync((GLsync)id, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+		while (result == GL_TIMEOUT_EXPIRED && timeoutNs > 0)
+		{
+			result = glClientWaitSync((GLsync)id, 0, timeoutNs);
+			if (timeoutNs != UINT64_MAX)
+				break;
+		}
+		return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+	}
 }
\ No newline at end of file
@@ -531,6 +531,7 @@ namespace Vxl
 	typedef uint32_t FramebufferObjectID;
 	typedef uint32_t UBOID;
 	typedef uint32_t QueryID;
+	typedef void*	 FenceID;
 
 	// Graphics Caller
 	namespace Graphics
@@ -545,6 +546,7 @@ namespace Vxl
 		extern float GLMaxAnisotropy;
 		extern int GLMaxFBOColorAttachments;
 		extern int GLMaxUniformBindings;
+		extern int GLUniformBufferOffsetAlignment;
 		extern int GLMaxAttributes;
 
 		extern std::string Gpu_Renderer;
@@ -638,6 +640,8 @@ namespace Vxl
 		// ~ Conversion ~ //
 		uint32_t GetValueCount(AttributeType type);
 		uint32_t GetSize(AttributeType type);
+		// Bytes per value [packed formats return the size of all their values]
+		uint32_t GetSize(DataType type);
 		DataType GetDataType(AttributeType type);
 		DrawSubType GetDrawSubType(DrawType type);
 		TexturePixelType GetPixelData(TextureDepthFormat format);
@@ -784,6 +788,14 @@ namespace Vxl
 			ShaderProgramID	GetCurrentlyActive(void);
 			std::string		GetError(ShaderProgramID id);
 
+			// Program binaries [GL 4.1], false if the driver exposes no binary format
+			bool			SupportsBinary(void);
+			// Must be set before linking for GetBinary to be reliable
+			void			SetBinaryRetrievable(ShaderProgramID program);
+			bool			GetBinary(ShaderProgramID program, uint32_t& format, std::vector<uint8_t>& binary);
+			// Replaces compile and link, false if the driver rejects the binary [driver or source changed]
+			bool			LoadBinary(ShaderProgramID program, uint32_t format, const void* binary, uint32_t size);
+
 			std::map<std::string, Graphics::Attribute> AcquireAttributes(ShaderProgramID id);
 			std::map<std::string, Graphics::Uniform> AcquireUniforms(ShaderProgramID id);
 			std::map<std::string, Graphics::UniformBlock> AcquireUniformBlocks(ShaderProgramID id);
@@ -806,6 +818,9 @@ namespace Vxl
 			void	Unbind(void);
 			void	BindData(ptrdiff_t length, void* data, BufferUsage usage);
 			void	BindSubData(int OffsetBytes, int SizeBytes, void* data);
+			// Immutable storage that stays mapped for writing [coherent, GL 4.4], nullptr if unsupported
+			// or if mapping failed, the buffer is then immutable already and can't take BindData
+			void*	BindStorageMapped(ptrdiff_t length);
 
 			void	SetVertexAttribState(uint32_t bufferIndex, bool state);
 			void	SetVertexAttrib(uint32_t bufferIndex, int valueCount, DataType datatype, uint32_t strideSize, uint32_t strideOffset, bool normalized);
@@ -837,9 +852,16 @@ namespace Vxl
 			void		Delete(TextureID id);
 			void		bind(TextureType type, TextureID textureID);
 			void		Unbind(TextureType type);
+			// Only touches the active level if the unit doesn't already hold the texture
+			void		BindToLevel(TextureLevel level, TextureType type, TextureID textureID);
 			TextureID	GetCurrentlyBound(void);
 			void		SetActiveLevel(TextureLevel level);
 
+			// glBindTexture calls made and skipped [already bound] since last reset
+			uint32_t	GetBindCount(void);
+			uint32_t	GetSkippedBindCount(void);
+			void		ResetBindCounts(void);
+
 			void		CreateStorage(TextureType type, uint32_t levels, TextureFormat format, uint32_t width, uint32_t height);
 			void		SetStorage(TextureType type, uint32_t width, uint32_t height, TextureChannelType channelType, TexturePixelType pixeltype, const void* pixels);
 			void		SetStorage(CubemapFace type, uint32_t width, uint32_t height, TextureChannelType channelType, TexturePixelType pixeltype, const void* pixels);
@@ -899,6 +921,8 @@ namespace Vxl
 			void	bind(UBOID id);
 			void	Unbind(void);
 			void	UpdateBuffer(void* buffer, uint32_t totalBytes, uint32_t offset);
+			// Slot only sees [offset, offset + size), offset must be a multiple of GLUniformBufferOffsetAlignment
+			void	BindRange(uint32_t slot, UBOID id, uint32_t offset, uint32_t size);
 		}
 
 		// ~ Queries ~ //
@@ -919,9 +943,21 @@ namespace Vxl
 
 			void		Start(QueryID id, Type type);
 			void		End(Type type);
+			// GPU time once all previous commands finished [can be nested, unlike TIME_ELAPSED]
+			void		Timestamp(QueryID id);
 			bool		CheckFinished(QueryID id);
 			uint64_t	GetResult(QueryID id);
 		}
+
+		// ~ Sync ~ //
+		namespace Sync
+		{
+			// Signaled once the GPU finished every command issued before it
+			FenceID		CreateFence(void);
+			void		DeleteFence(FenceID id);
+			// Blocks until signaled, returns false if it timed out
+			bool		WaitFence(FenceID id, uint64_t timeoutNs = UINT64_MAX);
+		}
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,1233 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "GraphicsBackend.h"
+
+#include <GL/gl3w.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+namespace Vxl
+{
+	namespace GraphicsBackend
+	{
+		static Stats m_stats;
+		static std::vector<std::string> m_recording;
+
+		uint32_t Stats::total(void) const
+		{
+			uint32_t count = 0;
+			for (uint32_t i = 0; i < (uint32_t)CallType::TOTAL; i++)
+				count += calls[i];
+			return count;
+		}
+
+#ifdef GLOBAL_GRAPHICS_NULL
+		// Just enough driver state for Graphics to run [names, buffer memory for mapping, enabled caps]
+		static GLuint m_nextName = 1;
+		static std::unordered_map<GLenum, GLuint> m_boundBuffers;
+		static std::unordered_map<GLuint, std::vector<uint8_t>> m_bufferMemory;
+		static std::set<GLenum> m_enabled;
+
+		// Programs report the uniforms declared in their shaders' source, so reflection and uniform sends still run
+		struct StubUniform
+		{
+			std::string name;		// Arrays end with [0] like GL reports them
+			GLenum		type;
+			GLint		size;
+			GLint		location;
+		};
+		static std::unordered_map<GLuint, std::string> m_shaderSources;
+		static std::unordered_map<GLuint, std::vector<GLuint>> m_attachedShaders;
+		static std::unordered_map<GLuint, std::vector<StubUniform>> m_programUniforms;
+
+#ifdef GLOBAL_GRAPHICS_RECORDING
+		static void Append(std::ostringstream& stream, unsigned char value)
+		{
+			// GLboolean
+			stream << (uint32_t)value;
+		}
+		static void Append(std::ostringstream& stream, const char* value)
+		{
+			stream << '"' << (value ? value : "") << '"';
+		}
+		template<typename Type>
+		static void Append(std::ostringstream& stream, const Type& value)
+		{
+			stream << value;
+		}
+#endif
+
+		template<typename... Args>
+		static void Record(CallType type, const char* name, const Args&... args)
+		{
+			m_stats.calls[(int)type]++;
+
+#ifdef GLOBAL_GRAPHICS_RECORDING
+			std::ostringstream stream;
+			stream << name << '(';
+			uint32_t index = 0;
+			(void)std::initializer_list<int>{ 0, (stream << (index++ ? ", " : ""), Append(stream, args), 0)... };
+			stream << ')';
+			m_recording.push_back(stream.str());
+#else
+			(void)name;
+#endif
+		}
+
+		static void CountDraw(GLsizei count, GLsizei instances)
+		{
+			m_stats.drawnVertices += (uint64_t)count * (uint64_t)instances;
+			m_stats.drawnInstances += instances;
+		}
+		static void EmptyString(GLsizei bufSize, GLsizei* length, GLchar* string)
+		{
+			if (length)
+				*length = 0;
+			if (string && bufSize > 0)
+				string[0] = '\0';
+		}
+
+		static GLint IntegerValue(GLenum pname)
+		{
+			switch (pname)
+			{
+			case GL_MAJOR_VERSION:						return 4;
+			case GL_MINOR_VERSION:						return 5;
+			case GL_MAX_LABEL_LENGTH:					return 256;
+			case GL_MAX_COLOR_ATTACHMENTS:				return 8;
+			case GL_MAX_UNIFORM_BUFFER_BINDINGS:		return 36;
+			case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:	return 256;
+			case GL_MAX_VERTEX_ATTRIBS:					return 16;
+			// No binary formats keeps ShaderCache off
+			default:									return 0;
+			}
+		}
+		static GLenum UniformTypeValue(const std::string& type)
+		{
+			static const std::unordered_map<std::string, GLenum> types =
+			{
+				{ "float", GL_FLOAT },				{ "vec2", GL_FLOAT_VEC2 },			{ "vec3", GL_FLOAT_VEC3 },			{ "vec4", GL_FLOAT_VEC4 },
+				{ "double", GL_DOUBLE },			{ "dvec2", GL_DOUBLE_VEC2 },		{ "dvec3", GL_DOUBLE_VEC3 },		{ "dvec4", GL_DOUBLE_VEC4 },
+				{ "int", GL_INT },					{ "ivec2", GL_INT_VEC2 },			{ "ivec3", GL_INT_VEC3 },			{ "ivec4", GL_INT_VEC4 },
+				{ "uint", GL_UNSIGNED_INT },		{ "uvec2", GL_UNSIGNED_INT_VEC2 },	{ "uvec3", GL_UNSIGNED_INT_VEC3 },	{ "uvec4", GL_UNSIGNED_INT_VEC4 },
+				{ "bool", GL_BOOL },				{ "bvec2", GL_BOOL_VEC2 },			{ "bvec3", GL_BOOL_VEC3 },			{ "bvec4", GL_BOOL_VEC4 },
+				{ "mat2", GL_FLOAT_MAT2 },			{ "mat3", GL_FLOAT_MAT3 },			{ "mat4", GL_FLOAT_MAT4 },
+				{ "mat2x2", GL_FLOAT_MAT2 },		{ "mat3x3", GL_FLOAT_MAT3 },		{ "mat4x4", GL_FLOAT_MAT4 },
+				{ "mat2x3", GL_FLOAT_MAT2x3 },		{ "mat2x4", GL_FLOAT_MAT2x4 },		{ "mat3x2", GL_FLOAT_MAT3x2 },
+				{ "mat3x4", GL_FLOAT_MAT3x4 },		{ "mat4x2", GL_FLOAT_MAT4x2 },		{ "mat4x3", GL_FLOAT_MAT4x3 },
+				{ "dmat2", GL_DOUBLE_MAT2 },		{ "dmat3", GL_DOUBLE_MAT3 },		{ "dmat4", GL_DOUBLE_MAT4 },
+				{ "dmat2x3", GL_DOUBLE_MAT2x3 },	{ "dmat2x4", GL_DOUBLE_MAT2x4 },	{ "dmat3x2", GL_DOUBLE_MAT3x2 },
+				{ "dmat3x4", GL_DOUBLE_MAT3x4 },	{ "dmat4x2", GL_DOUBLE_MAT4x2 },	{ "dmat4x3", GL_DOUBLE_MAT4x3 },
+				{ "sampler1D", GL_SAMPLER_1D },					{ "sampler2D", GL_SAMPLER_2D },
+				{ "sampler3D", GL_SAMPLER_3D },					{ "samplerCube", GL_SAMPLER_CUBE },
+				{ "sampler1DShadow", GL_SAMPLER_1D_SHADOW },	{ "sampler2DShadow", GL_SAMPLER_2D_SHADOW },
+				{ "sampler1DArray", GL_SAMPLER_1D_ARRAY },		{ "sampler2DArray", GL_SAMPLER_2D_ARRAY },
+				{ "sampler1DArrayShadow", GL_SAMPLER_1D_ARRAY_SHADOW },	{ "sampler2DArrayShadow", GL_SAMPLER_2D_ARRAY_SHADOW },
+				{ "sampler2DMS", GL_SAMPLER_2D_MULTISAMPLE },	{ "sampler2DMSArray", GL_SAMPLER_2D_MULTISAMPLE_ARRAY },
+				{ "samplerCubeShadow", GL_SAMPLER_CUBE_SHADOW },{ "samplerBuffer", GL_SAMPLER_BUFFER },
+			};
+			auto it = types.find(type);
+			return (it != types.end()) ? it->second : 0;
+		}
+		// Words and single symbols, parenthesis content dropped [layout qualifiers, initializers]
+		static std::vector<std::string> Tokenize(const std::string& text)
+		{
+			std::vector<std::string> tokens;
+			std::string word;
+			int parenthesis = 0;
+			for (char c : text)
+			{
+				if (c == '(' || c == ')')
+				{
+					parenthesis += (c == '(') ? 1 : -1;
+					c = ' ';
+				}
+				else if (parenthesis > 0)
+					continue;
+
+				if (isalnum((unsigned char)c) || c == '_' || c == '.')
+				{
+					word += c;
+					continue;
+				}
+				if (!word.empty())
+				{
+					tokens.push_back(word);
+					word.clear();
+				}
+				if (!isspace((unsigned char)c))
+					tokens.push_back(std::string(1, c));
+			}
+			if (!word.empty())
+				tokens.push_back(word);
+
+			return tokens;
+		}
+		// "uniform [precision] type name[N] [= value], ..." [structs and unknown types are skipped]
+		static void AddUniforms(const std::string& statement, std::vector<StubUniform>& uniforms)
+		{
+			std::vector<std::string> tokens = Tokenize(statement);
+			size_t i = std::find(tokens.begin(), tokens.end(), "uniform") - tokens.begin();
+			if (i == tokens.size())
+				return;
+
+			i++;
+			while (i < tokens.size() && (tokens[i] == "lowp" || tokens[i] == "mediump" || tokens[i] == "highp"))
+				i++;
+			if (i >= tokens.size())
+				return;
+
+			GLenum type = UniformTypeValue(tokens[i++]);
+			if (type == 0)
+				return;
+
+			while (i < tokens.size())
+			{
+				StubUniform uniform = { tokens[i++], type, 1, -1 };
+				if (i + 2 < tokens.size() && tokens[i] == "[" && tokens[i + 2] == "]")
+				{
+					uniform.size = (std::max)(atoi(tokens[i + 1].c_str()), 1);
+					uniform.name += "[0]";
+					i += 3;
+				}
+
+				// Same uniform declared in another stage
+				bool duplicate = false;
+				for (const StubUniform& other : uniforms)
+					duplicate |= (other.name == uniform.name);
+				if (!duplicate)
+					uniforms.push_back(uniform);
+
+				while (i < tokens.size() && tokens[i] != ",")
+					i++;
+				i++;
+			}
+		}
+		// Global scope statements only, uniform blocks and function bodies are skipped
+		static void ParseUniforms(const std::string& source, std::vector<StubUniform>& uniforms)
+		{
+			std::string statement;
+			bool block = false;
+			int depth = 0;
+			for (size_t i = 0; i < source.size(); i++)
+			{
+				char c = source[i];
+
+				// Comments and preprocessor lines
+				if (c == '#' || (c == '/' && i + 1 < source.size() && source[i + 1] == '/'))
+				{
+					i = source.find('\n', i);
+					if (i == std::string::npos)
+						break;
+					continue;
+				}
+				if (c == '/' && i + 1 < source.size() && source[i + 1] == '*')
+				{
+					i = source.find("*/", i + 2);
+					if (i == std::string::npos)
+						break;
+					i++;
+					continue;
+				}
+
+				if (c == '{')
+				{
+					block = true;
+					depth++;
+				}
+				else if (c == '}')
+				{
+					// Function body ended, uniform blocks wait for their ';'
+					std::vector<std::string> tokens = Tokenize(statement);
+					if (--depth == 0 && std::find(tokens.begin(), tokens.end(), "uniform") == tokens.end())
+					{
+						statement.clear();
+						block = false;
+					}
+				}
+				else if (depth > 0)
+					continue;
+				else if (c == ';')
+				{
+					if (!block)
+						AddUniforms(statement, uniforms);
+
+					statement.clear();
+					block = false;
+				}
+				else
+					statement += c;
+			}
+		}
+		static const StubUniform* FindUniform(GLuint program, GLuint index)
+		{
+			auto it = m_programUniforms.find(program);
+			if (it == m_programUniforms.end() || index >= it->second.size())
+				return nullptr;
+
+			return &it->second[index];
+		}
+
+		static const char* StringValue(GLenum name)
+		{
+			switch (name)
+			{
+			case GL_RENDERER:	return GetName();
+			case GL_VERSION:	return "4.5";
+			case GL_VENDOR:		return "VoxelEngine";
+			default:			return "";
+			}
+		}
+
+		// Every GL entry point Graphics.cpp and ImGui's OpenGL3 backend use
+		namespace Stub
+		{
+			static void APIENTRY ActiveTexture(GLenum texture)
+			{
+				Record(CallType::BIND, "glActiveTexture", texture);
+			}
+			static void APIENTRY AttachShader(GLuint program, GLuint shader)
+			{
+				Record(CallType::CREATE, "glAttachShader", program, shader);
+				m_attachedShaders[program].push_back(shader);
+			}
+			static void APIENTRY BeginQuery(GLenum target, GLuint id)
+			{
+				Record(CallType::QUERY, "glBeginQuery", target, id);
+			}
+			static void APIENTRY BindBuffer(GLenum target, GLuint buffer)
+			{
+				Record(CallType::BIND, "glBindBuffer", target, buffer);
+				m_boundBuffers[target] = buffer;
+			}
+			static void APIENTRY BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+			{
+				Record(CallType::BIND, "glBindBufferBase", target, index, buffer);
+			}
+			static void APIENTRY BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+			{
+				Record(CallType::BIND, "glBindBufferRange", target, index, buffer, offset, size);
+			}
+			static void APIENTRY BindFramebuffer(GLenum target, GLuint framebuffer)
+			{
+				Record(CallType::BIND, "glBindFramebuffer", target, framebuffer);
+			}
+			static void APIENTRY BindRenderbuffer(GLenum target, GLuint renderbuffer)
+			{
+				Record(CallType::BIND, "glBindRenderbuffer", target, renderbuffer);
+			}
+			static void APIENTRY BindSampler(GLuint unit, GLuint sampler)
+			{
+				Record(CallType::BIND, "glBindSampler", unit, sampler);
+			}
+			static void APIENTRY BindTexture(GLenum target, GLuint texture)
+			{
+				Record(CallType::BIND, "glBindTexture", target, texture);
+			}
+			static void APIENTRY BindVertexArray(GLuint array)
+			{
+				Record(CallType::BIND, "glBindVertexArray", array);
+			}
+			static void APIENTRY BlendEquation(GLenum mode)
+			{
+				Record(CallType::STATE, "glBlendEquation", mode);
+			}
+			static void APIENTRY BlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha)
+			{
+				Record(CallType::STATE, "glBlendEquationSeparate", modeRGB, modeAlpha);
+			}
+			static void APIENTRY BlendFunc(GLenum sfactor, GLenum dfactor)
+			{
+				Record(CallType::STATE, "glBlendFunc", sfactor, dfactor);
+			}
+			static void APIENTRY BlendFunci(GLuint buf, GLenum src, GLenum dst)
+			{
+				Record(CallType::STATE, "glBlendFunci", buf, src, dst);
+			}
+			static void APIENTRY BlendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha)
+			{
+				Record(CallType::STATE, "glBlendFuncSeparate", sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha);
+			}
+			static void APIENTRY BlitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter)
+			{
+				Record(CallType::DRAW, "glBlitFramebuffer", srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+			}
+			static void APIENTRY BufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage)
+			{
+				Record(CallType::UPLOAD, "glBufferData", target, size, (const void*)data, usage);
+				m_bufferMemory[m_boundBuffers[target]].resize((size_t)size);
+				if (data)
+					m_stats.uploadedBytes += size;
+			}
+			static void APIENTRY BufferStorage(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags)
+			{
+				Record(CallType::UPLOAD, "glBufferStorage", target, size, (const void*)data, flags);
+				m_bufferMemory[m_boundBuffers[target]].resize((size_t)size);
+				if (data)
+					m_stats.uploadedBytes += size;
+			}
+			static void APIENTRY BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data)
+			{
+				Record(CallType::UPLOAD, "glBufferSubData", target, offset, size, (const void*)data);
+				m_stats.uploadedBytes += size;
+			}
+			static GLenum APIENTRY CheckFramebufferStatus(GLenum target)
+			{
+				Record(CallType::QUERY, "glCheckFramebufferStatus", target);
+				return GL_FRAMEBUFFER_COMPLETE;
+			}
+			static void APIENTRY Clear(GLbitfield mask)
+			{
+				Record(CallType::DRAW, "glClear", mask);
+			}
+			static void APIENTRY ClearBufferfv(GLenum buffer, GLint drawbuffer, const GLfloat *value)
+			{
+				Record(CallType::DRAW, "glClearBufferfv", buffer, drawbuffer, (const void*)value);
+			}
+			static void APIENTRY ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+			{
+				Record(CallType::STATE, "glClearColor", red, green, blue, alpha);
+			}
+			static void APIENTRY ClearDepth(GLdouble depth)
+			{
+				Record(CallType::STATE, "glClearDepth", depth);
+			}
+			static void APIENTRY ClearStencil(GLint s)
+			{
+				Record(CallType::STATE, "glClearStencil", s);
+			}
+			static GLenum APIENTRY ClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+			{
+				Record(CallType::QUERY, "glClientWaitSync", sync, flags, timeout);
+				return GL_ALREADY_SIGNALED;
+			}
+			static void APIENTRY ClipControl(GLenum origin, GLenum depth)
+			{
+				Record(CallType::STATE, "glClipControl", origin, depth);
+			}
+			static void APIENTRY CompileShader(GLuint shader)
+			{
+				Record(CallType::CREATE, "glCompileShader", shader);
+			}
+			static void APIENTRY CopyImageSubData(GLuint srcName, GLenum srcTarget, GLint srcLevel, GLint srcX, GLint srcY, GLint srcZ, GLuint dstName, GLenum dstTarget, GLint dstLevel, GLint dstX, GLint dstY, GLint dstZ, GLsizei srcWidth, GLsizei srcHeight, GLsizei srcDepth)
+			{
+				Record(CallType::UPLOAD, "glCopyImageSubData", srcName, srcTarget, srcLevel, srcX, srcY, srcZ, dstName, dstTarget, dstLevel, dstX, dstY, dstZ, srcWidth, srcHeight, srcDepth);
+			}
+			static GLuint APIENTRY CreateProgram(void)
+			{
+				Record(CallType::CREATE, "glCreateProgram");
+				return m_nextName++;
+			}
+			static GLuint APIENTRY CreateShader(GLenum type)
+			{
+				Record(CallType::CREATE, "glCreateShader", type);
+				return m_nextName++;
+			}
+			static void APIENTRY DebugMessageCallback(GLDEBUGPROC callback, const void *userParam)
+			{
+				Record(CallType::CREATE, "glDebugMessageCallback", (const void*)userParam);
+			}
+			static void APIENTRY DebugMessageControl(GLenum source, GLenum type, GLenum severity, GLsizei count, const GLuint *ids, GLboolean enabled)
+			{
+				Record(CallType::CREATE, "glDebugMessageControl", source, type, severity, count, (const void*)ids, enabled);
+			}
+			static void APIENTRY DeleteBuffers(GLsizei n, const GLuint *buffers)
+			{
+				Record(CallType::DESTROY, "glDeleteBuffers", n, (const void*)buffers);
+				for (GLsizei i = 0; i < n; i++)
+					m_bufferMemory.erase(buffers[i]);
+			}
+			static void APIENTRY DeleteFramebuffers(GLsizei n, const GLuint *framebuffers)
+			{
+				Record(CallType::DESTROY, "glDeleteFramebuffers", n, (const void*)framebuffers);
+			}
+			static void APIENTRY DeleteProgram(GLuint program)
+			{
+				Record(CallType::DESTROY, "glDeleteProgram", program);
+				m_attachedShaders.erase(program);
+				m_programUniforms.erase(program);
+			}
+			static void APIENTRY DeleteQueries(GLsizei n, const GLuint *ids)
+			{
+				Record(CallType::DESTROY, "glDeleteQueries", n, (const void*)ids);
+			}
+			static void APIENTRY DeleteRenderbuffers(GLsizei n, const GLuint *renderbuffers)
+			{
+				Record(CallType::DESTROY, "glDeleteRenderbuffers", n, (const void*)renderbuffers);
+			}
+			static void APIENTRY DeleteShader(GLuint shader)
+			{
+				Record(CallType::DESTROY, "glDeleteShader", shader);
+				m_shaderSources.erase(shader);
+			}
+			static void APIENTRY DeleteSync(GLsync sync)
+			{
+				Record(CallType::DESTROY, "glDeleteSync", sync);
+			}
+			static void APIENTRY DeleteTextures(GLsizei n, const GLuint *textures)
+			{
+				Record(CallType::DESTROY, "glDeleteTextures", n, (const void*)textures);
+			}
+			static void APIENTRY DeleteVertexArrays(GLsizei n, const GLuint *arrays)
+			{
+				Record(CallType::DESTROY, "glDeleteVertexArrays", n, (const void*)arrays);
+			}
+			static void APIENTRY DepthFunc(GLenum func)
+			{
+				Record(CallType::STATE, "glDepthFunc", func);
+			}
+			static void APIENTRY DepthMask(GLboolean flag)
+			{
+				Record(CallType::STATE, "glDepthMask", flag);
+			}
+			static void APIENTRY DetachShader(GLuint program, GLuint shader)
+			{
+				Record(CallType::DESTROY, "glDetachShader", program, shader);
+				std::vector<GLuint>& shaders = m_attachedShaders[program];
+				shaders.erase(std::remove(shaders.begin(), shaders.end(), shader), shaders.end());
+			}
+			static void APIENTRY Disable(GLenum cap)
+			{
+				Record(CallType::STATE, "glDisable", cap);
+				m_enabled.erase(cap);
+			}
+			static void APIENTRY DisableVertexAttribArray(GLuint index)
+			{
+				Record(CallType::STATE, "glDisableVertexAttribArray", index);
+			}
+			static void APIENTRY DrawArrays(GLenum mode, GLint first, GLsizei count)
+			{
+				Record(CallType::DRAW, "glDrawArrays", mode, first, count);
+				CountDraw(count, 1);
+			}
+			static void APIENTRY DrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount)
+			{
+				Record(CallType::DRAW, "glDrawArraysInstanced", mode, first, count, instancecount);
+				CountDraw(count, instancecount);
+			}
+			static void APIENTRY DrawBuffers(GLsizei n, const GLenum *bufs)
+			{
+				Record(CallType::STATE, "glDrawBuffers", n, (const void*)bufs);
+			}
+			static void APIENTRY DrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices)
+			{
+				Record(CallType::DRAW, "glDrawElements", mode, count, type, (const void*)indices);
+				CountDraw(count, 1);
+			}
+			static void APIENTRY DrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void *indices, GLint basevertex)
+			{
+				Record(CallType::DRAW, "glDrawElementsBaseVertex", mode, count, type, (const void*)indices, basevertex);
+				CountDraw(count, 1);
+			}
+			static void APIENTRY DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount)
+			{
+				Record(CallType::DRAW, "glDrawElementsInstanced", mode, count, type, (const void*)indices, instancecount);
+				CountDraw(count, instancecount);
+			}
+			static void APIENTRY Enable(GLenum cap)
+			{
+				Record(CallType::STATE, "glEnable", cap);
+				m_enabled.insert(cap);
+			}
+			static void APIENTRY EnableVertexAttribArray(GLuint index)
+			{
+				Record(CallType::STATE, "glEnableVertexAttribArray", index);
+			}
+			static void APIENTRY EndQuery(GLenum target)
+			{
+				Record(CallType::QUERY, "glEndQuery", target);
+			}
+			static GLsync APIENTRY FenceSync(GLenum condition, GLbitfield flags)
+			{
+				Record(CallType::CREATE, "glFenceSync", condition, flags);
+				return (GLsync)(uintptr_t)m_nextName++;
+			}
+			static void APIENTRY FramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+			{
+				Record(CallType::BIND, "glFramebufferRenderbuffer", target, attachment, renderbuffertarget, renderbuffer);
+			}
+			static void APIENTRY FramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+			{
+				Record(CallType::BIND, "glFramebufferTexture2D", target, attachment, textarget, texture, level);
+			}
+			static void APIENTRY FrontFace(GLenum mode)
+			{
+				Record(CallType::STATE, "glFrontFace", mode);
+			}
+			static void APIENTRY GenBuffers(GLsizei n, GLuint *buffers)
+			{
+				Record(CallType::CREATE, "glGenBuffers", n, (const void*)buffers);
+				for (GLsizei i = 0; i < n; i++)
+					buffers[i] = m_nextName++;
+			}
+			static void APIENTRY GenFramebuffers(GLsizei n, GLuint *framebuffers)
+			{
+				Record(CallType::CREATE, "glGenFramebuffers", n, (const void*)framebuffers);
+				for (GLsizei i = 0; i < n; i++)
+					framebuffers[i] = m_nextName++;
+			}
+			static void APIENTRY GenQueries(GLsizei n, GLuint *ids)
+			{
+				Record(CallType::CREATE, "glGenQueries", n, (const void*)ids);
+				for (GLsizei i = 0; i < n; i++)
+					ids[i] = m_nextName++;
+			}
+			static void APIENTRY GenRenderbuffers(GLsizei n, GLuint *renderbuffers)
+			{
+				Record(CallType::CREATE, "glGenRenderbuffers", n, (const void*)renderbuffers);
+				for (GLsizei i = 0; i < n; i++)
+					renderbuffers[i] = m_nextName++;
+			}
+			static void APIENTRY GenTextures(GLsizei n, GLuint *textures)
+			{
+				Record(CallType::CREATE, "glGenTextures", n, (const void*)textures);
+				for (GLsizei i = 0; i < n; i++)
+					textures[i] = m_nextName++;
+			}
+			static void APIENTRY GenVertexArrays(GLsizei n, GLuint *arrays)
+			{
+				Record(CallType::CREATE, "glGenVertexArrays", n, (const void*)arrays);
+				for (GLsizei i = 0; i < n; i++)
+					arrays[i] = m_nextName++;
+			}
+			static void APIENTRY GenerateMipmap(GLenum target)
+			{
+				Record(CallType::UPLOAD, "glGenerateMipmap", target);
+			}
+			static void APIENTRY GetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name)
+			{
+				Record(CallType::QUERY, "glGetActiveAttrib", program, index, bufSize, (const void*)length, (const void*)size, (const void*)type, (const void*)name);
+				EmptyString(bufSize, length, name);
+				if (size) *size = 0;
+				if (type) *type = 0;
+			}
+			static void APIENTRY GetActiveSubroutineName(GLuint program, GLenum shadertype, GLuint index, GLsizei bufsize, GLsizei *length, GLchar *name)
+			{
+				Record(CallType::QUERY, "glGetActiveSubroutineName", program, shadertype, index, bufsize, (const void*)length, (const void*)name);
+				EmptyString(bufsize, length, name);
+			}
+			static void APIENTRY GetActiveSubroutineUniformName(GLuint program, GLenum shadertype, GLuint index, GLsizei bufsize, GLsizei *length, GLchar *name)
+			{
+				Record(CallType::QUERY, "glGetActiveSubroutineUniformName", program, shadertype, index, bufsize, (const void*)length, (const void*)name);
+				EmptyString(bufsize, length, name);
+			}
+			static void APIENTRY GetActiveSubroutineUniformiv(GLuint program, GLenum shadertype, GLuint index, GLenum pname, GLint *values)
+			{
+				Record(CallType::QUERY, "glGetActiveSubroutineUniformiv", program, shadertype, index, pname, (const void*)values);
+				*values = 0;
+			}
+			static void APIENTRY GetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name)
+			{
+				Record(CallType::QUERY, "glGetActiveUniform", program, index, bufSize, (const void*)length, (const void*)size, (const void*)type, (const void*)name);
+				const StubUniform* uniform = FindUniform(program, index);
+				if (!uniform)
+				{
+					EmptyString(bufSize, length, name);
+					if (size) *size = 0;
+					if (type) *type = 0;
+					return;
+				}
+
+				GLsizei count = 0;
+				if (name && bufSize > 0)
+				{
+					count = (GLsizei)(std::min)(uniform->name.size(), (size_t)bufSize - 1);
+					memcpy(name, uniform->name.c_str(), count);
+					name[count] = '\0';
+				}
+				if (length) *length = count;
+				if (size) *size = uniform->size;
+				if (type) *type = uniform->type;
+			}
+			static void APIENTRY GetActiveUniformBlockName(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei *length, GLchar *uniformBlockName)
+			{
+				Record(CallType::QUERY, "glGetActiveUniformBlockName", program, uniformBlockIndex, bufSize, (const void*)length, (const void*)uniformBlockName);
+				EmptyString(bufSize, length, uniformBlockName);
+			}
+			static void APIENTRY GetActiveUniformBlockiv(GLuint program, GLuint uniformBlockIndex, GLenum pname, GLint *params)
+			{
+				Record(CallType::QUERY, "glGetActiveUniformBlockiv", program, uniformBlockIndex, pname, (const void*)params);
+				*params = 0;
+			}
+			static GLint APIENTRY GetAttribLocation(GLuint program, const GLchar *name)
+			{
+				Record(CallType::QUERY, "glGetAttribLocation", program, name);
+				return -1;
+			}
+			static void APIENTRY GetBooleanv(GLenum pname, GLboolean *data)
+			{
+				Record(CallType::QUERY, "glGetBooleanv", pname, (const void*)data);
+				*data = m_enabled.count(pname) ? GL_TRUE : GL_FALSE;
+			}
+			static void APIENTRY GetFloatv(GLenum pname, GLfloat *data)
+			{
+				Record(CallType::QUERY, "glGetFloatv", pname, (const void*)data);
+				*data = (pname == GL_MAX_TEXTURE_MAX_ANISOTROPY) ? 16.0f : 0.0f;
+			}
+			static void APIENTRY GetIntegerv(GLenum pname, GLint *data)
+			{
+				Record(CallType::QUERY, "glGetIntegerv", pname, (const void*)data);
+				*data = IntegerValue(pname);
+
+				// ImGui backs up these before drawing
+				if (pname == GL_VIEWPORT || pname == GL_SCISSOR_BOX)
+					data[1] = data[2] = data[3] = 0;
+				else if (pname == GL_POLYGON_MODE)
+					data[1] = 0;
+			}
+			static void APIENTRY GetProgramBinary(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary)
+			{
+				Record(CallType::QUERY, "glGetProgramBinary", program, bufSize, (const void*)length, (const void*)binaryFormat, (const void*)binary);
+				if (length) *length = 0;
+				if (binaryFormat) *binaryFormat = 0;
+			}
+			static void APIENTRY GetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+			{
+				Record(CallType::QUERY, "glGetProgramInfoLog", program, bufSize, (const void*)length, (const void*)infoLog);
+				EmptyString(bufSize, length, infoLog);
+			}
+			static void APIENTRY GetProgramStageiv(GLuint program, GLenum shadertype, GLenum pname, GLint *values)
+			{
+				Record(CallType::QUERY, "glGetProgramStageiv", program, shadertype, pname, (const void*)values);
+				*values = 0;
+			}
+			static void APIENTRY GetProgramiv(GLuint program, GLenum pname, GLint *params)
+			{
+				Record(CallType::QUERY, "glGetProgramiv", program, pname, (const void*)params);
+				*params = (pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS) ? GL_TRUE : 0;
+
+				if (pname == GL_ACTIVE_UNIFORMS || pname == GL_ACTIVE_UNIFORM_MAX_LENGTH)
+				{
+					auto it = m_programUniforms.find(program);
+					if (it == m_programUniforms.end())
+						return;
+
+					if (pname == GL_ACTIVE_UNIFORMS)
+						*params = (GLint)it->second.size();
+					else
+					{
+						for (const StubUniform& uniform : it->second)
+							*params = (std::max)(*params, (GLint)uniform.name.size() + 1);
+					}
+				}
+			}
+			static void APIENTRY GetQueryObjectiv(GLuint id, GLenum pname, GLint *params)
+			{
+				Record(CallType::QUERY, "glGetQueryObjectiv", id, pname, (const void*)params);
+				*params = (pname == GL_QUERY_RESULT_AVAILABLE) ? GL_TRUE : 0;
+			}
+			static void APIENTRY GetQueryObjectui64v(GLuint id, GLenum pname, GLuint64 *params)
+			{
+				Record(CallType::QUERY, "glGetQueryObjectui64v", id, pname, (const void*)params);
+				*params = 0;
+			}
+			static void APIENTRY GetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+			{
+				Record(CallType::QUERY, "glGetShaderInfoLog", shader, bufSize, (const void*)length, (const void*)infoLog);
+				EmptyString(bufSize, length, infoLog);
+			}
+			static void APIENTRY GetShaderiv(GLuint shader, GLenum pname, GLint *params)
+			{
+				Record(CallType::QUERY, "glGetShaderiv", shader, pname, (const void*)params);
+				*params = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0;
+			}
+			static const GLubyte* APIENTRY GetString(GLenum name)
+			{
+				Record(CallType::QUERY, "glGetString", name);
+				return (const GLubyte*)StringValue(name);
+			}
+			static GLuint APIENTRY GetSubroutineIndex(GLuint program, GLenum shadertype, const GLchar *name)
+			{
+				Record(CallType::QUERY, "glGetSubroutineIndex", program, shadertype, name);
+				return GL_INVALID_INDEX;
+			}
+			static GLint APIENTRY GetSubroutineUniformLocation(GLuint program, GLenum shadertype, const GLchar *name)
+			{
+				Record(CallType::QUERY, "glGetSubroutineUniformLocation", program, shadertype, name);
+				return -1;
+			}
+			static void APIENTRY GetTextureSubImage(GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, GLsizei bufSize, void *pixels)
+			{
+				Record(CallType::QUERY, "glGetTextureSubImage", texture, level, xoffset, yoffset, zoffset, width, height, depth, format, type, bufSize, (const void*)pixels);
+			}
+			static GLuint APIENTRY GetUniformBlockIndex(GLuint program, const GLchar *uniformBlockName)
+			{
+				Record(CallType::QUERY, "glGetUniformBlockIndex", program, uniformBlockName);
+				return GL_INVALID_INDEX;
+			}
+			static GLint APIENTRY GetUniformLocation(GLuint program, const GLchar *name)
+			{
+				Record(CallType::QUERY, "glGetUniformLocation", program, name);
+				auto it = m_programUniforms.find(program);
+				if (it == m_programUniforms.end() || !name)
+					return -1;
+
+				// "name", "name[0]" or "name[N]" for arrays
+				std::string base = name;
+				GLint element = 0;
+				size_t bracket = base.find('[');
+				if (bracket != std::string::npos)
+				{
+					element = atoi(base.c_str() + bracket + 1);
+					base.resize(bracket);
+				}
+
+				for (const StubUniform& uniform : it->second)
+				{
+					if (uniform.name == base && element == 0)
+						return uniform.location;
+					if (uniform.size > 1 && uniform.name.compare(0, base.size(), base) == 0 && uniform.name.size() == base.size() + 3 && element < uniform.size)
+						return uniform.location + element;
+				}
+				return -1;
+			}
+			static void APIENTRY GetUniformdv(GLuint program, GLint location, GLdouble *params)
+			{
+				Record(CallType::QUERY, "glGetUniformdv", program, location, (const void*)params);
+			}
+			static void APIENTRY GetUniformfv(GLuint program, GLint location, GLfloat *params)
+			{
+				Record(CallType::QUERY, "glGetUniformfv", program, location, (const void*)params);
+			}
+			static void APIENTRY GetUniformiv(GLuint program, GLint location, GLint *params)
+			{
+				Record(CallType::QUERY, "glGetUniformiv", program, location, (const void*)params);
+			}
+			static void APIENTRY GetUniformuiv(GLuint program, GLint location, GLuint *params)
+			{
+				Record(CallType::QUERY, "glGetUniformuiv", program, location, (const void*)params);
+			}
+			static GLboolean APIENTRY IsEnabled(GLenum cap)
+			{
+				Record(CallType::QUERY, "glIsEnabled", cap);
+				return m_enabled.count(cap) ? GL_TRUE : GL_FALSE;
+			}
+			static void APIENTRY LineWidth(GLfloat width)
+			{
+				Record(CallType::STATE, "glLineWidth", width);
+			}
+			static void APIENTRY LinkProgram(GLuint program)
+			{
+				Record(CallType::CREATE, "glLinkProgram", program);
+
+				std::vector<StubUniform>& uniforms = m_programUniforms[program];
+				uniforms.clear();
+				for (GLuint shader : m_attachedShaders[program])
+					ParseUniforms(m_shaderSources[shader], uniforms);
+
+				// Arrays take one location per element
+				GLint location = 0;
+				for (StubUniform& uniform : uniforms)
+				{
+					uniform.location = location;
+					location += uniform.size;
+				}
+			}
+			static void* APIENTRY MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+			{
+				Record(CallType::UPLOAD, "glMapBufferRange", target, offset, length, access);
+				// Writes through the pointer land in memory owned by the fake buffer
+				std::vector<uint8_t>& memory = m_bufferMemory[m_boundBuffers[target]];
+				if (memory.size() < (size_t)(offset + length))
+					memory.resize((size_t)(offset + length));
+				return memory.data() + offset;
+			}
+			static void APIENTRY ObjectLabel(GLenum identifier, GLuint name, GLsizei length, const GLchar *label)
+			{
+				Record(CallType::CREATE, "glObjectLabel", identifier, name, length, label);
+			}
+			static void APIENTRY PixelStorei(GLenum pname, GLint param)
+			{
+				Record(CallType::STATE, "glPixelStorei", pname, param);
+			}
+			static void APIENTRY PolygonMode(GLenum face, GLenum mode)
+			{
+				Record(CallType::STATE, "glPolygonMode", face, mode);
+			}
+			static void APIENTRY ProgramBinary(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length)
+			{
+				Record(CallType::CREATE, "glProgramBinary", program, binaryFormat, (const void*)binary, length);
+			}
+			static void APIENTRY ProgramParameteri(GLuint program, GLenum pname, GLint value)
+			{
+				Record(CallType::CREATE, "glProgramParameteri", program, pname, value);
+			}
+			static void APIENTRY QueryCounter(GLuint id, GLenum target)
+			{
+				Record(CallType::QUERY, "glQueryCounter", id, target);
+			}
+			static void APIENTRY ReadBuffer(GLenum src)
+			{
+				Record(CallType::STATE, "glReadBuffer", src);
+			}
+			static void APIENTRY ReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void *pixels)
+			{
+				Record(CallType::QUERY, "glReadPixels", x, y, width, height, format, type, (const void*)pixels);
+			}
+			static void APIENTRY RenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+			{
+				Record(CallType::UPLOAD, "glRenderbufferStorage", target, internalformat, width, height);
+			}
+			static void APIENTRY Scissor(GLint x, GLint y, GLsizei width, GLsizei height)
+			{
+				Record(CallType::STATE, "glScissor", x, y, width, height);
+			}
+			static void APIENTRY ShaderSource(GLuint shader, GLsizei count, const GLchar *const* string, const GLint *length)
+			{
+				Record(CallType::CREATE, "glShaderSource", shader, count, (const void*)string, (const void*)length);
+
+				std::string& source = m_shaderSources[shader];
+				source.clear();
+				for (GLsizei i = 0; i < count; i++)
+				{
+					if (length && length[i] >= 0)
+						source.append(string[i], length[i]);
+					else
+						source.append(string[i]);
+				}
+			}
+			static void APIENTRY TexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels)
+			{
+				Record(CallType::UPLOAD, "glTexImage2D", target, level, internalformat, width, height, border, format, type, (const void*)pixels);
+			}
+			static void APIENTRY TexParameterf(GLenum target, GLenum pname, GLfloat param)
+			{
+				Record(CallType::STATE, "glTexParameterf", target, pname, param);
+			}
+			static void APIENTRY TexParameterfv(GLenum target, GLenum pname, const GLfloat *params)
+			{
+				Record(CallType::STATE, "glTexParameterfv", target, pname, (const void*)params);
+			}
+			static void APIENTRY TexParameteri(GLenum target, GLenum pname, GLint param)
+			{
+				Record(CallType::STATE, "glTexParameteri", target, pname, param);
+			}
+			static void APIENTRY TexStorage2D(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height)
+			{
+				Record(CallType::UPLOAD, "glTexStorage2D", target, levels, internalformat, width, height);
+			}
+			static void APIENTRY TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels)
+			{
+				Record(CallType::UPLOAD, "glTexSubImage2D", target, level, xoffset, yoffset, width, height, format, type, (const void*)pixels);
+			}
+			static void APIENTRY Uniform1d(GLint location, GLdouble x)
+			{
+				Record(CallType::UNIFORM, "glUniform1d", location, x);
+			}
+			static void APIENTRY Uniform1f(GLint location, GLfloat v0)
+			{
+				Record(CallType::UNIFORM, "glUniform1f", location, v0);
+			}
+			static void APIENTRY Uniform1i(GLint location, GLint v0)
+			{
+				Record(CallType::UNIFORM, "glUniform1i", location, v0);
+			}
+			static void APIENTRY Uniform1ui(GLint location, GLuint v0)
+			{
+				Record(CallType::UNIFORM, "glUniform1ui", location, v0);
+			}
+			static void APIENTRY Uniform2d(GLint location, GLdouble x, GLdouble y)
+			{
+				Record(CallType::UNIFORM, "glUniform2d", location, x, y);
+			}
+			static void APIENTRY Uniform2f(GLint location, GLfloat v0, GLfloat v1)
+			{
+				Record(CallType::UNIFORM, "glUniform2f", location, v0, v1);
+			}
+			static void APIENTRY Uniform2i(GLint location, GLint v0, GLint v1)
+			{
+				Record(CallType::UNIFORM, "glUniform2i", location, v0, v1);
+			}
+			static void APIENTRY Uniform2ui(GLint location, GLuint v0, GLuint v1)
+			{
+				Record(CallType::UNIFORM, "glUniform2ui", location, v0, v1);
+			}
+			static void APIENTRY Uniform3d(GLint location, GLdouble x, GLdouble y, GLdouble z)
+			{
+				Record(CallType::UNIFORM, "glUniform3d", location, x, y, z);
+			}
+			static void APIENTRY Uniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+			{
+				Record(CallType::UNIFORM, "glUniform3f", location, v0, v1, v2);
+			}
+			static void APIENTRY Uniform3i(GLint location, GLint v0, GLint v1, GLint v2)
+			{
+				Record(CallType::UNIFORM, "glUniform3i", location, v0, v1, v2);
+			}
+			static void APIENTRY Uniform3ui(GLint location, GLuint v0, GLuint v1, GLuint v2)
+			{
+				Record(CallType::UNIFORM, "glUniform3ui", location, v0, v1, v2);
+			}
+			static void APIENTRY Uniform4d(GLint location, GLdouble x, GLdouble y, GLdouble z, GLdouble w)
+			{
+				Record(CallType::UNIFORM, "glUniform4d", location, x, y, z, w);
+			}
+			static void APIENTRY Uniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+			{
+				Record(CallType::UNIFORM, "glUniform4f", location, v0, v1, v2, v3);
+			}
+			static void APIENTRY Uniform4i(GLint location, GLint v0, GLint v1, GLint v2, GLint v3)
+			{
+				Record(CallType::UNIFORM, "glUniform4i", location, v0, v1, v2, v3);
+			}
+			static void APIENTRY Uniform4ui(GLint location, GLuint v0, GLuint v1, GLuint v2, GLuint v3)
+			{
+				Record(CallType::UNIFORM, "glUniform4ui", location, v0, v1, v2, v3);
+			}
+			static void APIENTRY UniformBlockBinding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding)
+			{
+				Record(CallType::BIND, "glUniformBlockBinding", program, uniformBlockIndex, uniformBlockBinding);
+			}
+			static void APIENTRY UniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value)
+			{
+				Record(CallType::UNIFORM, "glUniformMatrix2fv", location, count, transpose, (const void*)value);
+			}
+			static void APIENTRY UniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value)
+			{
+				Record(CallType::UNIFORM, "glUniformMatrix3fv", location, count, transpose, (const void*)value);
+			}
+			static void APIENTRY UniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value)
+			{
+				Record(CallType::UNIFORM, "glUniformMatrix4fv", location, count, transpose, (const void*)value);
+			}
+			static void APIENTRY UniformSubroutinesuiv(GLenum shadertype, GLsizei count, const GLuint *indices)
+			{
+				Record(CallType::BIND, "glUniformSubroutinesuiv", shadertype, count, (const void*)indices);
+			}
+			static void APIENTRY UseProgram(GLuint program)
+			{
+				Record(CallType::BIND, "glUseProgram", program);
+			}
+			static void APIENTRY ValidateProgram(GLuint program)
+			{
+				Record(CallType::CREATE, "glValidateProgram", program);
+			}
+			static void APIENTRY VertexAttribDivisor(GLuint index, GLuint divisor)
+			{
+				Record(CallType::STATE, "glVertexAttribDivisor", index, divisor);
+			}
+			static void APIENTRY VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer)
+			{
+				Record(CallType::STATE, "glVertexAttribPointer", index, size, type, normalized, stride, (const void*)pointer);
+			}
+			static void APIENTRY Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+			{
+				Record(CallType::STATE, "glViewport", x, y, width, height);
+			}
+		}
+
+		void Install(void)
+		{
+			m_nextName = 1;
+			m_boundBuffers.clear();
+			m_bufferMemory.clear();
+			m_enabled.clear();
+
+			gl3wProcs.gl.ActiveTexture = Stub::ActiveTexture;
+			gl3wProcs.gl.AttachShader = Stub::AttachShader;
+			gl3wProcs.gl.BeginQuery = Stub::BeginQuery;
+			gl3wProcs.gl.BindBuffer = Stub::BindBuffer;
+			gl3wProcs.gl.BindBufferBase = Stub::BindBufferBase;
+			gl3wProcs.gl.BindBufferRange = Stub::BindBufferRange;
+			gl3wProcs.gl.BindFramebuffer = Stub::BindFramebuffer;
+			gl3wProcs.gl.BindRenderbuffer = Stub::BindRenderbuffer;
+			gl3wProcs.gl.BindSampler = Stub::BindSampler;
+			gl3wProcs.gl.BindTexture = Stub::BindTexture;
+			gl3wProcs.gl.BindVertexArray = Stub::BindVertexArray;
+			gl3wProcs.gl.BlendEquation = Stub::BlendEquation;
+			gl3wProcs.gl.BlendEquationSeparate = Stub::BlendEquationSeparate;
+			gl3wProcs.gl.BlendFunc = Stub::BlendFunc;
+			gl3wProcs.gl.BlendFunci = Stub::BlendFunci;
+			gl3wProcs.gl.BlendFuncSeparate = Stub::BlendFuncSeparate;
+			gl3wProcs.gl.BlitFramebuffer = Stub::BlitFramebuffer;
+			gl3wProcs.gl.BufferData = Stub::BufferData;
+			gl3wProcs.gl.BufferStorage = Stub::BufferStorage;
+			gl3wProcs.gl.BufferSubData = Stub::BufferSubData;
+			gl3wProcs.gl.CheckFramebufferStatus = Stub::CheckFramebufferStatus;
+			gl3wProcs.gl.Clear = Stub::Clear;
+			gl3wProcs.gl.ClearBufferfv = Stub::ClearBufferfv;
+			gl3wProcs.gl.ClearColor = Stub::ClearColor;
+			gl3wProcs.gl.ClearDepth = Stub::ClearDepth;
+			gl3wProcs.gl.ClearStencil = Stub::ClearStencil;
+			gl3wProcs.gl.ClientWaitSync = Stub::ClientWaitSync;
+			gl3wProcs.gl.ClipControl = Stub::ClipControl;
+			gl3wProcs.gl.CompileShader = Stub::CompileShader;
+			gl3wProcs.gl.CopyImageSubData = Stub::CopyImageSubData;
+			gl3wProcs.gl.CreateProgram = Stub::CreateProgram;
+			gl3wProcs.gl.CreateShader = Stub::CreateShader;
+			gl3wProcs.gl.DebugMessageCallback = Stub::DebugMessageCallback;
+			gl3wProcs.gl.DebugMessageControl = Stub::DebugMessageControl;
+			gl3wProcs.gl.DeleteBuffers = Stub::DeleteBuffers;
+			gl3wProcs.gl.DeleteFramebuffers = Stub::DeleteFramebuffers;
+			gl3wProcs.gl.DeleteProgram = Stub::DeleteProgram;
+			gl3wProcs.gl.DeleteQueries = Stub::DeleteQueries;
+			gl3wProcs.gl.DeleteRenderbuffers = Stub::DeleteRenderbuffers;
+			gl3wProcs.gl.DeleteShader = Stub::DeleteShader;
+			gl3wProcs.gl.DeleteSync = Stub::DeleteSync;
+			gl3wProcs.gl.DeleteTextures = Stub::DeleteTextures;
+			gl3wProcs.gl.DeleteVertexArrays = Stub::DeleteVertexArrays;
+			gl3wProcs.gl.DepthFunc = Stub::DepthFunc;
+			gl3wProcs.gl.DepthMask = Stub::DepthMask;
+			gl3wProcs.gl.DetachShader = Stub::DetachShader;
+			gl3wProcs.gl.Disable = Stub::Disable;
+			gl3wProcs.gl.DisableVertexAttribArray = Stub::DisableVertexAttribArray;
+			gl3wProcs.gl.DrawArrays = Stub::DrawArrays;
+			gl3wProcs.gl.DrawArraysInstanced = Stub::DrawArraysInstanced;
+			gl3wProcs.gl.DrawBuffers = Stub::DrawBuffers;
+			gl3wProcs.gl.DrawElements = Stub::DrawElements;
+			gl3wProcs.gl.DrawElementsBaseVertex = Stub::DrawElementsBaseVertex;
+			gl3wProcs.gl.DrawElementsInstanced = Stub::DrawElementsInstanced;
+			gl3wProcs.gl.Enable = Stub::Enable;
+			gl3wProcs.gl.EnableVertexAttribArray = Stub::EnableVertexAttribArray;
+			gl3wProcs.gl.EndQuery = Stub::EndQuery;
+			gl3wProcs.gl.FenceSync = Stub::FenceSync;
+			gl3wProcs.gl.FramebufferRenderbuffer = Stub::FramebufferRenderbuffer;
+			gl3wProcs.gl.FramebufferTexture2D = Stub::FramebufferTexture2D;
+			gl3wProcs.gl.FrontFace = Stub::FrontFace;
+			gl3wProcs.gl.GenBuffers = Stub::GenBuffers;
+			gl3wProcs.gl.GenFramebuffers = Stub::GenFramebuffers;
+			gl3wProcs.gl.GenQueries = Stub::GenQueries;
+			gl3wProcs.gl.GenRenderbuffers = Stub::GenRenderbuffers;
+			gl3wProcs.gl.GenTextures = Stub::GenTextures;
+			gl3wProcs.gl.GenVertexArrays = Stub::GenVertexArrays;
+			gl3wProcs.gl.GenerateMipmap = Stub::GenerateMipmap;
+			gl3wProcs.gl.GetActiveAttrib = Stub::GetActiveAttrib;
+			gl3wProcs.gl.GetActiveSubroutineName = Stub::GetActiveSubroutineName;
+			gl3wProcs.gl.GetActiveSubroutineUniformName = Stub::GetActiveSubroutineUniformName;
+			gl3wProcs.gl.GetActiveSubroutineUniformiv = Stub::GetActiveSubroutineUniformiv;
+			gl3wProcs.gl.GetActiveUniform = Stub::GetActiveUniform;
+			gl3wProcs.gl.GetActiveUniformBlockName = Stub::GetActiveUniformBlockName;
+			gl3wProcs.gl.GetActiveUniformBlockiv = Stub::GetActiveUniformBlockiv;
+			gl3wProcs.gl.GetAttribLocation = Stub::GetAttribLocation;
+			gl3wProcs.gl.GetBooleanv = Stub::GetBooleanv;
+			gl3wProcs.gl.GetFloatv = Stub::GetFloatv;
+			gl3wProcs.gl.GetIntegerv = Stub::GetIntegerv;
+			gl3wProcs.gl.GetProgramBinary = Stub::GetProgramBinary;
+			gl3wProcs.gl.GetProgramInfoLog = Stub::GetProgramInfoLog;
+			gl3wProcs.gl.GetProgramStageiv = Stub::GetProgramStageiv;
+			gl3wProcs.gl.GetProgramiv = Stub::GetProgramiv;
+			gl3wProcs.gl.GetQueryObjectiv = Stub::GetQueryObjectiv;
+			gl3wProcs.gl.GetQueryObjectui64v = Stub::GetQueryObjectui64v;
+			gl3wProcs.gl.GetShaderInfoLog = Stub::GetShaderInfoLog;
+			gl3wProcs.gl.GetShaderiv = Stub::GetShaderiv;
+			gl3wProcs.gl.GetString = Stub::GetString;
+			gl3wProcs.gl.GetSubroutineIndex = Stub::GetSubroutineIndex;
+			gl3wProcs.gl.GetSubroutineUniformLocation = Stub::GetSubroutineUniformLocation;
+			gl3wProcs.gl.GetTextureSubImage = Stub::GetTextureSubImage;
+			gl3wProcs.gl.GetUniformBlockIndex = Stub::GetUniformBlockIndex;
+			gl3wProcs.gl.GetUniformLocation = Stub::GetUniformLocation;
+			gl3wProcs.gl.GetUniformdv = Stub::GetUniformdv;
+			gl3wProcs.gl.GetUniformfv = Stub::GetUniformfv;
+			gl3wProcs.gl.GetUniformiv = Stub::GetUniformiv;
+			gl3wProcs.gl.GetUniformuiv = Stub::GetUniformuiv;
+			gl3wProcs.gl.IsEnabled = Stub::IsEnabled;
+			gl3wProcs.gl.LineWidth = Stub::LineWidth;
+			gl3wProcs.gl.LinkProgram = Stub::LinkProgram;
+			gl3wProcs.gl.MapBufferRange = Stub::MapBufferRange;
+			gl3wProcs.gl.ObjectLabel = Stub::ObjectLabel;
+			gl3wProcs.gl.PixelStorei = Stub::PixelStorei;
+			gl3wProcs.gl.PolygonMode = Stub::PolygonMode;
+			gl3wProcs.gl.ProgramBinary = Stub::ProgramBinary;
+			gl3wProcs.gl.ProgramParameteri = Stub::ProgramParameteri;
+			gl3wProcs.gl.QueryCounter = Stub::QueryCounter;
+			gl3wProcs.gl.ReadBuffer = Stub::ReadBuffer;
+			gl3wProcs.gl.ReadPixels = Stub::ReadPixels;
+			gl3wProcs.gl.RenderbufferStorage = Stub::RenderbufferStorage;
+			gl3wProcs.gl.Scissor = Stub::Scissor;
+			gl3wProcs.gl.ShaderSource = Stub::ShaderSource;
+			gl3wProcs.gl.TexImage2D = Stub::TexImage2D;
+			gl3wProcs.gl.TexParameterf = Stub::TexParameterf;
+			gl3wProcs.gl.TexParameterfv = Stub::TexParameterfv;
+			gl3wProcs.gl.TexParameteri = Stub::TexParameteri;
+			gl3wProcs.gl.TexStorage2D = Stub::TexStorage2D;
+			gl3wProcs.gl.TexSubImage2D = Stub::TexSubImage2D;
+			gl3wProcs.gl.Uniform1d = Stub::Uniform1d;
+			gl3wProcs.gl.Uniform1f = Stub::Uniform1f;
+			gl3wProcs.gl.Uniform1i = Stub::Uniform1i;
+			gl3wProcs.gl.Uniform1ui = Stub::Uniform1ui;
+			gl3wProcs.gl.Uniform2d = Stub::Uniform2d;
+			gl3wProcs.gl.Uniform2f = Stub::Uniform2f;
+			gl3wProcs.gl.Uniform2i = Stub::Uniform2i;
+			gl3wProcs.gl.Uniform2ui = Stub::Uniform2ui;
+			gl3wProcs.gl.Uniform3d = Stub::Uniform3d;
+			gl3wProcs.gl.Uniform3f = Stub::Uniform3f;
+			gl3wProcs.gl.Uniform3i = Stub::Uniform3i;
+			gl3wProcs.gl.Uniform3ui = Stub::Uniform3ui;
+			gl3wProcs.gl.Uniform4d = Stub::Uniform4d;
+			gl3wProcs.gl.Uniform4f = Stub::Uniform4f;
+			gl3wProcs.gl.Uniform4i = Stub::Uniform4i;
+			gl3wProcs.gl.Uniform4ui = Stub::Uniform4ui;
+			gl3wProcs.gl.UniformBlockBinding = Stub::UniformBlockBinding;
+			gl3wProcs.gl.UniformMatrix2fv = Stub::UniformMatrix2fv;
+			gl3wProcs.gl.UniformMatrix3fv = Stub::UniformMatrix3fv;
+			gl3wProcs.gl.UniformMatrix4fv = Stub::UniformMatrix4fv;
+			gl3wProcs.gl.UniformSubroutinesuiv = Stub::UniformSubroutinesuiv;
+			gl3wProcs.gl.UseProgram = Stub::UseProgram;
+			gl3wProcs.gl.ValidateProgram = Stub::ValidateProgram;
+			gl3wProcs.gl.VertexAttribDivisor = Stub::VertexAttribDivisor;
+			gl3wProcs.gl.VertexAttribPointer = Stub::VertexAttribPointer;
+			gl3wProcs.gl.Viewport = Stub::Viewport;
+		}
+#else
+		void Install(void)
+		{
+		}
+#endif
+
+		const char* GetName(void)
+		{
+#if defined(GLOBAL_GRAPHICS_RECORDING)
+			return "Recording";
+#elif defined(GLOBAL_GRAPHICS_NULL)
+			return "Null";
+#else
+			return "OpenGL";
+#endif
+		}
+		bool IsHardware(void)
+		{
+#ifdef GLOBAL_GRAPHICS_NULL
+			return false;
+#else
+			return true;
+#endif
+		}
+
+		const Stats& GetStats(void)
+		{
+			return m_stats;
+		}
+		void ResetStats(void)
+		{
+			m_stats = Stats();
+		}
+
+		const std::vector<std::string>& GetRecording(void)
+		{
+			return m_recording;
+		}
+		void ClearRecording(void)
+		{
+			m_recording.clear();
+		}
+		bool SaveRecording(const std::string& filePath)
+		{
+			std::ofstream file(filePath);
+			if (!file.is_open())
+				return false;
+
+			for (const std::string& call : m_recording)
+				file << call << '\n';
+
+			return true;
+		}
+	}
+}
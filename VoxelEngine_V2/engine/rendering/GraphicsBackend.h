@@ -0,0 +1,65 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "../utilities/Macros.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace Vxl
+{
+	// Which driver Graphics:: calls end up in, picked at build time [GLOBAL_GRAPHICS_NULL / GLOBAL_GRAPHICS_RECORDING]
+	// Null and recording replace the gl3w entry points Graphics uses with stubs, Graphics' own state caching
+	// still runs so the counts below are what a real driver would have received
+	// Programs report the uniforms declared in their shader source [not uniform blocks], so uniform sends are counted too
+	namespace GraphicsBackend
+	{
+		enum class CallType
+		{
+			STATE,		// Enable, Blend, Depth, Viewport, VertexAttrib, TexParameter...
+			BIND,		// Bind*, UseProgram, ActiveTexture, Framebuffer attachments
+			DRAW,		// Draw*, Clear, Blit
+			UPLOAD,		// Buffer/Texture storage and data, Map, Mipmaps
+			UNIFORM,	// Uniform*
+			CREATE,		// Gen*, Create*, Shader/Program building
+			DESTROY,	// Delete*, Detach
+			QUERY,		// Get*, Queries, Fences, ReadPixels
+			OTHER,
+
+			TOTAL
+		};
+
+		struct Stats
+		{
+			uint32_t calls[(int)CallType::TOTAL] = {};
+			uint64_t drawnVertices = 0;		// Vertices or indices, times instances
+			uint64_t drawnInstances = 0;
+			uint64_t uploadedBytes = 0;		// Buffer data only
+
+			inline uint32_t get(CallType type) const
+			{
+				return calls[(int)type];
+			}
+			uint32_t total(void) const;
+		};
+
+		// "OpenGL", "Null" or "Recording"
+		const char* GetName(void);
+		// False if calls never reach a driver
+		bool IsHardware(void);
+
+		// Null and Recording only, replaces gl3wInit
+		void Install(void);
+
+		// Counted since the last reset [always empty for OpenGL]
+		const Stats& GetStats(void);
+		void ResetStats(void);
+
+		// Recording only, one line per call with its arguments [ex: "glBindTexture(3553, 4)"]
+		// RenderManager::Draw clears it with the stats, so it never holds more than a frame
+		const std::vector<std::string>& GetRecording(void);
+		void ClearRecording(void);
+		bool SaveRecording(const std::string& filePath);
+	}
+}
@@ -0,0 +1,463 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "MaterialParameters.h"
+
+#include "../utilities/Logger.h"
+
+#include <algorithm>
+
+#undef max
+#undef min
+
+namespace Vxl
+{
+	struct ParameterTypeInfo
+	{
+		const char*	name;
+		UniformType	type;
+		uint32_t	components;
+	};
+	static const ParameterTypeInfo ParameterTypes[] =
+	{
+		{ "float",	UniformType::FLOAT,				1 },
+		{ "vec2",	UniformType::FLOAT_VEC2,		2 },
+		{ "vec3",	UniformType::FLOAT_VEC3,		3 },
+		{ "vec4",	UniformType::FLOAT_VEC4,		4 },
+		{ "int",	UniformType::INT,				1 },
+		{ "ivec2",	UniformType::INT_VEC2,			2 },
+		{ "ivec3",	UniformType::INT_VEC3,			3 },
+		{ "ivec4",	UniformType::INT_VEC4,			4 },
+		{ "uint",	UniformType::UNSIGNED_INT,		1 },
+		{ "uvec2",	UniformType::UNSIGNED_INT_VEC2,	2 },
+		{ "uvec3",	UniformType::UNSIGNED_INT_VEC3,	3 },
+		{ "uvec4",	UniformType::UNSIGNED_INT_VEC4,	4 },
+		{ "bool",	UniformType::BOOL,				1 },
+		{ "bvec2",	UniformType::BOOL_VEC2,			2 },
+		{ "bvec3",	UniformType::BOOL_VEC3,			3 },
+		{ "bvec4",	UniformType::BOOL_VEC4,			4 },
+		{ "mat2",	UniformType::FLOAT_MAT2,		2 },
+		{ "mat3",	UniformType::FLOAT_MAT3,		3 },
+		{ "mat4",	UniformType::FLOAT_MAT4,		4 }
+	};
+
+	static const ParameterTypeInfo* FindParameterType(const std::string& name)
+	{
+		for (const ParameterTypeInfo& info : ParameterTypes)
+		{
+			if (name == info.name)
+				return &info;
+		}
+		return nullptr;
+	}
+	static const ParameterTypeInfo* FindParameterType(UniformType type)
+	{
+		for (const ParameterTypeInfo& info : ParameterTypes)
+		{
+			if (type == info.type)
+				return &info;
+		}
+		return nullptr;
+	}
+	static bool IsMatrix(UniformType type)
+	{
+		return type == UniformType::FLOAT_MAT2 || type == UniformType::FLOAT_MAT3 || type == UniformType::FLOAT_MAT4;
+	}
+
+	// Writes a single component [bools and ints are parsed from the same text]
+	static bool WriteComponent(uint8_t* destination, UniformType type, const std::string& text)
+	{
+		const ParameterTypeInfo* info = FindParameterType(type);
+		UniformType scalar = IsMatrix(type) ? UniformType::FLOAT : (UniformType)((uint32_t)type - (info->components - 1));
+
+		try
+		{
+			switch (scalar)
+			{
+			case UniformType::FLOAT:
+				ParameterScalar<float>::Write(destination, std::stof(text));
+				return true;
+			case UniformType::INT:
+				ParameterScalar<int>::Write(destination, std::stoi(text));
+				return true;
+			case UniformType::UNSIGNED_INT:
+				ParameterScalar<uint32_t>::Write(destination, (uint32_t)std::stoul(text));
+				return true;
+			case UniformType::BOOL:
+				if (text == "true" || text == "false")
+					ParameterScalar<bool>::Write(destination, text == "true");
+				else
+					ParameterScalar<bool>::Write(destination, std::stof(text) != 0.0f);
+				return true;
+			default:
+				return false;
+			}
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
+
+	// ~ Layout ~ //
+	uint32_t ParameterLayout::GetAlignment(UniformType type)
+	{
+		switch (type)
+		{
+		case UniformType::FLOAT:
+		case UniformType::INT:
+		case UniformType::UNSIGNED_INT:
+		case UniformType::BOOL:
+			return 4;
+		case UniformType::FLOAT_VEC2:
+		case UniformType::INT_VEC2:
+		case UniformType::UNSIGNED_INT_VEC2:
+		case UniformType::BOOL_VEC2:
+			return 8;
+		case UniformType::FLOAT_VEC3:
+		case UniformType::INT_VEC3:
+		case UniformType::UNSIGNED_INT_VEC3:
+		case UniformType::BOOL_VEC3:
+		case UniformType::FLOAT_VEC4:
+		case UniformType::INT_VEC4:
+		case UniformType::UNSIGNED_INT_VEC4:
+		case UniformType::BOOL_VEC4:
+		case UniformType::FLOAT_MAT2:
+		case UniformType::FLOAT_MAT3:
+		case UniformType::FLOAT_MAT4:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+	uint32_t ParameterLayout::GetSize(UniformType type)
+	{
+		switch (type)
+		{
+		case UniformType::FLOAT_MAT2:
+			return 32;
+		case UniformType::FLOAT_MAT3:
+			return 48;
+		case UniformType::FLOAT_MAT4:
+			return 64;
+		default:
+		{
+			// Vec3 is 12 bytes, only its alignment is 16
+			const ParameterTypeInfo* info = FindParameterType(type);
+			return info ? info->components * 4 : 0;
+		}
+		}
+	}
+	const char* ParameterLayout::GetTypeName(UniformType type)
+	{
+		const ParameterTypeInfo* info = FindParameterType(type);
+		return info ? info->name : "";
+	}
+
+	void ParameterLayout::parse(const std::string& section, std::vector<std::string>& errors)
+	{
+		// Statements end with ';', comments are removed first
+		std::string code;
+		for (const std::string& line : stringUtil::splitStr(section, '\n'))
+			code += line.substr(0, line.find("//")) + ' ';
+
+		for (std::string statement : stringUtil::splitStr(code, ';'))
+		{
+			stringUtil::trim(statement);
+			if (statement.empty())
+				continue;
+
+			size_t equals = statement.find('=');
+			std::vector<std::string> declaration = stringUtil::splitStr(statement.substr(0, equals), " \t\r");
+			if (declaration.size() != 2)
+			{
+				errors.push_back("Invalid parameter: " + statement);
+				continue;
+			}
+
+			const ParameterTypeInfo* info = FindParameterType(declaration[0]);
+			if (!info)
+			{
+				errors.push_back("Unsupported parameter type: " + statement);
+				continue;
+			}
+
+			Member member;
+			member.name = declaration[1];
+			member.hash = ParameterHandle(member.name).hash;
+			member.type = info->type;
+
+			if (find(ParameterHandle(member.name)) != -1)
+			{
+				errors.push_back("Duplicate parameter: " + member.name);
+				continue;
+			}
+
+			// std140
+			uint32_t alignment = GetAlignment(member.type);
+			uint32_t size = GetSize(member.type);
+			uint32_t end = m_members.empty() ? 0 : m_members.back().offset + GetSize(m_members.back().type);
+			member.offset = (end + alignment - 1) / alignment * alignment;
+
+			std::vector<uint8_t> value(size, 0);
+
+			// Default [single value fills a vector, or the diagonal of a matrix]
+			if (equals != std::string::npos)
+			{
+				std::vector<std::string> values = stringUtil::splitStr(statement.substr(equals + 1), " \t\r(),");
+				if (!values.empty() && values[0] == info->name)
+					values.erase(values.begin());
+
+				bool matrix = IsMatrix(member.type);
+				uint32_t components = matrix ? info->components * info->components : info->components;
+				bool valid = (values.size() == 1 || values.size() == components);
+
+				for (uint32_t i = 0; valid && i < components; i++)
+				{
+					uint32_t row = i % info->components;
+					uint32_t column = i / info->components;
+
+					// GLSL constructors list matrices column by column
+					uint32_t byteOffset = matrix ? row * 16 + column * 4 : i * 4;
+
+					if (values.size() == 1)
+					{
+						if (!matrix || row == column)
+							valid = WriteComponent(&value[byteOffset], member.type, values[0]);
+					}
+					else
+						valid = WriteComponent(&value[byteOffset], member.type, values[i]);
+				}
+
+				if (!valid)
+				{
+					errors.push_back("Invalid default value: " + statement);
+					continue;
+				}
+			}
+
+			m_defaults.resize(member.offset + size, 0);
+			std::copy(value.begin(), value.end(), m_defaults.begin() + member.offset);
+
+			m_lookup.insert(std::upper_bound(m_lookup.begin(), m_lookup.end(), std::make_pair(member.hash, 0u)), std::make_pair(member.hash, (uint32_t)m_members.size()));
+			m_members.push_back(member);
+		}
+
+		// Block size is always a multiple of vec4
+		m_size = ((uint32_t)m_defaults.size() + 15) / 16 * 16;
+		m_defaults.resize(m_size, 0);
+	}
+	std::string ParameterLayout::getGLSL(void) const
+	{
+		if (m_members.empty())
+			return "";
+
+		std::string glsl = "// Parameters\nlayout (std140, row_major) uniform VXL_Material_" + std::to_string(MaterialParameterBuffer::Slot) + "\n{\n";
+		for (const Member& member : m_members)
+			glsl += '\t' + std::string(GetTypeName(member.type)) + ' ' + member.name + ";\n";
+		glsl += "};\n";
+
+		return glsl;
+	}
+
+	int32_t ParameterLayout::find(ParameterHandle handle) const
+	{
+		auto it = std::lower_bound(m_lookup.begin(), m_lookup.end(), std::make_pair(handle.hash, 0u));
+		if (it == m_lookup.end() || it->first != handle.hash)
+			return -1;
+
+		return (int32_t)it->second;
+	}
+
+	bool ParameterLayout::operator==(const ParameterLayout& other) const
+	{
+		if (m_members.size() != other.m_members.size() || m_defaults != other.m_defaults)
+			return false;
+
+		for (size_t i = 0; i < m_members.size(); i++)
+		{
+			if (m_members[i].name != other.m_members[i].name || m_members[i].type != other.m_members[i].type)
+				return false;
+		}
+		return true;
+	}
+
+	// ~ Buffer ~ //
+	void MaterialParameterBuffer::InitGLResources()
+	{
+		m_alignment = std::max(m_alignment, (uint32_t)std::max(Graphics::GLUniformBufferOffsetAlignment, 1));
+
+		// Blocks created before a reload are uploaded again
+		m_capacity = 0;
+		if (!m_data.empty())
+		{
+			m_dirtyBegin = 0;
+			m_dirtyEnd = (uint32_t)m_data.size();
+		}
+	}
+	void MaterialParameterBuffer::DestroyGLResources()
+	{
+		if (m_id != -1)
+			Graphics::UBO::Delete(m_id);
+
+		m_id = -1;
+		m_capacity = 0;
+		m_boundOffset = -1;
+		m_boundSize = 0;
+	}
+
+	uint32_t MaterialParameterBuffer::allocate(uint32_t size)
+	{
+		size = (size + m_alignment - 1) / m_alignment * m_alignment;
+		m_used += size;
+
+		// Materials of the same shader have the same size, first fit is good enough
+		for (auto it = m_freeRanges.begin(); it != m_freeRanges.end(); it++)
+		{
+			if (it->second < size)
+				continue;
+
+			uint32_t offset = it->first;
+			if (it->second == size)
+				m_freeRanges.erase(it);
+			else
+			{
+				it->first += size;
+				it->second -= size;
+			}
+			return offset;
+		}
+
+		uint32_t offset = (uint32_t)m_data.size();
+		m_data.resize(offset + size, 0);
+		return offset;
+	}
+	void MaterialParameterBuffer::release(uint32_t offset, uint32_t size)
+	{
+		size = (size + m_alignment - 1) / m_alignment * m_alignment;
+		m_used -= size;
+
+		m_freeRanges.push_back(std::make_pair(offset, size));
+
+		if (m_boundOffset == offset)
+			m_boundOffset = -1;
+	}
+	void MaterialParameterBuffer::write(uint32_t offset, const void* data, uint32_t size)
+	{
+		VXL_ASSERT(offset + size <= m_data.size(), "Material parameter write out of range");
+
+		// Unchanged values don't dirty the buffer
+		if (memcmp(m_data.data() + offset, data, size) == 0)
+			return;
+
+		memcpy(m_data.data() + offset, data, size);
+
+		m_dirtyBegin = std::min(m_dirtyBegin, offset);
+		m_dirtyEnd = std::max(m_dirtyEnd, offset + size);
+	}
+
+	void MaterialParameterBuffer::flush()
+	{
+		if (m_data.empty())
+			return;
+
+		// Grown since last upload, GL buffer is created again with everything in it
+		if (m_capacity < m_data.size())
+		{
+			if (m_id != -1)
+				Graphics::UBO::Delete(m_id);
+
+			m_capacity = (uint32_t)m_data.capacity();
+			m_id = Graphics::UBO::Create(Slot, m_capacity, BufferUsage::DYNAMIC_DRAW);
+			Graphics::SetGLName(ObjectType::BUFFER, m_id, "UBO_MaterialParameters");
+
+			m_dirtyBegin = 0;
+			m_dirtyEnd = (uint32_t)m_data.size();
+			m_boundOffset = -1;
+		}
+
+		if (m_dirtyBegin >= m_dirtyEnd)
+			return;
+
+		Graphics::UBO::bind(m_id);
+		Graphics::UBO::UpdateBuffer(m_data.data() + m_dirtyBegin, m_dirtyEnd - m_dirtyBegin, m_dirtyBegin);
+		m_uploadCount++;
+
+		m_dirtyBegin = -1;
+		m_dirtyEnd = 0;
+	}
+	void MaterialParameterBuffer::bind(uint32_t offset, uint32_t size)
+	{
+		flush();
+
+		if (m_boundOffset == offset && m_boundSize == size)
+			return;
+
+		Graphics::UBO::BindRange(Slot, m_id, offset, size);
+		m_boundOffset = offset;
+		m_boundSize = size;
+	}
+
+	// ~ Block ~ //
+	ParameterBlock::~ParameterBlock()
+	{
+		if (m_layout && m_offset != -1)
+			MaterialParameterBuffer.release(m_offset, m_layout->getSize());
+	}
+
+	void ParameterBlock::reportTypeMismatch(const ParameterLayout::Member& member, UniformType type) const
+	{
+		Logger.error("Parameter " + member.name + " is a " + ParameterLayout::GetTypeName(member.type) + ", value sent is a " + ParameterLayout::GetTypeName(type));
+	}
+
+	void ParameterBlock::setLayout(const std::shared_ptr<const ParameterLayout>& layout)
+	{
+		if (m_layout == layout)
+			return;
+
+		std::shared_ptr<const ParameterLayout> oldLayout = m_layout;
+		uint32_t oldOffset = m_offset;
+
+		m_layout = layout;
+		m_offset = -1;
+
+		if (m_layout && !m_layout->isEmpty())
+		{
+			m_offset = MaterialParameterBuffer.allocate(m_layout->getSize());
+			MaterialParameterBuffer.write(m_offset, m_layout->getDefaults().data(), m_layout->getSize());
+		}
+
+		if (!oldLayout || oldOffset == -1)
+			return;
+
+		// Keep values that were set on purpose
+		if (m_offset != -1)
+		{
+			const uint8_t* oldValues = MaterialParameterBuffer.read(oldOffset);
+			const uint8_t* oldDefaults = oldLayout->getDefaults().data();
+
+			for (const ParameterLayout::Member& member : oldLayout->getMembers())
+			{
+				int32_t index = m_layout->find(ParameterHandle(member.name));
+				if (index == -1 || m_layout->getMembers()[index].type != member.type)
+					continue;
+
+				uint32_t size = ParameterLayout::GetSize(member.type);
+				if (memcmp(oldValues + member.offset, oldDefaults + member.offset, size) == 0)
+					continue;
+
+				// Copy first, write may grow the buffer
+				std::vector<uint8_t> value(oldValues + member.offset, oldValues + member.offset + size);
+				MaterialParameterBuffer.write(m_offset + m_layout->getMembers()[index].offset, value.data(), size);
+				oldValues = MaterialParameterBuffer.read(oldOffset);
+			}
+		}
+
+		MaterialParameterBuffer.release(oldOffset, oldLayout->getSize());
+	}
+
+	void ParameterBlock::bind(void) const
+	{
+		if (m_offset != -1)
+			MaterialParameterBuffer.bind(m_offset, m_layout->getSize());
+	}
+}
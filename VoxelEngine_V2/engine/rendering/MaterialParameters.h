@@ -0,0 +1,327 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "Graphics.h"
+
+#include "../math/Color.h"
+#include "../math/Matrix2x2.h"
+#include "../math/Matrix3x3.h"
+#include "../math/Matrix4x4.h"
+#include "../math/Vector.h"
+
+#include "../utilities/singleton.h"
+#include "../utilities/Macros.h"
+#include "../utilities/stringUtil.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Vxl
+{
+	// Hashed parameter name, declare as constexpr to hash literals at compile time
+	// ex: static constexpr ParameterHandle Reflectivity("reflectivity");
+	struct ParameterHandle
+	{
+		uint32_t hash;
+
+		constexpr ParameterHandle(const char* name)
+			: hash(StringHash32(name))
+		{}
+		explicit ParameterHandle(const std::string& name)
+			: hash(hash_32_fnv1a(name.data(), (uint32_t)name.size()))
+		{}
+	};
+
+	// std140 encoding of C++ values [bools are 32 bits, matrix rows are padded to vec4]
+	template<typename Type>
+	struct ParameterTraits;
+
+	template<typename Scalar>
+	struct ParameterScalar;
+	template<> struct ParameterScalar<float>
+	{
+		static const UniformType Type = UniformType::FLOAT;
+		static void Write(uint8_t* destination, float value) { memcpy(destination, &value, 4); }
+		static void Read(const uint8_t* source, float& value) { memcpy(&value, source, 4); }
+	};
+	template<> struct ParameterScalar<int>
+	{
+		static const UniformType Type = UniformType::INT;
+		static void Write(uint8_t* destination, int value) { memcpy(destination, &value, 4); }
+		static void Read(const uint8_t* source, int& value) { memcpy(&value, source, 4); }
+	};
+	template<> struct ParameterScalar<uint32_t>
+	{
+		static const UniformType Type = UniformType::UNSIGNED_INT;
+		static void Write(uint8_t* destination, uint32_t value) { memcpy(destination, &value, 4); }
+		static void Read(const uint8_t* source, uint32_t& value) { memcpy(&value, source, 4); }
+	};
+	template<> struct ParameterScalar<bool>
+	{
+		static const UniformType Type = UniformType::BOOL;
+		static void Write(uint8_t* destination, bool value) { uint32_t v = value ? 1u : 0u; memcpy(destination, &v, 4); }
+		static void Read(const uint8_t* source, bool& value) { uint32_t v; memcpy(&v, source, 4); value = (v != 0); }
+	};
+
+	template<> struct ParameterTraits<float> : ParameterScalar<float> {};
+	template<> struct ParameterTraits<int> : ParameterScalar<int> {};
+	template<> struct ParameterTraits<uint32_t> : ParameterScalar<uint32_t> {};
+	template<> struct ParameterTraits<bool> : ParameterScalar<bool> {};
+
+	// Vector types follow their scalar [FLOAT -> FLOAT_VEC2 -> FLOAT_VEC3 -> FLOAT_VEC4]
+	template<typename Scalar>
+	struct ParameterTraits<_Vector2<Scalar>>
+	{
+		static const UniformType Type = (UniformType)((uint32_t)ParameterScalar<Scalar>::Type + 1);
+		static void Write(uint8_t* destination, const _Vector2<Scalar>& value)
+		{
+			ParameterScalar<Scalar>::Write(destination + 0, value.x);
+			ParameterScalar<Scalar>::Write(destination + 4, value.y);
+		}
+		static void Read(const uint8_t* source, _Vector2<Scalar>& value)
+		{
+			ParameterScalar<Scalar>::Read(source + 0, value.x);
+			ParameterScalar<Scalar>::Read(source + 4, value.y);
+		}
+	};
+	template<typename Scalar>
+	struct ParameterTraits<_Vector3<Scalar>>
+	{
+		static const UniformType Type = (UniformType)((uint32_t)ParameterScalar<Scalar>::Type + 2);
+		static void Write(uint8_t* destination, const _Vector3<Scalar>& value)
+		{
+			ParameterScalar<Scalar>::Write(destination + 0, value.x);
+			ParameterScalar<Scalar>::Write(destination + 4, value.y);
+			ParameterScalar<Scalar>::Write(destination + 8, value.z);
+		}
+		static void Read(const uint8_t* source, _Vector3<Scalar>& value)
+		{
+			ParameterScalar<Scalar>::Read(source + 0, value.x);
+			ParameterScalar<Scalar>::Read(source + 4, value.y);
+			ParameterScalar<Scalar>::Read(source + 8, value.z);
+		}
+	};
+	template<typename Scalar>
+	struct ParameterTraits<_Vector4<Scalar>>
+	{
+		static const UniformType Type = (UniformType)((uint32_t)ParameterScalar<Scalar>::Type + 3);
+		static void Write(uint8_t* destination, const _Vector4<Scalar>& value)
+		{
+			ParameterScalar<Scalar>::Write(destination + 0, value.x);
+			ParameterScalar<Scalar>::Write(destination + 4, value.y);
+			ParameterScalar<Scalar>::Write(destination + 8, value.z);
+			ParameterScalar<Scalar>::Write(destination + 12, value.w);
+		}
+		static void Read(const uint8_t* source, _Vector4<Scalar>& value)
+		{
+			ParameterScalar<Scalar>::Read(source + 0, value.x);
+			ParameterScalar<Scalar>::Read(source + 4, value.y);
+			ParameterScalar<Scalar>::Read(source + 8, value.z);
+			ParameterScalar<Scalar>::Read(source + 12, value.w);
+		}
+	};
+	template<> struct ParameterTraits<Color3F>
+	{
+		static const UniformType Type = UniformType::FLOAT_VEC3;
+		static void Write(uint8_t* destination, const Color3F& value) { memcpy(destination, &value.r, 12); }
+		static void Read(const uint8_t* source, Color3F& value) { memcpy(&value.r, source, 12); }
+	};
+	template<> struct ParameterTraits<Color4F>
+	{
+		static const UniformType Type = UniformType::FLOAT_VEC4;
+		static void Write(uint8_t* destination, const Color4F& value) { memcpy(destination, &value.r, 16); }
+		static void Read(const uint8_t* source, Color4F& value) { memcpy(&value.r, source, 16); }
+	};
+
+	// Same row order as UniformBufferObject::sendMatrix [block is row_major]
+	template<typename Matrix, uint32_t Size, UniformType MatrixType>
+	struct ParameterMatrix
+	{
+		static const UniformType Type = MatrixType;
+		static void Write(uint8_t* destination, const Matrix& value)
+		{
+			for (uint32_t row = 0; row < Size; row++)
+				for (uint32_t column = 0; column < Size; column++)
+					ParameterScalar<float>::Write(destination + row * 16 + column * 4, value[row * Size + column]);
+		}
+		static void Read(const uint8_t* source, Matrix& value)
+		{
+			for (uint32_t row = 0; row < Size; row++)
+				for (uint32_t column = 0; column < Size; column++)
+					ParameterScalar<float>::Read(source + row * 16 + column * 4, value[row * Size + column]);
+		}
+	};
+	template<> struct ParameterTraits<Matrix2x2> : ParameterMatrix<Matrix2x2, 2, UniformType::FLOAT_MAT2> {};
+	template<> struct ParameterTraits<Matrix3x3> : ParameterMatrix<Matrix3x3, 3, UniformType::FLOAT_MAT3> {};
+	template<> struct ParameterTraits<Matrix4x4> : ParameterMatrix<Matrix4x4, 4, UniformType::FLOAT_MAT4> {};
+
+	// std140 layout of a material's #Parameters section, shared by all of its programs
+	// Declarations are "type name;" or "type name = default;" [scalars, vectors and square float matrices, no doubles or arrays]
+	class ParameterLayout
+	{
+	public:
+		struct Member
+		{
+			std::string	name;
+			uint32_t	hash;
+			uint32_t	offset;
+			UniformType	type;
+		};
+
+	private:
+		std::vector<Member>							m_members;	// Declaration order
+		std::vector<std::pair<uint32_t, uint32_t>>	m_lookup;	// Hash -> member, sorted by hash
+		std::vector<uint8_t>						m_defaults;	// Block filled with every default value
+		uint32_t									m_size = 0;	// Rounded up to vec4
+
+	public:
+		ParameterLayout() {}
+
+		// Adds every declaration, invalid ones are skipped and reported in errors
+		void parse(const std::string& section, std::vector<std::string>& errors);
+		// Uniform block declaration, empty if there are no members
+		std::string getGLSL(void) const;
+
+		// -1 if the handle isn't a member
+		int32_t find(ParameterHandle handle) const;
+
+		// std140 rules, 0 if the type can't be a parameter
+		static uint32_t GetAlignment(UniformType type);
+		static uint32_t GetSize(UniformType type);
+		static const char* GetTypeName(UniformType type);
+
+		bool operator==(const ParameterLayout& other) const;
+
+		inline const std::vector<Member>&	getMembers(void) const
+		{
+			return m_members;
+		}
+		inline const std::vector<uint8_t>&	getDefaults(void) const
+		{
+			return m_defaults;
+		}
+		inline uint32_t						getSize(void) const
+		{
+			return m_size;
+		}
+		inline bool							isEmpty(void) const
+		{
+			return m_members.empty();
+		}
+	};
+
+	// Every material's parameter block lives in one uniform buffer
+	// Changed blocks are uploaded together as a single range, draws only rebind [slot, offset]
+	static class MaterialParameterBuffer : public Singleton<class MaterialParameterBuffer>
+	{
+		DISALLOW_COPY_AND_ASSIGN(MaterialParameterBuffer);
+		friend class ParameterBlock;
+	private:
+		UBOID					m_id = -1;
+		uint32_t				m_capacity = 0;	// GL side
+		uint32_t				m_alignment = 256;
+		std::vector<uint8_t>	m_data;			// CPU copy of every block, blocks never move
+		std::vector<std::pair<uint32_t, uint32_t>> m_freeRanges; // Offset, size
+		uint32_t				m_used = 0;
+		uint32_t				m_dirtyBegin = -1;
+		uint32_t				m_dirtyEnd = 0;
+		uint32_t				m_boundOffset = -1;
+		uint32_t				m_boundSize = 0;
+		uint32_t				m_uploadCount = 0;
+
+		uint32_t	allocate(uint32_t size);
+		void		release(uint32_t offset, uint32_t size);
+		void		write(uint32_t offset, const void* data, uint32_t size);
+		inline const uint8_t* read(uint32_t offset) const
+		{
+			return m_data.data() + offset;
+		}
+
+	public:
+		// Uniform block binding of "VXL_Material_3" [after Camera, Time and FBO_Data]
+		static const uint32_t Slot = 3;
+
+		MaterialParameterBuffer() {}
+
+		void InitGLResources();
+		void DestroyGLResources();
+
+		// Uploads all changed blocks in one call
+		void flush();
+		// Makes a block visible to shaders, flushes first if anything changed
+		void bind(uint32_t offset, uint32_t size);
+
+		// Buffer uploads since start
+		inline uint32_t getUploadCount(void) const
+		{
+			return m_uploadCount;
+		}
+		inline uint32_t getUsedBytes(void) const
+		{
+			return m_used;
+		}
+
+	} SingletonInstance(MaterialParameterBuffer);
+
+	// Values of one material, laid out by its ShaderMaterial's ParameterLayout
+	class ParameterBlock
+	{
+		DISALLOW_COPY_AND_ASSIGN(ParameterBlock);
+	private:
+		std::shared_ptr<const ParameterLayout>	m_layout;
+		uint32_t								m_offset = -1;
+
+		void reportTypeMismatch(const ParameterLayout::Member& member, UniformType type) const;
+
+	public:
+		ParameterBlock() {}
+		~ParameterBlock();
+
+		// Values that differ from the old default are moved to the new layout, everything else takes the new default
+		void setLayout(const std::shared_ptr<const ParameterLayout>& layout);
+		inline const std::shared_ptr<const ParameterLayout>& getLayout(void) const
+		{
+			return m_layout;
+		}
+
+		// False if the handle isn't a member or the type doesn't match
+		template<typename Type>
+		bool set(ParameterHandle handle, const Type& value)
+		{
+			int32_t index = m_layout ? m_layout->find(handle) : -1;
+			if (index == -1)
+				return false;
+
+			const ParameterLayout::Member& member = m_layout->getMembers()[index];
+			if (member.type != ParameterTraits<Type>::Type)
+			{
+				reportTypeMismatch(member, ParameterTraits<Type>::Type);
+				return false;
+			}
+
+			uint8_t data[64] = {};
+			ParameterTraits<Type>::Write(data, value);
+			MaterialParameterBuffer.write(m_offset + member.offset, data, ParameterLayout::GetSize(member.type));
+			return true;
+		}
+		template<typename Type>
+		bool get(ParameterHandle handle, Type& value) const
+		{
+			int32_t index = m_layout ? m_layout->find(handle) : -1;
+			if (index == -1)
+				return false;
+
+			const ParameterLayout::Member& member = m_layout->getMembers()[index];
+			if (member.type != ParameterTraits<Type>::Type)
+				return false;
+
+			ParameterTraits<Type>::Read(MaterialParameterBuffer.read(m_offset + member.offset), value);
+			return true;
+		}
+
+		// Per draw cost is a range bind
+		void bind(void) const;
+	};
+}
@@ -4,7 +4,10 @@
 
 #include "Graphics.h"
 
+#include "../math/MeshCache.h"
 #include "../math/Model.h"
+#include "../math/VertexPacking.h"
+#include "../math/VertexWeld.h"
 #include "../math/Vector.h"
 #include "../math/Color.h"
 
@@ -30,7 +33,7 @@ namespace Vxl
 		// Set Draw Count
 		if (m_mode == DrawMode::ARRAY)
 		{
-			m_drawCount = m_positions.getDrawCount();
+			m_drawCount = m_packed ? m_packedVertices.getDrawCount() : m_positions.getDrawCount();
 		}
 		else
 		{
@@ -127,13 +130,75 @@ namespace Vxl
 
 		bind();
 	}
+	void Mesh::set(const MeshCacheView& _view)
+	{
+		m_positions.vertices.assign(_view.positions, _view.positions + _view.vertexCount);
+
+		if (_view.uvs)
+			m_uvs.vertices.assign(_view.uvs, _view.uvs + _view.vertexCount);
+		else
+			m_uvs.vertices.clear();
+
+		if (_view.normals)
+			m_normals.vertices.assign(_view.normals, _view.normals + _view.vertexCount);
+		else
+			m_normals.vertices.clear();
+
+		if (_view.tangents)
+			m_tangents.vertices.assign(_view.tangents, _view.tangents + _view.vertexCount);
+		else
+			m_tangents.vertices.clear();
+
+		if (_view.indices)
+			m_indices.vertices.assign(_view.indices, _view.indices + _view.indexCount);
+		else
+			m_indices.vertices.clear();
+
+		// Same sized meshes would otherwise keep the old data
+		m_positions.markDirty();
+		m_uvs.markDirty();
+		m_normals.markDirty();
+		m_tangents.markDirty();
+		m_indices.markDirty();
+
+		UpdateMinMax(_view.min, _view.max);
+		bindBuffers();
+	}
 
 	void Mesh::setGLName(const std::string& name)
 	{
 		Graphics::SetGLName(ObjectType::VERTEX_ARRAY, m_VAO.getID(), "Mesh_" + name);
 	}
+	void Mesh::setPacked(bool state, bool quantizePositions)
+	{
+		m_packed = state;
+		m_quantizePositions = quantizePositions;
+		m_packedVertices.setLayout(GetPackedLayout(quantizePositions));
+
+		if (!state)
+			m_packedVertices.vertices.clear();
+	}
+	BufferLayout Mesh::GetPackedLayout(bool quantizePositions)
+	{
+		if (quantizePositions)
+		{
+			return BufferLayout({
+				{AttributeLocation::LOC0, DataType::UNSIGNED_SHORT, 4, true},
+				{AttributeLocation::LOC1, DataType::HALF_FLOAT, 2},
+				{AttributeLocation::LOC2, DataType::SHORT, 2, true},
+				{AttributeLocation::LOC6, DataType::SHORT, 2, true}
+			});
+		}
+		return BufferLayout({
+			{AttributeLocation::LOC0, DataType::FLOAT, 3},
+			{AttributeLocation::LOC1, DataType::HALF_FLOAT, 2},
+			{AttributeLocation::LOC2, DataType::SHORT, 2, true},
+			{AttributeLocation::LOC6, DataType::SHORT, 2, true}
+		});
+	}
 
 	void Mesh::GenerateNormals(
+		std::vector<Vector3>& _normals,
 		const Vector3* _vertices, uint32_t _vertCount,
 		const uint32_t* _indices, uint32_t _indexCount,
 		bool smooth
@@ -144,8 +209,8 @@ namespace Vxl
 			return;
 		}
 		//
-		std::vector<Vector3> Normals;
-		Normals.resize(_vertCount);
+		std::vector<Vector3>& Normals = _normals;
+		Normals.assign(_vertCount, Vector3::ZERO);
 		// Indexed Normals
 		if (_indices)
 		{
@@ -153,70 +218,14 @@ namespace Vxl
 			
 			for (uint32_t i = 0; i < _indexCount; i+= 3)
 			{
-				Vector3 P1(
-					_vertices[_indices[i + 0]].x,
-					_vertices[_indices[i + 0]].y,
-					_vertices[_indices[i + 0]].z
-				);
-				Vector3 P2(
-					_vertices[_indices[i + 1]].x,
-					_vertices[_indices[i + 1]].y,
-					_vertices[_indices[i + 1]].z
-				);
-				Vector3 P3(
-					_vertices[_indices[i + 2]].x,
-					_vertices[_indices[i + 2]].y,
-					_vertices[_indices[i + 2]].z
-				);
+				const Vector3& P1 = _vertices[_indices[i + 0]];
+				const Vector3& P2 = _vertices[_indices[i + 1]];
+				const Vector3& P3 = _vertices[_indices[i + 2]];
+
 				Vector3 N = Vector3::Cross((P2 - P1), (P3 - P1)).Normalize();
 				Normals[_indices[i + 0]] += N;
 				Normals[_indices[i + 1]] += N;
 				Normals[_indices[i + 2]] += N;
-
-			}
-			if (smooth)
-			{
-				for (uint32_t i = 0; i < _indexCount; i ++)
-				{
-					std::vector<Vector3> neighbors;
-
-					Vector3 P(
-						_vertices[_indices[i]].x,
-						_vertices[_indices[i]].y,
-						_vertices[_indices[i]].z
-					);
-
-					for (uint32_t j = 0; j < _indexCount; j++)
-					{
-						if (i == j)
-							continue;
-
-						Vector3 Q(
-							_vertices[_indices[j]].x,
-							_vertices[_indices[j]].y,
-							_vertices[_indices[j]].z
-						);
-
-						if (Vector3::Distance(P, Q) < 0.01f)
-						{
-							neighbors.push_back(Normals[_indices[j]]);
-						}
-					}
-
-					// No smoothing occurs
-					if (neighbors.size() == 1)
-						continue;
-
-					// Smooth vertices in similar space
-					float neighborCount = (float)neighbors.size();
-
-					Normals[_indices[i]] /= neighborCount;
-					for (auto& n : neighbors)
-						Normals[_indices[i]] += (n / neighborCount);
-
-					if (isinf(Normals[_indices[i]].x))
-						VXL_ASSERT(false, "Normal has invalid value");
-				}
 			}
 		}
 		// Position Normals
@@ -226,83 +235,50 @@ namespace Vxl
 
 			for (uint32_t i = 0; i < _vertCount; i += 3)
 			{
-				Vector3 P1(
-					_vertices[i + 0].x,
-					_vertices[i + 0].y,
-					_vertices[i + 0].z
-				);
-				Vector3 P2(
-					_vertices[i + 1].x,
-					_vertices[i + 1].y,
-					_vertices[i + 1].z
-				);
-				Vector3 P3(
-					_vertices[i + 2].x,
-					_vertices[i + 2].y,
-					_vertices[i + 2].z
-				);
+				const Vector3& P1 = _vertices[i + 0];
+				const Vector3& P2 = _vertices[i + 1];
+				const Vector3& P3 = _vertices[i + 2];
+
 				Vector3 N = Vector3::Cross((P2 - P1), (P3 - P1)).Normalize();
 				Normals[i + 0] += N;
 				Normals[i + 1] += N;
 				Normals[i + 2] += N;
 			}
-			if (smooth)
+		}
+		// Vertices in similar space share the sum of their normals
+		if (smooth)
+		{
+			std::vector<uint32_t> Remap;
+			WeldVertices(_vertices, _vertCount, 0.01f, Remap);
+
+			// Groups always point to an earlier vertex, so one pass gathers and one pass scatters
+			for (uint32_t i = 0; i < _vertCount; i++)
+			{
+				if (Remap[i] != i)
+					Normals[Remap[i]] += Normals[i];
+			}
+			for (uint32_t i = 0; i < _vertCount; i++)
 			{
-				std::vector<Vector3> WNormals;
-				WNormals.reserve(_vertCount);
-				WNormals.resize(_vertCount);
-
-				for (uint32_t i = 0; i < _vertCount; i++)
-				{
-					WNormals[i] = Normals[i];
-
-					std::vector<Vector3> neighbors;
-
-					Vector3 P(
-						_vertices[i].x,
-						_vertices[i].y,
-						_vertices[i].z
-					);
-
-					for (uint32_t j = 0; j < _vertCount; j++)
-					{
-						if (i == j)
-							continue;
-
-						Vector3 Q(
-							_vertices[j].x,
-							_vertices[j].y,
-							_vertices[j].z
-						);
-
-						if (Vector3::Distance(P, Q) < 0.01f)
-						{
-							WNormals[i] += Normals[j];
-						}
-					}
-				}
-
-				for (uint32_t i = 0; i < _vertCount; i++)
-				{
-					Normals[i] = WNormals[i];
-				}
+				if (Remap[i] != i)
+					Normals[i] = Normals[Remap[i]];
 			}
 		}
 		// Normalize the normals
 		for (uint32_t i = 0; i < _vertCount; i++)
 		{
 			Normals[i].NormalizeSelf();
-		}
 
-
-		//
-		m_normals = (Normals);
+			if (isinf(Normals[i].x))
+				VXL_ASSERT(false, "Normal has invalid value");
+		}
 	}
 
 	void Mesh::GenerateTangents(
+		std::vector<Vector3>& _tangents,
 		const Vector3* _vertices, uint32_t _vertCount,
 		const Vector2* _uvs, uint32_t _UVCount,
-		const uint32_t* _indices, uint32_t _indexCount
+		const uint32_t* _indices, uint32_t _indexCount,
+		const Vector3* _normals
 	)
 	{
 		if (_vertices == nullptr || _vertCount == 0)
@@ -311,9 +287,9 @@ namespace Vxl
 			return;
 		}
 		//
-		std::vector<Vector3> Tangents;
+		std::vector<Vector3>& Tangents = _tangents;
 		std::vector<Vector3> Bitangents;
-		Tangents.resize(_vertCount);
+		Tangents.assign(_vertCount, Vector3::ZERO);
 		Bitangents.resize(_vertCount);
 		// Indexed Normals
 		if (_indices)
@@ -323,35 +299,14 @@ namespace Vxl
 			for (uint32_t i = 0; i < _indexCount; i += 3)
 			{
 				// Positions
-				Vector3 P1(
-					_vertices[_indices[i + 0]].x,
-					_vertices[_indices[i + 0]].y,
-					_vertices[_indices[i + 0]].z
-				);
-				Vector3 P2(
-					_vertices[_indices[i + 1]].x,
-					_vertices[_indices[i + 1]].y,
-					_vertices[_indices[i + 1]].z
-				);
-				Vector3 P3(
-					_vertices[_indices[i + 2]].x,
-					_vertices[_indices[i + 2]].y,
-					_vertices[_indices[i + 2]].z
-				);
+				const Vector3& P1 = _vertices[_indices[i + 0]];
+				const Vector3& P2 = _vertices[_indices[i + 1]];
+				const Vector3& P3 = _vertices[_indices[i + 2]];
 				
 				// Uvs
-				Vector2 UV1(
-					_uvs[_indices[i + 0]].x,
-					_uvs[_indices[i + 0]].y
-				);
-				Vector2 UV2(
-					_uvs[_indices[i + 1]].x,
-					_uvs[_indices[i + 1]].y
-				);
-				Vector2 UV3(
-					_uvs[_indices[i + 2]].x,
-					_uvs[_indices[i + 2]].y
-				);
+				const Vector2& UV1 = _uvs[_indices[i + 0]];
+				const Vector2& UV2 = _uvs[_indices[i + 1]];
+				const Vector2& UV3 = _uvs[_indices[i + 2]];
 
 				// Edges of triangle
 				Vector3 deltaPos1 = P2 - P1;
@@ -379,35 +334,14 @@ namespace Vxl
 			for (uint32_t i = 0; i < _vertCount; i += 3)
 			{
 				// Positions
-				Vector3 P1(
-					_vertices[i + 0].x,
-					_vertices[i + 0].y,
-					_vertices[i + 0].z
-				);
-				Vector3 P2(
-					_vertices[i + 1].x,
-					_vertices[i + 1].y,
-					_vertices[i + 1].z
-				);
-				Vector3 P3(
-					_vertices[i + 2].x,
-					_vertices[i + 2].y,
-					_vertices[i + 2].z
-				);
+				const Vector3& P1 = _vertices[i + 0];
+				const Vector3& P2 = _vertices[i + 1];
+				const Vector3& P3 = _vertices[i + 2];
 
 				// Uvs
-				Vector2 UV1(
-					_uvs[i + 0].x,
-					_uvs[i + 0].y
-				);
-				Vector2 UV2(
-					_uvs[i + 1].x,
-					_uvs[i + 1].y
-				);
-				Vector2 UV3(
-					_uvs[i + 2].x,
-					_uvs[i + 2].y
-				);
+				const Vector2& UV1 = _uvs[i + 0];
+				const Vector2& UV2 = _uvs[i + 1];
+				const Vector2& UV3 = _uvs[i + 2];
 
 				// Edges of triangle
 				Vector3 deltaPos1 = P2 - P1;
@@ -424,13 +358,27 @@ namespace Vxl
 				Tangents[i + 2] += tangent;
 			}
 		}
+		// Split vertices with matching position/uv/normal share their tangent [uv seams stay split]
+		{
+			std::vector<uint32_t> Remap;
+			WeldVertices(_vertices, _vertCount, 0.0001f, Remap, _uvs, _normals);
+
+			for (uint32_t i = 0; i < _vertCount; i++)
+			{
+				if (Remap[i] != i)
+					Tangents[Remap[i]] += Tangents[i];
+			}
+			for (uint32_t i = 0; i < _vertCount; i++)
+			{
+				if (Remap[i] != i)
+					Tangents[i] = Tangents[Remap[i]];
+			}
+		}
 		// Normalize the normals
 		for (uint32_t i = 0; i < _vertCount; i++)
 		{
 			Tangents[i].NormalizeSelf();
 		}
-		//
-		m_tangents = (Tangents);
 	}
 
 	void Mesh::generateNormals(bool Smooth)
@@ -439,10 +387,12 @@ namespace Vxl
 		if (m_normals.isEmpty() && !m_positions.isEmpty())
 		{
 			GenerateNormals(
+				m_normals.vertices,
 				m_positions.vertices.data(), m_positions.size(),
 				m_indices.vertices.data(), (uint32_t)m_indices.size(),
 				Smooth
 			);
+			m_normals.markDirty();
 		}
 	}
 	void Mesh::generateTangents()
@@ -451,14 +401,94 @@ namespace Vxl
 		if ((m_tangents.isEmpty()) && !m_positions.isEmpty() && !m_uvs.isEmpty())
 		{
 			GenerateTangents(
+				m_tangents.vertices,
 				m_positions.vertices.data(), m_positions.size(),
 				m_uvs.vertices.data(), m_uvs.size(),
-				m_indices.vertices.data(), (uint32_t)m_indices.size()
+				m_indices.vertices.data(), (uint32_t)m_indices.size(),
+				(m_normals.size() == m_positions.size()) ? m_normals.vertices.data() : nullptr
 			);
+			m_tangents.markDirty();
 		}
 	}
+	uint32_t Mesh::weldVertices(float tolerance)
+	{
+		uint32_t vertCount = m_positions.size();
+		if (vertCount == 0)
+			return 0;
+
+		// Attributes that don't cover every vertex are dropped
+		bool hasUVs			= m_uvs.size() == vertCount;
+		bool hasNormals		= m_normals.size() == vertCount;
+		bool hasTangents	= m_tangents.size() == vertCount;
+
+		std::vector<uint32_t> Remap;
+		uint32_t uniqueCount = WeldVertices(
+			m_positions.vertices.data(), vertCount, tolerance, Remap,
+			hasUVs ? m_uvs.vertices.data() : nullptr,
+			hasNormals ? m_normals.vertices.data() : nullptr,
+			tolerance
+		);
+
+		// Compact unique vertices [groups keep the values of their first vertex]
+		std::vector<uint32_t> NewIndex(vertCount);
+		std::vector<Vector3> Positions, Normals, Tangents;
+		std::vector<Vector2> UVs;
+		Positions.reserve(uniqueCount);
+		if (hasUVs)
+			UVs.reserve(uniqueCount);
+		if (hasNormals)
+			Normals.reserve(uniqueCount);
+		if (hasTangents)
+			Tangents.reserve(uniqueCount);
+
+		for (uint32_t i = 0; i < vertCount; i++)
+		{
+			if (Remap[i] != i)
+			{
+				NewIndex[i] = NewIndex[Remap[i]];
+				continue;
+			}
+
+			NewIndex[i] = (uint32_t)Positions.size();
+			Positions.push_back(m_positions.vertices[i]);
+			if (hasUVs)
+				UVs.push_back(m_uvs.vertices[i]);
+			if (hasNormals)
+				Normals.push_back(m_normals.vertices[i]);
+			if (hasTangents)
+				Tangents.push_back(m_tangents.vertices[i]);
+		}
+
+		// Rewrite existing indices, or create them in draw order
+		std::vector<uint32_t> Indices;
+		if (m_indices.size() == 0)
+		{
+			Indices = NewIndex;
+		}
+		else
+		{
+			Indices.reserve(m_indices.size());
+			for (uint32_t index : m_indices.vertices)
+				Indices.push_back(NewIndex[index]);
+		}
+
+		m_positions = Positions;
+		m_uvs = UVs;
+		m_normals = Normals;
+		m_tangents = Tangents;
+		m_indices = Indices;
+
+		bind();
+
+		return uniqueCount;
+	}
 
 	void Mesh::bind()
+	{
+		recalculateMinMax();
+		bindBuffers();
+	}
+	void Mesh::bindBuffers()
 	{
 		// SIZE Assert Check //
 #ifdef _DEBUG
@@ -493,10 +523,27 @@ namespace Vxl
 		if (!RenderManager.m_globalVAO)
 			m_VAO.bind();
 
-		m_positions.bind();
-		m_uvs.bind();
-		m_normals.bind();
-		m_tangents.bind();
+		// Attribute vectors stay the editable copy, packed data is rebuilt from them
+		if (m_packed)
+		{
+			uint32_t vertCount = m_positions.size();
+			if (vertCount > 0)
+			{
+				VertexPacking::PackVertices(
+					m_packedVertices.vertices,
+					m_positions.vertices.data(), vertCount,
+					(m_uvs.size() == vertCount) ? m_uvs.vertices.data() : nullptr,
+					(m_normals.size() == vertCount) ? m_normals.vertices.data() : nullptr,
+					(m_tangents.size() == vertCount) ? m_tangents.vertices.data() : nullptr,
+					m_quantizePositions, m_min, m_max
+				);
+				m_packedVertices.markDirty();
+			}
+			else
+				m_packedVertices.vertices.clear();
+		}
+
+		bindVertexBuffers();
 		m_instances.bind();
 		m_indices.bind();
 
@@ -505,34 +552,54 @@ namespace Vxl
 		/*				*/	
 
 		UpdateDrawInfo();
-		recalculateMinMax();
+	}
+	void Mesh::bindVertexBuffers()
+	{
+		if (m_packed)
+		{
+			m_packedVertices.bind();
+		}
+		else
+		{
+			m_positions.bind();
+			m_uvs.bind();
+			m_normals.bind();
+			m_tangents.bind();
+		}
 	}
 
 	void Mesh::recalculateMinMax()
 	{
 		// Min/Max
-		m_max = Vector3::MIN;
-		m_min = Vector3::MAX;
+		Vector3 _max = Vector3::MIN;
+		Vector3 _min = Vector3::MAX;
 
 		uint32_t PosCount = (uint32_t)m_positions.size();
 		for (uint32_t i = 0; i < PosCount; i++)
 		{
-			m_min = Vector3::Min(m_min, m_positions.vertices[i]);
-			m_max = Vector3::Max(m_max, m_positions.vertices[i]);
+			_min = Vector3::Min(_min, m_positions.vertices[i]);
+			_max = Vector3::Max(_max, m_positions.vertices[i]);
 		}
 
+		UpdateMinMax(_min, _max);
+	}
+	void Mesh::UpdateMinMax(const Vector3& min, const Vector3& max)
+	{
+		m_min = min;
+		m_max = max;
 		m_center = (m_max + m_min) * 0.5f;
 		m_scale = (m_max - m_min);
 	}
 
 	void Mesh::draw()
 	{
+		// Empty [data might still be loading]
+		if (m_drawCount == 0)
+			return;
+
 		if (RenderManager.m_globalVAO)
 		{
-			m_positions.bind();
-			m_uvs.bind();
-			m_normals.bind();
-			m_tangents.bind();
+			bindVertexBuffers();
 			m_instances.bind();
 			m_indices.bind();
 		}
@@ -558,59 +625,137 @@ namespace Vxl
 		}
 	}
 
-	//
-	void LineMesh3D::addLine(const Vector3& P1, const Vector3& P2, float Width, const Color3F& C1, const Color3F& C2)
+	void Mesh::drawInstanced(const VBO& instances, uint32_t count)
+	{
+		// Empty [data might still be loading]
+		if (m_drawCount == 0 || count == 0)
+			return;
+
+		bindForInstances();
+		instances.bind();
+		drawInstances(count);
+
+		// Mesh VAO must not keep reading from the external buffer
+		instances.unbindAttributes();
+	}
+	void Mesh::drawInstanced(const StreamVBO& instances, uint32_t count)
+	{
+		if (m_drawCount == 0 || count == 0)
+			return;
+
+		bindForInstances();
+		instances.bind();
+		drawInstances(count);
+
+		instances.unbindAttributes();
+	}
+	void Mesh::bindForInstances()
 	{
-		// Allocate necessary room
-		if (m_index + m_indexIncrement > m_points.size())
+		if (RenderManager.m_globalVAO)
+		{
+			bindVertexBuffers();
+			m_indices.bind();
+		}
+		else
+			m_VAO.bind();
+	}
+	void Mesh::drawInstances(uint32_t count)
+	{
+		switch (m_mode)
 		{
-			m_points.vertices.resize(m_index + m_indexIncrement);
+		case DrawMode::ARRAY:
+		case DrawMode::ARRAY_INSTANCED:
+			Graphics::Draw::ArrayInstanced(m_type, m_drawCount, count);
+			break;
+
+		case DrawMode::INDEXED:
+		case DrawMode::INDEXED_INSTANCED:
+			Graphics::Draw::IndexedInstanced(m_type, m_drawCount, count);
+			break;
 		}
+	}
+
+	//
+	float* LineMesh3D::allocateLines(uint32_t lineCount)
+	{
+		uint32_t end = m_index + lineCount * m_indexIncrement;
+
+		// Double instead of growing one line at a time
+		if (end > m_points.size())
+			m_points.resize(std::max(end, (uint32_t)m_points.size() * 2));
+
+		float* data = m_points.data() + m_index;
+		m_index = end;
+		return data;
+	}
+	void LineMesh3D::reserveLines(uint32_t lineCount)
+	{
+		uint32_t end = m_index + lineCount * m_indexIncrement;
+		if (end > m_points.size())
+			m_points.resize(end);
+	}
+
+	void LineMesh3D::addLine(const Vector3& P1, const Vector3& P2, float Width, const Color3F& C1, const Color3F& C2)
+	{
+		float* data = allocateLines(1);
 
 		// Set Vertices
-		m_points.vertices[m_index + 0] = P1.x;
-		m_points.vertices[m_index + 1] = P1.y;
-		m_points.vertices[m_index + 2] = P1.z;
-		m_points.vertices[m_index + 3] = C1.r;
-		m_points.vertices[m_index + 4] = C1.g;
-		m_points.vertices[m_index + 5] = C1.b;
-		m_points.vertices[m_index + 6] = Width;
-
-		m_points.vertices[m_index + 7] = P2.x;
-		m_points.vertices[m_index + 8] = P2.y;
-		m_points.vertices[m_index + 9] = P2.z;
-		m_points.vertices[m_index + 10] = C2.r;
-		m_points.vertices[m_index + 11] = C2.g;
-		m_points.vertices[m_index + 12] = C2.b;
-		m_points.vertices[m_index + 13] = Width;
-
-		// Increment Index
-		m_index += m_indexIncrement;
+		data[0] = P1.x;
+		data[1] = P1.y;
+		data[2] = P1.z;
+		data[3] = C1.r;
+		data[4] = C1.g;
+		data[5] = C1.b;
+		data[6] = Width;
+
+		data[7] = P2.x;
+		data[8] = P2.y;
+		data[9] = P2.z;
+		data[10] = C2.r;
+		data[11] = C2.g;
+		data[12] = C2.b;
+		data[13] = Width;
+	}
+	void LineMesh3D::addLines(const Vector3* points, uint32_t lineCount, float Width, const Color3F& C)
+	{
+		float* data = allocateLines(lineCount);
+
+		for (uint32_t i = 0; i < lineCount * 2; i++, data += m_indexIncrement / 2)
+		{
+			data[0] = points[i].x;
+			data[1] = points[i].y;
+			data[2] = points[i].z;
+			data[3] = C.r;
+			data[4] = C.g;
+			data[5] = C.b;
+			data[6] = Width;
+		}
 	}
 
 	void LineMesh3D::clear()
 	{
 		// Reset
 		m_index = 0;
-		m_points.vertices.clear();
+		m_points.clear();
 	}
 	void LineMesh3D::bind()
 	{
-		m_drawCount = m_points.getDrawCount();
-
 		// Buffers
 		if (!RenderManager.m_globalVAO)
 			m_VAO.bind();
 
-		// Resize vertices if index is smaller than its size
-		if (m_index < m_points.vertices.size() - 1)
-			m_points.vertices.resize(m_index + 1);
+		// Vector keeps its size between frames, lines past m_index are stale
+		m_stream.SetVertices(m_points.data(), m_index);
+		m_stream.bind();
 
-		m_points.bind();
+		m_drawCount = m_stream.GetDrawCount();
 	}
 
 	void LineMesh3D::draw()
 	{
+		if (m_drawCount == 0)
+			return;
+
 		if (!RenderManager.m_globalVAO)
 			m_VAO.bind();
 
@@ -618,56 +763,83 @@ namespace Vxl
 	}
 
 
+	float* LineMesh2D::allocateLines(uint32_t lineCount)
+	{
+		uint32_t end = m_index + lineCount * m_indexIncrement;
+
+		// Double instead of growing one line at a time
+		if (end > m_points.size())
+			m_points.resize(std::max(end, (uint32_t)m_points.size() * 2));
+
+		float* data = m_points.data() + m_index;
+		m_index = end;
+		return data;
+	}
+	void LineMesh2D::reserveLines(uint32_t lineCount)
+	{
+		uint32_t end = m_index + lineCount * m_indexIncrement;
+		if (end > m_points.size())
+			m_points.resize(end);
+	}
+
 	void LineMesh2D::addLine(const Vector2& P1, const Vector2& P2, float Width, const Color3F& C1, const Color3F& C2)
 	{
-		// Allocate necessary room
-		if (m_index + m_indexIncrement > m_points.size())
-		{
-			m_points.vertices.resize(m_index + m_indexIncrement);
-		}
+		float* data = allocateLines(1);
 
 		// Set Vertices
-		m_points.vertices[m_index + 0] = P1.x;
-		m_points.vertices[m_index + 1] = P1.y;
-		m_points.vertices[m_index + 2] = C1.r;
-		m_points.vertices[m_index + 3] = C1.g;
-		m_points.vertices[m_index + 4] = C1.b;
-		m_points.vertices[m_index + 5] = Width;
-
-		m_points.vertices[m_index + 6] = P2.x;
-		m_points.vertices[m_index + 7] = P2.y;
-		m_points.vertices[m_index + 8] = C2.r;
-		m_points.vertices[m_index + 9] = C2.g;
-		m_points.vertices[m_index + 10] = C2.b;
-		m_points.vertices[m_index + 11] = Width;
+		data[0] = P1.x;
+		data[1] = P1.y;
+		data[2] = C1.r;
+		data[3] = C1.g;
+		data[4] = C1.b;
+		data[5] = Width;
+
+		data[6] = P2.x;
+		data[7] = P2.y;
+		data[8] = C2.r;
+		data[9] = C2.g;
+		data[10] = C2.b;
+		data[11] = Width;
+	}
+	void LineMesh2D::addLines(const Vector2* points, uint32_t lineCount, float Width, const Color3F& C)
+	{
+		float* data = allocateLines(lineCount);
 
-		// Increment Index
-		m_index += m_indexIncrement;
+		for (uint32_t i = 0; i < lineCount * 2; i++, data += m_indexIncrement / 2)
+		{
+			data[0] = points[i].x;
+			data[1] = points[i].y;
+			data[2] = C.r;
+			data[3] = C.g;
+			data[4] = C.b;
+			data[5] = Width;
+		}
 	}
 
 	void LineMesh2D::clear()
 	{
 		// Reset
 		m_index = 0;
-		m_points.vertices.clear();
+		m_points.clear();
 	}
 	void LineMesh2D::bind()
 	{
-		m_drawCount = m_points.getDrawCount();
-
 		// Buffers
 		if (!RenderManager.m_globalVAO)
 			m_VAO.bind();
 
-		// Resize vertices if index is smaller than its size
-		if (m_index < m_points.vertices.size() - 1)
-			m_points.vertices.resize(m_index + 1);
+		// Vector keeps its size between frames, lines past m_index are stale
+		m_stream.SetVertices(m_points.data(), m_index);
+		m_stream.bind();
 
-		m_points.bind();
+		m_drawCount = m_stream.GetDrawCount();
 	}
 
 	void LineMesh2D::draw()
 	{
+		if (m_drawCount == 0)
+			return;
+
 		// Buffers
 		if (!RenderManager.m_globalVAO)
 			m_VAO.bind();
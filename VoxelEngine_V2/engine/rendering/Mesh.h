@@ -14,6 +14,7 @@
 namespace Vxl
 {
 	class Model;
+	struct MeshCacheView;
 
 	//
 	class Mesh
@@ -25,7 +26,7 @@ namespace Vxl
 
 		DrawType	m_type; // Triangles = Default
 		DrawSubType m_subtype; // points, lines, or triangles
-		DrawMode	m_mode; // Array = Default
+		DrawMode	m_mode = DrawMode::ARRAY; // Array = Default
 		uint32_t	m_drawCount = 0;	// Vertices Drawn
 		uint32_t	m_faces = 0;		// Triangles Drawn
 		uint32_t	m_lines = 0;		// Lines Drawn
@@ -33,21 +34,18 @@ namespace Vxl
 		Vector3		m_max; // largest vertices of mesh
 		Vector3		m_center; // (max + min) / 2
 		Vector3		m_scale;  // (max - min)
+		bool		m_packed = false;			// Attributes uploaded as m_packedVertices
+		bool		m_quantizePositions = true;	// Packed positions are relative to the bounds
 
 		void UpdateDrawInfo();
-
-		// Fills m_normals Based on existing positions and/or indices
-		void GenerateNormals(
-			const Vector3* _vertices, uint32_t _vertCount,
-			const uint32_t* _indices = nullptr, uint32_t _indexCount = 0,
-			bool smooth = false
-		);
-		// Fills m_tangents and m_bitangents based on existing positions/uvs/indices
-		void GenerateTangents(
-			const Vector3* _vertices, uint32_t _vertCount,
-			const Vector2* _uvs, uint32_t _UVCount,
-			const uint32_t* _indices = nullptr, uint32_t _indexCount = 0
-		);
+		void UpdateMinMax(const Vector3& min, const Vector3& max);
+		// Uploads all buffers without touching bounds [packing reads the current bounds]
+		void bindBuffers();
+		// Positions/uvs/normals/tangents, or the packed buffer that replaces them
+		void bindVertexBuffers();
+		// Everything but the instance buffer
+		void bindForInstances();
+		void drawInstances(uint32_t count);
 
 		// Protected, created through assets
 		Mesh(DrawType type = DrawType::TRIANGLES)
@@ -59,6 +57,23 @@ namespace Vxl
 
 		virtual ~Mesh() {}
 
+		// Fills _normals based on positions and/or indices [no GL, usable without a context]
+		static void GenerateNormals(
+			std::vector<Vector3>& _normals,
+			const Vector3* _vertices, uint32_t _vertCount,
+			const uint32_t* _indices = nullptr, uint32_t _indexCount = 0,
+			bool smooth = false
+		);
+		// Fills _tangents based on positions/uvs/indices [no GL, usable without a context]
+		// Vertices split with the same position/uv/normal end up with the same tangent
+		static void GenerateTangents(
+			std::vector<Vector3>& _tangents,
+			const Vector3* _vertices, uint32_t _vertCount,
+			const Vector2* _uvs, uint32_t _UVCount,
+			const uint32_t* _indices = nullptr, uint32_t _indexCount = 0,
+			const Vector3* _normals = nullptr
+		);
+
 		MeshBuffer<Vector3> m_positions		= MeshBuffer<Vector3>(BufferLayout({ {AttributeLocation::LOC0, AttributeType::VEC3} }), BufferUsage::STATIC_DRAW);
 		MeshBuffer<Vector2> m_uvs			= MeshBuffer<Vector2>(BufferLayout({ {AttributeLocation::LOC1, AttributeType::VEC2} }), BufferUsage::STATIC_DRAW);
 		MeshBuffer<Vector3> m_normals		= MeshBuffer<Vector3>(BufferLayout({ {AttributeLocation::LOC2, AttributeType::VEC3} }), BufferUsage::STATIC_DRAW);
@@ -73,9 +88,21 @@ namespace Vxl
 
 		MeshBufferIndices m_indices = MeshBufferIndices(BufferUsage::STATIC_DRAW);
 
+		// Interleaved copy of positions/uvs/normals/tangents, filled on bind when packed [see VertexPacking]
+		MeshBuffer<uint8_t> m_packedVertices = MeshBuffer<uint8_t>(GetPackedLayout(true), BufferUsage::STATIC_DRAW);
+
+		// Layout of VertexPacking::PackVertices, attributes keep their usual locations
+		static BufferLayout GetPackedLayout(bool quantizePositions);
+
 		// Update all data from model
 		void set(const Model& _model);
+		// Update all data from a mapped cache file [bounds come from the cache]
+		void set(const MeshCacheView& _view);
 		void setGLName(const std::string& name);
+		// Opt-in single interleaved buffer [20 bytes per vertex, 24 without quantized positions, instead of 44]
+		// Takes effect on next bind, set it before the first one so the separate buffers are never created
+		// Shaders decode it through VXL_unpackPosition/VXL_unpackDirection [_Core.glsl]
+		void setPacked(bool state, bool quantizePositions = true);
 
 		inline uint32_t		getDrawCount(void)	 const
 		{
@@ -113,13 +140,26 @@ namespace Vxl
 		{
 			return m_VAO.getID();
 		}
+		inline bool			isPacked(void) const
+		{
+			return m_packed;
+		}
+		inline bool			hasQuantizedPositions(void) const
+		{
+			return m_packed && m_quantizePositions;
+		}
 
 		void generateNormals(bool Smooth);
 		void generateTangents();
+		// Merges duplicate vertices [all attributes within tolerance] and rebuilds indices, returns new vertex count
+		uint32_t weldVertices(float tolerance = 0.00001f);
 		void recalculateMinMax();
 
 		void bind();
 		void draw();
+		// Draws count instances using an external instance buffer [layout must match m_instances]
+		void drawInstanced(const VBO& instances, uint32_t count);
+		void drawInstanced(const StreamVBO& instances, uint32_t count);
 	};
 
 	//
@@ -141,21 +181,28 @@ namespace Vxl
 			: m_type(type)
 		{
 			m_subtype = Graphics::GetDrawSubType(type);
+			m_stream.SetLayout(BufferLayout(
+				{
+					{AttributeLocation::LOC0, AttributeType::VEC3 }, // Position
+					{AttributeLocation::LOC3, AttributeType::VEC3 }, // Color
+					{AttributeLocation::LOC1, AttributeType::FLOAT}  // Width
+				}));
 		}
 	public:
-		MeshBuffer<float> m_points = MeshBuffer<float>(BufferLayout(
-			{
-				{AttributeLocation::LOC0, AttributeType::VEC3 }, // Position
-				{AttributeLocation::LOC3, AttributeType::VEC3 }, // Color
-				{AttributeLocation::LOC1, AttributeType::FLOAT}  // Width
-			}),
-			BufferUsage::DYNAMIC_DRAW
-			);
+		// Lines for this frame, only the used part is streamed on bind
+		std::vector<float> m_points;
+		StreamVBO m_stream;
 		
 		// Used to reference where in points the vertices is being used
 		uint32_t m_index = 0;
 
+		// Returns room for lineCount lines [m_indexIncrement floats each], storage grows geometrically
+		float* allocateLines(uint32_t lineCount);
+		void reserveLines(uint32_t lineCount);
+
 		void addLine(const Vector3& P1, const Vector3& P2, float Width, const Color3F& C1, const Color3F& C2);
+		// Points are consecutive pairs, all lines share width and color
+		void addLines(const Vector3* points, uint32_t lineCount, float Width, const Color3F& C);
 
 		void resetIndex() { m_index = 0; }
 		void clear();
@@ -183,21 +230,28 @@ namespace Vxl
 			: m_type(type)
 		{
 			m_subtype = Graphics::GetDrawSubType(type);
+			m_stream.SetLayout(BufferLayout(
+				{
+					{AttributeLocation::LOC0, AttributeType::VEC2 }, // Position
+					{AttributeLocation::LOC3, AttributeType::VEC3 }, // Color
+					{AttributeLocation::LOC1, AttributeType::FLOAT}  // Width
+				}));
 		}
 	public:
-		MeshBuffer<float> m_points = MeshBuffer<float>(BufferLayout(
-			{
-				{AttributeLocation::LOC0, AttributeType::VEC2 }, // Position
-				{AttributeLocation::LOC3, AttributeType::VEC3 }, // Color
-				{AttributeLocation::LOC1, AttributeType::FLOAT}  // Width
-			}),
-			BufferUsage::DYNAMIC_DRAW
-			);
+		// Lines for this frame, only the used part is streamed on bind
+		std::vector<float> m_points;
+		StreamVBO m_stream;
 
 		// Used to reference where in points the vertices is being used
 		uint32_t m_index = 0;
 
+		// Returns room for lineCount lines [m_indexIncrement floats each], storage grows geometrically
+		float* allocateLines(uint32_t lineCount);
+		void reserveLines(uint32_t lineCount);
+
 		void addLine(const Vector2& P1, const Vector2& P2, float Width, const Color3F& C1, const Color3F& C2);
+		// Points are consecutive pairs, all lines share width and color
+		void addLines(const Vector2* points, uint32_t lineCount, float Width, const Color3F& C);
 
 		void resetIndex() { m_index = 0; }
 		void clear();
@@ -6,9 +6,14 @@
 
 #include "VBO.h"
 
+#include <algorithm>
+
+#define MESHBUFFER_MAX_RANGES 8 // More dirty ranges than this are merged into one upload
+
 namespace Vxl
 {
-	// MeshBuffer
+	// MeshBuffer [CPU copy of a VBO, bind only uploads what changed]
+	// Writing to vertices directly requires markDirty, operator= and set() do it for you
 	template<typename Type>
 	class MeshBuffer
 	{
@@ -16,6 +21,7 @@ namespace Vxl
 		VBO			m_vbo;
 		BufferUsage m_bindMode;
 		uint32_t	m_storedVertexSize = 0;
+		std::vector<std::pair<uint32_t, uint32_t>> m_dirty; // [first, last) vertices, sorted and never touching
 	public:
 
 		// Vertices to modify
@@ -25,8 +31,50 @@ namespace Vxl
 		MeshBuffer<Type>& operator=(const std::vector<Type>& _vector)
 		{
 			vertices = _vector;
+			markDirty();
 			return *this;
 		}
+		void set(uint32_t index, const Type& value)
+		{
+			vertices[index] = value;
+			markDirty(index, 1);
+		}
+		// Vertices to upload on next bind [size changes always upload everything]
+		void markDirty(uint32_t first, uint32_t count)
+		{
+			if (count == 0)
+				return;
+
+			uint32_t last = first + count;
+
+			// Absorb every range that overlaps or touches
+			auto it = std::lower_bound(m_dirty.begin(), m_dirty.end(), first,
+				[](const std::pair<uint32_t, uint32_t>& range, uint32_t value) { return range.second < value; });
+			auto end = it;
+			while (end != m_dirty.end() && end->first <= last)
+			{
+				first = (std::min)(first, end->first);
+				last = (std::max)(last, end->second);
+				++end;
+			}
+			it = m_dirty.erase(it, end);
+			m_dirty.insert(it, { first, last });
+
+			// Many small uploads cost more than one larger one
+			if (m_dirty.size() > MESHBUFFER_MAX_RANGES)
+			{
+				std::pair<uint32_t, uint32_t> all = { m_dirty.front().first, m_dirty.back().second };
+				m_dirty.assign(1, all);
+			}
+		}
+		void markDirty(void)
+		{
+			m_dirty.assign(1, { 0, (uint32_t)vertices.size() });
+		}
+		bool isDirty(void) const
+		{
+			return !m_dirty.empty();
+		}
 		bool isEmpty(void) const
 		{
 			return !vertices.size();
@@ -58,11 +106,17 @@ namespace Vxl
 			{
 				m_vbo.SetVertices(vertices.data(), (uint32_t)vertices.size(), m_bindMode);
 			}
-			// Size hasn't changed, just update vertices
+			// Size hasn't changed, only upload modified ranges [untouched buffers are never uploaded again]
 			else
 			{
-				m_vbo.UpdateVertices(vertices.data(), 0);
+				for (const auto& range : m_dirty)
+				{
+					uint32_t last = (std::min)(range.second, verticesCount);
+					if (range.first < last)
+						m_vbo.UpdateVertices(vertices.data() + range.first, range.first * sizeof(Type), (last - range.first) * sizeof(Type));
+				}
 			}
+			m_dirty.clear();
 			m_storedVertexSize = verticesCount;
 
 			m_vbo.bind();
@@ -82,6 +136,7 @@ namespace Vxl
 		EBO			m_ebo;
 		BufferUsage m_bindMode;
 		uint32_t	m_storedVertexSize = 0;
+		bool		m_dirty = false;
 	public:
 
 		// Vertices to modify
@@ -91,8 +146,14 @@ namespace Vxl
 		MeshBufferIndices& operator=(const std::vector<uint32_t>& _vector)
 		{
 			vertices = _vector;
+			m_dirty = true;
 			return *this;
 		}
+		// Indices are always uploaded whole, call after writing to vertices directly
+		void markDirty(void)
+		{
+			m_dirty = true;
+		}
 		uint32_t getDrawCount(void) const
 		{
 			return m_ebo.GetDrawCount();
@@ -117,10 +178,11 @@ namespace Vxl
 				m_ebo.SetIndices(vertices.data(), (uint32_t)vertices.size(), m_bindMode);
 			}
 			// Size hasn't changed, just update vertices
-			else
+			else if (m_dirty)
 			{
 				m_ebo.UpdateIndices(vertices.data(), 0);
 			}
+			m_dirty = false;
 			m_storedVertexSize = verticesCount;
 
 			m_ebo.bind();
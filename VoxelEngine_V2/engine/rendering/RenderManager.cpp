@@ -7,7 +7,9 @@
 #include "Mesh.h"
 #include "FramebufferObject.h"
 #include "Graphics.h"
+#include "GraphicsBackend.h"
 #include "RenderBuffer.h"
+#include "VBO.h"
 
 #include "../modules/Scene.h"
 #include "../modules/Layer.h"
@@ -24,7 +26,9 @@
 #include "../window/window.h"
 #include "../editor/Editor.h"
 #include "../rendering/Gizmo.h"
+#include "../rendering/MaterialParameters.h"
 #include "../rendering/Shader.h"
+#include "../rendering/ShaderReloader.h"
 
 #include "../objects/GameObject.h"
 #include "../objects/LightObject.h"
@@ -34,8 +38,12 @@
 #include "../editorGui/GUI_Viewport.h"
 
 #include "../utilities/Asset.h"
+#include "../utilities/AssetLoader.h"
+#include "../utilities/JobSystem.h"
+#include "../utilities/Profiler.h"
 
 #include <algorithm>
+#include <tuple>
 
 namespace Vxl
 {
@@ -66,6 +74,15 @@ namespace Vxl
 	//		return m_layers[index];
 	//	}
 
+	void RenderManager::UpdateMeshBounds(MeshIndex mesh)
+	{
+		for (const auto& entity : Assets.getAllEntity())
+		{
+			if (entity.second->getMesh() == mesh)
+				entity.second->UpdateBoundingBoxCheap();
+		}
+	}
+
 	void RenderManager::UpdateAllWindowAspectCameras()
 	{
 		auto AllCameras = Assets.getAllCamera();
@@ -129,6 +146,7 @@ namespace Vxl
 	{
 		// UBO = first
 		UBOManager.InitGLResources();
+		MaterialParameterBuffer.InitGLResources();
 
 #ifdef GLOBAL_IMGUI
 		GUI_Viewport.InitGLResources();
@@ -143,11 +161,22 @@ namespace Vxl
 		Primitives.InitGLResources();
 
 		GlobalAssets.InitGLResources();
+
+		// Same layout as Mesh::m_instances
+		m_instanceBatch = new StreamVBO();
+		m_instanceBatch->SetLayout(BufferLayout(
+			{
+				{AttributeLocation::LOC8, AttributeType::VEC4, false, 1},
+				{AttributeLocation::LOC9, AttributeType::VEC4, false, 1},
+				{AttributeLocation::LOC10, AttributeType::VEC4, false, 1},
+				{AttributeLocation::LOC11, AttributeType::VEC4, false, 1}
+			}));
 	}
 	void RenderManager::DestroyGlobalGLResources()
 	{
 		// UBO = first
 		UBOManager.DestroyGLResources();
+		MaterialParameterBuffer.DestroyGLResources();
 
 #ifdef GLOBAL_IMGUI
 		GUI_Viewport.DestroyGLResources();
@@ -163,6 +192,11 @@ namespace Vxl
 		Primitives.DestroyGLResources();
 
 		GlobalAssets.DestroyAndEraseAll();
+
+		delete m_instanceBatch;
+		m_instanceBatch = nullptr;
+
+		Profiler.DestroyGLResources();
 	}
 
 	//
@@ -171,27 +205,30 @@ namespace Vxl
 		// Remove selected entity
 		Editor.clearSelection();
 
-		// Delete special
-		GPUTimer::DestroyTimers();
-
 		// Delete All Scene Assets
 		SceneAssets.DestroyAndEraseAll();
 	}
 	void RenderManager::Update()
 	{
+		VXL_PROFILE_SCOPE("RenderManager::Update");
+
+		// Edited shader files start preprocessing [built by AssetLoader uploads]
+		ShaderReloader.Update();
+
+		// Finish background loads within budget
+		AssetLoader.Update();
+
+		// GL work handed back by jobs
+		JobSystem.RunMainThreadJobs();
+
 		m_currentScene->Update();
 
+		// Batch update all moved transforms
+		TransformManager.Update();
+
 		// Update all entities
 		//	for (auto it = m_allEntities.begin(); it != m_allEntities.end(); it++)
 		//		(*it)->update();
-
-		// Update all CPU Timers
-		for (auto it = CPUTimer::m_timers.begin(); it != CPUTimer::m_timers.end(); it++)
-			it->second->Update();
-
-		// Update all GPU Timers
-		for (auto it = GPUTimer::m_timers.begin(); it != GPUTimer::m_timers.end(); it++)
-			it->second->Update();
 	}
 	void RenderManager::UpdateFixed()
 	{
@@ -199,6 +236,19 @@ namespace Vxl
 	}
 	void RenderManager::Draw()
 	{
+		m_lastDrawCallCount = m_drawCallCount;
+		m_lastBatchedEntityCount = m_batchedEntityCount;
+		m_drawCallCount = 0;
+		m_batchedEntityCount = 0;
+		m_lastTextureBindCount = Graphics::Texture::GetBindCount();
+		m_lastSkippedTextureBindCount = Graphics::Texture::GetSkippedBindCount();
+		Graphics::Texture::ResetBindCounts();
+
+		// Backend counts and recording only cover the current frame
+		GraphicsBackend::ResetStats();
+		GraphicsBackend::ClearRecording();
+
+		VXL_PROFILE_SCOPE("RenderManager::Draw");
 		m_currentScene->Draw();
 		Debug.End();
 	}
@@ -229,12 +279,24 @@ namespace Vxl
 		m_materialSequence.clear();
 		for (const auto& material : materials)
 		{
+			material.second->m_sequenceRank = -1;
+
 			uint32_t SequenceID = material.second->getSequenceID();
 			if (SequenceID == -1)
 				continue;
 
 			m_materialSequence[SequenceID] = material.first;
 		}
+
+		// Rank = compact sequence order for sort keys
+		uint32_t rank = 0;
+		for (const auto& sequence : m_materialSequence)
+			Assets.getMaterial(sequence.second)->m_sequenceRank = rank++;
+
+		VXL_ASSERT(rank <= (1u << RenderQueue::SequenceBits), "Too many material sequences for render queue keys");
+
+		// Keys are out of date
+		m_renderQueueDirty = true;
 	}
 
 	void RenderManager::sortEntities()
@@ -244,55 +306,258 @@ namespace Vxl
 
 		m_renderlistDirty = false;
 
-		// Data
-		const auto& materials = Assets.getAllMaterial();
-		const auto& entities = Assets.getAllEntity();
+		// Entities with a material, draw order is decided by the render queue
+		m_renderables.clear();
+		for (const auto& entity : Assets.getAllEntity())
+		{
+			if (entity.second->getMaterial() != -1)
+				m_renderables.push_back(entity.second);
+		}
 
-		// Material/Entity match
-		m_renderlist_opaque.clear();
-		m_renderlist_transparent.clear();
-		
-		// Setup Slots
-		for (const auto& material : materials)
+		// Render queue holds pointers from the old list
+		m_renderQueue.clear();
+		m_renderQueueDirty = true;
+	}
+
+	// Entities with the same textures end up next to each other [0 = material textures]
+	static uint32_t TextureSetKey(const std::map<TextureLevel, TextureIndex>& textures)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (const auto& texture : textures)
 		{
-			if(material.second->m_renderMode == MaterialRenderMode::Opaque)
-				m_renderlist_opaque[material.first] = std::vector<Entity*>();
-			else
-				m_renderlist_transparent[material.first] = std::vector<Entity*>();
+			hash = (hash ^ (uint64_t)texture.first) * 1099511628211ull;
+			hash = (hash ^ (uint64_t)texture.second) * 1099511628211ull;
 		}
 
-		// Fill Slots
-		for (const auto& entity : entities)
+		uint32_t key = (uint32_t)(hash ^ (hash >> 32)) & ((1u << RenderQueue::TextureSetBits) - 1);
+		return key ? key : 1;
+	}
+
+	void RenderManager::cullEntities()
+	{
+		// Only rebuild once per frame unless render lists have changed
+		if (m_cullFrame == Time.GetFrameCount() && !m_renderQueueDirty)
+			return;
+
+		VXL_PROFILE_SCOPE("RenderManager::cullEntities");
+
+		m_cullFrame = Time.GetFrameCount();
+		m_renderQueueDirty = false;
+
+		m_visibleCount = 0;
+		m_culledCount = 0;
+		m_renderQueue.clear();
+
+		uint32_t count = (uint32_t)m_renderables.size();
+		if (count == 0)
+			return;
+
+		// Frustum culling
+		Camera* camera = Assets.getCamera(m_mainCamera);
+		m_cullResults.resize(count);
+		if (m_frustumCulling && camera)
+		{
+			m_cullAABBs.resize(count);
+			for (uint32_t i = 0; i < count; i++)
+				m_cullAABBs[i] = m_renderables[i]->col_AABB;
+
+			FrustumCullAABBs(Frustum(camera->getViewProjection()), m_cullAABBs.data(), count, m_cullResults.data());
+		}
+		else
+			std::fill(m_cullResults.begin(), m_cullResults.end(), (uint8_t)1);
+
+		// Depth = distance to camera relative to far plane
+		Vector3 cameraPosition = camera ? camera->m_transform.getWorldPosition() : Vector3::ZERO;
+		float depthScale = (camera && camera->GetZFar() > 0.0f) ? 1.0f / camera->GetZFar() : 0.0f;
+
+		for (uint32_t i = 0; i < count; i++)
 		{
-			if (entity.second->getMaterial() == -1)
+			Entity* entity = m_renderables[i];
+
+			// Material might have been destroyed, or isn't part of the sequence
+			Material* material = Assets.getMaterial(entity->m_material);
+			if (!material || material->m_sequenceRank == -1)
 				continue;
 
-			Material* mat = Assets.getMaterial(entity.second->m_material);
-			MaterialRenderMode mode = mat->m_renderMode;
+			Mesh* mesh = Assets.getMesh(entity->m_mesh);
 
-			if (mode == MaterialRenderMode::Opaque)
-				m_renderlist_opaque[entity.second->m_material].push_back(entity.second);
-			else
-				m_renderlist_transparent[entity.second->m_material].push_back(entity.second);
+			// Bounding box doesn't cover instances, never cull them
+			if (!m_cullResults[i] && (!mesh || mesh->m_instances.isEmpty()))
+			{
+				m_culledCount++;
+				continue;
+			}
+			m_visibleCount++;
+
+			bool transparent = material->m_renderMode == MaterialRenderMode::Transparent;
+			uint32_t textureSet = material->m_sharedTextures ? 0 : TextureSetKey(entity->m_textures);
+			uint32_t vao = mesh ? mesh->getVAOID() : 0;
+			float depth = Vector3::Distance(cameraPosition, entity->col_AABB.getCenter()) * depthScale;
 
+			m_renderQueue.push(RenderQueue::MakeKey(transparent, material->m_sequenceRank, textureSet, vao, depth), entity);
 		}
 
-		// Sort each Material/Entity slots based on their VAO Id to make sure similar meshes render one after another
-		// Ignore sorting if global VAOs are used instead
-		if (!m_globalVAO)
+		m_renderQueue.sort();
+
+		if (camera)
+			batchMVPs(camera->getViewProjection());
+	}
+
+	void RenderManager::batchMVPs(const Matrix4x4& viewProjection)
+	{
+		// Old entries become invalid even if nothing is visible
+		m_mvpStamp++;
+		m_mvpViewProjection = viewProjection;
+
+		const std::vector<Entity*>& entities = m_renderQueue.getEntities();
+		m_mvpModels.clear();
+		for (Entity* entity : entities)
+		{
+			if (entity->m_useTransform)
+			{
+				m_mvpModels.push_back(entity->m_transform.getModel());
+				entity->m_mvpModelStamp = entity->m_transform.getStamp();
+			}
+		}
+
+		uint32_t count = (uint32_t)m_mvpModels.size();
+		m_mvpResults.resize(count);
+		if (count > 0)
+			Matrix4x4::MultiplyBatch(viewProjection, m_mvpModels.data(), m_mvpResults.data(), count);
+
+		uint32_t index = 0;
+		for (Entity* entity : entities)
+		{
+			if (entity->m_useTransform)
+			{
+				entity->m_mvp = m_mvpResults[index++];
+				entity->m_mvpStamp = m_mvpStamp;
+			}
+		}
+	}
+
+	// Test every triangle of a mesh with a ray in the mesh's local space
+	static bool RaycastMeshTriangles(const Ray& localRay, const Mesh* mesh, float maxDistance, float& distance)
+	{
+		const std::vector<Vector3>& positions = mesh->m_positions.vertices;
+		const std::vector<uint32_t>& indices = mesh->m_indices.vertices;
+
+		bool	 indexed = !indices.empty();
+		uint32_t count = indexed ? (uint32_t)indices.size() : (uint32_t)positions.size();
+		if (count < 3)
+			return false;
+
+		bool hit = false;
+		auto testTriangle = [&](uint32_t i0, uint32_t i1, uint32_t i2)
 		{
-			for (auto& set : m_renderlist_opaque)
+			if (indexed)
 			{
-				std::sort(set.second.begin(), set.second.end());
+				i0 = indices[i0];
+				i1 = indices[i1];
+				i2 = indices[i2];
 			}
-			for (auto& set : m_renderlist_transparent)
+			RayHit result = Intersection(localRay, positions[i0], positions[i1], positions[i2]);
+			if (!result.m_missed && result.m_distance < maxDistance)
 			{
-				std::sort(set.second.begin(), set.second.end());
+				maxDistance = result.m_distance;
+				hit = true;
 			}
+		};
+
+		switch (mesh->getDrawType())
+		{
+		case DrawType::TRIANGLES:
+			for (uint32_t i = 0; i + 2 < count; i += 3)
+				testTriangle(i, i + 1, i + 2);
+			break;
+		case DrawType::TRIANGLE_STRIP:
+			for (uint32_t i = 0; i + 2 < count; i++)
+				testTriangle(i, i + 1, i + 2);
+			break;
+		case DrawType::TRIANGLE_FAN:
+			for (uint32_t i = 1; i + 1 < count; i++)
+				testTriangle(0, i, i + 1);
+			break;
+		default:
+			// Points/Lines can't be hit by a ray
+			return false;
+		}
+
+		if (hit)
+			distance = maxDistance;
+
+		return hit;
+	}
+
+	bool RenderManager::raycastEntity(const Ray& ray, Entity* entity, float maxDistance, float& distance)
+	{
+		Mesh* mesh = Assets.getMesh(entity->m_mesh);
+		if (!mesh || mesh->m_positions.isEmpty())
+			return false;
+
+		const Matrix4x4& model = entity->m_transform.getModel();
+
+		// Moving the ray into local space keeps the same distance parameter, as long as the direction isn't normalized again
+		auto raycastModel = [&](const Matrix4x4& worldModel)
+		{
+			Matrix4x4 inverse = worldModel.Inverse();
+			Ray localRay(
+				Vector3(inverse * Vector4(ray.m_origin, 1.0f)),
+				inverse * ray.m_direction
+			);
+			return RaycastMeshTriangles(localRay, mesh, maxDistance, maxDistance);
+		};
+
+		bool hit = false;
+		if (mesh->m_instances.isEmpty())
+			hit = raycastModel(model);
+		else
+		{
+			for (const Matrix4x4& instance : mesh->m_instances.vertices)
+				hit |= raycastModel(model * instance.Transpose());
 		}
+
+		if (hit)
+			distance = maxDistance;
+
+		return hit;
+	}
+
+	PickResult RenderManager::pickEntity(const Ray& ray, float maxDistance)
+	{
+		PickResult result;
+
+		// Broadphase through entity bounds, the ray gets shorter with every closer hit
+		m_entityTree.queryRay(ray, maxDistance, [&](uint32_t sceneNodeIndex, float currentMax)
+		{
+			Entity* entity = Assets.getEntity(sceneNodeIndex);
+			if (!entity || !entity->IsFamilyActive() || !entity->m_isSelectable)
+				return currentMax;
+
+			float distance;
+			if (raycastEntity(ray, entity, currentMax, distance))
+			{
+				result.m_sceneNode = sceneNodeIndex;
+				result.m_distance = distance;
+				result.m_hit = true;
+				return distance;
+			}
+			return currentMax;
+		});
+
+		return result;
+	}
+	PickResult RenderManager::pickEntity(const Vector2& screenSpace)
+	{
+		Camera* camera = Assets.getCamera(m_mainCamera);
+		if (!camera)
+			return PickResult();
+
+		Ray ray(camera->m_transform.getWorldPosition(), camera->ScreenSpaceToDirection(screenSpace));
+		return pickEntity(ray);
 	}
 
-	void RenderManager::render(MaterialIndex _material, const std::vector<Entity*>& _entities)
+	void RenderManager::render(MaterialIndex _material, Entity* const* _entities, uint32_t _count)
 	{
 		Material* material = Assets.getMaterial(_material);
 
@@ -307,31 +572,115 @@ namespace Vxl
 			}
 
 			material->bindProgramStates(ShaderMaterialType::CORE);
+			material->bindParameters();
 
 			if(material->m_sharedTextures)
 				material->bindTextures(ShaderMaterialType::CORE, nullptr);
+
+			// Transparent entities keep their order, shader must read instance matrices
+			ShaderProgram* program = material->getProgram(ShaderMaterialType::CORE);
+			bool batching =
+				m_instancedBatching && m_instanceBatch &&
+				material->m_renderMode == MaterialRenderMode::Opaque &&
+				program && program->supportsInstancing();
+
+			m_batchEntities.clear();
 			
-			for (auto& ent : _entities)
+			for (uint32_t i = 0; i < _count; i++)
 			{
+				Entity* ent = _entities[i];
 				if (ent->IsFamilyActive())
 				{
 					Mesh* mesh = Assets.getMesh(ent->m_mesh);
 					if (mesh)
 					{
+						// Meshes with their own instances can't be merged
+						if (batching && ent->m_useTransform && mesh->m_instances.isEmpty())
+						{
+							m_batchEntities.push_back(ent);
+							continue;
+						}
+
 						if (!material->m_sharedTextures)
 							material->bindTextures(ShaderMaterialType::CORE, ent);
 
 						material->bindProgramUniforms(ShaderMaterialType::CORE, ent->m_uniqueID);
 
 						mesh->draw();
+						m_drawCallCount++;
 					}
 				}
 			}
+
+			if (!m_batchEntities.empty())
+				renderBatches(material, program);
 		}
 	}
-	void RenderManager::render_ColorID(MaterialIndex _material, const std::vector<Entity*>& _entities)
+
+	// Entities in the same batch send identical uniforms/textures, so only the first one is bound
+	bool RenderManager::BatchOrder(Entity* a, Entity* b)
 	{
-		if (_entities.size() == 0)
+		if (a->m_mesh != b->m_mesh)
+			return a->m_mesh < b->m_mesh;
+
+		if (a->m_useTextures != b->m_useTextures)
+			return a->m_useTextures < b->m_useTextures;
+
+		if (a->m_textures != b->m_textures)
+			return a->m_textures < b->m_textures;
+
+		auto colorA = std::tie(a->m_Color.r, a->m_Color.g, a->m_Color.b, a->m_Tint.r, a->m_Tint.g, a->m_Tint.b);
+		auto colorB = std::tie(b->m_Color.r, b->m_Color.g, b->m_Color.b, b->m_Tint.r, b->m_Tint.g, b->m_Tint.b);
+		return colorA < colorB;
+	}
+	void RenderManager::renderBatches(Material* material, ShaderProgram* program)
+	{
+		std::sort(m_batchEntities.begin(), m_batchEntities.end(), BatchOrder);
+
+		size_t count = m_batchEntities.size();
+		size_t start = 0;
+		while (start < count)
+		{
+			// Sorted, so the batch ends at the first entity that orders after
+			size_t end = start + 1;
+			while (end < count && !BatchOrder(m_batchEntities[start], m_batchEntities[end]))
+				end++;
+
+			Entity* ent = m_batchEntities[start];
+			Mesh* mesh = Assets.getMesh(ent->m_mesh);
+
+			if (!material->m_sharedTextures)
+				material->bindTextures(ShaderMaterialType::CORE, ent);
+
+			material->bindProgramUniforms(ShaderMaterialType::CORE, ent->m_uniqueID);
+
+			if (end - start == 1)
+			{
+				mesh->draw();
+			}
+			else
+			{
+				// Instance matrices are stored transposed [same as Mesh::m_instances]
+				m_batchInstances.clear();
+				for (size_t i = start; i < end; i++)
+					m_batchInstances.push_back(m_batchEntities[i]->m_transform.getModel().Transpose());
+
+				uint32_t instanceCount = (uint32_t)m_batchInstances.size();
+				m_instanceBatch->SetVertices(m_batchInstances.data(), instanceCount);
+
+				program->bindBatchUniforms();
+				mesh->drawInstanced(*m_instanceBatch, instanceCount);
+
+				m_batchedEntityCount += instanceCount;
+			}
+
+			m_drawCallCount++;
+			start = end;
+		}
+	}
+	void RenderManager::render_ColorID(MaterialIndex _material, Entity* const* _entities, uint32_t _count)
+	{
+		if (_count == 0)
 			return;
 
 		Material* material = Assets.getMaterial(_material);
@@ -345,12 +694,14 @@ namespace Vxl
 			}
 
 			material->bindProgramStates(ShaderMaterialType::COLORID);
+			material->bindParameters();
 
 			if (material->m_sharedTextures)
 				material->bindTextures(ShaderMaterialType::COLORID, nullptr);
 
-			for (auto& ent : _entities)
+			for (uint32_t i = 0; i < _count; i++)
 			{
+				Entity* ent = _entities[i];
 				if (ent->IsFamilyActive())
 				{
 					Mesh* mesh = Assets.getMesh(ent->m_mesh);
@@ -368,49 +719,40 @@ namespace Vxl
 		}
 	}
 
-	void RenderManager::renderOpaque(ShaderMaterialType type)
+	void RenderManager::renderQueue(uint32_t begin, uint32_t end, ShaderMaterialType type)
 	{
-		// Check all materials in order
-		for (const auto& data : m_materialSequence)
+		const std::vector<Entity*>& entities = m_renderQueue.getEntities();
+
+		uint32_t start = begin;
+		while (start < end)
 		{
-			MaterialIndex _materialIndex = data.second;
-			// Render all associated entities tied to that material
-			if (m_renderlist_opaque.find(_materialIndex) != m_renderlist_opaque.end())
+			// Runs of the same material share program and state binding
+			MaterialIndex _materialIndex = entities[start]->m_material;
+			uint32_t stop = start + 1;
+			while (stop < end && entities[stop]->m_material == _materialIndex)
+				stop++;
+
+			switch (type)
 			{
-				switch (type)
-				{
-				case ShaderMaterialType::CORE:
-					render(_materialIndex, m_renderlist_opaque[_materialIndex]);
-					continue;
+			case ShaderMaterialType::CORE:
+				render(_materialIndex, &entities[start], stop - start);
+				break;
 
-				case ShaderMaterialType::COLORID:
-					render_ColorID(_materialIndex, m_renderlist_opaque[_materialIndex]);
-					continue;
-				}
+			case ShaderMaterialType::COLORID:
+				render_ColorID(_materialIndex, &entities[start], stop - start);
+				break;
 			}
+
+			start = stop;
 		}
 	}
+	void RenderManager::renderOpaque(ShaderMaterialType type)
+	{
+		renderQueue(0, m_renderQueue.getTransparentStart(), type);
+	}
 	void RenderManager::renderTransparent(ShaderMaterialType type)
 	{
-		// Check all materials in order
-		for (const auto& data : m_materialSequence)
-		{
-			MaterialIndex _materialIndex = data.second;
-			// Render all associated entities tied to that material
-			if (m_renderlist_transparent.find(_materialIndex) != m_renderlist_transparent.end())
-			{
-				switch (type)
-				{
-				case ShaderMaterialType::CORE:
-					render(_materialIndex, m_renderlist_opaque[_materialIndex]);
-					continue;
-
-				case ShaderMaterialType::COLORID:
-					render_ColorID(_materialIndex, m_renderlist_opaque[_materialIndex]);
-					continue;
-				}
-			}
-		}
+		renderQueue(m_renderQueue.getTransparentStart(), m_renderQueue.size(), type);
 	}
 
 
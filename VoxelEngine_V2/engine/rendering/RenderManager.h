@@ -7,11 +7,18 @@
 #include <unordered_map>
 #include <map>
 #include <vector>
+#include <cfloat>
 
 #include "../utilities/singleton.h"
 #include "../utilities/Macros.h"
 #include "../utilities/Types.h"
 
+#include "../math/Collision.h"
+#include "../math/AABBTree.h"
+#include "../math/Matrix4x4.h"
+
+#include "RenderQueue.h"
+
 #define MAX_LAYERS 32
 
 namespace Vxl
@@ -21,6 +28,9 @@ namespace Vxl
 	class Entity;
 	class Camera;
 	class GuiWindow;
+	class Material;
+	class ShaderProgram;
+	class StreamVBO;
 	enum class ShaderMaterialType;
 
 	// Special Rendering info
@@ -30,22 +40,69 @@ namespace Vxl
 		QUAD
 	};
 
+	// Result of a CPU ray pick
+	struct PickResult
+	{
+		SceneNodeIndex	m_sceneNode = -1;
+		float			m_distance = FLT_MAX;
+		bool			m_hit = false;
+	};
+
 	static class RenderManager : public Singleton<class RenderManager>
 	{
 		DISALLOW_COPY_AND_ASSIGN(RenderManager);
 		friend class Hierarchy;
 		friend class Editor;
+		friend class Entity;
+		friend class ShaderProgram;
 	private:
 		Scene* m_currentScene = nullptr;
 
 		// Associate Materials with rendering sequence
 		std::map<uint32_t, MaterialIndex> m_materialSequence;
 		bool m_materialSequenceDirty = false;
-		// Associate entities to materials [internal map sorts by VAO ID to make sure similar meshes render one after another]1
-		std::map<MaterialIndex, std::vector<Entity*>> m_renderlist_opaque;
-		std::map<MaterialIndex, std::vector<Entity*>> m_renderlist_transparent;
+		// All entities that have a material
+		std::vector<Entity*> m_renderables;
 		bool m_renderlistDirty = false;
 
+		// Frustum culled entities sorted by draw key [rebuilt every frame]
+		RenderQueue				m_renderQueue;
+		std::vector<AABB>		m_cullAABBs;
+		std::vector<uint8_t>	m_cullResults;
+		uint32_t m_cullFrame = -1;
+		bool	 m_renderQueueDirty = true;
+		uint32_t m_visibleCount = 0;
+		uint32_t m_culledCount = 0;
+
+		// Main camera MVPs of visible entities, computed in one batch after culling
+		std::vector<Matrix4x4>	m_mvpModels;
+		std::vector<Matrix4x4>	m_mvpResults;
+		Matrix4x4				m_mvpViewProjection;
+		uint32_t				m_mvpStamp = 0;
+
+		// Spatial index of all entity bounding boxes [Entities keep their own proxy]
+		AABBTree m_entityTree;
+
+		// Instanced batching [entities sharing mesh, material, textures and colors become one draw]
+		StreamVBO*				m_instanceBatch = nullptr;
+		std::vector<Entity*>	m_batchEntities;
+		std::vector<Matrix4x4>	m_batchInstances;
+		uint32_t m_drawCallCount = 0;
+		uint32_t m_batchedEntityCount = 0;
+		uint32_t m_lastDrawCallCount = 0;
+		uint32_t m_lastBatchedEntityCount = 0;
+		uint32_t m_lastTextureBindCount = 0;
+		uint32_t m_lastSkippedTextureBindCount = 0;
+
+		static bool BatchOrder(Entity* a, Entity* b);
+		void renderBatches(Material* material, ShaderProgram* program);
+
+		// Draws queue range [begin, end) split into material runs
+		void renderQueue(uint32_t begin, uint32_t end, ShaderMaterialType type);
+
+		// Exact ray test against an entity's triangles [distance is along world ray]
+		bool raycastEntity(const Ray& ray, Entity* entity, float maxDistance, float& distance);
+
 	public:
 		RenderManager();
 
@@ -56,10 +113,16 @@ namespace Vxl
 		FullScreenRender m_fullScreenRender = FullScreenRender::TRIANGLE;
 		bool m_globalVAO = false;
 		bool m_editorMode = true;
+		bool m_frustumCulling = true;
+		bool m_colorIDPicking = false; // Selection uses GPU colorID pass instead of CPU ray picking
+		bool m_instancedBatching = true; // Only for opaque materials with instancing shaders
 
 		// Utility
 		void sortMaterials();
 		void sortEntities();
+		void cullEntities();
+		// Computes main camera MVPs of every queued entity [used by ShaderProgram::bindCommonUniforms]
+		void batchMVPs(const Matrix4x4& viewProjection);
 
 		void dirtyMaterialSequence()
 		{
@@ -70,8 +133,50 @@ namespace Vxl
 			m_renderlistDirty = true;
 		}
 
-		void render(MaterialIndex _material, const std::vector<Entity*>& _entities);
-		void render_ColorID(MaterialIndex _material, const std::vector<Entity*>& _entities);
+		// Entities using this mesh refit their bounds [mesh data changed after being assigned]
+		void UpdateMeshBounds(MeshIndex mesh);
+
+		// Spatial queries
+		inline const AABBTree& getEntityTree(void) const
+		{
+			return m_entityTree;
+		}
+
+		// Picking [ray direction must be normalized for distance to be in world units]
+		PickResult pickEntity(const Ray& ray, float maxDistance = FLT_MAX);
+		// Screenspace = [-1, 1] range, uses main camera
+		PickResult pickEntity(const Vector2& screenSpace);
+
+		// Culling Info [Last frame]
+		inline uint32_t getVisibleEntityCount(void) const
+		{
+			return m_visibleCount;
+		}
+		inline uint32_t getCulledEntityCount(void) const
+		{
+			return m_culledCount;
+		}
+		// Draw Info [Last frame, core pass only]
+		inline uint32_t getDrawCallCount(void) const
+		{
+			return m_lastDrawCallCount;
+		}
+		inline uint32_t getBatchedEntityCount(void) const
+		{
+			return m_lastBatchedEntityCount;
+		}
+		// Texture Info [Last frame, all passes]
+		inline uint32_t getTextureBindCount(void) const
+		{
+			return m_lastTextureBindCount;
+		}
+		inline uint32_t getSkippedTextureBindCount(void) const
+		{
+			return m_lastSkippedTextureBindCount;
+		}
+
+		void render(MaterialIndex _material, Entity* const* _entities, uint32_t _count);
+		void render_ColorID(MaterialIndex _material, Entity* const* _entities, uint32_t _count);
 
 		void renderOpaque(ShaderMaterialType type);
 		void renderTransparent(ShaderMaterialType type);
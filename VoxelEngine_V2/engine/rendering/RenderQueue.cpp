@@ -0,0 +1,117 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "RenderQueue.h"
+
+#include <cstring>
+
+namespace Vxl
+{
+	static inline uint64_t QuantizeDepth(float depth)
+	{
+		const uint64_t MaxDepth = (1ull << RenderQueue::DepthBits) - 1;
+
+		// NaN ends up at 0 as well
+		if (!(depth > 0.0f))
+			return 0;
+		if (depth >= 1.0f)
+			return MaxDepth;
+
+		return (uint64_t)(depth * (float)MaxDepth);
+	}
+
+	uint64_t RenderQueue::MakeKey(bool transparent, uint32_t sequence, uint32_t textureSet, uint32_t vao, float depth)
+	{
+		uint64_t _sequence = sequence & ((1u << SequenceBits) - 1);
+		uint64_t _textures = textureSet & ((1u << TextureSetBits) - 1);
+		uint64_t _vao = vao & ((1u << VAOBits) - 1);
+		uint64_t _depth = QuantizeDepth(depth);
+
+		if (!transparent)
+		{
+			return
+				(_sequence << (TextureSetBits + VAOBits + DepthBits)) |
+				(_textures << (VAOBits + DepthBits)) |
+				(_vao << DepthBits) |
+				_depth;
+		}
+
+		// Far objects first
+		_depth = ((1ull << DepthBits) - 1) - _depth;
+
+		return
+			(1ull << 63) |
+			(_depth << (SequenceBits + TextureSetBits + VAOBits)) |
+			(_sequence << (TextureSetBits + VAOBits)) |
+			(_textures << VAOBits) |
+			_vao;
+	}
+
+	void RenderQueue::clear()
+	{
+		m_items.clear();
+		m_keys.clear();
+		m_entities.clear();
+		m_transparentStart = 0;
+	}
+	void RenderQueue::push(uint64_t key, Entity* entity)
+	{
+		m_items.push_back({ key, entity });
+	}
+
+	void RenderQueue::sort()
+	{
+		uint32_t count = (uint32_t)m_items.size();
+		m_scratch.resize(count);
+
+		// LSD radix sort, 8 bits per pass, all histograms are built in one read
+		uint32_t histograms[8][256];
+		memset(histograms, 0, sizeof(histograms));
+
+		for (const Item& item : m_items)
+		{
+			for (uint32_t pass = 0; pass < 8; pass++)
+				histograms[pass][(item.key >> (pass * 8)) & 0xFF]++;
+		}
+
+		Item* source = m_items.data();
+		Item* destination = m_scratch.data();
+		for (uint32_t pass = 0; pass < 8; pass++)
+		{
+			uint32_t* histogram = histograms[pass];
+
+			// Every key has the same byte, nothing to reorder
+			if (count == 0 || histogram[(source[0].key >> (pass * 8)) & 0xFF] == count)
+				continue;
+
+			// Offsets
+			uint32_t offset = 0;
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				uint32_t amount = histogram[i];
+				histogram[i] = offset;
+				offset += amount;
+			}
+
+			// Stable scatter
+			for (uint32_t i = 0; i < count; i++)
+				destination[histogram[(source[i].key >> (pass * 8)) & 0xFF]++] = source[i];
+
+			std::swap(source, destination);
+		}
+
+		// Results
+		m_keys.resize(count);
+		m_entities.resize(count);
+		m_transparentStart = count;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			m_keys[i] = source[i].key;
+			m_entities[i] = source[i].entity;
+
+			if (m_transparentStart == count && IsTransparent(source[i].key))
+				m_transparentStart = i;
+		}
+
+		m_items.clear();
+	}
+}
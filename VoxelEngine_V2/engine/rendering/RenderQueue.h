@@ -0,0 +1,73 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "../utilities/Macros.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace Vxl
+{
+	class Entity;
+
+	// Per frame list of draws, ordered by 64 bit sort keys [radix sort, O(n)]
+	// Opaque:		[63 pass][62..49 material sequence][48..37 texture set][36..25 VAO][24..0 depth, front to back]
+	// Transparent:	[63 pass][62..38 depth, back to front][37..24 material sequence][23..12 texture set][11..0 VAO]
+	// Material sequence is the material's rank in sequence order, shader program is owned by the material
+	class RenderQueue
+	{
+		DISALLOW_COPY_AND_ASSIGN(RenderQueue);
+	public:
+		static const uint32_t SequenceBits = 14;
+		static const uint32_t TextureSetBits = 12;
+		static const uint32_t VAOBits = 12;
+		static const uint32_t DepthBits = 25;
+
+		// depth = [0, 1] range, values outside are clamped
+		static uint64_t MakeKey(bool transparent, uint32_t sequence, uint32_t textureSet, uint32_t vao, float depth);
+		static inline bool IsTransparent(uint64_t key)
+		{
+			return (key >> 63) != 0;
+		}
+
+	private:
+		struct Item
+		{
+			uint64_t	key;
+			Entity*		entity;
+		};
+		std::vector<Item>		m_items;
+		std::vector<Item>		m_scratch;
+
+		// Sorted results
+		std::vector<uint64_t>	m_keys;
+		std::vector<Entity*>	m_entities;
+		uint32_t				m_transparentStart = 0;
+
+	public:
+		RenderQueue() {}
+
+		void clear();
+		void push(uint64_t key, Entity* entity);
+		// Sorts all pushed items and fills sorted results
+		void sort();
+
+		inline uint32_t						size(void) const
+		{
+			return (uint32_t)m_entities.size();
+		}
+		inline const std::vector<uint64_t>& getKeys(void) const
+		{
+			return m_keys;
+		}
+		inline const std::vector<Entity*>&	getEntities(void) const
+		{
+			return m_entities;
+		}
+		// Opaque = [0, transparentStart), Transparent = [transparentStart, size)
+		inline uint32_t						getTransparentStart(void) const
+		{
+			return m_transparentStart;
+		}
+	};
+}
@@ -10,6 +10,9 @@
 
 #include "../rendering/Mesh.h"
 #include "../rendering/RenderManager.h"
+#include "../rendering/ShaderCache.h"
+#include "../rendering/ShaderPreprocessor.h"
+#include "../rendering/ShaderReloader.h"
 
 #include "../utilities/Logger.h"
 #include "../utilities/FileIO.h"
@@ -17,11 +20,18 @@
 
 #include "../window/window.h"
 
+#include <mutex>
+
 namespace Vxl
 {
 	std::map<ShaderID, Shader*> Shader::m_brokenShaders;
 	std::map<ShaderProgramID, ShaderProgram*> ShaderProgram::m_brokenShaderPrograms;
 
+	// Include files stay cached between material reloads [re-read when their write time changes]
+	// Shared by render thread reloads and ShaderReloader workers
+	static ShaderPreprocessor Preprocessor;
+	static std::mutex PreprocessorMutex;
+
 	Shader::Shader(const std::string& name, const std::string& shaderCode, ShaderType type)
 		: m_name(name), m_source(shaderCode), m_type(type)
 	{
@@ -33,9 +43,6 @@ namespace Vxl
 			return;
 		}
 
-		// Fix includes
-		m_source = FileIO::addInclude(m_source);
-
 		// Lines for source
 		m_sourceLineCount = (uint32_t)stringUtil::countChar(m_source, '\n') + 1;
 		for (uint32_t i = 1; i <= m_sourceLineCount; i++)
@@ -107,6 +114,231 @@ namespace Vxl
 			uniform = std::nullopt;
 	}
 
+	void ShaderProgram::acquireProgramInfo(const std::vector<ShaderType>& types, const std::vector<std::pair<std::string, TextureLevel>>& _textureLevels)
+	{
+		// attributes //
+		m_attributes = Graphics::ShaderProgram::AcquireAttributes(m_id);
+		
+		// uniforms //
+		m_uniforms = Graphics::ShaderProgram::AcquireUniforms(m_id);
+
+		// target levels // -> requires checking uniforms
+		for (const auto& pair : _textureLevels)
+		{
+			auto it = m_uniforms.find(pair.first); // search name
+			if (it != m_uniforms.end())
+			{
+				// texture is being used
+				m_targetLevels.push_back(std::make_pair(pair.first, pair.second));
+			}
+		}
+
+		// uniform storage // (stores intermediate values)
+		for (const auto& uniform : m_uniforms)
+		{
+			// Ignore VLX_ uniforms and uniform block members [no location, they live in a buffer]
+			if (uniform.first.substr(0, 4).compare("VXL_") != 0 && uniform.second.isData && uniform.second.location != -1)
+			{
+				// Check UniformType
+				UniformType utype = uniform.second.uType;
+				switch (utype)
+				{
+				case UniformType::FLOAT:
+				{
+					float defaultValue = 0.0f;
+					uniform.second.getFloat(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::FLOAT_VEC2:
+				{
+					Vector2 defaultValue;
+					uniform.second.getVec2(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::FLOAT_VEC3:
+				{
+					Vector3 defaultValue;
+					uniform.second.getVec3(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::FLOAT_VEC4:
+				{
+					Vector4 defaultValue;
+					uniform.second.getVec4(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+
+				case UniformType::DOUBLE:
+				{
+					double defaultValue = 0.0;
+					uniform.second.getDouble(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::DOUBLE_VEC2:
+				{
+					Vector2d defaultValue;
+					uniform.second.getVec2(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::DOUBLE_VEC3:
+				{
+					Vector3d defaultValue;
+					uniform.second.getVec3(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::DOUBLE_VEC4:
+				{
+					Vector4d defaultValue;
+					uniform.second.getVec4(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+
+				case UniformType::INT:
+				{
+					int defaultValue = 0;
+					uniform.second.getInt(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::INT_VEC2:
+				{
+					Vector2i defaultValue;
+					uniform.second.getVec2(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::INT_VEC3:
+				{
+					Vector3i defaultValue;
+					uniform.second.getVec3(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::INT_VEC4:
+				{
+					Vector4i defaultValue;
+					uniform.second.getVec4(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+
+				case UniformType::UNSIGNED_INT:
+				{
+					uint32_t defaultValue = 0u;
+					uniform.second.getUnsignedInt(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::UNSIGNED_INT_VEC2:
+				{
+					Vector2ui defaultValue;
+					uniform.second.getVec2(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::UNSIGNED_INT_VEC3:
+				{
+					Vector3ui defaultValue;
+					uniform.second.getVec3(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::UNSIGNED_INT_VEC4:
+				{
+					Vector4ui defaultValue;
+					uniform.second.getVec4(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+
+				case UniformType::BOOL:
+				{
+					bool defaultValue;
+					uniform.second.getBool(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::BOOL_VEC2:
+				{
+					Vector2b defaultValue;
+					uniform.second.getVec2(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::BOOL_VEC3:
+				{
+					Vector3b defaultValue;
+					uniform.second.getVec3(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::BOOL_VEC4:
+				{
+					Vector4b defaultValue;
+					uniform.second.getVec4(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+
+				case UniformType::FLOAT_MAT2:
+				{
+					Matrix2x2 defaultValue;
+					uniform.second.getMat2(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::FLOAT_MAT3:
+				{
+					Matrix3x3 defaultValue;
+					uniform.second.getMat3(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+				case UniformType::FLOAT_MAT4:
+				{
+					Matrix4x4 defaultValue;
+					uniform.second.getMat4(m_id, defaultValue);
+					m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
+					break;
+				}
+
+				default:
+					VXL_ERROR("Uniform Type not supported for Uniform Storage system");
+				}
+			}
+		}
+
+		// uniform blocks
+		m_uniformBlocks = Graphics::ShaderProgram::AcquireUniformBlocks(m_id);
+
+		// subroutines
+		m_subroutines = Graphics::ShaderProgram::AcquireUniformSubroutines(m_id, types);
+
+		// Setup common uniforms
+		setupCommonUniform("VXL_useModel", m_uniform_useModel);
+		setupCommonUniform("VXL_model", m_uniform_model);
+		setupCommonUniform("VXL_mvp", m_uniform_mvp);
+		setupCommonUniform("VXL_normalMatrix", m_uniform_normalMatrix);
+		setupCommonUniform("VXL_useInstancing", m_uniform_useInstancing);
+		setupCommonUniform("VXL_packedVertex", m_uniform_packedVertex);
+		setupCommonUniform("VXL_positionOffset", m_uniform_positionOffset);
+		setupCommonUniform("VXL_positionScale", m_uniform_positionScale);
+		setupCommonUniform("VXL_useTexture", m_uniform_useTexture);
+		setupCommonUniform("VXL_color", m_uniform_color);
+		setupCommonUniform("VXL_tint", m_uniform_tint);
+		setupCommonUniform("VXL_alpha", m_uniform_alpha);
+		setupCommonUniform("VXL_output", m_uniform_output);
+		setupCommonUniform("VXL_colorID", m_uniform_colorID);
+	}
+
 	ShaderProgram::ShaderProgram(const std::string& name, const std::vector<ShaderIndex>& _shaders, std::vector<std::pair<std::string, TextureLevel>> _textureLevels)
 		: m_name(name), m_shaders(_shaders)
 	{
@@ -149,6 +381,9 @@ namespace Vxl
 		}
 
 		// Link
+		if (ShaderCache::IsActive())
+			Graphics::ShaderProgram::SetBinaryRetrievable(m_id);
+
 		m_linked = Graphics::ShaderProgram::Link(m_id);
 
 #if _DEBUG
@@ -158,210 +393,6 @@ namespace Vxl
 
 		if (m_linked)
 		{
-			// attributes //
-			m_attributes = Graphics::ShaderProgram::AcquireAttributes(m_id);
-			
-			// uniforms //
-			m_uniforms = Graphics::ShaderProgram::AcquireUniforms(m_id);
-
-			// target levels // -> requires checking uniforms
-			for (const auto& pair : _textureLevels)
-			{
-				auto it = m_uniforms.find(pair.first); // search name
-				if (it != m_uniforms.end())
-				{
-					// texture is being used
-					m_targetLevels.push_back(std::make_pair(pair.first, pair.second));
-				}
-			}
-
-			// uniform storage // (stores intermediate values)
-			for (const auto& uniform : m_uniforms)
-			{
-				// Ignore VLX_ uniforms
-				if (uniform.first.substr(0, 4).compare("VXL_") != 0 && uniform.second.isData)
-				{
-					// Check UniformType
-					UniformType utype = uniform.second.uType;
-					switch (utype)
-					{
-					case UniformType::FLOAT:
-					{
-						float defaultValue = 0.0f;
-						uniform.second.getFloat(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::FLOAT_VEC2:
-					{
-						Vector2 defaultValue;
-						uniform.second.getVec2(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::FLOAT_VEC3:
-					{
-						Vector3 defaultValue;
-						uniform.second.getVec3(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::FLOAT_VEC4:
-					{
-						Vector4 defaultValue;
-						uniform.second.getVec4(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-
-					case UniformType::DOUBLE:
-					{
-						double defaultValue = 0.0;
-						uniform.second.getDouble(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::DOUBLE_VEC2:
-					{
-						Vector2d defaultValue;
-						uniform.second.getVec2(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::DOUBLE_VEC3:
-					{
-						Vector3d defaultValue;
-						uniform.second.getVec3(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::DOUBLE_VEC4:
-					{
-						Vector4d defaultValue;
-						uniform.second.getVec4(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-
-					case UniformType::INT:
-					{
-						int defaultValue = 0;
-						uniform.second.getInt(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::INT_VEC2:
-					{
-						Vector2i defaultValue;
-						uniform.second.getVec2(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::INT_VEC3:
-					{
-						Vector3i defaultValue;
-						uniform.second.getVec3(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::INT_VEC4:
-					{
-						Vector4i defaultValue;
-						uniform.second.getVec4(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-
-					case UniformType::UNSIGNED_INT:
-					{
-						uint32_t defaultValue = 0u;
-						uniform.second.getUnsignedInt(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::UNSIGNED_INT_VEC2:
-					{
-						Vector2ui defaultValue;
-						uniform.second.getVec2(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::UNSIGNED_INT_VEC3:
-					{
-						Vector3ui defaultValue;
-						uniform.second.getVec3(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::UNSIGNED_INT_VEC4:
-					{
-						Vector4ui defaultValue;
-						uniform.second.getVec4(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-
-					case UniformType::BOOL:
-					{
-						bool defaultValue;
-						uniform.second.getBool(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::BOOL_VEC2:
-					{
-						Vector2b defaultValue;
-						uniform.second.getVec2(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::BOOL_VEC3:
-					{
-						Vector3b defaultValue;
-						uniform.second.getVec3(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::BOOL_VEC4:
-					{
-						Vector4b defaultValue;
-						uniform.second.getVec4(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-
-					case UniformType::FLOAT_MAT2:
-					{
-						Matrix2x2 defaultValue;
-						uniform.second.getMat2(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::FLOAT_MAT3:
-					{
-						Matrix3x3 defaultValue;
-						uniform.second.getMat3(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-					case UniformType::FLOAT_MAT4:
-					{
-						Matrix4x4 defaultValue;
-						uniform.second.getMat4(m_id, defaultValue);
-						m_uniformStorage[uniform.first] = UniformStorage{ RawData(utype, defaultValue), false };
-						break;
-					}
-
-					default:
-						VXL_ERROR("Uniform Type not supported for Uniform Storage system");
-					}
-				}
-			}
-
-			// uniform blocks
-			m_uniformBlocks = Graphics::ShaderProgram::AcquireUniformBlocks(m_id);
-
-			// subroutines
 			std::vector<ShaderType> types;
 			types.reserve(shaderCount);
 			for (uint32_t shaderIndex : m_shaders)
@@ -370,20 +401,7 @@ namespace Vxl
 				types.push_back(shader->getType());
 			}
 
-			m_subroutines = Graphics::ShaderProgram::AcquireUniformSubroutines(m_id, types);
-
-			// Setup common uniforms
-			setupCommonUniform("VXL_useModel", m_uniform_useModel);
-			setupCommonUniform("VXL_model", m_uniform_model);
-			setupCommonUniform("VXL_mvp", m_uniform_mvp);
-			setupCommonUniform("VXL_normalMatrix", m_uniform_normalMatrix);
-			setupCommonUniform("VXL_useInstancing", m_uniform_useInstancing);
-			setupCommonUniform("VXL_useTexture", m_uniform_useTexture);
-			setupCommonUniform("VXL_color", m_uniform_color);
-			setupCommonUniform("VXL_tint", m_uniform_tint);
-			setupCommonUniform("VXL_alpha", m_uniform_alpha);
-			setupCommonUniform("VXL_output", m_uniform_output);
-			setupCommonUniform("VXL_colorID", m_uniform_colorID);
+			acquireProgramInfo(types, _textureLevels);
 		}
 		else
 		{
@@ -402,6 +420,28 @@ namespace Vxl
 		}
 
 	}
+	ShaderProgram::ShaderProgram(const std::string& name, uint32_t binaryFormat, const std::vector<uint8_t>& binary, const std::vector<ShaderType>& types, std::vector<std::pair<std::string, TextureLevel>> _textureLevels)
+		: m_name(name), m_fromBinary(true)
+	{
+		m_id = Graphics::ShaderProgram::Create();
+		if (m_id == -1)
+		{
+			m_linked = false;
+			return;
+		}
+
+		// Rejected binaries aren't broken programs, the material compiles the sources instead
+		m_linked = Graphics::ShaderProgram::LoadBinary(m_id, binaryFormat, binary.data(), (uint32_t)binary.size());
+
+#if _DEBUG
+		// Validation
+		if (m_linked)
+			m_linked &= Graphics::ShaderProgram::Validate(m_id);
+#endif
+
+		if (m_linked)
+			acquireProgramInfo(types, _textureLevels);
+	}
 	ShaderProgram::~ShaderProgram()
 	{
 		m_brokenShaderPrograms.erase(m_id);
@@ -424,6 +464,14 @@ namespace Vxl
 		}
 	}
 
+	bool ShaderProgram::getBinary(uint32_t& format, std::vector<uint8_t>& binary) const
+	{
+		if (!m_linked)
+			return false;
+
+		return Graphics::ShaderProgram::GetBinary(m_id, format, binary);
+	}
+
 	void ShaderProgram::bind() const
 	{
 		if (m_linked)
@@ -479,7 +527,14 @@ namespace Vxl
 		{
 			Camera* camera = Assets.getCamera(RenderManager.m_mainCamera);
 			if (camera)
-				m_uniform_mvp.value().sendMatrix(camera->getViewProjection() * entity->m_transform.getModel(), true);
+			{
+				// Batched after culling, camera or entity could have moved since then
+				if (entity->m_mvpStamp == RenderManager.m_mvpStamp && entity->m_mvpModelStamp == entity->m_transform.getStamp() &&
+					camera->getViewProjection().Compare(RenderManager.m_mvpViewProjection))
+					m_uniform_mvp.value().sendMatrix(entity->m_mvp, true);
+				else
+					m_uniform_mvp.value().sendMatrix(camera->getViewProjection() * entity->m_transform.getModel(), true);
+			}
 		}
 
 		// ~ Normal Matrix ~ //
@@ -488,14 +543,34 @@ namespace Vxl
 			m_uniform_normalMatrix.value().sendMatrix(entity->m_transform.getNormalMatrix(), true);
 		}
 
+		Mesh* mesh = Assets.getMesh(entity->getMesh());
+
 		// ~ Instancing ~ //
 		if (m_uniform_useInstancing.has_value())
 		{
-			Mesh* mesh = Assets.getMesh(entity->getMesh());
-
 			m_uniform_useInstancing.value().send(mesh && mesh->m_instances.getDrawCount() > 0);
 		}
 
+		// ~ Packed Vertices ~ //
+		if (m_uniform_packedVertex.has_value())
+		{
+			m_uniform_packedVertex.value().send(mesh && mesh->isPacked());
+		}
+		if (m_uniform_positionOffset.has_value() && m_uniform_positionScale.has_value())
+		{
+			// Quantized positions are [0, 1] across the bounds
+			if (mesh && mesh->hasQuantizedPositions())
+			{
+				m_uniform_positionOffset.value().send(mesh->getVertexMin());
+				m_uniform_positionScale.value().send(mesh->getScale());
+			}
+			else
+			{
+				m_uniform_positionOffset.value().send(Vector3::ZERO);
+				m_uniform_positionScale.value().send(Vector3::ONE);
+			}
+		}
+
 		// ~ Texture ~ //
 		if (m_uniform_useTexture.has_value())
 		{
@@ -532,6 +607,25 @@ namespace Vxl
 		}
 	}
 
+	void ShaderProgram::bindBatchUniforms()
+	{
+		if (m_uniform_useModel.has_value())
+			m_uniform_useModel.value().send(true);
+
+		if (m_uniform_model.has_value())
+			m_uniform_model.value().sendMatrix(Matrix4x4::Identity, true);
+
+		if (m_uniform_mvp.has_value())
+		{
+			Camera* camera = Assets.getCamera(RenderManager.m_mainCamera);
+			if (camera)
+				m_uniform_mvp.value().sendMatrix(camera->getViewProjection(), true);
+		}
+
+		if (m_uniform_useInstancing.has_value())
+			m_uniform_useInstancing.value().send(true);
+	}
+
 	// Binding Custom Uniforms [Non VXL_]
 	void ShaderProgram::bindCustomUniforms()
 	{
@@ -637,6 +731,7 @@ namespace Vxl
 	const char* SECTION_RENDERTARGETS = "#RenderTargets";
 	const char* SECTION_SAMPLERS = "#Samplers";
 	const char* SECTION_PROPERTIES = "#Properties";
+	const char* SECTION_PARAMETERS = "#Parameters";
 	const char* SECTION_VERTEX = "#Vertex";
 	const char* SECTION_GEOMETRY = "#Geometry";
 	const char* SECTION_FRAGMENT = "#Fragment";
@@ -651,24 +746,39 @@ namespace Vxl
 	{
 		reload();
 	}
+	ShaderMaterial::~ShaderMaterial()
+	{
+		ShaderReloader.untrack(this);
+	}
 
 	void ShaderMaterial::reload()
 	{
-		// Delete existing ShaderPrograms
-		Assets.deleteShaderProgram(m_coreProgram);
-		Assets.deleteShaderProgram(m_colorIDProgram);
+		ShaderMaterialSource source;
+		if (Preprocess(m_filePath, GetIncludeTable(), source))
+			build(source);
+	}
 
-		m_coreProgram = -1;
-		m_colorIDProgram = -1;
+	ShaderIncludeTable ShaderMaterial::GetIncludeTable(void)
+	{
+		ShaderIncludeTable table;
+		for (const auto& file : Assets.getAllFiles())
+			table[file.first] = { file.second->filepath, file.second->file };
+
+		return table;
+	}
 
-		std::string file = FileIO::readFile(m_filePath);
+	bool ShaderMaterial::Preprocess(const std::string& filePath, const ShaderIncludeTable& includeTable, ShaderMaterialSource& source)
+	{
+		std::string file = FileIO::readFile(filePath);
 		if (file.empty())
-			return;
+			return false;
+
+		source.dependencies.push_back(filePath);
 
-		std::string CORE_VertexShaderCode;
-		std::string CORE_GeometryShaderCode;
-		std::string CORE_FragmentShaderCode;
-		std::string COLORID_FragmentShaderCode;
+		std::string& CORE_VertexShaderCode = source.vertex;
+		std::string& CORE_GeometryShaderCode = source.geometry;
+		std::string& CORE_FragmentShaderCode = source.fragment;
+		std::string& COLORID_FragmentShaderCode = source.colorIDFragment;
 
 		struct OUTPUT
 		{
@@ -679,6 +789,7 @@ namespace Vxl
 			std::string o_link;
 			std::string o_rendertargets;
 			std::string o_samplers;
+			std::string o_parameters;
 			std::string o_properties;
 			std::string o_main;
 		};
@@ -696,6 +807,7 @@ namespace Vxl
 			std::size_t rendertargets;
 			std::size_t samplers;
 			std::size_t properties;
+			std::size_t parameters;
 			std::size_t vertex_defines;
 			std::size_t geometry_defines;
 			std::size_t fragment_defines;
@@ -711,6 +823,7 @@ namespace Vxl
 		locations.rendertargets = file.find(SECTION_RENDERTARGETS);
 		locations.samplers = file.find(SECTION_SAMPLERS);
 		locations.properties = file.find(SECTION_PROPERTIES);
+		locations.parameters = file.find(SECTION_PARAMETERS);
 		locations.vertex = file.find(SECTION_VERTEX);
 		locations.geometry = file.find(SECTION_GEOMETRY);
 		locations.fragment = file.find(SECTION_FRAGMENT);
@@ -724,7 +837,7 @@ namespace Vxl
 		output_fragment.active = (locations.fragment != std::string::npos);
 
 		// Name
-		std::string name;
+		std::string& name = source.name;
 		if (locations.name != std::string::npos)
 		{
 			name = stringUtil::extractSection(file, '{', '}', locations.name);
@@ -732,7 +845,7 @@ namespace Vxl
 		}
 		else
 		{
-			name = stringUtil::extractNameFromPath(m_filePath);
+			name = stringUtil::extractNameFromPath(filePath);
 		}
 
 		// Defines
@@ -766,10 +879,12 @@ namespace Vxl
 			for (auto& include : includes)
 			{
 				stringUtil::trim(include);
-				File* _fileStorage = Assets.getFile(include);
-				if (_fileStorage)
+				auto _fileStorage = includeTable.find(stringUtil::toLowerCopy(include));
+				if (_fileStorage != includeTable.end())
 				{
-					std::string file = _fileStorage->file + '\n';
+					source.dependencies.push_back(_fileStorage->second.filePath);
+
+					std::string file = _fileStorage->second.contents + '\n';
 
 					if (output_vertex.active)
 						output_vertex.o_include += file + '\n';
@@ -872,7 +987,7 @@ namespace Vxl
 		}
 
 		// Samplers
-		std::vector<std::pair<std::string, TextureLevel>> targetLevels;
+		std::vector<std::pair<std::string, TextureLevel>>& targetLevels = source.targetLevels;
 		if (locations.samplers != std::string::npos)
 		{
 			std::string section = stringUtil::extractSection(file, '{', '}', locations.samplers) + '\n';
@@ -913,6 +1028,28 @@ namespace Vxl
 				output_fragment.o_samplers += sampler_info + '\n';
 		}
 
+		// Parameters [one std140 block per material, see MaterialParameters.h]
+		auto parameters = std::make_shared<ParameterLayout>();
+		if (locations.parameters != std::string::npos)
+		{
+			std::vector<std::string> errors;
+			parameters->parse(stringUtil::extractSection(file, '{', '}', locations.parameters), errors);
+			for (const std::string& error : errors)
+				Logger.error(name + ": " + error);
+
+			std::string section = parameters->getGLSL() + '\n';
+
+			if (output_vertex.active)
+				output_vertex.o_parameters += section;
+
+			if (output_geometry.active)
+				output_geometry.o_parameters += section;
+
+			if (output_fragment.active)
+				output_fragment.o_parameters += section;
+		}
+		source.parameters = parameters;
+
 		// Properties
 		if (locations.properties != std::string::npos)
 		{
@@ -946,6 +1083,7 @@ namespace Vxl
 				output_vertex.o_link + '\n' +
 				// no rendertargets
 				output_vertex.o_samplers + '\n' +
+				output_vertex.o_parameters +
 				output_vertex.o_properties + '\n' +
 				output_vertex.o_main;
 		}
@@ -967,6 +1105,7 @@ namespace Vxl
 				output_geometry.o_link + '\n' +
 				// no rendertargets
 				output_geometry.o_samplers + '\n' +
+				output_geometry.o_parameters +
 				output_geometry.o_properties + '\n' +
 				output_geometry.o_main;
 		}
@@ -988,6 +1127,7 @@ namespace Vxl
 				output_fragment.o_link + '\n' +
 				output_fragment.o_rendertargets + '\n' +
 				output_fragment.o_samplers + '\n' +
+				output_fragment.o_parameters +
 				output_fragment.o_properties + '\n' +
 				output_fragment.o_main;
 
@@ -999,6 +1139,7 @@ namespace Vxl
 				output_fragment.o_link + '\n' +
 				"layout (location =  0) out vec4 FragOutput ;\n" + // Custom RenderTarget
 				output_fragment.o_samplers + '\n' +
+				output_fragment.o_parameters +
 				output_fragment.o_properties + '\n' +
 				// Custom Main
 				"// Main\n"
@@ -1008,42 +1149,91 @@ namespace Vxl
 				"}";
 		}
 
-		// Create Shaders
-		ShaderIndex CORE_VertexShader = -1;
-		ShaderIndex CORE_GeometryShader = -1;
-		ShaderIndex CORE_FragmentShader = -1;
-		ShaderIndex COLORID_FragmentShader = -1;
-
-		if (!CORE_VertexShaderCode.empty())
+		// Expand #include lines [sources are final from here, cache keys cover them]
+		std::vector<std::string> includes;
 		{
-			if (m_isGlobal)
-				CORE_VertexShader = GlobalAssets.createShader(name + "_vert", CORE_VertexShaderCode, ShaderType::VERTEX);
-			else
-				CORE_VertexShader = SceneAssets.createShader(name + "_vert", CORE_VertexShaderCode, ShaderType::VERTEX);
+			std::lock_guard<std::mutex> lock(PreprocessorMutex);
 
+			for (std::string* code : { &CORE_VertexShaderCode, &CORE_GeometryShaderCode, &CORE_FragmentShaderCode, &COLORID_FragmentShaderCode })
+			{
+				if (!code->empty())
+					*code = Preprocessor.process(*code, &includes);
+			}
+			for (const std::string& error : Preprocessor.getErrors())
+				Logger.error(name + ": " + error);
+			Preprocessor.clearErrors();
 		}
+		source.dependencies.insert(source.dependencies.end(), includes.begin(), includes.end());
 
+		return true;
+	}
+
+	bool ShaderMaterial::build(const ShaderMaterialSource& source)
+	{
+		// Includes can change with every edit
+		ShaderReloader.track(this, source.dependencies);
+
+		const std::string& name = source.name;
+		const std::string& CORE_VertexShaderCode = source.vertex;
+		const std::string& CORE_GeometryShaderCode = source.geometry;
+		const std::string& CORE_FragmentShaderCode = source.fragment;
+		const std::string& COLORID_FragmentShaderCode = source.colorIDFragment;
+		const std::vector<std::pair<std::string, TextureLevel>>& targetLevels = source.targetLevels;
+
+		// Stages of each program
+		std::vector<ShaderType> CORE_Types;
+		std::vector<ShaderType> COLORID_Types;
+		if (!CORE_VertexShaderCode.empty())
+		{
+			CORE_Types.push_back(ShaderType::VERTEX);
+			COLORID_Types.push_back(ShaderType::VERTEX);
+		}
 		if (!CORE_GeometryShaderCode.empty())
 		{
-			if (m_isGlobal)
-				CORE_GeometryShader = GlobalAssets.createShader(name + "_geom", CORE_GeometryShaderCode, ShaderType::GEOMETRY);
-			else
-				CORE_GeometryShader = SceneAssets.createShader(name + "_geom", CORE_GeometryShaderCode, ShaderType::GEOMETRY);
+			CORE_Types.push_back(ShaderType::GEOMETRY);
+			COLORID_Types.push_back(ShaderType::GEOMETRY);
 		}
-
 		if (!CORE_FragmentShaderCode.empty())
+			CORE_Types.push_back(ShaderType::FRAGMENT);
+		if (!COLORID_FragmentShaderCode.empty())
+			COLORID_Types.push_back(ShaderType::FRAGMENT);
+
+		uint64_t CORE_Key = ShaderCache::GetKey({ CORE_VertexShaderCode, CORE_GeometryShaderCode, CORE_FragmentShaderCode });
+		uint64_t COLORID_Key = ShaderCache::GetKey({ CORE_VertexShaderCode, CORE_GeometryShaderCode, COLORID_FragmentShaderCode });
+
+		// Current programs stay in use until the new ones are known to work
+		ShaderProgramIndex coreProgram = -1;
+		ShaderProgramIndex colorIDProgram = -1;
+
+		// Cached binaries skip compiling entirely
+		if (ShaderCache::IsActive())
 		{
+			coreProgram = loadCachedProgram(name + "_program", CORE_Key, CORE_Types, targetLevels);
+			colorIDProgram = loadCachedProgram(name + "_colorID_program", COLORID_Key, COLORID_Types, targetLevels);
+		}
+		bool compile = (coreProgram == -1 || colorIDProgram == -1);
+
+		// Create Shaders [only the ones a missed program needs]
+		auto createShader = [this](const std::string& shaderName, const std::string& code, ShaderType type) -> ShaderIndex
+		{
+			if (code.empty())
+				return -1;
+
 			if (m_isGlobal)
-			{
-				CORE_FragmentShader = GlobalAssets.createShader(name + "_frag", CORE_FragmentShaderCode, ShaderType::FRAGMENT);
-				COLORID_FragmentShader = GlobalAssets.createShader(name + "_colorID_frag", COLORID_FragmentShaderCode, ShaderType::FRAGMENT);
-			}
+				return GlobalAssets.createShader(shaderName, code, type);
 			else
-			{
-				CORE_FragmentShader = SceneAssets.createShader(name + "_frag", CORE_FragmentShaderCode, ShaderType::FRAGMENT);
-				COLORID_FragmentShader = SceneAssets.createShader(name + "_colorID_frag", COLORID_FragmentShaderCode, ShaderType::FRAGMENT);
-			}
-		}
+				return SceneAssets.createShader(shaderName, code, type);
+		};
+
+		ShaderIndex CORE_VertexShader = compile ? createShader(name + "_vert", CORE_VertexShaderCode, ShaderType::VERTEX) : -1;
+		ShaderIndex CORE_GeometryShader = compile ? createShader(name + "_geom", CORE_GeometryShaderCode, ShaderType::GEOMETRY) : -1;
+		ShaderIndex CORE_FragmentShader = -1;
+		ShaderIndex COLORID_FragmentShader = -1;
+
+		if (coreProgram == -1)
+			CORE_FragmentShader = createShader(name + "_frag", CORE_FragmentShaderCode, ShaderType::FRAGMENT);
+		if (colorIDProgram == -1)
+			COLORID_FragmentShader = createShader(name + "_colorID_frag", COLORID_FragmentShaderCode, ShaderType::FRAGMENT);
 
 		// Array of Shaders
 		std::vector<ShaderIndex> CORE_Shaders;
@@ -1070,18 +1260,79 @@ namespace Vxl
 			COLORID_Shaders.push_back(COLORID_FragmentShader);
 		}
 
+		// Create Programs
+		if (coreProgram == -1)
+			coreProgram = createProgram(name + "_program", CORE_Key, CORE_Shaders, targetLevels);
+		if (colorIDProgram == -1)
+			colorIDProgram = createProgram(name + "_colorID_program", COLORID_Key, COLORID_Shaders, targetLevels);
 
-		// Create Core Program
-		if (m_isGlobal)
+		// A broken edit keeps the last working programs [first load keeps them so errors can be displayed]
+		ShaderProgram* core = Assets.getShaderProgram(coreProgram);
+		ShaderProgram* colorID = Assets.getShaderProgram(colorIDProgram);
+		bool linked = core && core->isLinked() && colorID && colorID->isLinked();
+
+		if (!linked && (m_coreProgram != -1 || m_colorIDProgram != -1))
 		{
-			m_coreProgram = GlobalAssets.createShaderProgram(name + "_program", CORE_Shaders, targetLevels);
-			m_colorIDProgram = GlobalAssets.createShaderProgram(name + "_colorID_program", COLORID_Shaders, targetLevels);
+			Logger.error("Shader Material failed to rebuild, keeping previous programs: " + name);
+
+			Assets.deleteShaderProgram(coreProgram);
+			Assets.deleteShaderProgram(colorIDProgram);
+			return false;
 		}
+
+		// Swap
+		Assets.deleteShaderProgram(m_coreProgram);
+		Assets.deleteShaderProgram(m_colorIDProgram);
+
+		m_coreProgram = coreProgram;
+		m_colorIDProgram = colorIDProgram;
+
+		// Materials keep their values unless the declarations changed
+		if (source.parameters && !(*m_parameters == *source.parameters))
+			m_parameters = source.parameters;
+
+		return true;
+	}
+
+	ShaderProgramIndex ShaderMaterial::loadCachedProgram(const std::string& name, uint64_t key, const std::vector<ShaderType>& types, const std::vector<std::pair<std::string, TextureLevel>>& targetLevels)
+	{
+		uint32_t format;
+		std::vector<uint8_t> binary;
+		if (!ShaderCache::Load(name, key, format, binary))
+			return -1;
+
+		ShaderProgramIndex index;
+		if (m_isGlobal)
+			index = GlobalAssets.createShaderProgram(name, format, binary, types, targetLevels);
 		else
+			index = SceneAssets.createShaderProgram(name, format, binary, types, targetLevels);
+
+		ShaderProgram* program = Assets.getShaderProgram(index);
+		if (program && program->isLinked())
+			return index;
+
+		// Driver changed its binary format since the file was written
+		Assets.deleteShaderProgram(index);
+		return -1;
+	}
+	ShaderProgramIndex ShaderMaterial::createProgram(const std::string& name, uint64_t key, const std::vector<ShaderIndex>& shaders, const std::vector<std::pair<std::string, TextureLevel>>& targetLevels)
+	{
+		ShaderProgramIndex index;
+		if (m_isGlobal)
+			index = GlobalAssets.createShaderProgram(name, shaders, targetLevels);
+		else
+			index = SceneAssets.createShaderProgram(name, shaders, targetLevels);
+
+		ShaderProgram* program = Assets.getShaderProgram(index);
+		if (program && program->isLinked() && ShaderCache::IsActive())
 		{
-			m_coreProgram = SceneAssets.createShaderProgram(name + "_program", CORE_Shaders, targetLevels);
-			m_colorIDProgram = SceneAssets.createShaderProgram(name + "_colorID_program", COLORID_Shaders, targetLevels);
+			uint32_t format;
+			std::vector<uint8_t> binary;
+			if (program->getBinary(format, binary))
+				ShaderCache::Save(name, key, format, binary);
 		}
+
+		return index;
 	}
 
 	ShaderProgram* ShaderMaterial::getProgram(ShaderMaterialType type)
@@ -6,9 +6,12 @@
 #include "../utilities/Containers.h"
 
 #include "Uniform.h"
+#include "MaterialParameters.h"
 
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <optional>
 
@@ -103,10 +106,16 @@ namespace Vxl
 		std::map<ShaderType, Graphics::UniformSubroutine>	m_subroutines;
 		static std::map<ShaderProgramID, ShaderProgram*> m_brokenShaderPrograms;
 
+		bool						m_fromBinary = false;	// Loaded from ShaderCache, m_shaders is empty
+
 		//
 		void setupCommonUniform(const std::string& name, std::optional<Graphics::Uniform>& uniform);
+		// Reflection after a successful link [attributes, uniforms, blocks, subroutines]
+		void acquireProgramInfo(const std::vector<ShaderType>& types, const std::vector<std::pair<std::string, TextureLevel>>& _textureLevels);
 
 		ShaderProgram(const std::string& name, const std::vector<ShaderIndex>& _shaders, std::vector<std::pair<std::string, TextureLevel>> _textureLevels);
+		// From a cached program binary, types are the stages it was linked with
+		ShaderProgram(const std::string& name, uint32_t binaryFormat, const std::vector<uint8_t>& binary, const std::vector<ShaderType>& types, std::vector<std::pair<std::string, TextureLevel>> _textureLevels);
 	public:
 		~ShaderProgram();
 
@@ -180,6 +189,9 @@ namespace Vxl
 		std::optional<Graphics::Uniform> m_uniform_mvp = std::nullopt;
 		std::optional<Graphics::Uniform> m_uniform_normalMatrix = std::nullopt;
 		std::optional<Graphics::Uniform> m_uniform_useInstancing = std::nullopt;
+		std::optional<Graphics::Uniform> m_uniform_packedVertex = std::nullopt;
+		std::optional<Graphics::Uniform> m_uniform_positionOffset = std::nullopt;
+		std::optional<Graphics::Uniform> m_uniform_positionScale = std::nullopt;
 		std::optional<Graphics::Uniform> m_uniform_useTexture = std::nullopt;
 		std::optional<Graphics::Uniform> m_uniform_color = std::nullopt;
 		std::optional<Graphics::Uniform> m_uniform_tint = std::nullopt;
@@ -189,6 +201,14 @@ namespace Vxl
 
 		// Binding Common Uniforms [VXL_]
 		void bindCommonUniforms(EntityIndex _entity);
+		// Overrides transform uniforms for an instanced batch [instance matrices hold the full model]
+		void bindBatchUniforms();
+
+		// Shader reads instance matrices [VXL_useInstancing is active]
+		inline bool						supportsInstancing(void) const
+		{
+			return m_uniform_useInstancing.has_value();
+		}
 
 		// Binding Custom Uniforms [Non VXL_]
 		void bindCustomUniforms();
@@ -214,6 +234,12 @@ namespace Vxl
 		{
 			return m_shaders;
 		}
+		inline bool						isFromBinary(void) const
+		{
+			return m_fromBinary;
+		}
+		// Linked program as a driver specific binary [for ShaderCache]
+		bool getBinary(uint32_t& format, std::vector<uint8_t>& binary) const;
 	};
 
 	enum class ShaderMaterialType
@@ -221,19 +247,62 @@ namespace Vxl
 		CORE,
 		COLORID
 	};
+	// Files a material can pull in with #Include [lowercase name -> path, contents]
+	// Copied from Assets on the render thread so preprocessing can run anywhere
+	struct ShaderIncludeFile
+	{
+		std::string filePath;
+		std::string contents;
+	};
+	typedef std::unordered_map<std::string, ShaderIncludeFile> ShaderIncludeTable;
+
+	// Final stage sources of a material, result of ShaderMaterial::Preprocess [no GL objects]
+	struct ShaderMaterialSource
+	{
+		std::string name;
+		std::string vertex;
+		std::string geometry;
+		std::string fragment;
+		std::string colorIDFragment;
+		std::vector<std::pair<std::string, TextureLevel>> targetLevels;
+		// #Parameters section
+		std::shared_ptr<const ParameterLayout> parameters;
+		// Material file and every file it included [for hot reloading]
+		std::vector<std::string> dependencies;
+	};
+
 	class ShaderMaterial
 	{
 		DISALLOW_COPY_AND_ASSIGN(ShaderMaterial);
 		friend class _Assets;
 		friend class RenderManager;
+		friend class ShaderReloader;
 	private:
 		const bool m_isGlobal;
 		ShaderMaterial(const std::string& filePath, bool GlobalAsset);
+
+		// Preprocess + build on the calling thread
 		void reload();
+		// Compiles and links source, new programs replace the current ones only if both linked [or there were none]
+		// Returns true if they were replaced
+		bool build(const ShaderMaterialSource& source);
+
+		// -1 on a cache miss or if the driver rejects the binary
+		ShaderProgramIndex loadCachedProgram(const std::string& name, uint64_t key, const std::vector<ShaderType>& types, const std::vector<std::pair<std::string, TextureLevel>>& targetLevels);
+		// Compiled program, its binary is cached if it linked
+		ShaderProgramIndex createProgram(const std::string& name, uint64_t key, const std::vector<ShaderIndex>& shaders, const std::vector<std::pair<std::string, TextureLevel>>& targetLevels);
 	public:
+		~ShaderMaterial();
+
 		const std::string			m_filePath;				// File used to load
 		ShaderProgramIndex			m_coreProgram = -1;		// Main Program used for rendering
 		ShaderProgramIndex			m_colorIDProgram = -1;	// Alternate program used only for ColorID output
+		std::shared_ptr<const ParameterLayout> m_parameters = std::make_shared<ParameterLayout>(); // Replaced when a reload changes the declarations
+
+		// Render thread only
+		static ShaderIncludeTable GetIncludeTable(void);
+		// Reads and expands a material file, safe on worker threads [false if file is missing or empty]
+		static bool Preprocess(const std::string& filePath, const ShaderIncludeTable& includeTable, ShaderMaterialSource& source);
 
 		// Utility
 		ShaderProgram* getProgram(ShaderMaterialType type);
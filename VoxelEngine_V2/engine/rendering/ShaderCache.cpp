@@ -0,0 +1,140 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "ShaderCache.h"
+
+#include "Graphics.h"
+
+#include "../utilities/FileIO.h"
+#include "../utilities/Logger.h"
+#include "../utilities/stringUtil.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::experimental::filesystem;
+
+namespace Vxl
+{
+	// ~ File Layout ~ //
+	// [CacheHeader] [binary]
+
+	struct CacheHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t key;
+		uint32_t format;
+		uint32_t size;
+	};
+
+	bool ShaderCache::Enabled = true;
+
+	bool ShaderCache::IsActive(void)
+	{
+		return Enabled && Graphics::ShaderProgram::SupportsBinary();
+	}
+
+	uint64_t ShaderCache::GetKey(const std::vector<std::string>& sources)
+	{
+		// Binaries are only valid for the exact driver that produced them
+		std::vector<uint64_t> parts;
+		parts.reserve(sources.size() + 2);
+		parts.push_back(hash_64_fnv1a(Graphics::Gpu_Renderer.data(), Graphics::Gpu_Renderer.size()));
+		parts.push_back(hash_64_fnv1a(Graphics::Gpu_OpenGLVersion.data(), Graphics::Gpu_OpenGLVersion.size()));
+
+		// Empty stages still count [position of each stage matters]
+		for (const std::string& source : sources)
+			parts.push_back(hash_64_fnv1a(source.data(), source.size()) ^ source.size());
+
+		return hash_64_fnv1a(parts.data(), parts.size() * sizeof(uint64_t));
+	}
+	std::string ShaderCache::GetCachePath(const std::string& programName, uint64_t key)
+	{
+		char hashText[17];
+		snprintf(hashText, sizeof(hashText), "%016llx", (unsigned long long)key);
+
+		return "./cache/shaders/" + programName + '_' + hashText + ".vxprog";
+	}
+
+	bool ShaderCache::Load(const std::string& programName, uint64_t key, uint32_t& format, std::vector<uint8_t>& binary)
+	{
+		std::ifstream file(GetCachePath(programName, key), std::ios::binary);
+		if (!file.is_open())
+			return false;
+
+		CacheHeader header;
+		if (!file.read((char*)&header, sizeof(CacheHeader)))
+			return false;
+
+		if (header.magic != Magic ||
+			header.version != Version ||
+			header.key != key ||
+			header.size == 0)
+			return false;
+
+		binary.resize(header.size);
+		if (!file.read((char*)binary.data(), header.size))
+			return false;
+
+		format = header.format;
+		return true;
+	}
+	bool ShaderCache::Save(const std::string& programName, uint64_t key, uint32_t format, const std::vector<uint8_t>& binary)
+	{
+		if (binary.empty())
+			return false;
+
+		std::string cachePath = GetCachePath(programName, key);
+		FileIO::EnsureDirectory(cachePath);
+
+		// Write to temporary file first, a crash mid write must not leave a truncated binary behind
+		std::string tempPath = cachePath + ".tmp";
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			Logger.error("Unable to write shader cache: " + cachePath);
+			return false;
+		}
+
+		CacheHeader header;
+		header.magic = Magic;
+		header.version = Version;
+		header.key = key;
+		header.format = format;
+		header.size = (uint32_t)binary.size();
+
+		file.write((const char*)&header, sizeof(CacheHeader));
+		file.write((const char*)binary.data(), binary.size());
+
+		bool result = file.good();
+		file.close();
+
+		std::error_code error;
+		if (result)
+		{
+			fs::remove(cachePath, error);
+			fs::rename(tempPath, cachePath, error);
+		}
+		if (!result || error)
+		{
+			fs::remove(tempPath, error);
+			return false;
+		}
+
+		// Binaries of older sources can't be hit again [same name, different key]
+		std::string prefix = programName + '_';
+		std::string fileName = fs::path(cachePath).filename().string();
+		std::vector<fs::path> stale;
+		for (const auto& entry : fs::directory_iterator(fs::path(cachePath).parent_path(), error))
+		{
+			std::string other = entry.path().filename().string();
+			if (other != fileName && other.size() == fileName.size() && other.compare(0, prefix.size(), prefix) == 0 && entry.path().extension() == ".vxprog")
+				stale.push_back(entry.path());
+		}
+		for (const fs::path& path : stale)
+			fs::remove(path, error);
+
+		return true;
+	}
+}
@@ -0,0 +1,34 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "../utilities/Macros.h"
+
+#include <string>
+#include <vector>
+
+namespace Vxl
+{
+	// Binary cache of linked shader programs [./cache/shaders/]
+	// Files are keyed by the preprocessed source of every stage [defines included] and the GPU/driver strings
+	// A binary the driver rejects is treated as a miss and the program is compiled again
+	class ShaderCache
+	{
+	public:
+		static const uint32_t Magic = 0x53435856; // "VXCS"
+		static const uint32_t Version = 1;
+
+		// Can be turned off to always compile [only read when a ShaderMaterial reloads]
+		static bool Enabled;
+
+		// Enabled and the driver supports program binaries
+		static bool IsActive(void);
+
+		// Hash of final stage sources + Graphics::Gpu_Renderer/Gpu_OpenGLVersion
+		static uint64_t GetKey(const std::vector<std::string>& sources);
+		static std::string GetCachePath(const std::string& programName, uint64_t key);
+
+		// False if missing, corrupt or written for another key
+		static bool Load(const std::string& programName, uint64_t key, uint32_t& format, std::vector<uint8_t>& binary);
+		static bool Save(const std::string& programName, uint64_t key, uint32_t format, const std::vector<uint8_t>& binary);
+	};
+}
@@ -0,0 +1,123 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "ShaderPreprocessor.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace fs = std::experimental::filesystem;
+
+namespace Vxl
+{
+	static bool GetWriteTime(const std::string& path, int64_t& time)
+	{
+		std::error_code error;
+		time = (int64_t)fs::last_write_time(path, error).time_since_epoch().count();
+		return !error;
+	}
+
+	const std::string* ShaderPreprocessor::getFile(const std::string& path)
+	{
+		auto it = m_files.find(path);
+		if (it != m_files.end() && it->second.writeTime == -1)
+			return &it->second.contents;
+
+		int64_t writeTime;
+		if (!GetWriteTime(path, writeTime))
+			return nullptr;
+
+		// Unchanged since last read
+		if (it != m_files.end() && it->second.writeTime == writeTime)
+			return &it->second.contents;
+
+		std::ifstream file(path);
+		if (!file.is_open())
+			return nullptr;
+
+		m_readCount++;
+
+		// Map nodes don't move, pointers stay valid while nested includes are added
+		IncludeFile& entry = m_files[path];
+		entry.contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		entry.writeTime = writeTime;
+		return &entry.contents;
+	}
+
+	void ShaderPreprocessor::expand(std::string_view source, std::string& output, std::vector<std::string>& stack, std::vector<std::string>* includes)
+	{
+		size_t lineStart = 0;
+		while (lineStart < source.size())
+		{
+			size_t lineEnd = source.find('\n', lineStart);
+			size_t next = (lineEnd == std::string_view::npos) ? source.size() : lineEnd + 1;
+			std::string_view line = source.substr(lineStart, next - lineStart);
+			lineStart = next;
+
+			// Directive must start the line [leading whitespace allowed]
+			size_t directive = line.find_first_not_of(" \t");
+			if (directive == std::string_view::npos || line.compare(directive, 8, "#include") != 0)
+			{
+				output.append(line.data(), line.size());
+				continue;
+			}
+
+			std::string path;
+			for (char c : line.substr(directive + 8))
+			{
+				if (c != ' ' && c != '\t' && c != '"' && c != '<' && c != '>' && c != '\r' && c != '\n')
+					path += c;
+			}
+
+			if (std::find(stack.begin(), stack.end(), path) != stack.end())
+			{
+				m_errors.push_back("Recursive include skipped: " + path);
+				continue;
+			}
+
+			const std::string* contents = getFile(path);
+			if (!contents)
+			{
+				m_errors.push_back("Include does not exist: " + path);
+				continue;
+			}
+
+			if (includes && std::find(includes->begin(), includes->end(), path) == includes->end())
+				includes->push_back(path);
+
+			// Leave include signature
+			output += "// [INCLUDE \"" + path + "\"]\n";
+			stack.push_back(path);
+			expand(*contents, output, stack, includes);
+			stack.pop_back();
+			output += "\n// [END INCLUDE]\n";
+		}
+	}
+
+	std::string ShaderPreprocessor::process(std::string_view source, std::vector<std::string>* includes)
+	{
+		std::string output;
+		output.reserve(source.size());
+
+		std::vector<std::string> stack;
+		expand(source, output, stack, includes);
+
+		return output;
+	}
+
+	void ShaderPreprocessor::setFile(const std::string& path, const std::string& contents)
+	{
+		IncludeFile& entry = m_files[path];
+		entry.contents = contents;
+		entry.writeTime = -1;
+	}
+	void ShaderPreprocessor::invalidate(const std::string& path)
+	{
+		m_files.erase(path);
+	}
+	void ShaderPreprocessor::clear()
+	{
+		m_files.clear();
+	}
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "../utilities/Macros.h"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Vxl
+{
+	// Splices '#include "file"' lines into shader source in a single pass [no GL, usable without a context]
+	// Included files are read once and kept until their write time changes, nested includes are expanded
+	// Files already being expanded are skipped instead of recursing forever
+	class ShaderPreprocessor
+	{
+		DISALLOW_COPY_AND_ASSIGN(ShaderPreprocessor);
+	private:
+		struct IncludeFile
+		{
+			std::string contents;
+			int64_t		writeTime; // -1 = registered with setFile, never re-read
+		};
+		std::unordered_map<std::string, IncludeFile>	m_files;
+		std::vector<std::string>						m_errors;
+		uint32_t										m_readCount = 0;
+
+		// nullptr if the file doesn't exist
+		const std::string* getFile(const std::string& path);
+		void expand(std::string_view source, std::string& output, std::vector<std::string>& stack, std::vector<std::string>* includes);
+
+	public:
+		ShaderPreprocessor() {}
+
+		// Source with every include expanded, missing files are reported in getErrors() and their line removed
+		// Paths of expanded files [nested ones too] are appended to includes once each
+		std::string process(std::string_view source, std::vector<std::string>* includes = nullptr);
+
+		// Registers contents for a path without touching the disk
+		void setFile(const std::string& path, const std::string& contents);
+		// Forces the next use of a file to read it again
+		void invalidate(const std::string& path);
+		void clear();
+
+		inline const std::vector<std::string>& getErrors(void) const
+		{
+			return m_errors;
+		}
+		inline void								clearErrors(void)
+		{
+			m_errors.clear();
+		}
+		// Files read from disk since creation [cache hits don't count]
+		inline uint32_t							getReadCount(void) const
+		{
+			return m_readCount;
+		}
+	};
+}
@@ -0,0 +1,191 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "ShaderReloader.h"
+
+#include "Shader.h"
+
+#include "../utilities/Asset.h"
+#include "../utilities/AssetLoader.h"
+#include "../utilities/FileIO.h"
+#include "../utilities/Logger.h"
+#include "../utilities/Profiler.h"
+
+#include <algorithm>
+#include <memory>
+
+namespace Vxl
+{
+	void ShaderReloader::track(ShaderMaterial* material, const std::vector<std::string>& files)
+	{
+		std::vector<std::string> normalized;
+		normalized.reserve(files.size());
+		for (const std::string& file : files)
+		{
+			std::string path = FileWatcher::NormalizePath(file);
+			if (std::find(normalized.begin(), normalized.end(), path) == normalized.end())
+				normalized.push_back(path);
+		}
+
+		std::vector<std::string>& current = m_dependencies[material];
+
+		// Files no longer read
+		for (const std::string& file : current)
+		{
+			if (std::find(normalized.begin(), normalized.end(), file) != normalized.end())
+				continue;
+
+			auto it = m_dependents.find(file);
+			if (it == m_dependents.end())
+				continue;
+
+			it->second.erase(material);
+			if (it->second.empty())
+			{
+				m_dependents.erase(it);
+				m_watcher.unwatch(file);
+			}
+		}
+
+		// New files
+		for (const std::string& file : normalized)
+		{
+			if (std::find(current.begin(), current.end(), file) != current.end())
+				continue;
+
+			std::set<ShaderMaterial*>& materials = m_dependents[file];
+			if (materials.empty())
+				m_watcher.watch(file);
+
+			materials.insert(material);
+		}
+
+		current = std::move(normalized);
+	}
+	void ShaderReloader::untrack(ShaderMaterial* material)
+	{
+		auto dependencies = m_dependencies.find(material);
+		if (dependencies == m_dependencies.end())
+			return;
+
+		for (const std::string& file : dependencies->second)
+		{
+			auto it = m_dependents.find(file);
+			if (it == m_dependents.end())
+				continue;
+
+			it->second.erase(material);
+			if (it->second.empty())
+			{
+				m_dependents.erase(it);
+				m_watcher.unwatch(file);
+			}
+		}
+
+		m_dependencies.erase(dependencies);
+	}
+
+	void ShaderReloader::Init()
+	{
+		m_watcher.start();
+	}
+	void ShaderReloader::Shutdown()
+	{
+		m_watcher.stop();
+		m_pendingFiles.clear();
+	}
+
+	void ShaderReloader::Update()
+	{
+		if (!m_enabled || !m_watcher.isRunning())
+			return;
+
+		for (const std::string& file : m_watcher.poll())
+			m_pendingFiles.insert(file);
+
+		if (!m_batchInFlight && !m_pendingFiles.empty())
+			startBatch();
+	}
+
+	void ShaderReloader::startBatch()
+	{
+		VXL_PROFILE_SCOPE("ShaderReloader::startBatch");
+
+		// Assets keep #Include files in memory
+		for (const auto& file : Assets.getAllFiles())
+		{
+			if (m_pendingFiles.count(FileWatcher::NormalizePath(file.second->filepath)))
+				file.second->file = FileIO::readFile(file.second->filepath);
+		}
+
+		std::set<ShaderMaterial*> materials;
+		for (const std::string& file : m_pendingFiles)
+		{
+			Logger.log("Shader file changed: " + file);
+
+			auto it = m_dependents.find(file);
+			if (it != m_dependents.end())
+				materials.insert(it->second.begin(), it->second.end());
+		}
+		m_pendingFiles.clear();
+
+		if (materials.empty())
+			return;
+
+		// Workers only touch their own slot
+		struct Batch
+		{
+			std::vector<ShaderMaterial*>		materials;
+			std::vector<std::string>			filePaths;
+			std::vector<ShaderMaterialSource>	sources;
+			std::vector<uint8_t>				valid;
+			ShaderIncludeTable					includeTable;
+		};
+		auto batch = std::make_shared<Batch>();
+		batch->materials.assign(materials.begin(), materials.end());
+		for (ShaderMaterial* material : batch->materials)
+			batch->filePaths.push_back(material->m_filePath);
+		batch->sources.resize(batch->materials.size());
+		batch->valid.resize(batch->materials.size(), 0);
+		batch->includeTable = ShaderMaterial::GetIncludeTable();
+
+		std::vector<AssetLoader::Job> jobs;
+		for (uint32_t i = 0; i < (uint32_t)batch->materials.size(); i++)
+		{
+			jobs.push_back([batch, i]()
+			{
+				batch->valid[i] = ShaderMaterial::Preprocess(batch->filePaths[i], batch->includeTable, batch->sources[i]);
+				return true;
+			});
+		}
+
+		m_batchInFlight = true;
+		AssetLoader.Submit(-1, "Shader Reload", jobs,
+			// Render thread, every material of the batch swaps in the same frame
+			[this, batch]()
+			{
+				m_batchInFlight = false;
+
+				for (uint32_t i = 0; i < (uint32_t)batch->materials.size(); i++)
+				{
+					ShaderMaterial* material = batch->materials[i];
+
+					// Destroyed while preprocessing
+					if (m_dependencies.find(material) == m_dependencies.end() || material->m_filePath != batch->filePaths[i])
+						continue;
+
+					// Empty file, editor is most likely still writing it
+					if (!batch->valid[i])
+						continue;
+
+					if (material->build(batch->sources[i]))
+					{
+						m_rebuildCount++;
+						Logger.log("Reloaded Shader Material: " + batch->sources[i].name);
+					}
+				}
+
+				return LoadState::COMPLETE;
+			}
+		);
+	}
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "../utilities/singleton.h"
+#include "../utilities/Macros.h"
+#include "../utilities/FileWatcher.h"
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Vxl
+{
+	class ShaderMaterial;
+
+	// Rebuilds only the ShaderMaterials whose files changed on disk
+	// Materials report every file they read when built [.material, #Include files, #include'd GLSL]
+	// Preprocessing runs on AssetLoader workers, compiling and linking on the render thread
+	static class ShaderReloader : public Singleton<class ShaderReloader>
+	{
+		DISALLOW_COPY_AND_ASSIGN(ShaderReloader);
+		friend class ShaderMaterial;
+	private:
+		FileWatcher m_watcher;
+
+		// Normalized file path -> materials that read it, and the reverse
+		std::unordered_map<std::string, std::set<ShaderMaterial*>>		m_dependents;
+		std::unordered_map<ShaderMaterial*, std::vector<std::string>>	m_dependencies;
+
+		// Only one batch is preprocessed at a time, changes seen meanwhile wait for the next one
+		std::set<std::string>	m_pendingFiles;
+		bool					m_batchInFlight = false;
+		uint32_t				m_rebuildCount = 0;
+
+		void track(ShaderMaterial* material, const std::vector<std::string>& files);
+		void untrack(ShaderMaterial* material);
+
+		void startBatch();
+
+	public:
+		ShaderReloader() {}
+
+		bool m_enabled = true;
+
+		void Init();
+		void Shutdown();
+		// Render thread, once per frame
+		void Update();
+
+		// Materials rebuilt since Init
+		inline uint32_t getRebuildCount(void) const
+		{
+			return m_rebuildCount;
+		}
+		inline uint32_t getWatchedFileCount(void) const
+		{
+			return (uint32_t)m_dependents.size();
+		}
+
+	} SingletonInstance(ShaderReloader);
+}
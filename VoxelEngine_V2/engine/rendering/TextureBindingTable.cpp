@@ -0,0 +1,60 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "TextureBindingTable.h"
+
+#include "../textures/BaseTexture.h"
+#include "../textures/Texture2D.h"
+
+#include "../utilities/Asset.h"
+
+namespace Vxl
+{
+	bool TextureBindingTable::isValid(ShaderProgramIndex program, uint32_t texturesVersion) const
+	{
+		return m_program == program && m_texturesVersion == texturesVersion && m_textureGeneration == BaseTexture::GetGeneration();
+	}
+
+	void TextureBindingTable::build(ShaderProgramIndex program, const std::vector<std::pair<std::string, TextureLevel>>& targetLevels, const std::map<TextureLevel, TextureIndex>& textures, uint32_t texturesVersion)
+	{
+		m_program = program;
+		m_texturesVersion = texturesVersion;
+		m_textureGeneration = BaseTexture::GetGeneration();
+
+		m_bindings.clear();
+		m_bindings.reserve(targetLevels.size());
+
+		for (const auto& pair : targetLevels)
+		{
+			Binding binding;
+			binding.level = pair.second;
+
+			auto it = textures.find(binding.level);
+			binding.texture = (it != textures.end()) ? Assets.getBaseTexture(it->second) : nullptr;
+
+			if (binding.level == TextureLevel::LEVEL0)
+				binding.fallback = GlobalAssets.get_Tex2DNullImageCheckerboard();
+			else
+				binding.fallback = GlobalAssets.get_Tex2DNullImageBlack();
+
+			m_bindings.push_back(binding);
+		}
+	}
+	void TextureBindingTable::clear(void)
+	{
+		m_bindings.clear();
+		m_program = -1;
+		m_texturesVersion = -1;
+		m_textureGeneration = -1;
+	}
+
+	void TextureBindingTable::bind(void) const
+	{
+		for (const Binding& binding : m_bindings)
+		{
+			// Loading state and ids can change without the asset changing [async loads, resized render textures]
+			const BaseTexture* texture = (binding.texture && binding.texture->isLoaded()) ? binding.texture : binding.fallback;
+			if (texture)
+				Graphics::Texture::BindToLevel(binding.level, texture->getType(), texture->getID());
+		}
+	}
+}
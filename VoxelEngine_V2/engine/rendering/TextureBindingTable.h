@@ -0,0 +1,43 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "Graphics.h"
+
+#include "../utilities/Types.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Vxl
+{
+	class BaseTexture;
+
+	// Textures of a material or entity resolved against one program's samplers
+	// Rebuilt only when the program, the texture map or the set of texture assets changes
+	class TextureBindingTable
+	{
+	private:
+		struct Binding
+		{
+			TextureLevel	level;
+			BaseTexture*	texture;	// nullptr if missing
+			BaseTexture*	fallback;	// Used until texture is loaded
+		};
+		std::vector<Binding>	m_bindings;
+		ShaderProgramIndex		m_program = -1;
+		uint32_t				m_texturesVersion = -1;
+		uint32_t				m_textureGeneration = -1;
+
+	public:
+		TextureBindingTable() {}
+
+		// False if it must be built again before binding
+		bool isValid(ShaderProgramIndex program, uint32_t texturesVersion) const;
+		void build(ShaderProgramIndex program, const std::vector<std::pair<std::string, TextureLevel>>& targetLevels, const std::map<TextureLevel, TextureIndex>& textures, uint32_t texturesVersion);
+		void clear(void);
+
+		// No asset lookups, units that already hold the texture are skipped
+		void bind(void) const;
+	};
+}
@@ -32,6 +32,7 @@ namespace Vxl
 		m_ubos[UBOID::TIME]->sendVector(Vector4(_time[0], _time[1], _time[2], _time[3]), 0);
 		m_ubos[UBOID::TIME]->sendVector(Vector4(sinf(_time[0]), sinf(_time[1]), sinf(_time[2]), sinf(_time[3])), 16);
 		m_ubos[UBOID::TIME]->sendVector(Vector4(cosf(_time[0]), cosf(_time[1]), cosf(_time[2]), cosf(_time[3])), 32);
+		m_ubos[UBOID::TIME]->sendVector(Vector4(Time.GetFixedAlpha(), (float)Time.GetFixedDeltaTime(), (float)Time.GetFixedStepCount(), 0.0f), 48);
 		m_ubos[UBOID::TIME]->bind();
 	}
 	void UBOManager::BindFBOSize(const FramebufferObject& _fbo)
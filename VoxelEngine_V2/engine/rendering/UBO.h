@@ -85,7 +85,7 @@ namespace Vxl
 			// 64 = mat4
 			m_ubos = new UniformBufferObject*[(int)UBOID::TOTAL];
 			m_ubos[0] = new UniformBufferObject(64 * 3, UBOID::CAMERA, "Camera");
-			m_ubos[1] = new UniformBufferObject(16 * 3, UBOID::TIME, "Time");
+			m_ubos[1] = new UniformBufferObject(16 * 4, UBOID::TIME, "Time");
 			m_ubos[2] = new UniformBufferObject(16 * 2, UBOID::FBO_DATA, "FBO_Data");
 		}
 		void DestroyGLResources()
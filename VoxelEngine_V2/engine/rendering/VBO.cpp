@@ -2,6 +2,10 @@
 #include "Precompiled.h"
 #include "VBO.h"
 
+#include "../utilities/Time.h"
+
+#include <cstring>
+
 namespace Vxl
 {
 	// VBO //
@@ -16,38 +20,135 @@ namespace Vxl
 			return;
 
 		Graphics::VBO::bind(m_VBO);
+		m_layout.bindAttributes(0);
+	}
+
+	void VBO::unbindAttributes() const
+	{
+		m_layout.unbindAttributes();
+	}
+
+	// StreamVBO //
+	void StreamVBO::Allocate(uint32_t frameSize)
+	{
+		Release();
+
+		m_frameSize = frameSize;
+		m_VBO = Graphics::VBO::Create();
+		Graphics::VBO::bind(m_VBO);
+
+		m_mapped = (uint8_t*)Graphics::VBO::BindStorageMapped((ptrdiff_t)m_frameSize * VBO_STREAM_FRAMES);
+		if (!m_mapped)
+		{
+			// Storage is already immutable if only the map failed, orphaning needs a fresh buffer
+			Graphics::VBO::Delete(m_VBO);
+			m_VBO = Graphics::VBO::Create();
+			Graphics::VBO::bind(m_VBO);
+			Graphics::VBO::BindData((ptrdiff_t)m_frameSize * VBO_STREAM_FRAMES, nullptr, BufferUsage::STREAM_DRAW);
+		}
 
-		uint32_t elementCount = (uint32_t)m_layout.m_elements.size();
-		VXL_ASSERT(elementCount > 0, "Layout requires at least one Element");
+		m_region = 0;
+		m_used = 0;
+	}
+	void StreamVBO::Release()
+	{
+		if (m_VBO == -1)
+			return;
 
-		// If only 1 element, stride and offset can be set to zero for efficient packing
-		if (elementCount == 1)
+		// Deleting unmaps it, the driver keeps the storage alive for draws still in flight
+		for (FenceID& fence : m_fences)
 		{
-			const BufferElement& element = m_layout.m_elements[0];
+			Graphics::Sync::DeleteFence(fence);
+			fence = nullptr;
+		}
+
+		Graphics::VBO::Delete(m_VBO);
+		m_VBO = -1;
+		m_mapped = nullptr;
+	}
+	void StreamVBO::NextRegion()
+	{
+		// Draws from the finished region were all issued before this fence
+		Graphics::Sync::DeleteFence(m_fences[m_region]);
+		m_fences[m_region] = m_mapped ? Graphics::Sync::CreateFence() : nullptr;
 
-			Graphics::VBO::SetVertexAttribState((uint32_t)element.m_attributeLocation, true);
-			Graphics::VBO::SetVertexAttrib((uint32_t)element.m_attributeLocation, element.m_valueCount, element.m_dataType, 0, 0, element.m_normalized);
+		m_region = (m_region + 1) % VBO_STREAM_FRAMES;
+		m_used = 0;
 
-			if (element.m_divisor > 0)
-				Graphics::VBO::SetVertexAttribDivisor((uint32_t)element.m_attributeLocation, element.m_divisor);
+		if (m_mapped)
+		{
+			Graphics::Sync::WaitFence(m_fences[m_region]);
+			Graphics::Sync::DeleteFence(m_fences[m_region]);
+			m_fences[m_region] = nullptr;
+		}
+		// Driver hands out fresh memory instead of waiting
+		else if (m_region == 0)
+		{
+			Graphics::VBO::bind(m_VBO);
+			Graphics::VBO::BindData((ptrdiff_t)m_frameSize * VBO_STREAM_FRAMES, nullptr, BufferUsage::STREAM_DRAW);
+		}
+	}
+	void StreamVBO::Write(const void* data, uint32_t bytes)
+	{
+		uint32_t stride = m_layout.getStride();
+		VXL_ASSERT(stride > 0, "StreamVBO requires a layout before writing");
+
+		if (m_VBO == -1)
+			Allocate(m_frameSize);
+
+		if (m_frame != Time.GetFrameCount())
+		{
+			m_frame = Time.GetFrameCount();
+			NextRegion();
+		}
+
+		// Attribute offsets need alignment
+		uint32_t start = (m_used + VBO_STREAM_ALIGNMENT - 1) & ~(uint32_t)(VBO_STREAM_ALIGNMENT - 1);
+
+		// Region is full, grow every region [rare, old buffer is released once the GPU is done with it]
+		if (start + bytes > m_frameSize)
+		{
+			uint32_t frameSize = m_frameSize;
+			while (frameSize < start + bytes)
+				frameSize *= 2;
+
+			Allocate(frameSize);
+			start = 0;
+		}
+
+		m_offset = m_region * m_frameSize + start;
+		m_used = start + bytes;
+		m_DrawCount = bytes / stride;
+
+		if (bytes == 0)
+			return;
+
+		if (m_mapped)
+		{
+			memcpy(m_mapped + m_offset, data, bytes);
 		}
-		// Normal layout
 		else
 		{
-			for (const auto& element : m_layout.m_elements)
-			{
-				Graphics::VBO::SetVertexAttribState((uint32_t)element.m_attributeLocation, true);
-				Graphics::VBO::SetVertexAttrib((uint32_t)element.m_attributeLocation, element.m_valueCount, element.m_dataType, m_layout.m_stride, element.m_offset, element.m_normalized);
-
-				if (element.m_divisor > 0)
-					Graphics::VBO::SetVertexAttribDivisor((uint32_t)element.m_attributeLocation, element.m_divisor);
-			}
+			Graphics::VBO::bind(m_VBO);
+			Graphics::VBO::BindSubData(m_offset, bytes, (void*)data);
 		}
 	}
+	void StreamVBO::bind() const
+	{
+		if (m_VBO == -1)
+			return;
+
+		Graphics::VBO::bind(m_VBO);
+		m_layout.bindAttributes(m_offset);
+	}
+	void StreamVBO::unbindAttributes() const
+	{
+		m_layout.unbindAttributes();
+	}
 
 	// EBO //
 
-	void EBO::SetIndices(uint32_t* _arr, uint32_t _count, BufferUsage _mode)
+	void EBO::SetIndices(const uint32_t* _arr, uint32_t _count, BufferUsage _mode)
 	{
 		VXL_ASSERT(_mode != BufferUsage::NONE, "Incorrect BufferUsage for EBO");
 		m_bindMode = _mode;
@@ -63,11 +164,11 @@ namespace Vxl
 		m_Size = _count * sizeof(uint32_t);
 		m_DrawCount = _count;
 		Graphics::EBO::bind(m_EBO);
-		Graphics::EBO::BindData(m_Size, _arr, _mode);
+		Graphics::EBO::BindData(m_Size, (void*)_arr, _mode);
 	}
-	void EBO::SetIndices(std::vector<uint32_t> _arr, BufferUsage _mode)
+	void EBO::SetIndices(const std::vector<uint32_t>& _arr, BufferUsage _mode)
 	{
-		SetIndices(&_arr[0], (uint32_t)_arr.size(), _mode);
+		SetIndices(_arr.data(), (uint32_t)_arr.size(), _mode);
 	}
 	void EBO::bind() const
 	{
@@ -9,6 +9,9 @@
 #include <vector>
 #include <map>
 
+#define VBO_STREAM_FRAMES 3 // Regions of a StreamVBO [frames the GPU can fall behind]
+#define VBO_STREAM_ALIGNMENT 16 // Bytes
+
 namespace Vxl
 {
 	// Vertex Array Object Wrapper
@@ -62,13 +65,13 @@ namespace Vxl
 			m_TypeSize = sizeof(Type);
 		}
 		template<typename Type = float>
-		VBO(Type* _arr, uint32_t _count, BufferUsage _mode = BufferUsage::STATIC_DRAW)
+		VBO(const Type* _arr, uint32_t _count, BufferUsage _mode = BufferUsage::STATIC_DRAW)
 		{
 			m_TypeSize = sizeof(Type);
 			SetVertices<Type>(_arr, _count, _mode);
 		}
 		template<typename Type = float>
-		VBO(std::vector<Type> _arr, BufferUsage _mode = BufferUsage::STATIC_DRAW)
+		VBO(const std::vector<Type>& _arr, BufferUsage _mode = BufferUsage::STATIC_DRAW)
 		{
 			m_TypeSize = sizeof(Type);
 			SetVertices<Type>(_arr, _mode);
@@ -82,7 +85,7 @@ namespace Vxl
 
 		// If Type is not a float, it must be an object containing floats
 		template<typename Type = float>
-		void SetVertices(Type* _arr, uint32_t _count, BufferUsage _mode)
+		void SetVertices(const Type* _arr, uint32_t _count, BufferUsage _mode)
 		{
 			VXL_ASSERT(_mode != BufferUsage::NONE, "Incorrect BufferUsage for VBO");
 			m_bindMode = _mode;
@@ -102,20 +105,21 @@ namespace Vxl
 			UpdateDrawCount();
 		}
 		template<typename Type = float>
-		void SetVertices(std::vector<Type> _arr, BufferUsage _mode)
+		void SetVertices(const std::vector<Type>& _arr, BufferUsage _mode)
 		{
-			SetVertices(&_arr[0], (uint32_t)_arr.size(), _mode);
+			SetVertices(_arr.data(), (uint32_t)_arr.size(), _mode);
 		}
 
 		template<typename Type = float>
-		void UpdateVertices(Type* _arr, int offset)
+		void UpdateVertices(const Type* _arr, int offset)
 		{
 			Graphics::VBO::bind(m_VBO);
 			Graphics::VBO::BindSubData(offset, m_Size, (void*)_arr);
 		}
 
+		// _arr is the data to place at offset [bytes], not the start of the buffer
 		template<typename Type = float>
-		void UpdateVertices(Type* _arr, int offset, uint32_t size)
+		void UpdateVertices(const Type* _arr, int offset, uint32_t size)
 		{
 			VXL_ASSERT(size + offset <= m_Size, "VBO: Size + Offset too large for updating vertices");
 
@@ -155,6 +159,8 @@ namespace Vxl
 		}
 
 		void bind() const;
+		// Disables the layout's attributes on the bound VAO
+		void unbindAttributes() const;
 	};
 
 	// Element Buffer Object
@@ -180,15 +186,15 @@ namespace Vxl
 				Graphics::EBO::Delete(m_EBO);
 		}
 
-		void SetIndices(uint32_t* _arr, uint32_t _count, BufferUsage _mode = BufferUsage::STATIC_DRAW);
-		void SetIndices(std::vector<uint32_t> _arr, BufferUsage _mode = BufferUsage::STATIC_DRAW);
+		void SetIndices(const uint32_t* _arr, uint32_t _count, BufferUsage _mode = BufferUsage::STATIC_DRAW);
+		void SetIndices(const std::vector<uint32_t>& _arr, BufferUsage _mode = BufferUsage::STATIC_DRAW);
 
-		void UpdateIndices(uint32_t* _arr, int offset)
+		void UpdateIndices(const uint32_t* _arr, int offset)
 		{
 			Graphics::EBO::bind(m_EBO);
-			Graphics::EBO::BindSubData(offset, m_Size, _arr);
+			Graphics::EBO::BindSubData(offset, m_Size, (void*)_arr);
 		}
-		void UpdateIndices(uint32_t* _arr, int offset, uint32_t size)
+		void UpdateIndices(const uint32_t* _arr, int offset, uint32_t size)
 		{
 			VXL_ASSERT(size + offset <= m_Size, "VBO: Size + Offset too large for updating vertices");
 
@@ -220,5 +226,65 @@ namespace Vxl
 
 		void bind() const;
 	};
+
+	// Vertex Buffer Object for data rewritten every frame [debug lines, instance batches]
+	// Persistently mapped and split in VBO_STREAM_FRAMES regions, the CPU fills one while the GPU reads the others
+	// A fence per region keeps writes away from data still in use [orphans the buffer instead before GL 4.4]
+	class StreamVBO
+	{
+		DISALLOW_COPY_AND_ASSIGN(StreamVBO);
+	private:
+		VBOID			m_VBO = -1;
+		uint8_t*		m_mapped = nullptr;		// nullptr while orphaning
+		uint32_t		m_frameSize = 0;		// Bytes per region
+		uint32_t		m_region = 0;			// Region being written
+		uint32_t		m_used = 0;				// Bytes written in the region
+		uint32_t		m_offset = 0;			// Last write [bytes from the start of the buffer]
+		uint32_t		m_DrawCount = 0;		// Last write
+		uint32_t		m_frame = UINT32_MAX;	// Frame the region belongs to
+		FenceID			m_fences[VBO_STREAM_FRAMES] = {};
+		BufferLayout	m_layout;
+
+		void Allocate(uint32_t frameSize);
+		void Release();
+		// Moves to the next region once per frame [waits for the GPU if it's still reading it]
+		void NextRegion();
+
+	public:
+		StreamVBO(uint32_t frameSize = 65536)
+			: m_frameSize(frameSize)
+		{}
+		~StreamVBO()
+		{
+			Release();
+		}
+
+		// Copies data into this frame's region, draws read it until the next write
+		void Write(const void* data, uint32_t bytes);
+
+		template<typename Type = float>
+		void SetVertices(const Type* _arr, uint32_t _count)
+		{
+			Write(_arr, _count * sizeof(Type));
+		}
+
+		inline void SetLayout(const BufferLayout& layout)
+		{
+			m_layout = layout;
+		}
+
+		inline uint32_t GetDrawCount(void) const
+		{
+			return m_DrawCount;
+		}
+		inline bool IsPersistent(void) const
+		{
+			return m_mapped != nullptr;
+		}
+
+		void bind() const;
+		// Disables the layout's attributes on the bound VAO
+		void unbindAttributes() const;
+	};
 }
 
@@ -18,6 +18,24 @@ namespace Vxl
 		m_dataType = Graphics::GetDataType(shaderDataType);
 	}
 
+	BufferElement::BufferElement(AttributeLocation attribLocation, DataType dataType, uint32_t valueCount, bool normalized, uint32_t divisor)
+		: m_attributeLocation(attribLocation), m_dataType(dataType), m_normalized(normalized), m_valueCount(valueCount), m_divisor(divisor)
+	{
+		VXL_ASSERT((int)m_attributeLocation <= Graphics::GLMaxAttributes,
+			"Attribute location is too large; Current: " + std::to_string((int)attribLocation) + ", Max: " + std::to_string(Graphics::GLMaxAttributes)
+		);
+		VXL_ASSERT(valueCount >= 1 && valueCount <= 4, "Attribute value count must be between 1 and 4");
+
+		static const AttributeType ShaderTypes[4] = { AttributeType::FLOAT, AttributeType::VEC2, AttributeType::VEC3, AttributeType::VEC4 };
+		m_shaderDataType = ShaderTypes[valueCount - 1];
+
+		// Packed formats hold all 4 values in one 32 bit value
+		if (dataType == DataType::INT_2_10_10_10_REV || dataType == DataType::UNSIGNED_INT_2_10_10_10_REV || dataType == DataType::UNSIGNED_INT_10F_11F_11F_REV)
+			m_size = Graphics::GetSize(dataType);
+		else
+			m_size = Graphics::GetSize(dataType) * valueCount;
+	}
+
 	BufferLayout::BufferLayout(const std::initializer_list<BufferElement>& elements)
 		: m_elements(elements)
 	{
@@ -30,4 +48,27 @@ namespace Vxl
 			m_stride += element.m_size;
 		}
 	}
+
+	void BufferLayout::bindAttributes(uint32_t baseOffset) const
+	{
+		uint32_t elementCount = (uint32_t)m_elements.size();
+		VXL_ASSERT(elementCount > 0, "Layout requires at least one Element");
+
+		// If only 1 element, stride can be set to zero for efficient packing
+		uint32_t stride = (elementCount == 1) ? 0 : m_stride;
+
+		for (const auto& element : m_elements)
+		{
+			Graphics::VBO::SetVertexAttribState((uint32_t)element.m_attributeLocation, true);
+			Graphics::VBO::SetVertexAttrib((uint32_t)element.m_attributeLocation, element.m_valueCount, element.m_dataType, stride, baseOffset + element.m_offset, element.m_normalized);
+
+			if (element.m_divisor > 0)
+				Graphics::VBO::SetVertexAttribDivisor((uint32_t)element.m_attributeLocation, element.m_divisor);
+		}
+	}
+	void BufferLayout::unbindAttributes() const
+	{
+		for (const auto& element : m_elements)
+			Graphics::VBO::SetVertexAttribState((uint32_t)element.m_attributeLocation, false);
+	}
 }
\ No newline at end of file
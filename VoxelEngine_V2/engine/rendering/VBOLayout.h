@@ -60,6 +60,8 @@ namespace Vxl
 
 	public:
 		BufferElement(AttributeLocation attribLocation, AttributeType shaderDataType, bool normalized = false, uint32_t divisor = 0);
+		// Stored type differs from what the shader reads [ex: 2 SHORT normalized -> vec2 in [-1, 1], 2 HALF_FLOAT -> vec2]
+		BufferElement(AttributeLocation attribLocation, DataType dataType, uint32_t valueCount, bool normalized = false, uint32_t divisor = 0);
 	};
 
 	// Vertex Buffer Layout
@@ -69,10 +71,19 @@ namespace Vxl
 	private:
 		int test;
 		std::vector<BufferElement>	m_elements;
-		uint32_t					m_stride; // Bytes
+		uint32_t					m_stride = 0; // Bytes
 
 	public:
 		BufferLayout() {}
 		BufferLayout(const std::initializer_list<BufferElement>& elements);
+
+		inline uint32_t getStride(void) const
+		{
+			return m_stride;
+		}
+
+		// Points the attributes at the bound VBO [baseOffset = bytes before the first vertex]
+		void bindAttributes(uint32_t baseOffset = 0) const;
+		void unbindAttributes() const;
 	};
 }
\ No newline at end of file
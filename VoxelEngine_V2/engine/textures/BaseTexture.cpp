@@ -12,12 +12,45 @@
 
 #include "../window/window.h"
 
+#include <SOIL/SOIL.h>
+
 #include <assert.h>
 
 namespace Vxl
 {
+	/* IMAGE DATA */
+
+	ImageData::~ImageData()
+	{
+		if (pixels)
+			SOIL_free_image_data(pixels);
+	}
+	bool ImageData::load(const std::string& filePath, bool InvertY)
+	{
+		pixels = SOIL_load_image(filePath.c_str(), &width, &height, &channelCount, SOIL_LOAD_AUTO);
+
+		if (!pixels)
+		{
+			error = "Could not load Image: " + filePath + "\nSOIL: " + std::string(SOIL_last_result());
+			return false;
+		}
+
+		if (InvertY)
+			BaseTexture::FlipImageVertically(pixels, width, height, channelCount);
+
+		return true;
+	}
+	uint8_t* ImageData::release()
+	{
+		uint8_t* data = pixels;
+		pixels = nullptr;
+		return data;
+	}
+
 	/* BASE TEXTURE */
 
+	uint32_t BaseTexture::m_generation = 0;
+
 	void BaseTexture::load()
 	{
 		VXL_ASSERT(m_id == -1, "Cannot call load on Texture that is alread loaded");
@@ -66,20 +99,25 @@ namespace Vxl
 		}
 	}
 	void BaseTexture::flipImageVertically(uint8_t* imagePixels)
+	{
+		FlipImageVertically(imagePixels, m_width, m_height, m_channelCount);
+	}
+	void BaseTexture::FlipImageVertically(uint8_t* imagePixels, int width, int height, int channelCount)
 	{
 		VXL_ASSERT(imagePixels, "Cannot flip texture/image if pixels are not stored");
 
-		unsigned char* Tmp = new unsigned char[m_width * m_channelCount];
-		for (uint32_t y = 0; y < (uint32_t)m_height / 2; y++)
+		UINT rowSize = width * channelCount;
+		std::vector<uint8_t> Tmp(rowSize);
+		for (uint32_t y = 0; y < (uint32_t)height / 2; y++)
 		{
 			// Top row
-			UINT index1 = ((m_height - y) - 1) * m_width * m_channelCount;
-			UINT index2 = y * m_width * m_channelCount;
+			UINT index1 = ((height - y) - 1) * rowSize;
+			UINT index2 = y * rowSize;
 			// Temp
-			memcpy(Tmp, &imagePixels[index1], m_width * m_channelCount);
+			memcpy(Tmp.data(), &imagePixels[index1], rowSize);
 			// Swap
-			memcpy(&imagePixels[index1], &imagePixels[index2], m_width * m_channelCount);
-			memcpy(&imagePixels[index2], Tmp, m_width * m_channelCount);
+			memcpy(&imagePixels[index1], &imagePixels[index2], rowSize);
+			memcpy(&imagePixels[index2], Tmp.data(), rowSize);
 		}
 	}
 
@@ -109,10 +147,12 @@ namespace Vxl
 			m_channelCount = Graphics::GetChannelCount(FormatType);
 
 		updateParameters();
+		m_generation++;
 	}
 	BaseTexture::~BaseTexture()
 	{
 		unload();
+		m_generation++;
 	}
 
 	void BaseTexture::bind(TextureLevel layer) const
@@ -12,6 +12,25 @@
 namespace Vxl
 {
 	class RenderBuffer;
+
+	// Image decoded from file, has no GL dependencies so it can be loaded on any thread
+	struct ImageData
+	{
+		DISALLOW_COPY_AND_ASSIGN(ImageData);
+
+		uint8_t*	pixels = nullptr;
+		int			width = 0;
+		int			height = 0;
+		int			channelCount = 0;
+		std::string	error;
+
+		ImageData() {}
+		~ImageData();
+
+		bool	 load(const std::string& filePath, bool InvertY);
+		// Caller becomes owner of pixels
+		uint8_t* release();
+	};
 	
 	class BaseTexture
 	{
@@ -32,6 +51,9 @@ namespace Vxl
 		TexturePixelType	m_pixelType;
 		AnisotropicMode		m_anisotropicMode;
 
+		// Changes when any texture is created or destroyed
+		static uint32_t		m_generation;
+
 		// Creation/Deletion
 		void load();
 		void unload();
@@ -45,6 +67,8 @@ namespace Vxl
 		void updateMipmapping();
 		void flipImageVertically(uint8_t* imagePixels);
 
+		static void FlipImageVertically(uint8_t* imagePixels, int width, int height, int channelCount);
+
 	public:
 		BaseTexture(const BaseTexture&) = delete;
 		BaseTexture(
@@ -59,6 +83,12 @@ namespace Vxl
 		);
 		virtual ~BaseTexture();
 
+		// Cached texture pointers are valid while this doesn't change [TextureBindingTable]
+		static inline uint32_t GetGeneration(void)
+		{
+			return m_generation;
+		}
+
 		void bind(TextureLevel layer) const;
 		void bind() const;
 		void unbind() const;
@@ -4,10 +4,9 @@
 
 #include "../rendering/Graphics.h"
 
+#include "../utilities/Logger.h"
 #include "../utilities/stringUtil.h"
 
-#include <SOIL/SOIL.h>
-
 namespace Vxl
 {
 	Cubemap::Cubemap(
@@ -27,24 +26,46 @@ namespace Vxl
 	)
 		: BaseTexture(TextureType::TEX_CUBEMAP, WrapMode, FilterMode, FormatType, TextureChannelType::NONE, PixelType, AnisotropicMode, UseMipMapping)
 	{
-		m_image[0] = SOIL_load_image(filePath1.c_str(), &m_width, &m_height, &m_channelCount, SOIL_LOAD_AUTO);
-		m_image[1] = SOIL_load_image(filePath2.c_str(), &m_width, &m_height, &m_channelCount, SOIL_LOAD_AUTO);
-		m_image[2] = SOIL_load_image(filePath3.c_str(), &m_width, &m_height, &m_channelCount, SOIL_LOAD_AUTO);
-		m_image[3] = SOIL_load_image(filePath4.c_str(), &m_width, &m_height, &m_channelCount, SOIL_LOAD_AUTO);
-		m_image[4] = SOIL_load_image(filePath5.c_str(), &m_width, &m_height, &m_channelCount, SOIL_LOAD_AUTO);
-		m_image[5] = SOIL_load_image(filePath6.c_str(), &m_width, &m_height, &m_channelCount, SOIL_LOAD_AUTO);
+		const std::string* filePaths[6] = { &filePath1, &filePath2, &filePath3, &filePath4, &filePath5, &filePath6 };
 
+		ImageData faces[6];
 		for (uint32_t i = 0; i < 6; i++)
 		{
-			if (!m_image[i])
+			if (!faces[i].load(*filePaths[i], InvertY))
+			{
+				Logger.error(faces[i].error);
 				return;
-
-			else if (InvertY)
-				flipImageVertically(m_image[i]);
+			}
 		}
 
+		upload(faces, filePath1);
+	}
+	Cubemap::Cubemap(
+		TextureWrapping		WrapMode,
+		TextureFilter		FilterMode,
+		TextureFormat		FormatType,
+		TexturePixelType	PixelType,
+		AnisotropicMode		AnisotropicMode,
+		bool				UseMipMapping
+	)
+		: BaseTexture(TextureType::TEX_CUBEMAP, WrapMode, FilterMode, FormatType, TextureChannelType::NONE, PixelType, AnisotropicMode, UseMipMapping)
+	{
+		unbind();
+	}
+	void Cubemap::upload(ImageData* faces, const std::string& filePath)
+	{
+		VXL_ASSERT(!m_loaded, "Cubemap already has storage");
+
+		// All faces are expected to share the same size
+		m_width = faces[0].width;
+		m_height = faces[0].height;
+		m_channelCount = faces[0].channelCount;
+		for (uint32_t i = 0; i < 6; i++)
+			m_image[i] = faces[i].release();
+
 		m_channelType = Graphics::GetChannelType(m_channelCount);
 
+		bind();
 		createStorage();
 
 		// Storage
@@ -55,7 +76,7 @@ namespace Vxl
 		updateMipmapping();
 
 		// glName
-		auto Name = stringUtil::nameFromFilepath(filePath1);
+		auto Name = stringUtil::nameFromFilepath(filePath);
 		Graphics::SetGLName(ObjectType::TEXTURE, m_id, "Cubemap_" + Name);
 
 		// finished
@@ -10,7 +10,7 @@ namespace Vxl
 		DISALLOW_COPY_AND_ASSIGN(Cubemap);
 		friend class _Assets;
 	protected:
-		UCHAR**		m_image = new UCHAR*[6];
+		UCHAR*		m_image[6] = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
 
 		// Constructor
 		Cubemap(
@@ -28,6 +28,19 @@ namespace Vxl
 			TexturePixelType	PixelType = TexturePixelType::UNSIGNED_BYTE,
 			AnisotropicMode		AnisotropicMode = AnisotropicMode::NONE
 		);
+		// Constructor [Empty, filled by upload once all faces are decoded]
+		Cubemap(
+			TextureWrapping		WrapMode,
+			TextureFilter		FilterMode,
+			TextureFormat		FormatType,
+			TexturePixelType	PixelType,
+			AnisotropicMode		AnisotropicMode,
+			bool				UseMipMapping
+		);
+
+		// Create storage from decoded faces [takes ownership of pixels]
+		void upload(ImageData* faces, const std::string& filePath);
+
 	public:
 
 		~Cubemap();
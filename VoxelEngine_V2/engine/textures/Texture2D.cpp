@@ -28,23 +28,42 @@ namespace Vxl
 	)
 		: BaseTexture(TextureType::TEX_2D, WrapMode, FilterMode, FormatType, TextureChannelType::NONE, PixelType, AnisotropicMode, UseMipMapping)
 	{
-		m_image = SOIL_load_image(filePath.c_str(), &m_width, &m_height, &m_channelCount, SOIL_LOAD_AUTO);
-
-		if (!m_image)
+		ImageData image;
+		if (!image.load(filePath, InvertY))
 		{
-			Logger.error("Could not load Image: " + filePath);
-			Logger.error("SOIL: " + std::string(SOIL_last_result()));
+			Logger.error(image.error);
 			return;
 		}
 
+		upload(image, filePath);
+	}
+	// [ Empty ]
+	Texture2D::Texture2D(
+		TextureWrapping		WrapMode,
+		TextureFilter		FilterMode,
+		TextureFormat		FormatType,
+		TexturePixelType	PixelType,
+		AnisotropicMode		AnisotropicMode,
+		bool				UseMipMapping
+	)
+		: BaseTexture(TextureType::TEX_2D, WrapMode, FilterMode, FormatType, TextureChannelType::NONE, PixelType, AnisotropicMode, UseMipMapping)
+	{
+		unbind();
+	}
+	void Texture2D::upload(ImageData& image, const std::string& filePath)
+	{
+		VXL_ASSERT(!m_loaded, "Texture2D already has storage");
+
+		m_width = image.width;
+		m_height = image.height;
+		m_channelCount = image.channelCount;
+		m_image = image.release();
+
 		// Get Correct channel data
 		m_channelType = Graphics::GetChannelType(m_channelCount);
 
-		// Invert Y
-		if (InvertY)
-			flipImageVertically(m_image);
-
 		// Storage
+		bind();
 		createStorage();
 		setStorage(&m_image[0]);
 		updateMipmapping();
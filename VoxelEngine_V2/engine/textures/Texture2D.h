@@ -25,6 +25,15 @@ namespace Vxl
 			TexturePixelType	PixelType = TexturePixelType::UNSIGNED_BYTE,
 			AnisotropicMode		AnistropicMode = AnisotropicMode::NONE
 		);
+		// Constructor [Empty, filled by upload once the image is decoded]
+		Texture2D(
+			TextureWrapping		WrapMode,
+			TextureFilter		FilterMode,
+			TextureFormat		FormatType,
+			TexturePixelType	PixelType,
+			AnisotropicMode		AnistropicMode,
+			bool				UseMipMapping
+		);
 		// Constructor [Create custom] // 1 Channel
 		Texture2D(
 			std::vector<float>  pixels,
@@ -65,6 +74,10 @@ namespace Vxl
 			AnisotropicMode		AnisotropicMode = AnisotropicMode::NONE
 		);
 
+
+		// Create storage from decoded image [takes ownership of pixels]
+		void upload(ImageData& image, const std::string& filePath);
+
 	public:
 
 		~Texture2D();
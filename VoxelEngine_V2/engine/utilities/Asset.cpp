@@ -13,8 +13,11 @@
 #include "../textures/Texture2D.h"
 #include "../textures/RenderTexture.h"
 #include "../textures/Cubemap.h"
+#include "../utilities/AssetLoader.h"
 #include "../utilities/FileIO.h"
 
+#include <array>
+
 namespace Vxl
 {
 	IDStorage<BaseTexture>		  _Assets::m_baseTexture_storage;
@@ -622,6 +625,46 @@ namespace Vxl
 		// Return index
 		return index;
 	}
+	LoadHandle _Assets::loadTexture2DAsync(
+		const std::string& filePath,
+		bool				InvertY,
+		bool				UseMipMapping,
+		TextureWrapping		WrapMode,
+		TextureFilter		FilterMode,
+		TextureFormat		FormatType,
+		TexturePixelType	PixelType,
+		AnisotropicMode		AnisotropicMode
+	)
+	{
+		// Create New Data [storage is created on upload]
+		Texture2D* _texture = new Texture2D(WrapMode, FilterMode, FormatType, PixelType, AnisotropicMode, UseMipMapping);
+		// Store Data
+		TextureIndex index = m_baseTexture_storage.Add(_texture, m_creationType);
+		m_texture2D_storage.AddCustom(_texture, m_creationType, index);
+
+		auto image = std::make_shared<ImageData>();
+		return AssetLoader.Submit(index, filePath,
+			// Worker
+			[image, filePath, InvertY]()
+			{
+				if (image->load(filePath, InvertY))
+					return true;
+
+				AssetLoader::ReportError(image->error);
+				return false;
+			},
+			// Render thread [texture is gone if its scene was destroyed meanwhile]
+			[image, filePath, index]()
+			{
+				Texture2D* _texture = m_texture2D_storage.Get(index);
+				if (!_texture)
+					return LoadState::CANCELLED;
+
+				_texture->upload(*image, filePath);
+				return LoadState::COMPLETE;
+			}
+		);
+	}
 	TextureIndex _Assets::createTexture2D(
 		std::vector<float> pixels, uint32_t width,
 		bool				UseMipMapping,
@@ -713,6 +756,56 @@ namespace Vxl
 		// Return index
 		return index;
 	}
+	LoadHandle _Assets::loadCubemapAsync(
+		const std::string& filePath1, const std::string& filePath2,
+		const std::string& filePath3, const std::string& filePath4,
+		const std::string& filePath5, const std::string& filePath6,
+		bool InvertY,
+		bool UseMipMapping,
+		TextureWrapping		WrapMode,
+		TextureFilter		FilterMode,
+		TextureFormat		FormatType,
+		TexturePixelType	PixelType,
+		AnisotropicMode		AnisotropicMode
+	)
+	{
+		// Create New Data [storage is created on upload]
+		Cubemap* _cubemap = new Cubemap(WrapMode, FilterMode, FormatType, PixelType, AnisotropicMode, UseMipMapping);
+		// Store Data
+		TextureIndex index = m_baseTexture_storage.Add(_cubemap, m_creationType);
+		m_cubemap_storage.AddCustom(_cubemap, m_creationType, index);
+
+		// One job per face
+		auto faces = std::make_shared<std::array<ImageData, 6>>();
+		const std::string filePaths[6] = { filePath1, filePath2, filePath3, filePath4, filePath5, filePath6 };
+
+		std::vector<AssetLoader::Job> jobs;
+		for (uint32_t i = 0; i < 6; i++)
+		{
+			std::string filePath = filePaths[i];
+			jobs.push_back([faces, i, filePath, InvertY]()
+			{
+				if ((*faces)[i].load(filePath, InvertY))
+					return true;
+
+				AssetLoader::ReportError((*faces)[i].error);
+				return false;
+			});
+		}
+
+		return AssetLoader.Submit(index, filePath1, jobs,
+			// Render thread [cubemap is gone if its scene was destroyed meanwhile]
+			[faces, filePath1, index]()
+			{
+				Cubemap* _cubemap = m_cubemap_storage.Get(index);
+				if (!_cubemap)
+					return LoadState::CANCELLED;
+
+				_cubemap->upload(faces->data(), filePath1);
+				return LoadState::COMPLETE;
+			}
+		);
+	}
 	void _Assets::loadFile(
 		const std::string& name,
 		const std::string& filepath
@@ -817,6 +910,13 @@ namespace Vxl
 		// Store Data and Return index
 		return m_shaderProgram_storage.Add(_program, m_creationType);
 	}
+	ShaderProgramIndex _Assets::createShaderProgram(const std::string& name, uint32_t binaryFormat, const std::vector<uint8_t>& binary, const std::vector<ShaderType>& types, std::vector<std::pair<std::string, TextureLevel>> _textureLevels)
+	{
+		// Create New Data
+		ShaderProgram* _program = new ShaderProgram(name, binaryFormat, binary, types, _textureLevels);
+		// Store Data and Return index
+		return m_shaderProgram_storage.Add(_program, m_creationType);
+	}
 
 	MaterialIndex _Assets::createMaterial(const std::string& name)
 	{
@@ -852,7 +952,7 @@ namespace Vxl
 	{
 		// Create New Data
 		Camera* object = new Camera(name, znear, zfar);
-		object->m_transform.m_rotationOrder = EulerRotationOrder::YXZ;
+		object->m_transform.setRotationOrder(EulerRotationOrder::YXZ);
 		
 		// Store Data
 		SceneNodeIndex nodeIndex = m_sceneNode_storage.Add(dynamic_cast<SceneNode*>(object), m_creationType);
@@ -6,7 +6,7 @@
 #include <string>
 #include <set>
 #include <map>
-#include <stack>
+#include <algorithm>
 #include <vector>
 
 #include "Types.h"
@@ -40,6 +40,7 @@ namespace Vxl
 	class Entity;
 	class Camera;
 	class SceneNode;
+	class LoadHandle;
 	// Forward Declare Enums
 	enum class TextureWrapping;
 	enum class TextureFilter;
@@ -59,150 +60,236 @@ namespace Vxl
 		SCENE
 	};
 
+	// Slot Map [ID = generation (upper bits) + slot (lower bits)]
+	// Lookups are a single array access, IDs of erased data fail the generation check
+	// Dense arrays keep iteration contiguous [order changes when erasing]
 	template<class Type>
 	class IDStorage
 	{
 		DISALLOW_COPY_AND_ASSIGN(IDStorage);
+	public:
+		using Element = std::pair<uint32_t, Type*>;
+		using Elements = std::vector<Element>;
+
+		static const uint32_t SlotBits = 20;
+		static const uint32_t SlotMask = (1u << SlotBits) - 1;
+		static const uint32_t GenerationMask = (1u << (32 - SlotBits)) - 1;
+
+	private:
+		struct Slot
+		{
+			Type*		data = nullptr;
+			uint32_t	generation = 1;
+			AssetType	type = AssetType::NONE;
+			uint32_t	denseAll = -1; // Location in m_all
+			uint32_t	denseType = -1; // Location in m_global/m_scene
+			uint32_t	freeIndex = -1; // Location in m_freeSlots
+		};
+
+		std::vector<Slot>		m_slots;
+		std::vector<uint32_t>	m_freeSlots;
+		Elements				m_all;
+		Elements				m_global;
+		Elements				m_scene;
+
+		static inline uint32_t	MakeID(uint32_t slot, uint32_t generation)
+		{
+			return (generation << SlotBits) | slot;
+		}
+		static inline uint32_t	GetSlot(uint32_t id)
+		{
+			return id & SlotMask;
+		}
+		static inline uint32_t	GetGeneration(uint32_t id)
+		{
+			return id >> SlotBits;
+		}
+
+		inline Elements*		GetTypeElements(AssetType type)
+		{
+			if (type == AssetType::GLOBAL)
+				return &m_global;
+			else if (type == AssetType::SCENE)
+				return &m_scene;
+
+			return nullptr;
+		}
+
+		// Swap with last element and pop
+		void		RemoveDense(Elements& elements, uint32_t index, uint32_t Slot::* denseIndex)
+		{
+			if (index != elements.size() - 1)
+			{
+				elements[index] = elements.back();
+				m_slots[GetSlot(elements[index].first)].*denseIndex = index;
+			}
+			elements.pop_back();
+		}
+
+		void		PushFree(uint32_t slot)
+		{
+			m_slots[slot].freeIndex = (uint32_t)m_freeSlots.size();
+			m_freeSlots.push_back(slot);
+		}
+		// Swap with last free slot and pop
+		void		RemoveFree(uint32_t slot)
+		{
+			uint32_t index = m_slots[slot].freeIndex;
+			if (index == -1)
+				return;
+
+			if (index != m_freeSlots.size() - 1)
+			{
+				m_freeSlots[index] = m_freeSlots.back();
+				m_slots[m_freeSlots[index]].freeIndex = index;
+			}
+			m_freeSlots.pop_back();
+			m_slots[slot].freeIndex = -1;
+		}
+
+		void		Store(uint32_t id, Type* data, AssetType type)
+		{
+			Slot& slot = m_slots[GetSlot(id)];
+			slot.data = data;
+			slot.generation = GetGeneration(id);
+			slot.type = type;
+
+			slot.denseAll = (uint32_t)m_all.size();
+			m_all.emplace_back(id, data);
+
+			Elements* typeElements = GetTypeElements(type);
+			if (typeElements)
+			{
+				slot.denseType = (uint32_t)typeElements->size();
+				typeElements->emplace_back(id, data);
+			}
+			else
+				slot.denseType = -1;
+		}
+
 	public:
 		IDStorage() {}
 
-		static uint32_t				m_nextID;
-		std::stack<uint32_t>		m_deletedIDs;
-		std::map<uint32_t, Type*>	m_storage;
-		std::map<uint32_t, Type*>	m_storage_typeGlobal;
-		std::map<uint32_t, Type*>	m_storage_typeScene;
-		
 		// Used as a special case to override setting automatic ID
 		uint32_t	AddCustom(Type* data, AssetType type, uint32_t customID)
 		{
-			m_storage[customID] = data;
+			uint32_t slot = GetSlot(customID);
+			VXL_ASSERT(slot != SlotMask, "IDStorage custom ID out of range");
 
-			if (type == AssetType::GLOBAL)
-				m_storage_typeGlobal[customID] = data;
-			else if (type == AssetType::SCENE)
-				m_storage_typeScene[customID] = data;
+			// Slots skipped over stay available to Add
+			if (slot >= m_slots.size())
+			{
+				uint32_t first = (uint32_t)m_slots.size();
+				m_slots.resize(slot + 1);
+				for (uint32_t i = first; i < slot; i++)
+					PushFree(i);
+			}
+			// Replace existing data
+			else if (m_slots[slot].data)
+				Erase(MakeID(slot, m_slots[slot].generation));
 
+			// Custom slots can't be handed out by Add
+			RemoveFree(slot);
+
+			Store(customID, data, type);
 			return customID;
 		}
 		uint32_t	Add(Type* data, AssetType type)
 		{
-			uint32_t NewID;
+			uint32_t slot;
 
-			// use a spare ID
-			if (m_deletedIDs.size() > 0)
+			// use a spare slot
+			if (m_freeSlots.size() > 0)
 			{
-				NewID = m_deletedIDs.top();
-				m_deletedIDs.pop();
+				slot = m_freeSlots.back();
+				RemoveFree(slot);
 			}
-			// create a new ID
+			// create a new slot
 			else
-				NewID = m_nextID++;
+			{
+				slot = (uint32_t)m_slots.size();
+				VXL_ASSERT(slot < SlotMask, "IDStorage out of slots");
+				m_slots.emplace_back();
+			}
 
-			// Store
-			m_storage[NewID] = data;
-			if (type == AssetType::GLOBAL)
-				m_storage_typeGlobal[NewID] = data;
-			else if (type == AssetType::SCENE)
-				m_storage_typeScene[NewID] = data;
+			uint32_t NewID = MakeID(slot, m_slots[slot].generation);
+			Store(NewID, data, type);
 
 			// Get ID
 			return NewID;
 		}
-		Type*		Get(uint32_t id)
+		inline Type*	Get(uint32_t id) const
 		{
-			// return data
-			auto it = m_storage.find(id);
-			if (it != m_storage.end())
-				return it->second;
+			uint32_t slot = GetSlot(id);
+			if (slot < m_slots.size() && m_slots[slot].generation == GetGeneration(id))
+				return m_slots[slot].data;
 
 			// not found
 			return nullptr;
 		}
 		Type*		Erase(uint32_t id)
 		{
-			auto it = m_storage.find(id);
-			if (it != m_storage.end())
-			{
-				m_deletedIDs.push(id);
-				// Get data
-				Type* data = m_storage[id];
-				// Erase
-				m_storage.erase(id);
-				m_storage_typeGlobal.erase(id);
-				m_storage_typeScene.erase(id);
-				//
-				return data;
-			}
-			return nullptr;
+			uint32_t slot = GetSlot(id);
+			if (slot >= m_slots.size())
+				return nullptr;
+
+			Slot& s = m_slots[slot];
+			if (!s.data || s.generation != GetGeneration(id))
+				return nullptr;
+
+			// Get data
+			Type* data = s.data;
+
+			// Erase
+			RemoveDense(m_all, s.denseAll, &Slot::denseAll);
+			Elements* typeElements = GetTypeElements(s.type);
+			if (typeElements)
+				RemoveDense(*typeElements, s.denseType, &Slot::denseType);
+
+			// Invalidate old IDs [generation 0 is skipped so IDs are never 0]
+			s.data = nullptr;
+			s.generation = (s.generation + 1) & GenerationMask;
+			if (s.generation == 0)
+				s.generation = 1;
+			s.type = AssetType::NONE;
+			s.denseAll = -1;
+			s.denseType = -1;
+
+			PushFree(slot);
+			//
+			return data;
 		}
 		void		EraseAll(void)
 		{
-			m_nextID = 1;
-			m_deletedIDs = std::stack<uint32_t>();
-
-			m_storage_typeGlobal.clear();
-			m_storage_typeScene.clear();
-			m_storage.clear();
+			while (!m_all.empty())
+				Erase(m_all.back().first);
 		}
 		void		EraseAll(AssetType type)
 		{
-			if (type == AssetType::GLOBAL)
+			Elements* typeElements = GetTypeElements(type);
+			if (!typeElements)
 			{
-				if (m_storage_typeScene.empty())
-				{
-					m_nextID = 1;
-					m_deletedIDs = std::stack<uint32_t>();
-				}
-				else
-				{
-					for (auto& data : m_storage_typeGlobal)
-						m_deletedIDs.push(data.first);
-				}
-
-				m_storage_typeGlobal.clear();
-				m_storage = m_storage_typeScene;
+				EraseAll();
+				return;
 			}
-			else if (type == AssetType::SCENE)
-			{
-				if (m_storage_typeGlobal.empty())
-				{
-					m_nextID = 1;
-					m_deletedIDs = std::stack<uint32_t>();
-				}
-				else
-				{
-					for (auto& data : m_storage_typeScene)
-						m_deletedIDs.push(data.first);
-				}
 
-				m_storage_typeScene.clear();
-				m_storage = m_storage_typeGlobal;
-			}
-			else
-			{
-				m_storage.clear();
-				m_storage_typeGlobal.clear();
-				m_storage_typeScene.clear();
-			}
+			while (!typeElements->empty())
+				Erase(typeElements->back().first);
 		}
-		std::map<uint32_t, Type*>& GetAll(void)
+		const Elements& GetAll(void) const
 		{
-			return m_storage;
+			return m_all;
 		}
-		std::map<uint32_t, Type*>& GetAll(AssetType type)
+		const Elements& GetAll(AssetType type)
 		{
-			if (type == AssetType::GLOBAL)
-				return m_storage_typeGlobal;
-			else if (type == AssetType::SCENE)
-				return m_storage_typeScene;
+			Elements* typeElements = GetTypeElements(type);
+			if (typeElements)
+				return *typeElements;
 
-			return m_storage;
+			return m_all;
 		}
 	};
 
-	template<class Type>
-	uint32_t IDStorage<Type>::m_nextID = 1;
-
 	template<class Type>
 	class NamedStorage
 	{
@@ -403,25 +490,25 @@ namespace Vxl
 		Camera*				getCamera(CameraIndex index) { return m_camera_storage.Get(index); }
 
 		// Get All
-		const std::map<uint32_t, BaseTexture*>&			getAllBaseTexture() { return m_baseTexture_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, Texture2D*>&			getAllTexture2D() { return m_texture2D_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, Cubemap*>&				getAllCubemap() { return m_cubemap_storage.GetAll(m_creationType); }
+		const IDStorage<BaseTexture>::Elements&			getAllBaseTexture() { return m_baseTexture_storage.GetAll(m_creationType); }
+		const IDStorage<Texture2D>::Elements&			getAllTexture2D() { return m_texture2D_storage.GetAll(m_creationType); }
+		const IDStorage<Cubemap>::Elements&				getAllCubemap() { return m_cubemap_storage.GetAll(m_creationType); }
 		const std::map<std::string, File*>&				getAllFiles() { return m_file_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, FramebufferObject*>&	getAllFramebufferObject() { return m_framebufferObject_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, RenderTexture*>&		getAllRenderTexture() { return m_renderTexture_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, RenderTextureDepth*>&	getAllRenderTextureDepth() { return m_renderTextureDepth_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, RenderBuffer*>&		getAllRenderBuffer() { return m_renderBuffer_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, RenderBufferDepth*>&	getAllRenderBufferDepth() { return m_renderBufferDepth_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, Mesh*>&				getAllMesh() { return m_mesh_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, LineMesh3D*>&			getAllLineMesh3D() { return m_lineMesh3D_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, LineMesh2D*>&			getAllLineMesh2D() { return m_lineMesh2D_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, ShaderProgram*>&		getAllShaderProgram() { return m_shaderProgram_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, Shader*>&				getAllShader() { return m_shader_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, ShaderMaterial*>&		getAllShaderMaterial() { return m_shaderMaterial_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, Material*>&			getAllMaterial() { return m_material_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, SceneNode*>&			getAllSceneNode() { return m_sceneNode_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, Entity*>&				getAllEntity() { return m_entity_storage.GetAll(m_creationType); }
-		const std::map<uint32_t, Camera*>&				getAllCamera() { return m_camera_storage.GetAll(m_creationType); }
+		const IDStorage<FramebufferObject>::Elements&	getAllFramebufferObject() { return m_framebufferObject_storage.GetAll(m_creationType); }
+		const IDStorage<RenderTexture>::Elements&		getAllRenderTexture() { return m_renderTexture_storage.GetAll(m_creationType); }
+		const IDStorage<RenderTextureDepth>::Elements&	getAllRenderTextureDepth() { return m_renderTextureDepth_storage.GetAll(m_creationType); }
+		const IDStorage<RenderBuffer>::Elements&		getAllRenderBuffer() { return m_renderBuffer_storage.GetAll(m_creationType); }
+		const IDStorage<RenderBufferDepth>::Elements&	getAllRenderBufferDepth() { return m_renderBufferDepth_storage.GetAll(m_creationType); }
+		const IDStorage<Mesh>::Elements&				getAllMesh() { return m_mesh_storage.GetAll(m_creationType); }
+		const IDStorage<LineMesh3D>::Elements&			getAllLineMesh3D() { return m_lineMesh3D_storage.GetAll(m_creationType); }
+		const IDStorage<LineMesh2D>::Elements&			getAllLineMesh2D() { return m_lineMesh2D_storage.GetAll(m_creationType); }
+		const IDStorage<ShaderProgram>::Elements&		getAllShaderProgram() { return m_shaderProgram_storage.GetAll(m_creationType); }
+		const IDStorage<Shader>::Elements&				getAllShader() { return m_shader_storage.GetAll(m_creationType); }
+		const IDStorage<ShaderMaterial>::Elements&		getAllShaderMaterial() { return m_shaderMaterial_storage.GetAll(m_creationType); }
+		const IDStorage<Material>::Elements&			getAllMaterial() { return m_material_storage.GetAll(m_creationType); }
+		const IDStorage<SceneNode>::Elements&			getAllSceneNode() { return m_sceneNode_storage.GetAll(m_creationType); }
+		const IDStorage<Entity>::Elements&				getAllEntity() { return m_entity_storage.GetAll(m_creationType); }
+		const IDStorage<Camera>::Elements&				getAllCamera() { return m_camera_storage.GetAll(m_creationType); }
 
 		//
 		TextureIndex loadTexture2D(
@@ -434,6 +521,17 @@ namespace Vxl
 			TexturePixelType	PixelType,
 			AnisotropicMode		AnisotropicMode
 		);
+		// Index is valid immediately, texture shows as not loaded until the AssetLoader uploads it
+		LoadHandle loadTexture2DAsync(
+			const std::string& filePath,
+			bool				InvertY,
+			bool				UseMipMapping,
+			TextureWrapping		WrapMode,
+			TextureFilter		FilterMode,
+			TextureFormat		FormatType,
+			TexturePixelType	PixelType,
+			AnisotropicMode		AnisotropicMode
+		);
 		TextureIndex createTexture2D(
 			std::vector<float> pixels, uint32_t width,
 			bool				UseMipMapping,
@@ -478,6 +576,19 @@ namespace Vxl
 			TexturePixelType	PixelType,
 			AnisotropicMode		AnisotropicMode
 		);
+		// All six faces are decoded in parallel
+		LoadHandle loadCubemapAsync(
+			const std::string& filePath1, const std::string& filePath2,
+			const std::string& filePath3, const std::string& filePath4,
+			const std::string& filePath5, const std::string& filePath6,
+			bool InvertY,
+			bool UseMipMapping,
+			TextureWrapping		WrapMode,
+			TextureFilter		FilterMode,
+			TextureFormat		FormatType,
+			TexturePixelType	PixelType,
+			AnisotropicMode		AnisotropicMode
+		);
 		//
 		void loadFile(
 			const std::string& name,
@@ -523,6 +634,7 @@ namespace Vxl
 		//
 		ShaderIndex createShader(const std::string& name, const std::string& source, ShaderType type);
 		ShaderProgramIndex createShaderProgram(const std::string& name, const std::vector<ShaderIndex>& _shaders, std::vector<std::pair<std::string, TextureLevel>> _textureLevels);
+		ShaderProgramIndex createShaderProgram(const std::string& name, uint32_t binaryFormat, const std::vector<uint8_t>& binary, const std::vector<ShaderType>& types, std::vector<std::pair<std::string, TextureLevel>> _textureLevels);
 		//
 		MaterialIndex createMaterial(const std::string& name);
 		//
@@ -0,0 +1,199 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "AssetLoader.h"
+
+#include "Logger.h"
+#include "Profiler.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace Vxl
+{
+	// Errors of the job running on this worker [null outside of jobs]
+	static thread_local std::vector<std::string>* t_jobErrors = nullptr;
+
+	uint32_t LoadHandle::wait() const
+	{
+		AssetLoader.Wait(*this);
+		return m_index;
+	}
+
+	AssetLoader::~AssetLoader()
+	{
+		Shutdown();
+	}
+
+	void AssetLoader::Init(uint32_t threadCount)
+	{
+		JobSystem.Init(threadCount);
+		m_quit = false;
+	}
+	void AssetLoader::Shutdown()
+	{
+		// Queued jobs return straight away, running ones get to finish
+		m_quit = true;
+		if (!m_jobs.isDone())
+			JobSystem.Wait(m_jobs);
+
+		{
+			std::lock_guard<std::mutex> lock(m_uploadMutex);
+			m_uploads.clear();
+		}
+		m_pendingCount = 0;
+	}
+
+	void AssetLoader::PushJob(std::function<void()> job)
+	{
+		JobSystem.Run([this, job]()
+		{
+			if (m_quit)
+				return;
+
+			VXL_PROFILE_SCOPE("AssetLoader::Job");
+			job();
+		}, &m_jobs);
+	}
+	void AssetLoader::PushUpload(std::function<void()> upload)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_uploadMutex);
+			m_uploads.push_back(std::move(upload));
+		}
+		m_uploadCondition.notify_one();
+	}
+	bool AssetLoader::RunUpload()
+	{
+		std::function<void()> upload;
+		{
+			std::lock_guard<std::mutex> lock(m_uploadMutex);
+			if (m_uploads.empty())
+				return false;
+
+			upload = std::move(m_uploads.front());
+			m_uploads.pop_front();
+		}
+
+		VXL_PROFILE_SCOPE("AssetLoader::Upload");
+		upload();
+		return true;
+	}
+
+	LoadHandle AssetLoader::Submit(uint32_t index, const std::string& name, std::vector<Job> jobs, Upload upload)
+	{
+		Init();
+
+		LoadHandle handle;
+		handle.m_index = index;
+		handle.m_status = std::make_shared<LoadHandle::Status>();
+
+		m_pendingCount++;
+
+		// Render thread, final state is only ever set here
+		auto status = handle.m_status;
+		auto finish = [this, status, name, upload](bool success, const std::vector<std::string>& errors)
+		{
+			for (const std::string& error : errors)
+				Logger.error(error);
+
+			LoadState state = success ? upload() : LoadState::FAILED;
+
+			if (state == LoadState::FAILED)
+				Logger.error("Unable to load asset: " + name);
+
+			status->state = state;
+			m_pendingCount--;
+		};
+
+		if (jobs.empty())
+		{
+			PushUpload([finish]() { finish(true, {}); });
+			return handle;
+		}
+
+		// Last job to finish sends the upload
+		struct Batch
+		{
+			std::atomic<uint32_t>	remaining;
+			std::atomic<bool>		success;
+			std::mutex				errorMutex;
+			std::vector<std::string> errors;
+		};
+		auto batch = std::make_shared<Batch>();
+		batch->remaining = (uint32_t)jobs.size();
+		batch->success = true;
+
+		for (auto& job : jobs)
+		{
+			PushJob([this, batch, job, finish]()
+			{
+				std::vector<std::string> errors;
+				t_jobErrors = &errors;
+				if (!job())
+					batch->success = false;
+				t_jobErrors = nullptr;
+
+				if (!errors.empty())
+				{
+					std::lock_guard<std::mutex> lock(batch->errorMutex);
+					batch->errors.insert(batch->errors.end(), errors.begin(), errors.end());
+				}
+
+				if (--batch->remaining == 0)
+				{
+					bool success = batch->success;
+					PushUpload([finish, success, batch]() { finish(success, batch->errors); });
+				}
+			});
+		}
+
+		return handle;
+	}
+	LoadHandle AssetLoader::Submit(uint32_t index, const std::string& name, Job job, Upload upload)
+	{
+		return Submit(index, name, std::vector<Job>{ job }, upload);
+	}
+
+	void AssetLoader::ReportError(const std::string& message)
+	{
+		if (t_jobErrors)
+			t_jobErrors->push_back(message);
+		else
+			Logger.error(message);
+	}
+
+	void AssetLoader::Update()
+	{
+		auto start = std::chrono::steady_clock::now();
+		while (RunUpload())
+		{
+			auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (elapsed >= m_uploadBudget)
+				break;
+		}
+	}
+	void AssetLoader::Wait(const LoadHandle& handle)
+	{
+		VXL_ASSERT(handle.m_status, "Cannot wait on empty LoadHandle");
+
+		while (!handle.isDone())
+		{
+			if (RunUpload())
+				continue;
+
+			std::unique_lock<std::mutex> lock(m_uploadMutex);
+			m_uploadCondition.wait(lock, [this]() { return !m_uploads.empty(); });
+		}
+	}
+	void AssetLoader::WaitAll()
+	{
+		while (m_pendingCount > 0)
+		{
+			if (RunUpload())
+				continue;
+
+			std::unique_lock<std::mutex> lock(m_uploadMutex);
+			m_uploadCondition.wait(lock, [this]() { return !m_uploads.empty(); });
+		}
+	}
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "singleton.h"
+#include "Macros.h"
+#include "JobSystem.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Vxl
+{
+	enum class LoadState
+	{
+		PENDING,	// Waiting on workers or upload
+		COMPLETE,
+		FAILED,
+		CANCELLED	// Asset was destroyed before upload
+	};
+
+	// Future-like handle for an asset loaded in the background
+	// The asset index is reserved immediately, the asset is usable but empty until the load completes
+	class LoadHandle
+	{
+		friend class AssetLoader;
+	private:
+		struct Status
+		{
+			LoadState state = LoadState::PENDING;
+		};
+		std::shared_ptr<Status> m_status;
+		uint32_t				m_index = -1;
+
+	public:
+		LoadHandle() {}
+
+		// Blocks until the load is complete [render thread only], returns index
+		uint32_t wait() const;
+
+		inline uint32_t getIndex(void) const
+		{
+			return m_index;
+		}
+		inline LoadState getState(void) const
+		{
+			return m_status ? m_status->state : LoadState::FAILED;
+		}
+		inline bool isDone(void) const
+		{
+			return getState() != LoadState::PENDING;
+		}
+		inline bool isComplete(void) const
+		{
+			return getState() == LoadState::COMPLETE;
+		}
+	};
+
+	// Runs parsing/decoding as JobSystem jobs, GL uploads are done by the render thread
+	// inside a time budget every frame
+	static class AssetLoader : public Singleton<class AssetLoader>
+	{
+		DISALLOW_COPY_AND_ASSIGN(AssetLoader);
+	public:
+		// Worker side, must not touch GL or asset storage, returns false if failed
+		using Job = std::function<bool()>;
+		// Render thread side, returns final state
+		using Upload = std::function<LoadState()>;
+
+	private:
+		// Jobs still queued or running on the JobSystem
+		JobCounter							m_jobs;
+		std::atomic<bool>					m_quit{ false };
+
+		// Finished jobs waiting for the render thread
+		std::deque<std::function<void()>>	m_uploads;
+		std::mutex							m_uploadMutex;
+		std::condition_variable				m_uploadCondition;
+
+		uint32_t							m_pendingCount = 0;
+
+		void PushJob(std::function<void()> job);
+		void PushUpload(std::function<void()> upload);
+		// Returns false if no upload was ready
+		bool RunUpload();
+
+	public:
+		AssetLoader() {}
+		~AssetLoader();
+
+		// Max time spent on uploads per frame in ms [one upload always happens]
+		float m_uploadBudget = 2.0f;
+
+		// Starts the JobSystem [called automatically by first load]
+		void Init(uint32_t threadCount = 0);
+		// Unfinished loads are dropped, returns once running jobs are done
+		void Shutdown();
+
+		// All jobs run in parallel, upload happens once all of them succeeded
+		LoadHandle Submit(uint32_t index, const std::string& name, std::vector<Job> jobs, Upload upload);
+		LoadHandle Submit(uint32_t index, const std::string& name, Job job, Upload upload);
+
+		// Logger isn't thread safe, errors raised inside a Job are logged by the render thread before its upload
+		// Logs straight away anywhere else
+		static void ReportError(const std::string& message);
+
+		// Render thread
+		void Update();
+		void Wait(const LoadHandle& handle);
+		void WaitAll();
+
+		inline uint32_t getPendingCount(void) const
+		{
+			return m_pendingCount;
+		}
+		inline uint32_t getWorkerCount(void) const
+		{
+			return JobSystem.getWorkerCount();
+		}
+
+	} SingletonInstance(AssetLoader);
+}
@@ -0,0 +1,1492 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "Benchmark.h"
+
+#include "Asset.h"
+#include "FileIO.h"
+#include "JobSystem.h"
+#include "Logger.h"
+#include "Time.h"
+
+#include "../math/AABBTree.h"
+#include "../math/Affine.h"
+#include "../math/Collision.h"
+#include "../math/Matrix4x4.h"
+#include "../math/Quaternion.h"
+#include "../math/SIMD.h"
+#include "../math/Transform.h"
+#include "../math/TransformManager.h"
+#include "../math/VertexPacking.h"
+#include "../modules/Entity.h"
+#include "../modules/Material.h"
+#include "../objects/Camera.h"
+#include "../rendering/FramebufferObject.h"
+#include "../rendering/Graphics.h"
+#include "../rendering/GraphicsBackend.h"
+#include "../rendering/MaterialParameters.h"
+#include "../rendering/Mesh.h"
+#include "../rendering/Primitives.h"
+#include "../rendering/RenderManager.h"
+#include "../rendering/RenderQueue.h"
+#include "../rendering/ShaderPreprocessor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+
+#undef max
+#undef min
+
+#define BENCHMARK_SAMPLES 15
+#define BENCHMARK_SAMPLE_NS 5000000 // Minimum time per sample
+
+namespace Vxl
+{
+	// Results are written here so the optimizer can't remove the work
+	static volatile float BenchmarkSink = 0.0f;
+
+	static int64_t BenchmarkNow()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Synthetic data [fixed seed, every run measures the same input]
+	static std::vector<Matrix4x4> RandomMatrices(std::mt19937& random, uint32_t count)
+	{
+		std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+		std::uniform_real_distribution<float> offset(-100.0f, 100.0f);
+
+		std::vector<Matrix4x4> matrices(count);
+		for (auto& matrix : matrices)
+			matrix = Quaternion::ToQuaternion_YXZ(angle(random), angle(random), angle(random)).GetMatrix4x4(Vector3(offset(random), offset(random), offset(random)));
+
+		return matrices;
+	}
+	// Rotation, translation and scale [uniform or not]
+	static std::vector<Matrix4x4> RandomAffineMatrices(std::mt19937& random, uint32_t count, bool uniformScale)
+	{
+		std::uniform_real_distribution<float> scale(0.1f, 10.0f);
+
+		std::vector<Matrix4x4> matrices = RandomMatrices(random, count);
+		for (auto& matrix : matrices)
+		{
+			float x = scale(random);
+			matrix = matrix * (uniformScale ? Matrix4x4::GetScale(x) : Matrix4x4::GetScale(x, scale(random), scale(random)));
+		}
+
+		return matrices;
+	}
+	// Boxes 0.5 to 2 units wide spread over [-extent, extent]
+	static std::vector<AABB> RandomBoxes(std::mt19937& random, uint32_t count, float extent)
+	{
+		std::uniform_real_distribution<float> position(-extent, extent);
+		std::uniform_real_distribution<float> size(0.25f, 1.0f);
+
+		std::vector<AABB> boxes(count);
+		for (auto& box : boxes)
+		{
+			Vector3 center(position(random), position(random), position(random));
+			Vector3 half(size(random), size(random), size(random));
+			box = AABB(center - half, center + half);
+		}
+
+		return boxes;
+	}
+	static Vector3 RandomDirection(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+		Vector3 direction(value(random), value(random), value(random) + 0.01f);
+		return direction.NormalizeSelf();
+	}
+	// Largest difference relative to the reference value [absolute below 1]
+	static double MaxError(const float* values, const float* reference, uint32_t count)
+	{
+		double error = 0.0;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			double difference = fabs((double)values[i] - (double)reference[i]);
+			error = std::max(error, difference / std::max(1.0, fabs((double)reference[i])));
+		}
+		return error;
+	}
+	static uint32_t UlpDistance(float a, float b)
+	{
+		int32_t x, y;
+		memcpy(&x, &a, sizeof(float));
+		memcpy(&y, &b, sizeof(float));
+
+		// Map sign magnitude onto a continuous integer line
+		int64_t ix = x < 0 ? (int64_t)INT32_MIN - x : x;
+		int64_t iy = y < 0 ? (int64_t)INT32_MIN - y : y;
+		int64_t distance = ix > iy ? ix - iy : iy - ix;
+		return (uint32_t)std::min<int64_t>(distance, UINT32_MAX);
+	}
+
+	// Indexed grid with a bumpy surface
+	static void GridMesh(uint32_t size, std::vector<Vector3>& positions, std::vector<Vector2>& uvs, std::vector<uint32_t>& indices)
+	{
+		positions.clear();
+		uvs.clear();
+		indices.clear();
+
+		for (uint32_t y = 0; y < size; y++)
+		{
+			for (uint32_t x = 0; x < size; x++)
+			{
+				float u = (float)x / (float)(size - 1);
+				float v = (float)y / (float)(size - 1);
+				positions.push_back(Vector3(u * 10.0f, sinf(u * 20.0f) * cosf(v * 20.0f), v * 10.0f));
+				uvs.push_back(Vector2(u, v));
+			}
+		}
+		for (uint32_t y = 0; y < size - 1; y++)
+		{
+			for (uint32_t x = 0; x < size - 1; x++)
+			{
+				uint32_t i = y * size + x;
+				indices.insert(indices.end(), { i, i + size, i + 1, i + 1, i + size, i + size + 1 });
+			}
+		}
+	}
+
+	Benchmark::Result Benchmark::Run(const std::string& name, uint32_t items, const std::function<void()>& function)
+	{
+		// Double iterations until a sample is long enough [doubles as warmup]
+		uint32_t iterations = 1;
+		while (true)
+		{
+			int64_t start = BenchmarkNow();
+			for (uint32_t i = 0; i < iterations; i++)
+				function();
+			int64_t elapsed = BenchmarkNow() - start;
+
+			if (elapsed >= BENCHMARK_SAMPLE_NS || iterations >= (1u << 24))
+				break;
+
+			iterations *= 2;
+		}
+
+		std::vector<double> samples(BENCHMARK_SAMPLES);
+		for (auto& sample : samples)
+		{
+			int64_t start = BenchmarkNow();
+			for (uint32_t i = 0; i < iterations; i++)
+				function();
+			sample = (double)(BenchmarkNow() - start) / (double)iterations;
+		}
+		std::sort(samples.begin(), samples.end());
+
+		Result result;
+		result.name = name;
+		result.items = items;
+		result.iterations = iterations;
+		result.samples = BENCHMARK_SAMPLES;
+		result.median = samples[BENCHMARK_SAMPLES / 2];
+		result.min = samples[0];
+		result.mean = 0.0;
+		for (double sample : samples)
+			result.mean += sample;
+		result.mean /= (double)BENCHMARK_SAMPLES;
+
+		Logger.log(name + ": " + std::to_string(result.median / 1000.0) + " us [" + std::to_string(result.median / (double)items) + " ns per item]");
+		return result;
+	}
+
+	std::vector<Benchmark::Result> Benchmark::RunAll(const std::string& filter)
+	{
+		std::vector<Result> results;
+		std::mt19937 random(1234);
+
+		auto match = [&filter](const char* name)
+		{
+			return filter.empty() || std::string(name).find(filter) != std::string::npos;
+		};
+
+		// ~ Matrices ~ //
+		if (match("Matrix4x4::Multiply"))
+		{
+			const uint32_t Count = 1024;
+			std::vector<Matrix4x4> a = RandomMatrices(random, Count);
+			std::vector<Matrix4x4> b = RandomMatrices(random, Count);
+			std::vector<Matrix4x4> out(Count);
+
+			results.push_back(Run("Matrix4x4::Multiply", Count, [&]()
+			{
+				for (uint32_t i = 0; i < Count; i++)
+					out[i] = Matrix4x4::Multiply(a[i], b[i]);
+				BenchmarkSink = out[Count - 1]._Val[0];
+			}));
+		}
+		if (match("Matrix4x4::Inverse"))
+		{
+			const uint32_t Count = 1024;
+			std::vector<Matrix4x4> a = RandomMatrices(random, Count);
+			std::vector<Matrix4x4> out(Count);
+
+			results.push_back(Run("Matrix4x4::Inverse", Count, [&]()
+			{
+				for (uint32_t i = 0; i < Count; i++)
+					out[i] = a[i].Inverse();
+				BenchmarkSink = out[Count - 1]._Val[0];
+			}));
+		}
+		if (match("Matrix4x4::AffineInverse"))
+		{
+			const uint32_t Count = 1024;
+			std::vector<Matrix4x4> a = RandomMatrices(random, Count);
+			std::vector<Matrix4x4> out(Count);
+
+			results.push_back(Run("Matrix4x4::AffineInverse", Count, [&]()
+			{
+				for (uint32_t i = 0; i < Count; i++)
+					out[i] = a[i].AffineInverse();
+				BenchmarkSink = out[Count - 1]._Val[0];
+			}));
+		}
+		if (match("Affine::InverseUniformScale"))
+		{
+			const uint32_t Count = 1024;
+			std::vector<Matrix4x4> matrices = RandomAffineMatrices(random, Count, true);
+			std::vector<Affine> a(Count);
+			std::vector<float> scales(Count);
+			for (uint32_t i = 0; i < Count; i++)
+			{
+				a[i] = Affine(matrices[i]);
+				scales[i] = Vector3::Length(matrices[i][0], matrices[i][4], matrices[i][8]);
+			}
+			std::vector<Affine> out(Count);
+
+			results.push_back(Run("Affine::InverseUniformScale", Count, [&]()
+			{
+				for (uint32_t i = 0; i < Count; i++)
+					out[i] = a[i].InverseUniformScale(scales[i]);
+				BenchmarkSink = out[Count - 1].m_translation.x;
+			}));
+		}
+		if (match("Matrix4x4::MultiplyBatch"))
+		{
+			const uint32_t Count = 1024;
+			Matrix4x4 viewProjection = Matrix4x4::Perspective(1.2f, 1.7f, 0.1f, 1000.0f) * RandomMatrices(random, 1)[0];
+			std::vector<Matrix4x4> models = RandomMatrices(random, Count);
+			std::vector<Matrix4x4> out(Count);
+
+			results.push_back(Run("Matrix4x4::MultiplyBatch", Count, [&]()
+			{
+				Matrix4x4::MultiplyBatch(viewProjection, models.data(), out.data(), Count);
+				BenchmarkSink = out[Count - 1]._Val[0];
+			}));
+		}
+		// Reference kernels, compare with the cases above to see the instruction set's gain
+		if (match("SIMD::Scalar::Multiply"))
+		{
+			const uint32_t Count = 1024;
+			std::vector<Matrix4x4> a = RandomMatrices(random, Count);
+			std::vector<Matrix4x4> b = RandomMatrices(random, Count);
+			std::vector<Matrix4x4> out(Count);
+
+			results.push_back(Run("SIMD::Scalar::Multiply", Count, [&]()
+			{
+				for (uint32_t i = 0; i < Count; i++)
+					SIMD::Scalar::Multiply(a[i]._Val, b[i]._Val, out[i]._Val);
+				BenchmarkSink = out[Count - 1]._Val[0];
+			}));
+		}
+		if (match("SIMD::Scalar::Inverse"))
+		{
+			const uint32_t Count = 1024;
+			std::vector<Matrix4x4> a = RandomMatrices(random, Count);
+			std::vector<Matrix4x4> out(Count);
+
+			results.push_back(Run("SIMD::Scalar::Inverse", Count, [&]()
+			{
+				for (uint32_t i = 0; i < Count; i++)
+					SIMD::Scalar::Inverse(a[i]._Val, out[i]._Val);
+				BenchmarkSink = out[Count - 1]._Val[0];
+			}));
+		}
+		if (match("AABB::transform"))
+		{
+			const uint32_t Count = 1024;
+			std::vector<Matrix4x4> models = RandomMatrices(random, Count);
+			AABB box(Vector3(-1.0f, -2.0f, -0.5f), Vector3(1.0f, 3.0f, 0.5f));
+			std::vector<AABB> out(Count);
+
+			results.push_back(Run("AABB::transform", Count, [&]()
+			{
+				for (uint32_t i = 0; i < Count; i++)
+					out[i] = box.transform(models[i]);
+				BenchmarkSink = out[Count - 1].min.x;
+			}));
+		}
+
+		// ~ Quaternions ~ //
+		if (match("Quaternion::ToQuaternion_YXZ"))
+		{
+			const uint32_t Count = 1024;
+			std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+			std::vector<Vector3> eulers(Count);
+			for (auto& euler : eulers)
+				euler = Vector3(angle(random), angle(random), angle(random));
+			std::vector<Quaternion> out(Count);
+
+			results.push_back(Run("Quaternion::ToQuaternion_YXZ", Count, [&]()
+			{
+				for (uint32_t i = 0; i < Count; i++)
+					out[i] = Quaternion::ToQuaternion_YXZ(eulers[i].x, eulers[i].y, eulers[i].z);
+				BenchmarkSink = out[Count - 1].w;
+			}));
+		}
+		if (match("Quaternion::GetMatrix4x4"))
+		{
+			const uint32_t Count = 1024;
+			std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+			std::vector<Quaternion> quaternions(Count);
+			for (auto& quaternion : quaternions)
+				quaternion = Quaternion::ToQuaternion_YXZ(angle(random), angle(random), angle(random));
+			std::vector<Matrix4x4> out(Count);
+
+			results.push_back(Run("Quaternion::GetMatrix4x4", Count, [&]()
+			{
+				for (uint32_t i = 0; i < Count; i++)
+					out[i] = quaternions[i].GetMatrix4x4();
+				BenchmarkSink = out[Count - 1]._Val[0];
+			}));
+		}
+		if (match("Quaternion::AngleAxis(Matrix4x4)"))
+		{
+			const uint32_t Count = 1024;
+			std::vector<Matrix4x4> matrices = RandomMatrices(random, Count);
+			std::vector<Quaternion> out(Count);
+
+			results.push_back(Run("Quaternion::AngleAxis(Matrix4x4)", Count, [&]()
+			{
+				for (uint32_t i = 0; i < Count; i++)
+					out[i] = Quaternion::AngleAxis(matrices[i]);
+				BenchmarkSink = out[Count - 1].w;
+			}));
+		}
+
+		// ~ Transforms ~ //
+		if (match("Transform::updateValues(depth 64)"))
+		{
+			// Moving the root makes the whole chain stale, leaf getter walks it
+			const uint32_t Depth = 64;
+			std::vector<std::unique_ptr<Transform>> chain;
+			for (uint32_t i = 0; i < Depth; i++)
+			{
+				chain.push_back(std::make_unique<Transform>(Vector3(1, 0, 0), Vector3(0, 5, 0)));
+				if (i > 0)
+					chain[i]->setParent(chain[i - 1].get());
+			}
+			float x = 0.0f;
+
+			results.push_back(Run("Transform::updateValues(depth 64)", Depth, [&]()
+			{
+				chain[0]->setPosition(x += 0.001f, 0.0f, 0.0f);
+				BenchmarkSink = chain[Depth - 1]->getModel()._Val[3];
+			}));
+		}
+		if (match("Transform::setWorldPosition(depth 8)"))
+		{
+			// Child of a moving parent, inverse is requested once per parent change
+			const uint32_t Depth = 8;
+			std::vector<std::unique_ptr<Transform>> chain;
+			for (uint32_t i = 0; i < Depth; i++)
+			{
+				chain.push_back(std::make_unique<Transform>(Vector3(1, 0, 0), Vector3(0, 5, 0), Vector3(2, 2, 2)));
+				if (i > 0)
+					chain[i]->setParent(chain[i - 1].get());
+			}
+			float x = 0.0f;
+
+			results.push_back(Run("Transform::setWorldPosition(depth 8)", 1, [&]()
+			{
+				chain[Depth - 2]->setPosition(x += 0.001f, 0.0f, 0.0f);
+				chain[Depth - 1]->setWorldPosition(Vector3(1.0f, 2.0f, 3.0f));
+				BenchmarkSink = chain[Depth - 1]->getPosition().x;
+			}));
+		}
+		if (match("TransformManager::Update(512x8)"))
+		{
+			// Many shallow hierarchies, every root moves each frame
+			const uint32_t Roots = 512;
+			const uint32_t Depth = 8;
+			std::vector<std::unique_ptr<Transform>> transforms;
+			for (uint32_t r = 0; r < Roots; r++)
+			{
+				for (uint32_t d = 0; d < Depth; d++)
+				{
+					transforms.push_back(std::make_unique<Transform>(Vector3(1, 0, 0), Vector3(0, 5, 0)));
+					if (d > 0)
+						transforms.back()->setParent(transforms[transforms.size() - 2].get());
+				}
+			}
+			TransformManager.Update();
+			float x = 0.0f;
+
+			results.push_back(Run("TransformManager::Update(512x8)", Roots * Depth, [&]()
+			{
+				x += 0.001f;
+				for (uint32_t r = 0; r < Roots; r++)
+					transforms[r * Depth]->setPosition(x, 0.0f, 0.0f);
+				TransformManager.Update();
+				BenchmarkSink = transforms.back()->getModel()._Val[3];
+			}));
+		}
+		if (match("TransformManager::Update(16384x2)"))
+		{
+			// Wide levels, split across the JobSystem
+			const uint32_t Roots = 16384;
+			std::vector<std::unique_ptr<Transform>> transforms;
+			for (uint32_t r = 0; r < Roots; r++)
+			{
+				transforms.push_back(std::make_unique<Transform>(Vector3(1, 0, 0), Vector3(0, 5, 0)));
+				transforms.push_back(std::make_unique<Transform>(Vector3(0, 1, 0), Vector3(5, 0, 0)));
+				transforms.back()->setParent(transforms[transforms.size() - 2].get());
+			}
+			TransformManager.Update();
+			float x = 0.0f;
+
+			results.push_back(Run("TransformManager::Update(16384x2)", Roots * 2, [&]()
+			{
+				x += 0.001f;
+				for (uint32_t r = 0; r < Roots; r++)
+					transforms[r * 2]->setPosition(x, 0.0f, 0.0f);
+				TransformManager.Update();
+				BenchmarkSink = transforms.back()->getModel()._Val[3];
+			}));
+		}
+
+		// ~ Jobs ~ //
+		if (match("JobSystem::Run(empty)"))
+		{
+			// Scheduling overhead per job
+			const uint32_t Count = 4096;
+			results.push_back(Run("JobSystem::Run(empty)", Count, [&]()
+			{
+				JobCounter counter;
+				for (uint32_t i = 0; i < Count; i++)
+					JobSystem.Run([]() {}, &counter);
+				JobSystem.Wait(counter);
+			}));
+		}
+
+		// ~ Collision ~ //
+		if (match("OBB::generateAABB"))
+		{
+			const uint32_t Count = 1024;
+			std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+			std::vector<OBB> boxes(Count);
+			for (auto& box : boxes)
+				box = OBB(Vector3(value(random), value(random), value(random)), Vector3(value(random), 0, 0), Vector3(0, value(random), 0), Vector3(0, 0, value(random)));
+			std::vector<AABB> out(Count);
+
+			results.push_back(Run("OBB::generateAABB", Count, [&]()
+			{
+				for (uint32_t i = 0; i < Count; i++)
+					out[i] = boxes[i].generateAABB();
+				BenchmarkSink = out[Count - 1].max.x;
+			}));
+		}
+
+		// ~ AABB Tree ~ // Density stays the same at every count [world grows with the box count]
+		for (uint32_t Count : { 10000u, 100000u, 1000000u })
+		{
+			const std::string size = "(" + std::to_string(Count / 1000) + "k)";
+			const std::string insertName = "AABBTree::insert" + size;
+			const std::string updateName = "AABBTree::update" + size;
+			const std::string queryAABBName = "AABBTree::queryAABB" + size;
+			const std::string querySphereName = "AABBTree::querySphere" + size;
+			const std::string queryFrustumName = "AABBTree::queryFrustum" + size;
+			const std::string queryRayName = "AABBTree::queryRay" + size;
+			if (!match(insertName.c_str()) && !match(updateName.c_str()) && !match(queryAABBName.c_str()) &&
+				!match(querySphereName.c_str()) && !match(queryFrustumName.c_str()) && !match(queryRayName.c_str()))
+				continue;
+
+			const float Extent = 5.0f * std::cbrt((float)Count);
+			std::vector<AABB> boxes = RandomBoxes(random, Count, Extent);
+
+			if (match(insertName.c_str()))
+			{
+				results.push_back(Run(insertName, Count, [&]()
+				{
+					AABBTree tree;
+					for (uint32_t i = 0; i < Count; i++)
+						tree.insert(boxes[i], i);
+					BenchmarkSink = (float)tree.getHeight();
+				}));
+			}
+
+			AABBTree tree;
+			std::vector<uint32_t> proxies(Count);
+			for (uint32_t i = 0; i < Count; i++)
+				proxies[i] = tree.insert(boxes[i], i);
+
+			const uint32_t Queries = 256;
+			std::uniform_real_distribution<float> position(-Extent, Extent);
+			std::vector<Vector3> centers(Queries);
+			for (auto& center : centers)
+				center = Vector3(position(random), position(random), position(random));
+
+			if (match(queryAABBName.c_str()))
+			{
+				results.push_back(Run(queryAABBName, Queries, [&]()
+				{
+					uint32_t found = 0;
+					for (const Vector3& center : centers)
+						tree.queryAABB(AABB(center - Vector3(8.0f), center + Vector3(8.0f)), [&found](uint32_t) { found++; return true; });
+					BenchmarkSink = (float)found;
+				}));
+			}
+			if (match(querySphereName.c_str()))
+			{
+				results.push_back(Run(querySphereName, Queries, [&]()
+				{
+					uint32_t found = 0;
+					for (const Vector3& center : centers)
+						tree.querySphere(center, 8.0f, [&found](uint32_t) { found++; return true; });
+					BenchmarkSink = (float)found;
+				}));
+			}
+			if (match(queryFrustumName.c_str()))
+			{
+				const uint32_t Cameras = 16;
+				std::vector<Frustum> frustums(Cameras);
+				std::vector<Matrix4x4> views = RandomMatrices(random, Cameras);
+				for (uint32_t i = 0; i < Cameras; i++)
+					frustums[i] = Frustum(Matrix4x4::Perspective(1.2f, 1.7f, 0.1f, 100.0f) * views[i]);
+
+				results.push_back(Run(queryFrustumName, Cameras, [&]()
+				{
+					uint32_t found = 0;
+					for (const Frustum& frustum : frustums)
+						tree.queryFrustum(frustum, [&found](uint32_t) { found++; return true; });
+					BenchmarkSink = (float)found;
+				}));
+			}
+			if (match(queryRayName.c_str()))
+			{
+				// Closest hit, every hit clips the ray
+				std::vector<Ray> rays;
+				for (const Vector3& center : centers)
+					rays.push_back(Ray(center, RandomDirection(random)));
+
+				results.push_back(Run(queryRayName, Queries, [&]()
+				{
+					float distance = 0.0f;
+					for (const Ray& ray : rays)
+					{
+						Vector3 invDirection(1.0f / ray.m_direction.x, 1.0f / ray.m_direction.y, 1.0f / ray.m_direction.z);
+						float closest = Extent * 2.0f;
+						tree.queryRay(ray, closest, [&](uint32_t userData, float maxDistance)
+						{
+							float hit;
+							if (!boxes[userData].intersects(ray.m_origin, invDirection, maxDistance, hit))
+								return maxDistance;
+
+							closest = hit;
+							return hit;
+						});
+						distance += closest;
+					}
+					BenchmarkSink = distance;
+				}));
+			}
+			if (match(updateName.c_str()))
+			{
+				// Runs last, it moves the boxes the queries above use
+				// 1% of the boxes move further than the margin every iteration [removed and re-inserted]
+				const uint32_t Batch = Count / 100;
+				uint32_t cursor = 0;
+				uint32_t pass = 1;
+				results.push_back(Run(updateName, Batch, [&]()
+				{
+					Vector3 offset = (pass & 1) ? Vector3(1.0f, 0.0f, 0.0f) : Vector3::ZERO;
+					for (uint32_t i = 0; i < Batch; i++)
+					{
+						uint32_t index = cursor + i;
+						tree.update(proxies[index], AABB(boxes[index].min + offset, boxes[index].max + offset));
+					}
+					cursor += Batch;
+					if (cursor + Batch > Count)
+					{
+						cursor = 0;
+						pass++;
+					}
+					BenchmarkSink = (float)tree.getHeight();
+				}));
+			}
+		}
+
+		// ~ Meshes ~ //
+		if (match("Mesh::GenerateNormals") || match("Mesh::GenerateNormals(smooth)") || match("Mesh::GenerateTangents") || match("VertexPacking::PackVertices"))
+		{
+			std::vector<Vector3> positions;
+			std::vector<Vector2> uvs;
+			std::vector<uint32_t> indices;
+			GridMesh(256, positions, uvs, indices);
+			uint32_t vertexCount = (uint32_t)positions.size();
+
+			std::vector<Vector3> normals;
+			std::vector<Vector3> tangents;
+			Mesh::GenerateNormals(normals, positions.data(), vertexCount, indices.data(), (uint32_t)indices.size(), false);
+
+			if (match("Mesh::GenerateNormals"))
+			{
+				std::vector<Vector3> out;
+				results.push_back(Run("Mesh::GenerateNormals", vertexCount, [&]()
+				{
+					Mesh::GenerateNormals(out, positions.data(), vertexCount, indices.data(), (uint32_t)indices.size(), false);
+					BenchmarkSink = out[0].y;
+				}));
+			}
+			if (match("Mesh::GenerateNormals(smooth)"))
+			{
+				std::vector<Vector3> out;
+				results.push_back(Run("Mesh::GenerateNormals(smooth)", vertexCount, [&]()
+				{
+					Mesh::GenerateNormals(out, positions.data(), vertexCount, indices.data(), (uint32_t)indices.size(), true);
+					BenchmarkSink = out[0].y;
+				}));
+			}
+			if (match("Mesh::GenerateTangents"))
+			{
+				std::vector<Vector3> out;
+				results.push_back(Run("Mesh::GenerateTangents", vertexCount, [&]()
+				{
+					Mesh::GenerateTangents(out, positions.data(), vertexCount, uvs.data(), (uint32_t)uvs.size(), indices.data(), (uint32_t)indices.size(), normals.data());
+					BenchmarkSink = out[0].x;
+				}));
+			}
+			if (match("VertexPacking::PackVertices"))
+			{
+				Mesh::GenerateTangents(tangents, positions.data(), vertexCount, uvs.data(), (uint32_t)uvs.size(), indices.data(), (uint32_t)indices.size(), normals.data());
+
+				Vector3 min = Vector3::MAX;
+				Vector3 max = Vector3::MIN;
+				for (const Vector3& position : positions)
+				{
+					min = Vector3::Min(min, position);
+					max = Vector3::Max(max, position);
+				}
+
+				std::vector<uint8_t> out;
+				results.push_back(Run("VertexPacking::PackVertices", vertexCount, [&]()
+				{
+					VertexPacking::PackVertices(out, positions.data(), vertexCount, uvs.data(), normals.data(), tangents.data(), true, min, max);
+					BenchmarkSink = (float)out[0];
+				}));
+			}
+		}
+
+		// ~ Storage ~ //
+		if (match("IDStorage::Get"))
+		{
+			// Random lookups with some stale IDs, like assets that were unloaded
+			const uint32_t Count = 65536;
+			std::vector<int> values(Count);
+			IDStorage<int> storage;
+			std::vector<uint32_t> ids(Count);
+			for (uint32_t i = 0; i < Count; i++)
+				ids[i] = storage.Add(&values[i], AssetType::SCENE);
+			for (uint32_t i = 0; i < Count; i += 16)
+				storage.Erase(ids[i]);
+			std::shuffle(ids.begin(), ids.end(), random);
+
+			results.push_back(Run("IDStorage::Get", Count, [&]()
+			{
+				uint32_t found = 0;
+				for (uint32_t id : ids)
+					found += (storage.Get(id) != nullptr);
+				BenchmarkSink = (float)found;
+			}));
+		}
+		if (match("IDStorage::Add/Erase"))
+		{
+			const uint32_t Count = 4096;
+			std::vector<int> values(Count);
+			IDStorage<int> storage;
+			std::vector<uint32_t> ids(Count);
+
+			results.push_back(Run("IDStorage::Add/Erase", Count, [&]()
+			{
+				for (uint32_t i = 0; i < Count; i++)
+					ids[i] = storage.Add(&values[i], AssetType::SCENE);
+				for (uint32_t i = 0; i < Count; i++)
+					storage.Erase(ids[Count - 1 - i]);
+				BenchmarkSink = (float)ids[0];
+			}));
+		}
+
+		// ~ Rendering ~ //
+		if (match("RenderQueue::sort"))
+		{
+			// Entity gathering is a plain copy, draw order is decided by the queue sort
+			const uint32_t Count = 16384;
+			std::uniform_int_distribution<uint32_t> sequence(0, 63);
+			std::uniform_int_distribution<uint32_t> textures(0, 255);
+			std::uniform_int_distribution<uint32_t> vao(1, 511);
+			std::uniform_real_distribution<float> depth(0.0f, 1.0f);
+			std::vector<uint64_t> keys(Count);
+			for (auto& key : keys)
+				key = RenderQueue::MakeKey(depth(random) > 0.9f, sequence(random), textures(random), vao(random), depth(random));
+
+			RenderQueue queue;
+			results.push_back(Run("RenderQueue::sort", Count, [&]()
+			{
+				queue.clear();
+				for (uint32_t i = 0; i < Count; i++)
+					queue.push(keys[i], nullptr);
+				queue.sort();
+				BenchmarkSink = (float)queue.getTransparentStart();
+			}));
+		}
+		if (match("ShaderPreprocessor::process"))
+		{
+			// Material sized source with a nested include chain [files are cached after the first run]
+			const uint32_t Lines = 400;
+			std::string source = "#version 420 core\n#include \"_Core.glsl\"\n";
+			for (uint32_t i = 0; i < Lines; i++)
+				source += "\tvec4 value" + std::to_string(i) + " = texture(albedo_handler, frag_in.uv);\n";
+
+			ShaderPreprocessor preprocessor;
+			preprocessor.setFile("_Core.glsl", "#include \"_Lighting.glsl\"\nuniform mat4 VXL_mvp;\n");
+			preprocessor.setFile("_Lighting.glsl", "vec3 getCameraForwad() { return vec3(0, 0, 1); }\n");
+
+			results.push_back(Run("ShaderPreprocessor::process", Lines, [&]()
+			{
+				std::string output = preprocessor.process(source);
+				BenchmarkSink = (float)output.size();
+			}));
+		}
+		if (match("ParameterLayout::find") || match("UniformStorage::find"))
+		{
+			// Per material lookups of the same names, handles are hashed once
+			const uint32_t Count = 16;
+			std::string declarations;
+			std::vector<std::string> names;
+			std::map<std::string, float> storage;
+			for (uint32_t i = 0; i < Count; i++)
+			{
+				names.push_back("parameter" + std::to_string(i));
+				declarations += "float " + names.back() + ";\n";
+				storage[names.back()] = 0.0f;
+			}
+
+			ParameterLayout layout;
+			std::vector<std::string> errors;
+			layout.parse(declarations, errors);
+
+			std::vector<ParameterHandle> handles;
+			for (const std::string& name : names)
+				handles.push_back(ParameterHandle(name));
+
+			if (match("ParameterLayout::find"))
+			{
+				results.push_back(Run("ParameterLayout::find", Count, [&]()
+				{
+					int32_t sum = 0;
+					for (ParameterHandle handle : handles)
+						sum += layout.find(handle);
+					BenchmarkSink = (float)sum;
+				}));
+			}
+			if (match("UniformStorage::find"))
+			{
+				results.push_back(Run("UniformStorage::find", Count, [&]()
+				{
+					float sum = 0.0f;
+					for (const std::string& name : names)
+						sum += storage.find(name)->second;
+					BenchmarkSink = sum;
+				}));
+			}
+		}
+
+#ifdef GLOBAL_GRAPHICS_NULL
+		// ~ Graphics ~ // CPU side of state submission, the null backend stands in for the driver
+		if (match("Graphics::SetState(null)"))
+		{
+			Graphics::Setup();
+			Graphics::initHints();
+
+			const uint32_t Count = 1024;
+			results.push_back(Run("Graphics::SetState(null)", Count, [&]()
+			{
+				for (uint32_t i = 0; i < Count; i++)
+				{
+					bool odd = (i & 1) != 0;
+					Graphics::SetBlendState(odd);
+					Graphics::SetDepthWrite(!odd);
+					Graphics::SetCullMode(odd ? CullMode::CLOCKWISE : CullMode::COUNTER_CLOCKWISE);
+					Graphics::SetViewport(0, 0, 64 + (i & 1), 64);
+				}
+			}));
+		}
+#endif
+
+		return results;
+	}
+
+	std::vector<Benchmark::Accuracy> Benchmark::CheckAll(const std::string& filter)
+	{
+		std::vector<Accuracy> results;
+		std::mt19937 random(5678);
+
+		auto match = [&filter](const char* name)
+		{
+			return filter.empty() || std::string(name).find(filter) != std::string::npos;
+		};
+
+		// ~ Matrices ~ //
+		if (match("SIMD::Multiply(ulp)"))
+		{
+			const uint32_t Count = 4096;
+			std::vector<Matrix4x4> a = RandomAffineMatrices(random, Count, false);
+			std::vector<Matrix4x4> b = RandomAffineMatrices(random, Count, false);
+
+			uint32_t ulp = 0;
+			for (uint32_t i = 0; i < Count; i++)
+			{
+				Matrix4x4 fast = a[i] * b[i];
+				Matrix4x4 reference;
+				SIMD::Scalar::Multiply(a[i]._Val, b[i]._Val, reference._Val);
+				for (uint32_t j = 0; j < 16; j++)
+					ulp = std::max(ulp, UlpDistance(fast._Val[j], reference._Val[j]));
+			}
+			results.push_back({ "SIMD::Multiply(ulp)", Count, (double)ulp, 1.0 });
+		}
+		if (match("SIMD::Inverse(ulp)"))
+		{
+			const uint32_t Count = 4096;
+			std::vector<Matrix4x4> a = RandomAffineMatrices(random, Count, false);
+
+			uint32_t ulp = 0;
+			for (uint32_t i = 0; i < Count; i++)
+			{
+				Matrix4x4 fast, reference;
+				SIMD::Inverse(a[i]._Val, fast._Val);
+				SIMD::Scalar::Inverse(a[i]._Val, reference._Val);
+				for (uint32_t j = 0; j < 16; j++)
+					ulp = std::max(ulp, UlpDistance(fast._Val[j], reference._Val[j]));
+			}
+			results.push_back({ "SIMD::Inverse(ulp)", Count, (double)ulp, 1.0 });
+		}
+		if (match("Affine::Inverse"))
+		{
+			const uint32_t Count = 4096;
+			std::vector<Matrix4x4> a = RandomAffineMatrices(random, Count, false);
+
+			double error = 0.0;
+			for (uint32_t i = 0; i < Count; i++)
+			{
+				Matrix4x4 fast = Affine(a[i]).Inverse().GetMatrix4x4();
+				Matrix4x4 reference = a[i].Inverse();
+				error = std::max(error, MaxError(fast._Val, reference._Val, 16));
+			}
+			results.push_back({ "Affine::Inverse", Count, error, 1e-4 });
+		}
+		if (match("Affine::InverseUniformScale"))
+		{
+			const uint32_t Count = 4096;
+			std::vector<Matrix4x4> a = RandomAffineMatrices(random, Count, true);
+
+			double error = 0.0;
+			for (uint32_t i = 0; i < Count; i++)
+			{
+				float scale = Vector3::Length(a[i][0], a[i][4], a[i][8]);
+				Matrix4x4 fast = Affine(a[i]).InverseUniformScale(scale).GetMatrix4x4();
+				Matrix4x4 reference = a[i].Inverse();
+				error = std::max(error, MaxError(fast._Val, reference._Val, 16));
+			}
+			results.push_back({ "Affine::InverseUniformScale", Count, error, 1e-4 });
+		}
+
+		// ~ Transforms ~ //
+		if (match("Transform::getNormalMatrix"))
+		{
+			// Uniform chain uses the closed form, scaled leaves fall back to the general inverse
+			const uint32_t Depth = 8;
+			std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+			std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+			std::vector<std::unique_ptr<Transform>> chain;
+			for (uint32_t i = 0; i < Depth; i++)
+			{
+				float s = scale(random);
+				Vector3 scales = (i == Depth - 1) ? Vector3(s, scale(random), scale(random)) : Vector3(s);
+				chain.push_back(std::make_unique<Transform>(Vector3(1, 2, 3), Vector3(angle(random), angle(random), angle(random)), scales));
+				if (i > 0)
+					chain[i]->setParent(chain[i - 1].get());
+			}
+
+			double error = 0.0;
+			for (auto& transform : chain)
+			{
+				Matrix3x3 reference = Matrix3x3(transform->getModel()).Inverse();
+				error = std::max(error, MaxError(transform->getNormalMatrix().GetStartPointer(), reference.GetStartPointer(), 9));
+			}
+			results.push_back({ "Transform::getNormalMatrix", Depth, error, 1e-4 });
+		}
+		if (match("Transform::setWorldPosition"))
+		{
+			const uint32_t Count = 256;
+			std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+			std::uniform_real_distribution<float> offset(-100.0f, 100.0f);
+
+			Transform parent(Vector3(offset(random), offset(random), offset(random)), Vector3(angle(random), angle(random), angle(random)), Vector3(3.0f));
+			Transform child(Vector3(0, 0, 0));
+			child.setParent(&parent);
+
+			double error = 0.0;
+			for (uint32_t i = 0; i < Count; i++)
+			{
+				Vector3 target(offset(random), offset(random), offset(random));
+				child.setWorldPosition(target);
+				error = std::max(error, MaxError(&child.getWorldPosition().x, &target.x, 3));
+			}
+			results.push_back({ "Transform::setWorldPosition", Count, error, 1e-4 });
+		}
+
+		// ~ Vertex Packing ~ //
+		if (match("VertexPacking::FloatToHalf"))
+		{
+			// Normal range only, rounding to 11 significant bits is at most 2^-11 off
+			const uint32_t Count = 65536;
+			std::uniform_real_distribution<float> value(-1000.0f, 1000.0f);
+
+			double error = 0.0;
+			for (uint32_t i = 0; i < Count; i++)
+			{
+				float original = value(random);
+				if (fabs(original) < 6.2e-5f)
+					continue;
+				float decoded = VertexPacking::HalfToFloat(VertexPacking::FloatToHalf(original));
+				error = std::max(error, fabs((double)decoded - (double)original) / fabs((double)original));
+			}
+			results.push_back({ "VertexPacking::FloatToHalf", Count, error, 1.0 / 2048.0 });
+		}
+		if (match("VertexPacking::HalfToFloat(roundtrip)"))
+		{
+			// Every half value must survive float and back [NaN payloads excluded]
+			uint32_t mismatches = 0;
+			for (uint32_t i = 0; i < 65536; i++)
+			{
+				float value = VertexPacking::HalfToFloat((uint16_t)i);
+				if (value == value && VertexPacking::FloatToHalf(value) != (uint16_t)i)
+					mismatches++;
+			}
+			results.push_back({ "VertexPacking::HalfToFloat(roundtrip)", 65536, (double)mismatches, 0.0 });
+		}
+		if (match("VertexPacking::PackDirection(degrees)"))
+		{
+			const uint32_t Count = 65536;
+			std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+			double error = 0.0;
+			for (uint32_t i = 0; i < Count; i++)
+			{
+				Vector3 direction = Vector3(value(random), value(random), value(random)).Normalize();
+				int16_t packed[2];
+				VertexPacking::PackDirection(direction, packed);
+				Vector3 decoded = VertexPacking::UnpackDirection(packed);
+
+				// Angle from the cross product, acos loses too much near 1 in float
+				Vector3 cross = Vector3::Cross(direction, decoded);
+				double sine = sqrt((double)cross.x * cross.x + (double)cross.y * cross.y + (double)cross.z * cross.z);
+				error = std::max(error, asin(std::min(1.0, sine)) * 180.0 / 3.14159265358979);
+			}
+			results.push_back({ "VertexPacking::PackDirection(degrees)", Count, error, 0.01 });
+		}
+		if (match("VertexPacking::PackPosition(bounds)"))
+		{
+			// Error relative to the size of the bounds, half a step of 16 bits
+			const uint32_t Count = 65536;
+			const Vector3 min(-250.0f, -3.0f, 10.0f);
+			const Vector3 max(750.0f, 0.5f, 10.0f);
+			std::uniform_real_distribution<float> t(0.0f, 1.0f);
+
+			double error = 0.0;
+			for (uint32_t i = 0; i < Count; i++)
+			{
+				Vector3 position(min.x + t(random) * (max.x - min.x), min.y + t(random) * (max.y - min.y), min.z);
+				uint16_t packed[4];
+				VertexPacking::PackPosition(position, min, max, packed);
+				Vector3 decoded = VertexPacking::UnpackPosition(packed, min, max);
+
+				for (int j = 0; j < 3; j++)
+				{
+					double extent = std::max(1e-6, (double)(max[j] - min[j]));
+					error = std::max(error, fabs((double)decoded[j] - (double)position[j]) / extent);
+				}
+			}
+			results.push_back({ "VertexPacking::PackPosition(bounds)", Count, error, 1e-5 });
+		}
+
+		// ~ Storage ~ //
+		if (match("IDStorage::AddCustom(mismatches)"))
+		{
+			// Slots skipped by a custom ID are handed out by Add, custom slots never are
+			const uint32_t Gap = 16;
+			std::vector<int> values(Gap * 2);
+			IDStorage<int> storage;
+			uint32_t custom = storage.AddCustom(&values[0], AssetType::GLOBAL, Gap);
+
+			std::vector<bool> used(Gap + 1, false);
+			uint32_t mismatches = 0;
+			for (uint32_t i = 0; i < Gap; i++)
+			{
+				uint32_t slot = storage.Add(&values[i + 1], AssetType::SCENE) & IDStorage<int>::SlotMask;
+				mismatches += (slot >= Gap || used[slot]);
+				if (slot < Gap)
+					used[slot] = true;
+			}
+			mismatches += ((storage.Add(&values[Gap + 1], AssetType::SCENE) & IDStorage<int>::SlotMask) != Gap + 1);
+
+			// Erased then claimed by a custom ID, Add must skip it
+			storage.EraseAll(AssetType::SCENE);
+			storage.AddCustom(&values[Gap + 2], AssetType::GLOBAL, 3);
+			for (uint32_t i = 0; i < Gap; i++)
+				mismatches += ((storage.Add(&values[i], AssetType::SCENE) & IDStorage<int>::SlotMask) == 3);
+
+			mismatches += (storage.Get(custom) != &values[0]);
+			results.push_back({ "IDStorage::AddCustom(mismatches)", Gap * 2, (double)mismatches, 0.0 });
+		}
+
+		// ~ Shaders ~ //
+		if (match("ShaderPreprocessor::process(mismatches)"))
+		{
+			// Nested, repeated, self including and missing files
+			ShaderPreprocessor preprocessor;
+			preprocessor.setFile("a.glsl", "A\n#include \"b.glsl\"\n");
+			preprocessor.setFile("b.glsl", "B\n\t#include <a.glsl>\n");
+
+			std::string output = preprocessor.process("S\n#include \"a.glsl\"\n#include \"missing.glsl\"\n// #include \"a.glsl\"\nE");
+			const std::string expected =
+				"S\n"
+				"// [INCLUDE \"a.glsl\"]\nA\n"
+				"// [INCLUDE \"b.glsl\"]\nB\n\n// [END INCLUDE]\n"
+				"\n// [END INCLUDE]\n"
+				"// #include \"a.glsl\"\nE";
+
+			uint32_t mismatches = 0;
+			mismatches += (output != expected);
+			mismatches += (preprocessor.getErrors().size() != 2);
+			mismatches += (preprocessor.getReadCount() != 0);
+			results.push_back({ "ShaderPreprocessor::process(mismatches)", 3, (double)mismatches, 0.0 });
+		}
+		if (match("ParameterLayout::parse(mismatches)"))
+		{
+			// std140 offsets [vec3 aligns to 16, a float fits behind it, matrix rows are vec4]
+			ParameterLayout layout;
+			std::vector<std::string> errors;
+			layout.parse("float a = 2.0;\nvec3 b; // comment\nfloat c;\nmat3 d = mat3(1.0);\nvec2 e;\nfloat a;\ndouble f;", errors);
+
+			const uint32_t expected[] = { 0, 16, 28, 32, 80 };
+			uint32_t mismatches = 0;
+			mismatches += (layout.getMembers().size() != 5);
+			for (uint32_t i = 0; i < 5 && i < layout.getMembers().size(); i++)
+				mismatches += (layout.getMembers()[i].offset != expected[i]);
+			mismatches += (layout.getSize() != 96);
+			mismatches += (errors.size() != 2);
+
+			// Defaults [identity diagonal at each row start]
+			float value;
+			memcpy(&value, layout.getDefaults().data() + 0, 4);
+			mismatches += (value != 2.0f);
+			memcpy(&value, layout.getDefaults().data() + 32 + 16 + 4, 4);
+			mismatches += (value != 1.0f);
+			memcpy(&value, layout.getDefaults().data() + 32 + 4, 4);
+			mismatches += (value != 0.0f);
+
+			mismatches += (layout.find("e") != 4);
+			mismatches += (layout.find("missing") != -1);
+			results.push_back({ "ParameterLayout::parse(mismatches)", 13, (double)mismatches, 0.0 });
+		}
+
+		// ~ Jobs ~ //
+		if (match("JobSystem::ParallelFor(mismatches)"))
+		{
+			// Every index visited exactly once, uneven last batch
+			const uint32_t Count = 100003;
+			std::vector<uint32_t> visits(Count, 0);
+			JobSystem.ParallelFor(visits.data(), Count, 1000, [](uint32_t& value) { value++; });
+
+			uint32_t mismatches = 0;
+			for (uint32_t value : visits)
+				mismatches += (value != 1);
+
+			// Dependent jobs only start after every job of their dependency returned
+			JobCounter first;
+			JobCounter second;
+			std::atomic<uint32_t> firstDone{ 0 };
+			std::atomic<uint32_t> early{ 0 };
+			for (uint32_t i = 0; i < 64; i++)
+				JobSystem.Run([&firstDone]() { firstDone++; }, &first);
+			for (uint32_t i = 0; i < 64; i++)
+				JobSystem.RunAfter(first, [&firstDone, &early]() { early += (firstDone != 64); }, &second);
+
+			// Main thread jobs run inside Wait on the main thread
+			JobCounter last;
+			bool onMainThread = false;
+			JobSystem.RunAfter(second, [&onMainThread]() { onMainThread = JobSystem.isMainThread(); }, &last, JobAffinity::MAIN_THREAD);
+			JobSystem.Wait(last);
+
+			mismatches += early;
+			mismatches += !onMainThread;
+			results.push_back({ "JobSystem::ParallelFor(mismatches)", Count, (double)mismatches, 0.0 });
+		}
+
+		// ~ AABB Tree ~ //
+		if (match("AABBTree::query(mismatches)"))
+		{
+			// After inserts, removals and moves, every query must return exactly what a scan of every fat box returns
+			const uint32_t Count = 4000;
+			const float Extent = 80.0f;
+			std::vector<AABB> boxes = RandomBoxes(random, Count, Extent);
+			std::vector<uint32_t> proxies(Count);
+			std::vector<bool> alive(Count, true);
+
+			AABBTree tree;
+			for (uint32_t i = 0; i < Count; i++)
+				proxies[i] = tree.insert(boxes[i], i);
+
+			for (uint32_t i = 0; i < Count; i += 7)
+			{
+				tree.remove(proxies[i]);
+				alive[i] = false;
+			}
+
+			// Half of the moves stay inside the margin, the other half get re-inserted
+			std::uniform_real_distribution<float> position(-Extent, Extent);
+			std::uniform_real_distribution<float> jitter(-0.05f, 0.05f);
+			for (uint32_t i = 1; i < Count; i += 3)
+			{
+				if (!alive[i])
+					continue;
+
+				Vector3 offset = (i & 1) ? Vector3(jitter(random), jitter(random), jitter(random)) : Vector3(position(random), position(random), position(random)) * 0.1f;
+				boxes[i] = AABB(boxes[i].min + offset, boxes[i].max + offset);
+				tree.update(proxies[i], boxes[i]);
+			}
+
+			uint32_t aliveCount = 0;
+			uint32_t mismatches = 0;
+			for (uint32_t i = 0; i < Count; i++)
+			{
+				if (!alive[i])
+					continue;
+
+				aliveCount++;
+				mismatches += !tree.getFatAABB(proxies[i]).contains(boxes[i]);
+				mismatches += (tree.getUserData(proxies[i]) != i);
+			}
+			mismatches += (tree.getLeafCount() != aliveCount);
+
+			// One mismatch per query whose results differ [missing, extra or duplicate]
+			std::vector<uint32_t> found;
+			std::vector<uint32_t> expected;
+			auto gather = [&found](uint32_t userData) { found.push_back(userData); return true; };
+			auto bruteForce = [&](const std::function<bool(const AABB&)>& test)
+			{
+				expected.clear();
+				for (uint32_t i = 0; i < Count; i++)
+				{
+					if (alive[i] && test(tree.getFatAABB(proxies[i])))
+						expected.push_back(i);
+				}
+				std::sort(found.begin(), found.end());
+				mismatches += (found != expected);
+				found.clear();
+			};
+
+			const uint32_t Queries = 64;
+			std::vector<Matrix4x4> views = RandomMatrices(random, Queries);
+			for (uint32_t i = 0; i < Queries; i++)
+			{
+				Vector3 center(position(random), position(random), position(random));
+
+				AABB box(center - Vector3(10.0f), center + Vector3(10.0f));
+				tree.queryAABB(box, gather);
+				bruteForce([&box](const AABB& fat) { return fat.overlaps(box); });
+
+				tree.querySphere(center, 10.0f, gather);
+				bruteForce([&center](const AABB& fat) { return fat.distanceSqr(center) <= 100.0f; });
+
+				Frustum frustum(Matrix4x4::Perspective(1.2f, 1.7f, 0.1f, 100.0f) * views[i]);
+				tree.queryFrustum(frustum, gather);
+				bruteForce([&frustum](const AABB& fat) { return frustum.isInside(fat); });
+
+				// Every hit along the ray, nothing clips it
+				Ray ray(center, RandomDirection(random));
+				Vector3 invDirection(1.0f / ray.m_direction.x, 1.0f / ray.m_direction.y, 1.0f / ray.m_direction.z);
+				tree.queryRay(ray, Extent, [&found](uint32_t userData, float maxDistance) { found.push_back(userData); return maxDistance; });
+				bruteForce([&](const AABB& fat) { float distance; return fat.intersects(ray.m_origin, invDirection, Extent, distance); });
+			}
+
+			results.push_back({ "AABBTree::query(mismatches)", Queries * 4, (double)mismatches, 0.0 });
+		}
+
+		// ~ Time ~ //
+		if (match("FrameTimeHistogram::getPercentiles(mismatches)"))
+		{
+			// Ring only keeps the newest FRAME_TIME_HISTORY samples [61 to 300 ms]
+			const uint32_t Count = FRAME_TIME_HISTORY + 60;
+			FrameTimeHistogram histogram;
+			uint32_t mismatches = (histogram.getPercentiles().p99 != 0.0f);
+			for (uint32_t i = 1; i <= Count; i++)
+				histogram.add((float)i);
+
+			FrameTimeHistogram::Percentiles percentiles = histogram.getPercentiles();
+			mismatches += (percentiles.p50 != 180.0f);
+			mismatches += (percentiles.p95 != 288.0f);
+			mismatches += (percentiles.p99 != 298.0f);
+			mismatches += (percentiles.max != 300.0f);
+			mismatches += (histogram.getCount() != FRAME_TIME_HISTORY);
+			mismatches += (histogram.getOffset() != 60);
+			mismatches += (histogram.getSamples()[histogram.getOffset()] != 61.0f);
+			results.push_back({ "FrameTimeHistogram::getPercentiles(mismatches)", Count, (double)mismatches, 0.0 });
+		}
+
+#ifdef GLOBAL_GRAPHICS_NULL
+		// ~ Graphics ~ // Calls are only counted when they land in the null backend
+		if (match("Graphics::RedundantState(calls)"))
+		{
+			Graphics::Setup();
+			Graphics::initHints();
+
+			// Repeating the current state must not reach GL
+			const uint32_t Count = 64;
+			auto setState = []()
+			{
+				Graphics::SetBlendState(true);
+				Graphics::SetBlendMode(BlendSource::SRC_ALPHA, BlendDestination::ONE_MINUS_SRC_ALPHA);
+				Graphics::SetDepthRead(true);
+				Graphics::SetDepthWrite(true);
+				Graphics::SetCullMode(CullMode::CLOCKWISE);
+				Graphics::SetViewport(0, 0, 64, 64);
+				Graphics::SetLineWidth(2.0f);
+			};
+			setState();
+
+			GraphicsBackend::ResetStats();
+			for (uint32_t i = 0; i < Count; i++)
+				setState();
+
+			const GraphicsBackend::Stats& stats = GraphicsBackend::GetStats();
+			results.push_back({ "Graphics::RedundantState(calls)", Count, (double)stats.total(), 0.0 });
+		}
+		if (match("RenderManager::renderOpaque(calls)"))
+		{
+			Graphics::Setup();
+			Graphics::initHints();
+			RenderManager.InitGlobalGLResources();
+
+			// Every entity drawn on its own, batching and culling would hide the per entity cost
+			bool frustumCulling = RenderManager.m_frustumCulling;
+			bool instancedBatching = RenderManager.m_instancedBatching;
+			bool globalVAO = RenderManager.m_globalVAO;
+			CameraIndex mainCamera = RenderManager.m_mainCamera;
+			RenderManager.m_frustumCulling = false;
+			RenderManager.m_instancedBatching = false;
+			RenderManager.m_globalVAO = false;
+
+			FramebufferObjectIndex fboIndex = SceneAssets.createFramebuffer("_benchmark");
+			FramebufferObject* fbo = Assets.getFramebufferObject(fboIndex);
+			fbo->setSize(64, 64);
+			fbo->setRenderTexture(0, SceneAssets.createRenderTexture("_benchmark_albedo", 64, 64, TextureFormat::RGBA8, TexturePixelType::UNSIGNED_BYTE, false));
+			fbo->checkFBOStatus();
+
+			RenderManager.m_mainCamera = SceneAssets.createCamera("_benchmark_camera", 0.1f, 100.0f);
+			{
+				Camera* camera = Assets.getCamera(RenderManager.m_mainCamera);
+				camera->SetPerspective(90.0f, 1.0f);
+				camera->update();
+			}
+
+			// Two materials sharing a program, two meshes each
+			ShaderMaterialIndex shaderMaterial = SceneAssets.createShaderMaterial("./assets/materials/gbuffer.material");
+			MaterialIndex materials[2];
+			for (uint32_t i = 0; i < 2; i++)
+			{
+				materials[i] = SceneAssets.createMaterial("_benchmark_" + std::to_string(i));
+				Material* material = Assets.getMaterial(materials[i]);
+				material->setShaderMaterial(shaderMaterial);
+				material->setSequenceID(1000 + i);
+			}
+			MeshIndex meshes[2] = { Primitives.GetCube(), Primitives.GetQuadZ() };
+
+			// Entities are created interleaved so only sorting keeps the runs together
+			uint32_t entityCount = 0;
+			std::uniform_real_distribution<float> offset(-10.0f, 10.0f);
+			auto addEntities = [&](uint32_t countPerPair)
+			{
+				for (uint32_t i = 0; i < countPerPair; i++)
+				{
+					for (uint32_t pair = 0; pair < 4; pair++)
+					{
+						Entity* entity = Assets.getEntity(SceneAssets.createEntity("_benchmark_" + std::to_string(entityCount++)));
+						entity->setMaterial(materials[pair / 2]);
+						entity->setMesh(meshes[pair % 2]);
+						entity->m_transform.setPosition(offset(random), offset(random), -20.0f);
+					}
+				}
+			};
+			// Second frame of the same scene, the state cache already holds what the last frame left bound
+			auto renderFrame = [&]()
+			{
+				GraphicsBackend::Stats stats;
+				for (uint32_t frame = 0; frame < 2; frame++)
+				{
+					RenderManager.sortMaterials();
+					RenderManager.sortEntities();
+					RenderManager.cullEntities();
+
+					GraphicsBackend::ResetStats();
+					GraphicsBackend::ClearRecording();
+					fbo->bind();
+					fbo->clearBuffers();
+					RenderManager.renderOpaque(ShaderMaterialType::CORE);
+					FramebufferObject::unbind();
+					stats = GraphicsBackend::GetStats();
+				}
+				return stats;
+			};
+
+			const uint32_t Count = 64;
+			addEntities(Count);
+			GraphicsBackend::Stats statsA = renderFrame();
+			addEntities(Count);
+			GraphicsBackend::Stats statsB = renderFrame();
+
+			// One draw and one set of uniforms per added entity, binds only follow material and mesh changes
+			const int64_t Added = Count * 4;
+			int64_t addedDraws = (int64_t)statsB.get(GraphicsBackend::CallType::DRAW) - (int64_t)statsA.get(GraphicsBackend::CallType::DRAW);
+			int64_t addedBinds = (int64_t)statsB.get(GraphicsBackend::CallType::BIND) - (int64_t)statsA.get(GraphicsBackend::CallType::BIND);
+			int64_t addedUniforms = (int64_t)statsB.get(GraphicsBackend::CallType::UNIFORM) - (int64_t)statsA.get(GraphicsBackend::CallType::UNIFORM);
+			double error = (double)std::abs(addedDraws - Added) + (double)std::abs(addedBinds);
+			error += (double)std::abs(addedUniforms % Added) + ((addedUniforms < Added) ? 1.0 : 0.0);
+			results.push_back({ "RenderManager::renderOpaque(calls)", entityCount, error, 0.0 });
+
+#ifdef GLOBAL_GRAPHICS_RECORDING
+			// Recording holds the last frame, one line per counted call and one glDraw* per entity
+			const std::vector<std::string>& recording = GraphicsBackend::GetRecording();
+			uint32_t recordedDraws = 0;
+			for (const std::string& call : recording)
+				recordedDraws += (call.compare(0, 6, "glDraw") == 0) ? 1 : 0;
+
+			double recordingError = std::abs((double)recording.size() - (double)statsB.total()) + std::abs((double)recordedDraws - (double)entityCount);
+			results.push_back({ "GraphicsBackend::Recording(calls)", (uint32_t)recording.size(), recordingError, 0.0 });
+
+			FileIO::EnsureDirectory("./benchmarks/renderOpaque_calls.txt");
+			GraphicsBackend::SaveRecording("./benchmarks/renderOpaque_calls.txt");
+			GraphicsBackend::ClearRecording();
+#endif
+
+			RenderManager.DestroySceneGLResources();
+			RenderManager.dirtyEntitySequence();
+			RenderManager.sortEntities();
+			RenderManager.DestroyGlobalGLResources();
+
+			RenderManager.m_frustumCulling = frustumCulling;
+			RenderManager.m_instancedBatching = instancedBatching;
+			RenderManager.m_globalVAO = globalVAO;
+			RenderManager.m_mainCamera = mainCamera;
+		}
+#endif
+
+		return results;
+	}
+
+	bool Benchmark::WriteJson(const std::string& filePath, const std::vector<Result>& results, const std::vector<Accuracy>& accuracy)
+	{
+		FileIO::EnsureDirectory(filePath);
+		std::ofstream file(filePath, std::ios::trunc);
+		if (!file.is_open())
+		{
+			Logger.error("Unable to write benchmark results: " + filePath);
+			return false;
+		}
+
+		char date[32];
+		time_t now = time(nullptr);
+		strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+		file << "{\n";
+		file << "\t\"date\": \"" << date << "\",\n";
+#ifdef _DEBUG
+		file << "\t\"build\": \"Debug\",\n";
+#else
+		file << "\t\"build\": \"Release\",\n";
+#endif
+		file << "\t\"simd\": \"" << SIMD::GetInstructionSet() << "\",\n";
+		file << "\t\"results\": [\n";
+
+		char buffer[512];
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const Result& result = results[i];
+			snprintf(buffer, sizeof(buffer),
+				"\t\t{\"name\": \"%s\", \"items\": %u, \"iterations\": %u, \"samples\": %u, \"median_ns\": %.1f, \"min_ns\": %.1f, \"mean_ns\": %.1f, \"ns_per_item\": %.3f}%s\n",
+				result.name.c_str(), result.items, result.iterations, result.samples,
+				result.median, result.min, result.mean, result.median / (double)result.items,
+				(i + 1 < results.size()) ? "," : ""
+			);
+			file << buffer;
+		}
+
+		file << "\t],\n";
+		file << "\t\"accuracy\": [\n";
+
+		for (size_t i = 0; i < accuracy.size(); i++)
+		{
+			const Accuracy& check = accuracy[i];
+			snprintf(buffer, sizeof(buffer),
+				"\t\t{\"name\": \"%s\", \"samples\": %u, \"max_error\": %g, \"tolerance\": %g, \"passed\": %s}%s\n",
+				check.name.c_str(), check.samples, check.maxError, check.tolerance, check.passed() ? "true" : "false",
+				(i + 1 < accuracy.size()) ? "," : ""
+			);
+			file << buffer;
+		}
+
+		file << "\t]\n}\n";
+		return file.good();
+	}
+
+	bool Benchmark::RunCommandLine(const std::vector<std::string>& args)
+	{
+		if (args.empty() || args[0] != "--benchmark")
+			return false;
+
+		std::string filter;
+		std::string output = "./benchmarks/results.json";
+
+		for (size_t i = 1; i + 1 < args.size(); i++)
+		{
+			if (args[i] == "--filter")
+				filter = args[++i];
+			else if (args[i] == "--out")
+				output = args[++i];
+		}
+
+		std::vector<Accuracy> accuracy = CheckAll(filter);
+		for (const Accuracy& check : accuracy)
+		{
+			if (!check.passed())
+				Logger.error("Accuracy check failed: " + check.name + " [" + std::to_string(check.maxError) + " > " + std::to_string(check.tolerance) + "]");
+		}
+
+		std::vector<Result> results = RunAll(filter);
+		if (WriteJson(output, results, accuracy))
+			Logger.log("Benchmark results saved: " + output);
+
+		return true;
+	}
+}
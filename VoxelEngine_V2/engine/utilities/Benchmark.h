@@ -0,0 +1,55 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "Macros.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Vxl
+{
+	// Headless benchmarks for CPU hot paths [no window or GL context]
+	// Usage: --benchmark [--filter text] [--out file.json]
+	class Benchmark
+	{
+		DISALLOW_COPY_AND_ASSIGN(Benchmark);
+	public:
+		struct Result
+		{
+			std::string name;
+			uint32_t	items;		// Work items per iteration [matrices, vertices, transforms...]
+			uint32_t	iterations;	// Per sample
+			uint32_t	samples;
+			double		median;		// ns per iteration
+			double		min;		// ns per iteration
+			double		mean;		// ns per iteration
+		};
+		struct Accuracy
+		{
+			std::string name;
+			uint32_t	samples;
+			double		maxError;	// Largest difference from the reference [relative unless the name says otherwise]
+			double		tolerance;
+
+			inline bool passed(void) const
+			{
+				return maxError <= tolerance;
+			}
+		};
+
+	private:
+		// Picks an iteration count so each sample runs long enough to time, then times every sample
+		static Result Run(const std::string& name, uint32_t items, const std::function<void()>& function);
+
+	public:
+		// Cases whose name contains filter [empty = all]
+		static std::vector<Result> RunAll(const std::string& filter = "");
+		// Compares fast paths with the general versions they replace
+		static std::vector<Accuracy> CheckAll(const std::string& filter = "");
+		static bool WriteJson(const std::string& filePath, const std::vector<Result>& results, const std::vector<Accuracy>& accuracy);
+
+		// Returns true if arguments requested benchmarks [app should exit after]
+		static bool RunCommandLine(const std::vector<std::string>& args);
+	};
+}
@@ -5,6 +5,7 @@
 #include "Macros.h"
 #include "Logger.h"
 
+#include <Windows.h>
 #include <filesystem>
 
 namespace fs = std::experimental::filesystem;
@@ -20,6 +21,58 @@ namespace Vxl
 			VXL_ERROR("Filepath does not exist:" + _filepath);
 	}
 
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+	bool MappedFile::open(const std::string& filePath)
+	{
+		close();
+
+		HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+		m_file = file;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			close();
+			return false;
+		}
+		m_size = (uint64_t)size.QuadPart;
+
+		m_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (!m_mapping)
+		{
+			close();
+			return false;
+		}
+
+		m_data = (const uint8_t*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!m_data)
+		{
+			close();
+			return false;
+		}
+
+		return true;
+	}
+	void MappedFile::close()
+	{
+		if (m_data)
+			UnmapViewOfFile(m_data);
+		if (m_mapping)
+			CloseHandle(m_mapping);
+		if (m_file)
+			CloseHandle(m_file);
+
+		m_data = nullptr;
+		m_mapping = nullptr;
+		m_file = nullptr;
+		m_size = 0;
+	}
+
 	namespace FileIO
 	{
 		// Check if file exists
@@ -43,39 +96,6 @@ namespace Vxl
 			Logger.error("Unable to read file: " + filePath);
 			return std::string();
 		}
-		// Add include directory to txt
-		std::string addInclude(std::string data)
-		{
-			// Do this for every include statement in the file
-			size_t includeLoc;
-			while ((includeLoc = data.find("#include")) != std::string::npos)
-			{
-				size_t endlineLoc = data.find('\n', includeLoc);
-				std::string includePath = data.substr(includeLoc + 8, endlineLoc - includeLoc - 8);
-				// Find end of line,
-				stringUtil::removeChar(includePath, " \t\"");
-				stringUtil::trim(includePath);
-
-				//size_t lastDashLoc = originalDirectory.find_last_of("/\\");
-				//std::string directory = originalDirectory.substr(0, lastDashLoc + 1) + includePath;
-
-				if (fileExists(includePath))
-				{
-					// Leave include signature
-					std::string include = readFile(includePath);
-					include = "// [INCLUDE \"" + includePath + "\"]\n" + include + "\n// [END INCLUDE]\n";
-					// replace #include line with the file loaded from the include
-					data.replace(includeLoc, endlineLoc - includeLoc, include);
-				}
-				else
-				{
-					Logger.error("addInclude() for: " + includePath + " does not exist!");
-					data.erase(includeLoc, endlineLoc - includeLoc);
-				}
-
-			}
-			return data;
-		}
 		std::string getExtension(const std::string& filePath)
 		{
 			std::size_t pos = filePath.find_last_of('.');
@@ -3,6 +3,7 @@
 
 #include "stringUtil.h"
 #include "singleton.h"
+#include "Macros.h"
 #include <map>
 
 namespace Vxl
@@ -15,14 +16,43 @@ namespace Vxl
 		File(const std::string& _filepath);
 	};
 
+	// Read only memory mapping of an entire file
+	class MappedFile
+	{
+		DISALLOW_COPY_AND_ASSIGN(MappedFile);
+	private:
+		void*			m_file = nullptr;	 // HANDLE
+		void*			m_mapping = nullptr; // HANDLE
+		const uint8_t*	m_data = nullptr;
+		uint64_t		m_size = 0;
+
+	public:
+		MappedFile() {}
+		~MappedFile();
+
+		bool open(const std::string& filePath);
+		void close();
+
+		inline bool			  isOpen(void) const
+		{
+			return m_data != nullptr;
+		}
+		inline const uint8_t* getData(void) const
+		{
+			return m_data;
+		}
+		inline uint64_t		  getSize(void) const
+		{
+			return m_size;
+		}
+	};
+
 	namespace FileIO
 	{
 		// Check if file exists
 		bool fileExists(const std::string& filePath);
 		// Interpret file as string
 		std::string readFile(const std::string& filePath);
-		// Add include directory to txt
-		std::string addInclude(std::string data);
 		// Get Extension
 		std::string getExtension(const std::string& filePath);
 		// Get Name
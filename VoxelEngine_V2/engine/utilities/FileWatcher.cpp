@@ -0,0 +1,208 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "FileWatcher.h"
+
+#include "Profiler.h"
+#include "stringUtil.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <set>
+
+namespace fs = std::experimental::filesystem;
+
+namespace Vxl
+{
+	static int64_t GetWriteTime(const std::string& path)
+	{
+		std::error_code error;
+		int64_t time = (int64_t)fs::last_write_time(path, error).time_since_epoch().count();
+		return error ? -1 : time;
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		stop();
+	}
+
+	std::string FileWatcher::NormalizePath(const std::string& path)
+	{
+		std::string result = stringUtil::toLowerCopy(path);
+		std::replace(result.begin(), result.end(), '\\', '/');
+
+		while (result.compare(0, 2, "./") == 0)
+			result.erase(0, 2);
+
+		return result;
+	}
+
+	void FileWatcher::watch(const std::string& path)
+	{
+		std::string file = NormalizePath(path);
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_files.find(file) != m_files.end())
+				return;
+
+			m_files[file] = GetWriteTime(file);
+		}
+
+		m_directoriesDirty = true;
+		if (m_wakeEvent)
+			SetEvent((HANDLE)m_wakeEvent);
+	}
+	void FileWatcher::unwatch(const std::string& path)
+	{
+		std::string file = NormalizePath(path);
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_files.erase(file);
+			m_changed.erase(std::remove(m_changed.begin(), m_changed.end(), file), m_changed.end());
+		}
+
+		m_directoriesDirty = true;
+		if (m_wakeEvent)
+			SetEvent((HANDLE)m_wakeEvent);
+	}
+	void FileWatcher::clear()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_files.clear();
+			m_changed.clear();
+		}
+
+		m_directoriesDirty = true;
+		if (m_wakeEvent)
+			SetEvent((HANDLE)m_wakeEvent);
+	}
+
+	void FileWatcher::start(uint32_t pollInterval)
+	{
+		if (m_running)
+			return;
+
+		m_pollInterval = pollInterval;
+		m_wakeEvent = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+		m_directoriesDirty = true;
+		m_running = true;
+		m_thread = std::thread(&FileWatcher::threadLoop, this);
+	}
+	void FileWatcher::stop()
+	{
+		if (!m_running)
+			return;
+
+		m_running = false;
+		SetEvent((HANDLE)m_wakeEvent);
+		m_thread.join();
+
+		CloseHandle((HANDLE)m_wakeEvent);
+		m_wakeEvent = nullptr;
+	}
+
+	std::vector<std::string> FileWatcher::poll()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		std::vector<std::string> changed;
+		changed.swap(m_changed);
+		return changed;
+	}
+
+	void FileWatcher::scan()
+	{
+		// Disk is only touched outside of the lock
+		std::vector<std::pair<std::string, int64_t>> files;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			files.assign(m_files.begin(), m_files.end());
+		}
+
+		for (const auto& file : files)
+		{
+			int64_t writeTime = GetWriteTime(file.first);
+			if (writeTime == file.second)
+				continue;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_files.find(file.first);
+			if (it == m_files.end())
+				continue;
+
+			it->second = writeTime;
+
+			// Missing files aren't reported, editors that save by renaming delete the file for a moment
+			if (writeTime != -1 && std::find(m_changed.begin(), m_changed.end(), file.first) == m_changed.end())
+				m_changed.push_back(file.first);
+		}
+	}
+
+	void FileWatcher::threadLoop()
+	{
+		Profiler.SetThreadName("FileWatcher");
+
+		std::vector<HANDLE> notifications;
+		bool polling = false;
+
+		while (m_running)
+		{
+			// One notification per directory holding a watched file
+			if (m_directoriesDirty.exchange(false))
+			{
+				for (HANDLE notification : notifications)
+					FindCloseChangeNotification(notification);
+				notifications.clear();
+				polling = false;
+
+				std::set<std::string> directories;
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					for (const auto& file : m_files)
+						directories.insert(fs::path(file.first).parent_path().string());
+				}
+
+				for (const std::string& directory : directories)
+				{
+					// Wake event needs the last slot
+					if (notifications.size() + 1 >= MAXIMUM_WAIT_OBJECTS)
+					{
+						polling = true;
+						break;
+					}
+
+					HANDLE notification = FindFirstChangeNotificationA(
+						directory.empty() ? "." : directory.c_str(),
+						FALSE,
+						FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME
+					);
+
+					if (notification == INVALID_HANDLE_VALUE)
+						polling = true;
+					else
+						notifications.push_back(notification);
+				}
+			}
+
+			std::vector<HANDLE> handles = notifications;
+			handles.push_back((HANDLE)m_wakeEvent);
+
+			DWORD result = WaitForMultipleObjects((DWORD)handles.size(), handles.data(), FALSE, polling ? m_pollInterval : INFINITE);
+			if (!m_running)
+				break;
+
+			if (result >= WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + notifications.size())
+			{
+				FindNextChangeNotification(notifications[result - WAIT_OBJECT_0]);
+
+				// Editors write in several steps, give the file a moment to settle
+				Sleep(50);
+			}
+
+			VXL_PROFILE_SCOPE("FileWatcher::scan");
+			scan();
+		}
+
+		for (HANDLE notification : notifications)
+			FindCloseChangeNotification(notification);
+	}
+}
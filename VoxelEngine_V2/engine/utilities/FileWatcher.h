@@ -0,0 +1,59 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "Macros.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Vxl
+{
+	// Background thread reporting files whose write time changed
+	// Directories of watched files use change notifications, polling is the fallback when they can't be opened
+	class FileWatcher
+	{
+		DISALLOW_COPY_AND_ASSIGN(FileWatcher);
+	private:
+		// Normalized path -> last seen write time [-1 = missing]
+		std::unordered_map<std::string, int64_t>	m_files;
+		std::vector<std::string>					m_changed;
+		std::mutex									m_mutex;
+
+		std::thread			m_thread;
+		std::atomic<bool>	m_running = false;
+		std::atomic<bool>	m_directoriesDirty = false;
+		void*				m_wakeEvent = nullptr; // HANDLE
+		uint32_t			m_pollInterval = 250;
+
+		void threadLoop();
+		// Compares write times of all files
+		void scan();
+
+	public:
+		FileWatcher() {}
+		~FileWatcher();
+
+		// Lowercase, forward slashes and no leading "./" [same file = same string]
+		static std::string NormalizePath(const std::string& path);
+
+		void watch(const std::string& path);
+		void unwatch(const std::string& path);
+		void clear();
+
+		// Poll interval is only used by the fallback [ms]
+		void start(uint32_t pollInterval = 250);
+		void stop();
+
+		// Normalized paths changed since the last call
+		std::vector<std::string> poll();
+
+		inline bool isRunning(void) const
+		{
+			return m_running;
+		}
+	};
+}
@@ -0,0 +1,256 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "JobSystem.h"
+
+#include "Profiler.h"
+
+namespace Vxl
+{
+	static thread_local uint32_t t_queueIndex = (uint32_t)-1;
+
+	JobSystem::~JobSystem()
+	{
+		Shutdown();
+	}
+
+	void JobSystem::Init(uint32_t threadCount)
+	{
+		if (m_initialized.load(std::memory_order_acquire))
+			return;
+
+		std::lock_guard<std::mutex> initLock(m_initMutex);
+		if (m_initialized.load(std::memory_order_relaxed))
+			return;
+
+		// Leave a core for the main thread
+		if (threadCount == 0)
+		{
+			uint32_t cores = std::thread::hardware_concurrency();
+			threadCount = (cores > 1) ? cores - 1 : 1;
+		}
+
+		m_quit = false;
+
+		for (uint32_t i = 0; i < threadCount + 1; i++)
+			m_queues.push_back(std::make_unique<Queue>());
+
+		for (uint32_t i = 0; i < threadCount; i++)
+			m_workers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+
+		m_initialized.store(true, std::memory_order_release);
+	}
+	void JobSystem::Shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_quit = true;
+		}
+		m_sleepCondition.notify_all();
+
+		// Jobs still running can queue more, queues stay until every worker returned
+		for (auto& worker : m_workers)
+			worker.join();
+		m_workers.clear();
+
+		std::lock_guard<std::mutex> initLock(m_initMutex);
+		m_initialized = false;
+		m_queues.clear();
+		{
+			std::lock_guard<std::mutex> lock(m_mainThreadQueue.mutex);
+			m_mainThreadQueue.tasks.clear();
+		}
+		m_queuedCount = 0;
+	}
+
+	bool JobSystem::isMainThread(void) const
+	{
+		return std::this_thread::get_id() == m_mainThread;
+	}
+	uint32_t JobSystem::GetQueueIndex(void) const
+	{
+		if (t_queueIndex != (uint32_t)-1)
+			return t_queueIndex;
+
+		return isMainThread() ? 0 : (uint32_t)-1;
+	}
+
+	void JobSystem::WorkerLoop(uint32_t index)
+	{
+		Profiler.SetThreadName("Job Worker " + std::to_string(index));
+		t_queueIndex = index;
+
+		while (!m_quit)
+		{
+			if (RunOne(index, false))
+				continue;
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_sleepCondition.wait(lock, [this]() { return m_quit || m_queuedCount > 0; });
+		}
+	}
+
+	void JobSystem::Push(Task task, JobAffinity affinity)
+	{
+		if (affinity == JobAffinity::MAIN_THREAD)
+		{
+			std::lock_guard<std::mutex> lock(m_mainThreadQueue.mutex);
+			m_mainThreadQueue.tasks.push_back(std::move(task));
+			return;
+		}
+
+		// Threads outside the system spread their jobs over every queue
+		uint32_t index = GetQueueIndex();
+		if (index == (uint32_t)-1)
+			index = m_nextQueue++ % (uint32_t)m_queues.size();
+
+		{
+			std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+			m_queues[index]->tasks.push_back(std::move(task));
+		}
+		m_queuedCount++;
+
+		// Sleeping workers check the count while holding this lock, so the wake up can't be missed
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+		}
+		m_sleepCondition.notify_one();
+	}
+	bool JobSystem::Pop(uint32_t index, Task& task)
+	{
+		Queue& queue = *m_queues[index];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty())
+			return false;
+
+		// Newest first, its data is most likely still in cache
+		task = std::move(queue.tasks.back());
+		queue.tasks.pop_back();
+		m_queuedCount--;
+		return true;
+	}
+	bool JobSystem::Steal(uint32_t thief, Task& task)
+	{
+		// Starts after the thief so workers don't all hit the same queue [outside threads start at 0]
+		uint32_t count = (uint32_t)m_queues.size();
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint32_t index = (thief + 1 + i) % count;
+			if (index == thief)
+				continue;
+
+			Queue& queue = *m_queues[index];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.tasks.empty())
+				continue;
+
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+			m_queuedCount--;
+			return true;
+		}
+		return false;
+	}
+	bool JobSystem::RunOne(uint32_t index, bool mainThread)
+	{
+		Task task;
+		bool found = false;
+
+		if (mainThread)
+		{
+			std::lock_guard<std::mutex> lock(m_mainThreadQueue.mutex);
+			if (!m_mainThreadQueue.tasks.empty())
+			{
+				task = std::move(m_mainThreadQueue.tasks.front());
+				m_mainThreadQueue.tasks.pop_front();
+				found = true;
+			}
+		}
+
+		if (!found && index != (uint32_t)-1)
+			found = Pop(index, task);
+		if (!found)
+			found = Steal(index, task);
+		if (!found)
+			return false;
+
+		task.job();
+		Finish(task.counter);
+		return true;
+	}
+	void JobSystem::Finish(JobCounter* counter)
+	{
+		if (!counter)
+			return;
+
+		// Decrement inside the lock so RunAfter can't add a continuation that never gets queued
+		std::vector<JobCounter::Continuation> ready;
+		{
+			std::lock_guard<std::mutex> lock(counter->m_mutex);
+			if (--counter->m_count == 0)
+				ready.swap(counter->m_continuations);
+		}
+
+		// Counter may already be destroyed here
+		for (auto& continuation : ready)
+			Push({ std::move(continuation.job), continuation.counter }, continuation.affinity);
+	}
+
+	void JobSystem::Run(Job job, JobCounter* counter, JobAffinity affinity)
+	{
+		Init();
+
+		if (counter)
+			counter->m_count++;
+
+		Push({ std::move(job), counter }, affinity);
+	}
+	void JobSystem::RunAfter(JobCounter& dependency, Job job, JobCounter* counter, JobAffinity affinity)
+	{
+		Init();
+
+		if (counter)
+			counter->m_count++;
+
+		{
+			std::lock_guard<std::mutex> lock(dependency.m_mutex);
+			if (dependency.m_count > 0)
+			{
+				dependency.m_continuations.push_back({ std::move(job), counter, affinity });
+				return;
+			}
+		}
+
+		Push({ std::move(job), counter }, affinity);
+	}
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		uint32_t index = GetQueueIndex();
+		bool mainThread = isMainThread();
+
+		while (!counter.isDone())
+		{
+			if (!RunOne(index, mainThread))
+				std::this_thread::yield();
+		}
+
+		// Last Finish can still be holding the lock, counter must not be destroyed before it lets go
+		std::lock_guard<std::mutex> lock(counter.m_mutex);
+	}
+	void JobSystem::RunMainThreadJobs()
+	{
+		VXL_ASSERT(isMainThread(), "Main thread jobs can only run on the main thread");
+
+		// Jobs queued while these run wait for the next call
+		std::deque<Task> tasks;
+		{
+			std::lock_guard<std::mutex> lock(m_mainThreadQueue.mutex);
+			tasks.swap(m_mainThreadQueue.tasks);
+		}
+
+		for (Task& task : tasks)
+		{
+			task.job();
+			Finish(task.counter);
+		}
+	}
+}
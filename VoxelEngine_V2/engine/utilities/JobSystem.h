@@ -0,0 +1,166 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "singleton.h"
+#include "Macros.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Vxl
+{
+	enum class JobAffinity
+	{
+		ANY,
+		MAIN_THREAD	// GL work, only runs inside JobSystem::Wait or RunMainThreadJobs on the main thread
+	};
+
+	// Counts unfinished jobs, jobs queued with RunAfter start once it reaches zero
+	// Must outlive its jobs [waiting on it is enough]
+	class JobCounter
+	{
+		DISALLOW_COPY_AND_ASSIGN(JobCounter);
+		friend class JobSystem;
+	private:
+		struct Continuation
+		{
+			std::function<void()>	job;
+			JobCounter*				counter;
+			JobAffinity				affinity;
+		};
+		std::atomic<uint32_t>		m_count{ 0 };
+		std::mutex					m_mutex;
+		std::vector<Continuation>	m_continuations;
+
+	public:
+		JobCounter() {}
+
+		inline bool isDone(void) const
+		{
+			return m_count.load() == 0;
+		}
+		inline uint32_t getCount(void) const
+		{
+			return m_count.load();
+		}
+	};
+
+	// Work stealing scheduler, every worker owns a deque [newest job popped first, thieves take the oldest]
+	// The main thread owns one as well and runs jobs while it waits
+	static class JobSystem : public Singleton<class JobSystem>
+	{
+		DISALLOW_COPY_AND_ASSIGN(JobSystem);
+	public:
+		using Job = std::function<void()>;
+
+	private:
+		struct Task
+		{
+			Job			job;
+			JobCounter*	counter = nullptr;
+		};
+		struct Queue
+		{
+			std::deque<Task>	tasks;
+			std::mutex			mutex;
+		};
+
+		// [0] is the main thread, then one per worker
+		std::vector<std::unique_ptr<Queue>>	m_queues;
+		Queue								m_mainThreadQueue;
+		std::vector<std::thread>			m_workers;
+		std::thread::id						m_mainThread; // Thread that built the singleton [static init runs on the main thread]
+
+		// Any thread can trigger Init through its first job
+		std::mutex							m_initMutex;
+		std::atomic<bool>					m_initialized{ false };
+
+		// Idle workers sleep until something is queued
+		std::mutex							m_sleepMutex;
+		std::condition_variable				m_sleepCondition;
+		std::atomic<uint32_t>				m_queuedCount{ 0 };
+		std::atomic<uint32_t>				m_nextQueue{ 0 };
+		std::atomic<bool>					m_quit{ false };
+
+		void WorkerLoop(uint32_t index);
+		void Push(Task task, JobAffinity affinity);
+		bool Pop(uint32_t index, Task& task);
+		bool Steal(uint32_t thief, Task& task);
+		// Returns false if no job could be found
+		bool RunOne(uint32_t index, bool mainThread);
+		void Finish(JobCounter* counter);
+		// Queue owned by the calling thread [-1 for threads outside the system]
+		uint32_t GetQueueIndex(void) const;
+
+	public:
+		JobSystem() : m_mainThread(std::this_thread::get_id()) {}
+		~JobSystem();
+
+		// Creates workers [called automatically by first job, thread safe]
+		void Init(uint32_t threadCount = 0);
+		// Stops workers, unfinished jobs are dropped
+		void Shutdown();
+
+		// Counter is incremented now and decremented once the job returned
+		void Run(Job job, JobCounter* counter = nullptr, JobAffinity affinity = JobAffinity::ANY);
+		// Job is queued once dependency reaches zero
+		void RunAfter(JobCounter& dependency, Job job, JobCounter* counter = nullptr, JobAffinity affinity = JobAffinity::ANY);
+		// Runs other jobs until counter reaches zero
+		void Wait(JobCounter& counter);
+		// Main thread, once per frame
+		void RunMainThreadJobs();
+
+		// function(begin, end) over [0, count) in batches, the calling thread takes part and returns when all are done
+		template<typename Function>
+		void ParallelFor(uint32_t count, uint32_t batchSize, const Function& function);
+		// function(Type&) for every element of the span
+		template<typename Type, typename Function>
+		void ParallelFor(Type* data, uint32_t count, uint32_t batchSize, const Function& function);
+
+		bool isMainThread(void) const;
+		inline uint32_t getWorkerCount(void) const
+		{
+			return (uint32_t)m_workers.size();
+		}
+
+	} SingletonInstance(JobSystem);
+
+	template<typename Function>
+	void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const Function& function)
+	{
+		batchSize = (std::max)(batchSize, 1u);
+		if (count <= batchSize)
+		{
+			if (count > 0)
+				function(0u, count);
+			return;
+		}
+
+		JobCounter counter;
+		for (uint32_t begin = batchSize; begin < count; begin += batchSize)
+		{
+			uint32_t end = (std::min)(begin + batchSize, count);
+			Run([&function, begin, end]() { function(begin, end); }, &counter);
+		}
+
+		// First batch stays on this thread
+		function(0u, batchSize);
+		Wait(counter);
+	}
+	template<typename Type, typename Function>
+	void JobSystem::ParallelFor(Type* data, uint32_t count, uint32_t batchSize, const Function& function)
+	{
+		ParallelFor(count, batchSize, [data, &function](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+				function(data[i]);
+		});
+	}
+}
@@ -2,28 +2,200 @@
 #include "Precompiled.h"
 #include "Logger.h"
 
+#include "FileIO.h"
 #include "Macros.h"
 
+#include <chrono>
+#include <cstring>
+
+#define LOGGER_FLUSH_INTERVAL 50 // ms
+#define LOGGER_WRITING UINT64_MAX // Sequence while a producer fills the entry
+
 namespace Vxl
 {
-	LoggerMessage::LoggerMessage(
-			HANDLE handle,
-			const std::string& msg,
-			LogType type,
-			ConsoleColor color
-		) : m_string(msg), m_type(type), m_color(color)
+	static const std::chrono::steady_clock::time_point LoggerEpoch = std::chrono::steady_clock::now();
+
+	Logger::Logger()
+		: m_entries(new LogEntry[LOGGER_CAPACITY])
+	{
+		static_assert((LOGGER_CAPACITY & (LOGGER_CAPACITY - 1)) == 0, "LOGGER_CAPACITY must be a power of 2");
+
+#if defined(GLOBAL_OUTPUT_CONSOLE) && defined(_WIN32)
+		m_ConsoleHandle = GetStdHandle(STD_OUTPUT_HANDLE);
+#endif
+		m_thread = std::thread(&Logger::FlushLoop, this);
+	}
+	Logger::~Logger()
+	{
+		m_running = false;
+		m_flushSignal.notify_one();
+		if (m_thread.joinable())
+			m_thread.join();
+
+		setFile("");
+	}
+
+	void Logger::AddMessage(const char* msg, size_t length, LogLevel level)
+	{
+		double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - LoggerEpoch).count();
+
+		// Long messages take several entries
+		do
+		{
+			size_t chunk = length < LOGGER_ENTRY_SIZE - 1 ? length : LOGGER_ENTRY_SIZE - 1;
+
+			uint64_t index = m_head.fetch_add(1, std::memory_order_acq_rel);
+			LogEntry& entry = m_entries[index & (LOGGER_CAPACITY - 1)];
+
+			// Readers that see this sequence know the entry is changing
+			entry.sequence.store(LOGGER_WRITING, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+
+			entry.time = time;
+			entry.level = level;
+			entry.length = (uint16_t)chunk;
+			memcpy(entry.text, msg, chunk);
+			entry.text[chunk] = '\0';
+
+			entry.sequence.store(index + 1, std::memory_order_release);
+
+			msg += chunk;
+			length -= chunk;
+		} while (length > 0);
+
+		// Errors reach the sinks right away, everything else waits for the next interval
+		if (level >= LogLevel::Error)
+			m_flushSignal.notify_one();
+	}
+
+	void Logger::FlushLoop()
+	{
+		std::unique_lock<std::mutex> lock(m_flushMutex);
+		while (m_running)
+		{
+			m_flushSignal.wait_for(lock, std::chrono::milliseconds(LOGGER_FLUSH_INTERVAL));
+			FlushEntries();
+		}
+		FlushEntries();
+	}
+	bool Logger::FlushEntries()
+	{
+		uint64_t head = m_head.load(std::memory_order_acquire);
+
+		// Producers lapped the flush thread
+		if (head - m_flushed > LOGGER_CAPACITY)
+		{
+			m_lost.fetch_add(head - LOGGER_CAPACITY - m_flushed, std::memory_order_relaxed);
+			m_flushed = head - LOGGER_CAPACITY;
+		}
+
+		char text[LOGGER_ENTRY_SIZE];
+		bool complete = true;
+		for (; m_flushed < head; m_flushed++)
 		{
+			const LogEntry& entry = m_entries[m_flushed & (LOGGER_CAPACITY - 1)];
+			uint64_t sequence = entry.sequence.load(std::memory_order_acquire);
+
+			// Still being written, try again next time
+			if (sequence == LOGGER_WRITING || sequence < m_flushed + 1)
+			{
+				complete = false;
+				break;
+			}
+			// Already replaced by a newer message
+			if (sequence > m_flushed + 1)
+			{
+				m_lost.fetch_add(1, std::memory_order_relaxed);
+				continue;
+			}
+
+			LogLevel level = entry.level;
+			double time = entry.time;
+			uint16_t length = entry.length;
+			memcpy(text, entry.text, length);
+
+			if (!isStillValid(m_flushed, &entry))
+			{
+				m_lost.fetch_add(1, std::memory_order_relaxed);
+				continue;
+			}
+
+			WriteSinks(level, time, text, length);
+		}
 
 #ifdef GLOBAL_OUTPUT_CONSOLE
-			SetConsoleTextAttribute(handle, (int)color);
-			printf((msg + '\n').c_str());
+		fflush(stdout);
 #endif
+		{
+			std::lock_guard<std::mutex> fileLock(m_fileMutex);
+			if (m_file)
+				fflush(m_file);
 		}
-
-	Logger::Logger()
+		return complete;
+	}
+	void Logger::WriteSinks(LogLevel level, double time, const char* text, uint16_t length)
 	{
 #ifdef GLOBAL_OUTPUT_CONSOLE
-		m_ConsoleHandle = GetStdHandle(STD_OUTPUT_HANDLE);
+#ifdef _WIN32
+		SetConsoleTextAttribute(m_ConsoleHandle, (int)GetColor(level));
 #endif
+		fwrite(text, 1, length, stdout);
+		fputc('\n', stdout);
+#endif
+
+		std::lock_guard<std::mutex> lock(m_fileMutex);
+		if (m_file)
+		{
+			fprintf(m_file, "[%10.3f] [%s] ", time, GetName(level));
+			fwrite(text, 1, length, m_file);
+			fputc('\n', m_file);
+		}
+	}
+
+	bool Logger::setFile(const std::string& filePath)
+	{
+		std::lock_guard<std::mutex> lock(m_fileMutex);
+		if (m_file)
+		{
+			fclose(m_file);
+			m_file = nullptr;
+		}
+
+		if (filePath.empty())
+			return true;
+
+		FileIO::EnsureDirectory(filePath);
+		m_file = fopen(filePath.c_str(), "w");
+		return m_file != nullptr;
+	}
+	void Logger::flush()
+	{
+		// Flush thread holds the lock while it works, so only one consumer ever runs
+		std::lock_guard<std::mutex> lock(m_flushMutex);
+		while (!FlushEntries())
+			std::this_thread::yield();
+	}
+
+	ConsoleColor Logger::GetColor(LogLevel level)
+	{
+		switch (level)
+		{
+		case LogLevel::Debug:	return ConsoleColor::DARK_GRAY;
+		case LogLevel::Info:	return ConsoleColor::WHITE;
+		case LogLevel::Warning:	return ConsoleColor::YELLOW;
+		case LogLevel::Error:	return ConsoleColor::DARK_RED;
+		}
+		return ConsoleColor::WHITE;
+	}
+	const char* Logger::GetName(LogLevel level)
+	{
+		switch (level)
+		{
+		case LogLevel::Debug:	return "Debug";
+		case LogLevel::Info:	return "Info";
+		case LogLevel::Warning:	return "Warning";
+		case LogLevel::Error:	return "Error";
+		}
+		return "Unknown";
 	}
-}
\ No newline at end of file
+}
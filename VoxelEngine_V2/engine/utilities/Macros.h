@@ -18,12 +18,24 @@
 #define GLOBAL_ERROR_CALLBACK // conflicts with GLOBAL_USE_GLNAMES
 #endif
 
-// [x] whether GPUTimer::StartTimer and GPUTimer::EndTimer actually do anything
+// [x] whether VXL_PROFILE_GPU_SCOPE issues timestamp queries
 #define GLOBAL_GPU_TIMERS
 
+// [x] whether VXL_PROFILE_SCOPE and VXL_PROFILE_GPU_SCOPE record zones
+#define GLOBAL_PROFILER
+
 // [x] whether any of the ImGui libraries are used
 #define GLOBAL_IMGUI
 
+// [ ] whether Graphics calls reach stubs instead of the driver [headless tests, CPU submission cost, window is hidden and has no GL context]
+//#define GLOBAL_GRAPHICS_NULL
+
+// [ ] whether the null backend also logs every call with its arguments
+//#define GLOBAL_GRAPHICS_RECORDING
+#ifdef GLOBAL_GRAPHICS_RECORDING
+#define GLOBAL_GRAPHICS_NULL
+#endif
+
 // ~~~~~~~~~~~~~~~~~~~~~~~~~//
 // Macros that do Misc work //
 
@@ -0,0 +1,347 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#include "Precompiled.h"
+#include "Profiler.h"
+
+#include "FileIO.h"
+#include "Logger.h"
+
+#include "../rendering/Graphics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+#undef max
+#undef min
+
+#define PROFILER_MAX_CAPTURE 1000000 // Events
+
+namespace Vxl
+{
+	static const std::chrono::steady_clock::time_point ProfilerEpoch = std::chrono::steady_clock::now();
+	static thread_local ProfileThread* t_profileThread = nullptr;
+
+	// ~ Thread Ring ~ //
+	void ProfileThread::push(const ProfileZone& zone)
+	{
+		uint32_t write = m_write.load(std::memory_order_relaxed);
+		uint32_t read = m_read.load(std::memory_order_acquire);
+
+		if (write - read >= PROFILER_ZONES_PER_THREAD)
+		{
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		m_zones[write & (PROFILER_ZONES_PER_THREAD - 1)] = zone;
+		m_write.store(write + 1, std::memory_order_release);
+	}
+	bool ProfileThread::pop(ProfileZone& zone)
+	{
+		uint32_t read = m_read.load(std::memory_order_relaxed);
+		if (read == m_write.load(std::memory_order_acquire))
+			return false;
+
+		zone = m_zones[read & (PROFILER_ZONES_PER_THREAD - 1)];
+		m_read.store(read + 1, std::memory_order_release);
+		return true;
+	}
+
+	// ~ Profiler ~ //
+	Profiler::Profiler()
+	{
+		m_lastFrame.reserve(1024);
+	}
+
+	ProfileThread* Profiler::GetThread()
+	{
+		if (!t_profileThread)
+		{
+			std::lock_guard<std::mutex> lock(m_threadMutex);
+			uint32_t id = (uint32_t)m_threads.size();
+			m_threads.push_back(std::make_unique<ProfileThread>(id, "Thread " + std::to_string(id)));
+			t_profileThread = m_threads.back().get();
+		}
+		return t_profileThread;
+	}
+	void Profiler::SetThreadName(const std::string& name)
+	{
+		ProfileThread* thread = GetThread();
+
+		std::lock_guard<std::mutex> lock(m_threadMutex);
+		thread->m_name = name;
+	}
+	std::string Profiler::GetThreadName(uint32_t thread)
+	{
+		if (thread == GPUThread)
+			return "GPU";
+
+		std::lock_guard<std::mutex> lock(m_threadMutex);
+		if (thread < m_threads.size())
+			return m_threads[thread]->m_name;
+
+		return "Unknown";
+	}
+	uint32_t Profiler::GetDroppedCount()
+	{
+		uint32_t dropped = m_gpuDropped;
+
+		std::lock_guard<std::mutex> lock(m_threadMutex);
+		for (const auto& thread : m_threads)
+			dropped += thread->m_dropped.load(std::memory_order_relaxed);
+
+		return dropped;
+	}
+
+	int64_t Profiler::Now() const
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - ProfilerEpoch).count();
+	}
+
+	void Profiler::BeginFrame()
+	{
+		m_frameStart = Now();
+
+		// Oldest GPU frame gets reused, results that still aren't ready are dropped instead of waiting
+		m_gpuFrameIndex = (m_gpuFrameIndex + 1) % PROFILER_GPU_LATENCY;
+		GPUFrame& frame = m_gpuFrames[m_gpuFrameIndex];
+		if (frame.pending && !ResolveGPUFrame(frame))
+			m_gpuDropped++;
+
+		frame.used = 0;
+		frame.pending = false;
+		frame.cpuStart = m_frameStart;
+		m_gpuDepth = 0;
+	}
+	void Profiler::EndFrame()
+	{
+		m_lastFrameStart = m_frameStart;
+		m_lastFrameEnd = Now();
+
+		// Drain all threads [zones belong to the frame they finished in]
+		m_lastFrame.clear();
+		{
+			std::lock_guard<std::mutex> lock(m_threadMutex);
+			for (const auto& thread : m_threads)
+			{
+				ProfileZone zone;
+				while (thread->pop(zone))
+					m_lastFrame.push_back({ zone, thread->m_id });
+			}
+		}
+
+		// Children finish before parents, order by start for drawing and export
+		std::sort(m_lastFrame.begin(), m_lastFrame.end(), [](const ProfileEvent& a, const ProfileEvent& b)
+		{
+			if (a.zone.start != b.zone.start)
+				return a.zone.start < b.zone.start;
+			return a.zone.depth < b.zone.depth;
+		});
+
+		UpdateStats(m_stats, m_lastFrame);
+		AppendCapture(m_lastFrame);
+
+		// GPU frame finished recording
+		GPUFrame& current = m_gpuFrames[m_gpuFrameIndex];
+		current.pending = current.used > 0;
+
+		// Read older frames that are ready [oldest first]
+		for (uint32_t i = 1; i < PROFILER_GPU_LATENCY; i++)
+		{
+			GPUFrame& frame = m_gpuFrames[(m_gpuFrameIndex + i) % PROFILER_GPU_LATENCY];
+			if (frame.pending)
+				ResolveGPUFrame(frame);
+		}
+	}
+
+	bool Profiler::ResolveGPUFrame(GPUFrame& frame)
+	{
+		// Commands finish in order, if the last query is done all of them are
+		if (!Graphics::Query::CheckFinished(frame.lastQuery))
+			return false;
+
+		frame.pending = false;
+
+		// GPU clock is aligned to the start of the CPU frame that recorded it
+		uint64_t origin = Graphics::Query::GetResult(frame.queries[0].begin);
+
+		m_lastGPUFrame.clear();
+		for (uint32_t i = 0; i < frame.used; i++)
+		{
+			const GPUQuery& query = frame.queries[i];
+			uint64_t begin = Graphics::Query::GetResult(query.begin);
+			uint64_t end = Graphics::Query::GetResult(query.end);
+
+			ProfileZone zone = { query.name, query.hash, query.depth, frame.cpuStart + (int64_t)(begin - origin), frame.cpuStart + (int64_t)(end - origin) };
+			m_lastGPUFrame.push_back({ zone, GPUThread });
+		}
+
+		UpdateStats(m_gpuStats, m_lastGPUFrame);
+		AppendCapture(m_lastGPUFrame);
+		return true;
+	}
+
+	uint32_t Profiler::BeginGPUZone(const char* name, uint32_t hash)
+	{
+#ifdef GLOBAL_GPU_TIMERS
+		if (!m_enabled)
+			return (uint32_t)-1;
+
+		GPUFrame& frame = m_gpuFrames[m_gpuFrameIndex];
+		if (frame.used == frame.queries.size())
+			frame.queries.push_back({ Graphics::Query::Create(), Graphics::Query::Create() });
+
+		uint32_t slot = frame.used++;
+		GPUQuery& query = frame.queries[slot];
+		query.name = name;
+		query.hash = hash;
+		query.depth = m_gpuDepth++;
+
+		Graphics::Query::Timestamp(query.begin);
+		frame.lastQuery = query.begin;
+		return slot;
+#else
+		return (uint32_t)-1;
+#endif
+	}
+	void Profiler::EndGPUZone(uint32_t slot)
+	{
+#ifdef GLOBAL_GPU_TIMERS
+		if (slot == (uint32_t)-1)
+			return;
+
+		GPUFrame& frame = m_gpuFrames[m_gpuFrameIndex];
+		VXL_ASSERT(slot < frame.used, "GPU profile zones cannot span multiple frames");
+
+		Graphics::Query::Timestamp(frame.queries[slot].end);
+		frame.lastQuery = frame.queries[slot].end;
+		m_gpuDepth--;
+#endif
+	}
+	void Profiler::DestroyGLResources()
+	{
+		for (GPUFrame& frame : m_gpuFrames)
+		{
+			for (const GPUQuery& query : frame.queries)
+			{
+				Graphics::Query::Delete(query.begin);
+				Graphics::Query::Delete(query.end);
+			}
+			frame.queries.clear();
+			frame.used = 0;
+			frame.pending = false;
+		}
+		m_gpuDepth = 0;
+		m_lastGPUFrame.clear();
+	}
+
+	void Profiler::UpdateStats(std::unordered_map<uint32_t, ProfileStats>& stats, const std::vector<ProfileEvent>& events)
+	{
+		for (auto& stat : stats)
+		{
+			stat.second.last = 0.0;
+			stat.second.calls = 0;
+		}
+
+		for (const ProfileEvent& event : events)
+		{
+			ProfileStats& stat = stats[event.zone.hash];
+			stat.name = event.zone.name;
+			stat.last += (double)(event.zone.end - event.zone.start) / 1000000.0;
+			stat.calls++;
+		}
+
+		// Zones that didn't happen this frame count as 0
+		for (auto& stat : stats)
+		{
+			ProfileStats& s = stat.second;
+			s.average += (s.last - s.average) * 0.05;
+			s.peak = std::max(s.peak, s.last);
+		}
+	}
+	void Profiler::ResetStats()
+	{
+		m_stats.clear();
+		m_gpuStats.clear();
+	}
+
+	void Profiler::AppendCapture(const std::vector<ProfileEvent>& events)
+	{
+		if (!m_capturing)
+			return;
+
+		if (m_capture.size() + events.size() > PROFILER_MAX_CAPTURE)
+		{
+			Logger.error("Profiler capture is full, stopping early");
+			m_capturing = false;
+			return;
+		}
+
+		m_capture.insert(m_capture.end(), events.begin(), events.end());
+	}
+
+	void Profiler::StartCapture()
+	{
+		m_capture.clear();
+		m_capturing = true;
+	}
+	bool Profiler::StopCapture(const std::string& filePath)
+	{
+		m_capturing = false;
+
+		FileIO::EnsureDirectory(filePath);
+		std::ofstream file(filePath, std::ios::trunc);
+		if (!file.is_open())
+		{
+			Logger.error("Unable to write profiler trace: " + filePath);
+			m_capture.clear();
+			return false;
+		}
+
+		// Chrome trace format [chrome://tracing, ui.perfetto.dev], times in microseconds
+		char buffer[512];
+		bool first = true;
+		auto write = [&file, &first](const char* text)
+		{
+			if (!first)
+				file << ",\n";
+			file << text;
+			first = false;
+		};
+
+		file << "{\"traceEvents\":[\n";
+
+		// Thread names
+		std::vector<uint32_t> threads;
+		for (const ProfileEvent& event : m_capture)
+		{
+			if (std::find(threads.begin(), threads.end(), event.thread) == threads.end())
+				threads.push_back(event.thread);
+		}
+		for (uint32_t thread : threads)
+		{
+			snprintf(buffer, sizeof(buffer), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", thread, GetThreadName(thread).c_str());
+			write(buffer);
+		}
+
+		// Zones
+		for (const ProfileEvent& event : m_capture)
+		{
+			snprintf(buffer, sizeof(buffer), "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				event.zone.name,
+				event.thread == GPUThread ? "gpu" : "cpu",
+				event.thread,
+				(double)event.zone.start / 1000.0,
+				(double)(event.zone.end - event.zone.start) / 1000.0
+			);
+			write(buffer);
+		}
+
+		file << "\n]}\n";
+
+		Logger.log("Profiler trace saved: " + filePath + " [" + std::to_string(m_capture.size()) + " zones]");
+		m_capture.clear();
+		return file.good();
+	}
+}
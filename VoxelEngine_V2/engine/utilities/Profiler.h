@@ -0,0 +1,250 @@
+// Copyright (c) 2020 Emmanuel Lajeunesse
+#pragma once
+
+#include "singleton.h"
+#include "Macros.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#define PROFILER_GPU_LATENCY 3 // Frames before GPU results are read [never stalls]
+#define PROFILER_ZONES_PER_THREAD 8192 // Ring size, must be power of 2
+
+namespace Vxl
+{
+	// Finished zone [times are ns since profiler start]
+	struct ProfileZone
+	{
+		const char* name; // Must be a literal, only the pointer is stored
+		uint32_t	hash;
+		uint32_t	depth;
+		int64_t		start;
+		int64_t		end;
+	};
+	// Finished zone with the thread that recorded it
+	struct ProfileEvent
+	{
+		ProfileZone zone;
+		uint32_t	thread; // GPU = Profiler::GPUThread
+	};
+
+	// Averages per zone name
+	struct ProfileStats
+	{
+		const char* name = nullptr;
+		double		last = 0.0;		// ms [sum of all calls in last frame]
+		double		average = 0.0;	// ms [moving average]
+		double		peak = 0.0;		// ms [since reset]
+		uint32_t	calls = 0;		// last frame
+	};
+
+	// Lock-free ring of finished zones, only the owner thread writes and only the render thread reads
+	class ProfileThread
+	{
+		DISALLOW_COPY_AND_ASSIGN(ProfileThread);
+		friend class Profiler;
+		friend class ProfileScope;
+	private:
+		ProfileZone				m_zones[PROFILER_ZONES_PER_THREAD];
+		std::atomic<uint32_t>	m_write { 0 };
+		std::atomic<uint32_t>	m_read { 0 };
+		std::atomic<uint32_t>	m_dropped { 0 };
+		uint32_t				m_depth = 0; // Owner thread only
+		uint32_t				m_id;
+		std::string				m_name;
+
+		// Owner thread, zone is dropped if reader is too far behind
+		void push(const ProfileZone& zone);
+		// Reader thread
+		bool pop(ProfileZone& zone);
+
+	public:
+		ProfileThread(uint32_t id, const std::string& name)
+			: m_id(id), m_name(name)
+		{}
+	};
+
+	static class Profiler : public Singleton<class Profiler>
+	{
+		DISALLOW_COPY_AND_ASSIGN(Profiler);
+	public:
+		static const uint32_t GPUThread = (uint32_t)-1;
+
+	private:
+		// Threads [registered on first zone, never removed]
+		std::vector<std::unique_ptr<ProfileThread>> m_threads;
+		std::mutex									m_threadMutex;
+
+		// Frames
+		int64_t						m_frameStart = 0;
+		int64_t						m_lastFrameStart = 0;
+		int64_t						m_lastFrameEnd = 0;
+		std::vector<ProfileEvent>	m_lastFrame;
+		std::vector<ProfileEvent>	m_lastGPUFrame;
+		std::unordered_map<uint32_t, ProfileStats> m_stats;
+		std::unordered_map<uint32_t, ProfileStats> m_gpuStats;
+
+		// Capture for trace export
+		bool						m_capturing = false;
+		std::vector<ProfileEvent>	m_capture;
+
+		// GPU zones [timestamp query pairs, ring of frames]
+		struct GPUQuery
+		{
+			uint32_t	begin; // QueryID
+			uint32_t	end;   // QueryID
+			const char* name;
+			uint32_t	hash;
+			uint32_t	depth;
+		};
+		struct GPUFrame
+		{
+			std::vector<GPUQuery>	queries; // Grows, queries are reused
+			uint32_t				used = 0;
+			int64_t					cpuStart = 0;
+			uint32_t				lastQuery = 0; // Finishes last on the GPU
+			bool					pending = false;
+		};
+		GPUFrame				m_gpuFrames[PROFILER_GPU_LATENCY];
+		uint32_t				m_gpuFrameIndex = 0;
+		uint32_t				m_gpuDepth = 0;
+		uint32_t				m_gpuDropped = 0;
+
+		// Returns false if results aren't ready yet
+		bool ResolveGPUFrame(GPUFrame& frame);
+		void UpdateStats(std::unordered_map<uint32_t, ProfileStats>& stats, const std::vector<ProfileEvent>& events);
+		void AppendCapture(const std::vector<ProfileEvent>& events);
+
+	public:
+		Profiler();
+
+		// Stops recording without removing threads
+		bool m_enabled = true;
+
+		// Thread of the caller [registers it on first use]
+		ProfileThread* GetThread();
+		void SetThreadName(const std::string& name);
+
+		// ns since profiler start
+		int64_t Now() const;
+
+		// Render thread
+		void BeginFrame();
+		void EndFrame();
+
+		// GPU zones [render thread, returns query slot]
+		uint32_t BeginGPUZone(const char* name, uint32_t hash);
+		void EndGPUZone(uint32_t slot);
+		void DestroyGLResources();
+
+		// Trace capture [Chrome trace/Perfetto json]
+		void StartCapture();
+		bool StopCapture(const std::string& filePath);
+		inline bool isCapturing(void) const
+		{
+			return m_capturing;
+		}
+		inline uint32_t getCaptureSize(void) const
+		{
+			return (uint32_t)m_capture.size();
+		}
+
+		// Results of last finished frame
+		inline const std::vector<ProfileEvent>& getLastFrame(void) const
+		{
+			return m_lastFrame;
+		}
+		// GPU results are a few frames behind
+		inline const std::vector<ProfileEvent>& getLastGPUFrame(void) const
+		{
+			return m_lastGPUFrame;
+		}
+		inline int64_t getLastFrameStart(void) const
+		{
+			return m_lastFrameStart;
+		}
+		inline int64_t getLastFrameEnd(void) const
+		{
+			return m_lastFrameEnd;
+		}
+		// Zone hash -> stats
+		inline const std::unordered_map<uint32_t, ProfileStats>& getStats(void) const
+		{
+			return m_stats;
+		}
+		inline const std::unordered_map<uint32_t, ProfileStats>& getGPUStats(void) const
+		{
+			return m_gpuStats;
+		}
+		void ResetStats();
+
+		std::string GetThreadName(uint32_t thread);
+		uint32_t	GetDroppedCount();
+
+	} SingletonInstance(Profiler);
+
+	// CPU zone for the lifetime of the scope
+	class ProfileScope
+	{
+		DISALLOW_COPY_AND_ASSIGN(ProfileScope);
+	private:
+		ProfileThread*	m_thread;
+		const char*		m_name;
+		uint32_t		m_hash;
+		uint32_t		m_depth;
+		int64_t			m_start;
+	public:
+		ProfileScope(const char* name, uint32_t hash)
+			: m_thread(Profiler.m_enabled ? Profiler.GetThread() : nullptr), m_name(name), m_hash(hash)
+		{
+			if (!m_thread)
+				return;
+
+			m_depth = m_thread->m_depth++;
+			m_start = Profiler.Now();
+		}
+		~ProfileScope()
+		{
+			if (!m_thread)
+				return;
+
+			m_thread->m_depth--;
+			m_thread->push({ m_name, m_hash, m_depth, m_start, Profiler.Now() });
+		}
+	};
+
+	// GPU zone for the lifetime of the scope [render thread only]
+	class GPUProfileScope
+	{
+		DISALLOW_COPY_AND_ASSIGN(GPUProfileScope);
+	private:
+		uint32_t m_slot;
+	public:
+		GPUProfileScope(const char* name, uint32_t hash)
+			: m_slot(Profiler.BeginGPUZone(name, hash))
+		{}
+		~GPUProfileScope()
+		{
+			Profiler.EndGPUZone(m_slot);
+		}
+	};
+}
+
+// Zone names must be string literals, they are hashed at compile time
+#define VXL_PROFILE_CONCAT_INNER(a, b) a##b
+#define VXL_PROFILE_CONCAT(a, b) VXL_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef GLOBAL_PROFILER
+#define VXL_PROFILE_SCOPE(name) \
+	::Vxl::ProfileScope VXL_PROFILE_CONCAT(_profileScope, __LINE__)(name, std::integral_constant<uint32_t, ::Vxl::StringHash32(name)>::value)
+#define VXL_PROFILE_GPU_SCOPE(name) \
+	::Vxl::GPUProfileScope VXL_PROFILE_CONCAT(_profileGPUScope, __LINE__)(name, std::integral_constant<uint32_t, ::Vxl::StringHash32(name)>::value)
+#else
+#define VXL_PROFILE_SCOPE(name)
+#define VXL_PROFILE_GPU_SCOPE(name)
+#endif
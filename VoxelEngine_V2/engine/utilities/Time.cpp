@@ -4,190 +4,98 @@
 
 #include "../rendering/Graphics.h"
 #include "../utilities/Macros.h"
+#include <algorithm>
 #include <assert.h>
+#include <cmath>
 #include <GLFW/glfw3.h>
 
 namespace Vxl
 {
-	void TimeController::StartFrame()
-	{
-		Time.m_time = glfwGetTime();
-		Time.m_deltaTime = (Time.m_time - Time.m_lastTime) / Time.m_limitFPS;
-		Time.m_totalDeltaTime += Time.m_deltaTime;
-		Time.m_lastTime = Time.m_time;
-		Time.m_currentFPS = (Time.m_deltaTime * Time.m_targetFPS);
-
-		Time.m_histogramFPS[HISTOGRAM_SIZE - 1] = (float)Time.m_currentFPS;
-		memcpy(Time.m_histogramFPS, Time.m_histogramFPS + 1, (HISTOGRAM_SIZE - 1) * sizeof(float));
-	}
-
-	double Clock::GetTimeLeft(void) const
+	void FrameTimeHistogram::add(float ms)
 	{
-		return max(m_endTime - glfwGetTime(), 0);
+		m_samples[m_next] = ms;
+		m_next = (m_next + 1) % FRAME_TIME_HISTORY;
+		if (m_count < FRAME_TIME_HISTORY)
+			m_count++;
 	}
-	bool Clock::HasFinished(void) const
+	void FrameTimeHistogram::clear(void)
 	{
-		return ((m_endTime - glfwGetTime()) <= 0);
+		m_next = 0;
+		m_count = 0;
 	}
-	void Clock::Reset(void)
+	FrameTimeHistogram::Percentiles FrameTimeHistogram::getPercentiles(void) const
 	{
-		m_startTime = glfwGetTime();
-		m_endTime = m_startTime + m_time;
-	}
-
-	// CPU TIMERS //
-	std::map<std::string, CPUTimer*> CPUTimer::m_timers;
-
-	void CPUTimer::Begin()
-	{
-		VXL_ASSERT(!m_inUse, "Cannot start CPUTimer while in use");
-
-		m_start = std::chrono::steady_clock::now();
-		m_inUse = true;
-	}
-	void CPUTimer::End()
-	{
-		VXL_ASSERT(m_inUse, "Cannot stop CPUTimer while not in use");
-
-		auto elapsedTime = std::chrono::steady_clock::now() - m_start;
-		// Convert elapsed time into long long
-		m_elapsedTime = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsedTime).count();
-		m_inUse = false;
-	}
-
-	void CPUTimer::Update()
-	{
-		m_elapsedTime_MS[m_elapsedTime_MS_index] = (double)m_elapsedTime / 1000000.0;
-		m_elapsedTime_MS_index++;
-		m_elapsedTime_MS_index %= CPUTIMER_CAPTURES;
-
-		m_elapsedTime_MS_average = 0;
-		for (auto ms : m_elapsedTime_MS)
-			m_elapsedTime_MS_average += ms;
-		m_elapsedTime_MS_average /= (double)CPUTIMER_CAPTURES;
-	}
-
-	void CPUTimer::StartTimer(const std::string& name)
-	{
-		// Create timer if doesn't exist
-		if (m_timers.find(name) == m_timers.end())
-			m_timers[name] = new CPUTimer();
-
-		m_timers[name]->Begin();
-	}
-	void CPUTimer::EndTimer(const std::string& name)
-	{
-		// Error if timer doesn't exist
-		if (m_timers.find(name) == m_timers.end())
-			VXL_ASSERT(false, "CPUTimer, Cannot End Timer if it does not exist");
-
-		m_timers[name]->End();
-	}
+		Percentiles result;
+		if (m_count == 0)
+			return result;
 
-	double CPUTimer::GetElapsedTime_MS(const std::string& name)
-	{
-		// Error if timer doesn't exist
-		if (m_timers.find(name) == m_timers.end())
-			VXL_ASSERT(false, "CPUTimer, does not exist");
+		// Order doesn't matter, the held samples are always the first m_count
+		float sorted[FRAME_TIME_HISTORY];
+		memcpy(sorted, m_samples, m_count * sizeof(float));
+		std::sort(sorted, sorted + m_count);
 
-		// return time
-		return m_timers[name]->m_elapsedTime_MS_average;
+		auto rank = [&sorted, this](float percent)
+		{
+			uint32_t index = (uint32_t)std::ceil(percent * (float)m_count) - 1;
+			return sorted[(std::min)(index, m_count - 1)];
+		};
+		result.p50 = rank(0.50f);
+		result.p95 = rank(0.95f);
+		result.p99 = rank(0.99f);
+		result.max = sorted[m_count - 1];
+		return result;
 	}
 
-
-	// GPU TIMERS //
-	std::map<std::string, GPUTimer*> GPUTimer::m_timers;
-	bool GPUTimer::m_TimerBeingUsed = false;
-
-	void GPUTimer::DestroyTimers()
+	void TimeController::StartFrame()
 	{
-#ifdef GLOBAL_GPU_TIMERS
-		for (auto& timer : m_timers)
-			delete timer.second;
-		m_timers.clear();
-#endif
-	}
+		Time.m_time = glfwGetTime();
+		double seconds = Time.m_time - Time.m_lastTime;
+		Time.m_deltaTime = seconds / Time.m_limitFPS;
+		Time.m_totalDeltaTime += Time.m_deltaTime;
+		Time.m_lastTime = Time.m_time;
+		Time.m_currentFPS = (Time.m_deltaTime * Time.m_targetFPS);
+		Time.m_fixedSteps = 0;
 
-	GPUTimer::GPUTimer()
-	{
-#ifdef GLOBAL_GPU_TIMERS
-		m_ID = Graphics::Query::Create();
-#endif
-	}
-	GPUTimer::~GPUTimer()
-	{
-#ifdef GLOBAL_GPU_TIMERS
-		Graphics::Query::Delete(m_ID);
-#endif
-	}
+		Time.m_histogramFPS[Time.m_histogramOffset] = (float)Time.m_currentFPS;
+		Time.m_histogramOffset = (Time.m_histogramOffset + 1) % HISTOGRAM_SIZE;
 
-	void GPUTimer::Begin()
-	{
-		Graphics::Query::Start(m_ID, Graphics::Query::Type::TIME_ELAPSED);
+		// First frame measures startup
+		if (Time.m_frames > 0)
+			Time.m_frameTimes.add((float)(seconds * 1000.0));
 	}
-	void GPUTimer::End()
+	bool TimeController::StepFixed()
 	{
-		Graphics::Query::End(Graphics::Query::Type::TIME_ELAPSED);
-	}
-
-	void GPUTimer::Update()
-	{
-#ifdef GLOBAL_GPU_TIMERS
-		bool ready = Graphics::Query::CheckFinished(m_ID);
-	
-		if (ready)
+		if (Time.m_totalDeltaTime >= 1.0)
 		{
-			m_elapsedTime = Graphics::Query::GetResult(m_ID);
-
-			m_elapsedTime_MS[m_elapsedTime_MS_index] = (double)m_elapsedTime / 1000000.0;
-			m_elapsedTime_MS_index++;
-			m_elapsedTime_MS_index %= GPUTIMER_CAPTURES;
-
-			m_elapsedTime_MS_average = 0;
-			for (auto ms : m_elapsedTime_MS)
-				m_elapsedTime_MS_average += ms;
-			m_elapsedTime_MS_average /= (double)GPUTIMER_CAPTURES;
+			if (Time.m_fixedSteps < Time.m_maxFixedSteps)
+			{
+				Time.m_totalDeltaTime -= 1.0;
+				Time.m_fixedSteps++;
+				return true;
+			}
+
+			// Catching up after a stall would make the next frame even longer [spiral of death]
+			// Whole steps are dropped, the fraction stays so interpolation doesn't jump
+			double dropped = std::floor(Time.m_totalDeltaTime);
+			Time.m_droppedFixedSteps += (UINT)dropped;
+			Time.m_totalDeltaTime -= dropped;
 		}
-#endif
+
+		Time.m_fixedAlpha = Time.m_totalDeltaTime;
+		return false;
 	}
 
-	void GPUTimer::StartTimer(const std::string& name)
+	double Clock::GetTimeLeft(void) const
 	{
-#ifdef GLOBAL_GPU_TIMERS
-		// Must be open for usage
-		if (m_TimerBeingUsed)
-			VXL_ASSERT(false, "GPUTimer, Cannot Start Timer if one is already being used");
-
-		// Create timer if doesn't exist
-		if (m_timers.find(name) == m_timers.end())
-			m_timers[name] = new GPUTimer();
-
-		m_timers[name]->Begin();
-		m_TimerBeingUsed = true;
-#endif
+		return max(m_endTime - glfwGetTime(), 0);
 	}
-
-	void GPUTimer::EndTimer()
+	bool Clock::HasFinished(void) const
 	{
-#ifdef GLOBAL_GPU_TIMERS
-		// Must be open for usage
-		if (!m_TimerBeingUsed)
-			VXL_ASSERT(false, "GPUTimer, Cannot End Timer if not being used");
-
-		GPUTimer::End();
-		m_TimerBeingUsed = false;
-#endif
+		return ((m_endTime - glfwGetTime()) <= 0);
 	}
-
-	double GPUTimer::GetElapsedTime_MS(const std::string& name)
+	void Clock::Reset(void)
 	{
-#ifdef GLOBAL_GPU_TIMERS
-		if (m_timers.find(name) != m_timers.end())
-			return m_timers[name]->m_elapsedTime_MS_average;
-		else
-#endif
-			return 0.0;
+		m_startTime = glfwGetTime();
+		m_endTime = m_startTime + m_time;
 	}
-
-	
 }
\ No newline at end of file
@@ -13,11 +13,52 @@
 #include "../utilities/Macros.h"
 
 #define HISTOGRAM_SIZE 50
-#define GPUTIMER_CAPTURES 15
-#define CPUTIMER_CAPTURES 15
+#define FRAME_TIME_HISTORY 240
 
 namespace Vxl
 {
+	// Ring buffer of the last frame times in ms, percentiles are sorted from a copy when requested
+	class FrameTimeHistogram
+	{
+	private:
+		float			m_samples[FRAME_TIME_HISTORY];
+		uint32_t		m_next = 0;
+		uint32_t		m_count = 0;
+
+	public:
+		struct Percentiles
+		{
+			float p50 = 0.0f;
+			float p95 = 0.0f;
+			float p99 = 0.0f;
+			float max = 0.0f;
+		};
+
+		FrameTimeHistogram()
+		{
+			memset(m_samples, 0, FRAME_TIME_HISTORY * sizeof(float));
+		}
+
+		void add(float ms);
+		void clear(void);
+		// Nearest rank over the samples held [zero if empty]
+		Percentiles getPercentiles(void) const;
+
+		inline const float* getSamples(void) const
+		{
+			return m_samples;
+		}
+		inline uint32_t getCount(void) const
+		{
+			return m_count;
+		}
+		// Index of the oldest sample [ImGui plots take it as values_offset]
+		inline uint32_t getOffset(void) const
+		{
+			return (m_count < FRAME_TIME_HISTORY) ? 0 : m_next;
+		}
+	};
+
 	// ~~~ //
 	static class Time : public Singleton<class Time>
 	{
@@ -32,6 +73,14 @@ namespace Vxl
 		double m_targetFPS = 60.0;
 		double m_currentFPS = 0.0;
 		float m_histogramFPS[HISTOGRAM_SIZE];
+		UINT m_histogramOffset = 0;
+		FrameTimeHistogram m_frameTimes;
+
+		// Fixed steps [1.0 of m_totalDeltaTime is one step of m_limitFPS seconds]
+		UINT m_maxFixedSteps = 5;
+		UINT m_fixedSteps = 0;
+		UINT m_droppedFixedSteps = 0;
+		double m_fixedAlpha = 0.0;
 	public:
 
 		Time()
@@ -63,6 +112,15 @@ namespace Vxl
 		{
 			return HISTOGRAM_SIZE;
 		}
+		// Index of the oldest value
+		inline UINT GetFPSHistogramOffset(void) const
+		{
+			return m_histogramOffset;
+		}
+		inline const FrameTimeHistogram& GetFrameTimes(void) const
+		{
+			return m_frameTimes;
+		}
 		inline double GetTime() const
 		{
 			return m_time;
@@ -76,6 +134,38 @@ namespace Vxl
 			return m_frames;
 		}
 
+		// ~ Fixed Steps ~ //
+		// More steps than this in one frame are dropped instead of caught up
+		inline void SetMaxFixedSteps(UINT steps)
+		{
+			VXL_ASSERT(steps > 0, "At least one fixed step per frame is needed");
+			m_maxFixedSteps = steps;
+		}
+		inline UINT GetMaxFixedSteps(void) const
+		{
+			return m_maxFixedSteps;
+		}
+		// Seconds per fixed step
+		inline double GetFixedDeltaTime(void) const
+		{
+			return m_limitFPS;
+		}
+		// How far rendering is between the last two fixed steps [0, 1)
+		inline float GetFixedAlpha(void) const
+		{
+			return (float)m_fixedAlpha;
+		}
+		// Steps taken this frame
+		inline UINT GetFixedStepCount(void) const
+		{
+			return m_fixedSteps;
+		}
+		// Steps skipped by the cap since start
+		inline UINT GetDroppedFixedSteps(void) const
+		{
+			return m_droppedFixedSteps;
+		}
+
 	} SingletonInstance(Time);
 
 	// ~~~ //
@@ -87,6 +177,8 @@ namespace Vxl
 		{
 			Time.m_frames++;
 		}
+		// Returns true while another fixed step is due this frame [while (StepFixed()) UpdateFixed();]
+		bool StepFixed();
 		inline double GetTotalDeltaTime() const
 		{
 			return Time.m_totalDeltaTime;
@@ -125,71 +217,4 @@ namespace Vxl
 		}
 
 	};
-
-	// ~~~ //
-	class CPUTimer
-	{
-		friend class Performance;
-		friend class RenderManager;
-	private:
-
-		static std::map<std::string, CPUTimer*> m_timers;
-
-		bool m_inUse = false;
-		long long	m_elapsedTime;
-		double		m_elapsedTime_MS[GPUTIMER_CAPTURES] = { 0 };
-		UINT		m_elapsedTime_MS_index = 0;
-		double		m_elapsedTime_MS_average;
-		std::chrono::steady_clock::time_point m_start;
-
-		void Begin();
-		void End();
-
-		void Update();
-
-	public:
-		static void	StartTimer(const std::string& name);
-		static void	EndTimer(const std::string& name);
-
-		static double GetElapsedTime_MS(const std::string& name);
-	};
-
-	// ~~~ //
-	class GPUTimer
-	{
-		friend class Performance;
-		friend class RenderManager;
-	private:
-
-		static std::map<std::string, GPUTimer*> m_timers;
-		static bool	m_TimerBeingUsed;
-
-		UINT		m_ID;
-		uint64_t	m_elapsedTime = 0;
-		double		m_elapsedTime_MS[GPUTIMER_CAPTURES] = { 0 };
-		UINT		m_elapsedTime_MS_index = 0;
-		double		m_elapsedTime_MS_average;
-
-		static void DestroyTimers();
-
-		GPUTimer();
-		~GPUTimer();
-
-		void Begin();
-		static void End();
-
-		void Update();
-
-	public:
-
-		inline UINT		getID(void) const
-		{
-			return m_ID;
-		}
-
-		static void		StartTimer(const std::string& name);
-		static void		EndTimer();
-		static double	GetElapsedTime_MS(const std::string& name);
-
-	};
 }
\ No newline at end of file
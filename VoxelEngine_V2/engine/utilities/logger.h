@@ -3,10 +3,33 @@
 
 #include "singleton.h"
 
-#include <vector>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <Windows.h>
+#include <thread>
+#include <vector>
 #include <iostream>
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+// [x] Messages below this level are compiled out [0 = Debug, 1 = Info, 2 = Warning, 3 = Error]
+#ifndef GLOBAL_LOG_LEVEL
+#ifdef _DEBUG
+#define GLOBAL_LOG_LEVEL 0
+#else
+#define GLOBAL_LOG_LEVEL 1
+#endif
+#endif
+
+#define LOGGER_CAPACITY 4096 // Entries [power of 2]
+#define LOGGER_ENTRY_SIZE 496 // Characters per entry, longer messages are split
+
+// Skips building the message when its level is compiled out
+#define VXL_LOG(level, message) do { if (Vxl::Logger::IsEnabled(level)) { Logger.write(level, message); } } while (0)
 
 namespace Vxl
 {
@@ -30,55 +53,111 @@ namespace Vxl
 		WHITE,
 		TOTAL
 	};
-	enum class LogType
+	enum class LogLevel : uint8_t
 	{
-		Message,
+		Debug,
+		Info,
+		Warning,
 		Error
 	};
 
-	class LoggerMessage
+	// Slot in the ring, only readable while its sequence matches the index it was read for
+	struct LogEntry
 	{
-		// Cannot use macro because Macros.h is including this file
-		LoggerMessage(const LoggerMessage&) = delete;
-		void operator=(const LoggerMessage&) = delete;
-	private:
-		// Data
-		std::string  m_string;
-		LogType		 m_type;
-		ConsoleColor m_color;
-
-	public:
-		LoggerMessage(
-			HANDLE handle,
-			const std::string& msg,
-			LogType type,
-			ConsoleColor color
-		);
+		std::atomic<uint64_t>	sequence{ 0 };	// Index + 1 once written
+		double					time = 0.0;		// Seconds since logger started
+		LogLevel				level = LogLevel::Info;
+		uint16_t				length = 0;
+		char					text[LOGGER_ENTRY_SIZE];
 	};
 
+	// Producers claim slots with a single atomic increment and never wait, the oldest entries get overwritten when full
+	// A background thread flushes new entries to the console and file, the ring doubles as history for the editor
 	static class Logger : public Singleton<class Logger>
 	{
+		// Cannot use macro because Macros.h is including this file
+		Logger(const Logger&) = delete;
+		void operator=(const Logger&) = delete;
 	private:
 		// Data
-		HANDLE						m_ConsoleHandle;
-		std::vector<LoggerMessage*> m_log;
+		std::unique_ptr<LogEntry[]>	m_entries;
+		std::atomic<uint64_t>		m_head{ 0 };	// Next index to claim
+		std::atomic<uint64_t>		m_lost{ 0 };	// Overwritten before being flushed
+
+		// Flush thread
+		std::thread					m_thread;
+		std::mutex					m_flushMutex;
+		std::condition_variable		m_flushSignal;
+		std::atomic<bool>			m_running{ true };
+		uint64_t					m_flushed = 0;	// Flush thread only
+
+		// File sink
+		std::mutex					m_fileMutex;
+		FILE*						m_file = nullptr;
+#ifdef _WIN32
+		HANDLE						m_ConsoleHandle = nullptr;
+#endif
+
+		void AddMessage(const char* msg, size_t length, LogLevel level);
+		void FlushLoop();
+		// Writes all complete entries to the sinks, returns false if an entry is still being written
+		bool FlushEntries();
+		void WriteSinks(LogLevel level, double time, const char* text, uint16_t length);
+
+	public:
+		Logger();
+		~Logger();
 
-		inline void AddMessage(const std::string& msg, LogType type, ConsoleColor color)
+		static constexpr bool IsEnabled(LogLevel level)
 		{
-			m_log.push_back(new LoggerMessage(m_ConsoleHandle, msg, type, color));
+			return (int)level >= GLOBAL_LOG_LEVEL;
 		}
 
-	public:
+		inline void write(LogLevel level, const std::string& msg)
+		{
+			AddMessage(msg.c_str(), msg.size(), level);
+		}
 
-		Logger();
+		inline void debug	(const std::string& msg) { if (IsEnabled(LogLevel::Debug)) AddMessage(msg.c_str(), msg.size(), LogLevel::Debug); }
+		inline void log		(const std::string& msg) { if (IsEnabled(LogLevel::Info)) AddMessage(msg.c_str(), msg.size(), LogLevel::Info); }
+		inline void warning	(const std::string& msg) { if (IsEnabled(LogLevel::Warning)) AddMessage(msg.c_str(), msg.size(), LogLevel::Warning); }
+		inline void error	(const std::string& msg) { if (IsEnabled(LogLevel::Error)) AddMessage(msg.c_str(), msg.size(), LogLevel::Error); }
 
-		inline const HANDLE getHandle() const { return m_ConsoleHandle;}
+		// Also writes every message to a file [empty path closes it]
+		bool setFile(const std::string& filePath);
+		// Blocks until everything logged so far reached the sinks
+		void flush();
+
+		// ~ History [no copies, entries can be overwritten by other threads at any time] ~ //
+		inline uint64_t getHead(void) const
+		{
+			return m_head.load(std::memory_order_acquire);
+		}
+		// Oldest index that can still be in the ring
+		inline uint64_t getTail(void) const
+		{
+			uint64_t head = getHead();
+			return head > LOGGER_CAPACITY ? head - LOGGER_CAPACITY : 0;
+		}
+		// nullptr if index was overwritten or is still being written
+		inline const LogEntry* getEntry(uint64_t index) const
+		{
+			const LogEntry& entry = m_entries[index & (LOGGER_CAPACITY - 1)];
+			return entry.sequence.load(std::memory_order_acquire) == index + 1 ? &entry : nullptr;
+		}
+		// Entry wasn't overwritten while it was being read
+		inline bool isStillValid(uint64_t index, const LogEntry* entry) const
+		{
+			std::atomic_thread_fence(std::memory_order_acquire);
+			return entry->sequence.load(std::memory_order_relaxed) == index + 1;
+		}
+		inline uint64_t getLostCount(void) const
+		{
+			return m_lost.load(std::memory_order_relaxed);
+		}
 
-		inline void log		(const std::string& msg) { AddMessage(msg, LogType::Message, ConsoleColor::WHITE); }
-		inline void error	(const std::string& msg) { AddMessage(msg, LogType::Error, ConsoleColor::DARK_RED); }
+		static ConsoleColor GetColor(LogLevel level);
+		static const char*	GetName(LogLevel level);
 
 	} SingletonInstance(Logger);
-
-	
 }
-
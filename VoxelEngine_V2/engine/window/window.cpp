@@ -37,6 +37,11 @@ namespace Vxl
 		m_size[0] = width;
 		m_size[1] = height;
 
+#ifdef GLOBAL_GRAPHICS_NULL
+		// Nothing reaches a driver, window only exists for input and ImGui [no context needed, works headless]
+		glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#else
 		// Debug Context
 		glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
 
@@ -45,6 +50,7 @@ namespace Vxl
 		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, OPENGL_MINOR);
 		// Set OpenGL to Core Mode
 		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#endif
 
 		m_window = glfwCreateWindow(m_size[0], m_size[1], m_name.c_str(), NULL, NULL);
 		if (!m_window)
@@ -52,7 +58,9 @@ namespace Vxl
 			Logger.error("Glfw could not create a new window: " + m_name);
 			return;
 		}
+#ifndef GLOBAL_GRAPHICS_NULL
 		glfwMakeContextCurrent(m_window);
+#endif
 
 		// default position
 		SetPosition(393, 296);
@@ -102,7 +110,10 @@ namespace Vxl
 		io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
 		io.ConfigDockingWithShift = false;
 		static bool once = true;
+#ifndef GLOBAL_GRAPHICS_NULL
+		// Platform windows need their own GL context
 		io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+#endif
 
 		ImGui_ImplGlfw_InitForOpenGL(GetContext(), true);
 		ImGui_ImplOpenGL3_Init(Graphics::GLSL_Version.c_str());
@@ -201,7 +212,9 @@ namespace Vxl
 		}
 #endif
 
+#ifndef GLOBAL_GRAPHICS_NULL
 		glfwSwapBuffers(m_window);
+#endif
 		glfwPollEvents();
 	}
 
@@ -220,7 +233,9 @@ namespace Vxl
 	}
 	void Window::SetVSynch(bool state)
 	{
+#ifndef GLOBAL_GRAPHICS_NULL
 		glfwSwapInterval((int)state);
+#endif
 	}
 	void Window::SetCustomAspectRatio(bool state, float aspect)
 	{
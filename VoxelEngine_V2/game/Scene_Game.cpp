@@ -13,6 +13,8 @@
 #include "../engine/utilities/Time.h"
 #include "../engine/utilities/FileIO.h"
 #include "../engine/utilities/Asset.h"
+#include "../engine/utilities/AssetLoader.h"
+#include "../engine/utilities/Profiler.h"
 
 #include "../engine/rendering/FramebufferObject.h"
 #include "../engine/rendering/Primitives.h"
@@ -59,8 +61,8 @@ namespace Vxl
 {
 	void Scene_Game::Setup()
 	{
-		// Load Textures
-		tex_grid_test = SceneAssets.loadTexture2D(
+		// Load Textures [decoded in background, uploaded over the next frames]
+		tex_grid_test = SceneAssets.loadTexture2DAsync(
 			"./assets/textures/grid_test.png",
 			true,
 			true,
@@ -69,8 +71,8 @@ namespace Vxl
 			TextureFormat::RGB8,
 			TexturePixelType::UNSIGNED_BYTE,
 			AnisotropicMode::HIGH
-			);
-		tex_checkerboard = SceneAssets.loadTexture2D(
+		).getIndex();
+		tex_checkerboard = SceneAssets.loadTexture2DAsync(
 			"./assets/textures/checkerboard.jpg",
 			true,
 			true,
@@ -79,8 +81,8 @@ namespace Vxl
 			TextureFormat::RGB8,
 			TexturePixelType::UNSIGNED_BYTE,
 			AnisotropicMode::HIGH
-		);
-		tex_beato = SceneAssets.loadTexture2D(
+		).getIndex();
+		tex_beato = SceneAssets.loadTexture2DAsync(
 			"./assets/textures/beato.png",
 			true,
 			true,
@@ -89,9 +91,9 @@ namespace Vxl
 			TextureFormat::RGB8,
 			TexturePixelType::UNSIGNED_BYTE,
 			AnisotropicMode::NONE
-		);
+		).getIndex();
 
-		tex_crate_diffuse = SceneAssets.loadTexture2D(
+		tex_crate_diffuse = SceneAssets.loadTexture2DAsync(
 			"./assets/textures/crate_diffuse.png",
 			true,
 			true,
@@ -100,8 +102,8 @@ namespace Vxl
 			TextureFormat::RGB8,
 			TexturePixelType::UNSIGNED_BYTE,
 			AnisotropicMode::NONE
-		);
-		cubemap_craterlake = SceneAssets.loadCubemap(
+		).getIndex();
+		cubemap_craterlake = SceneAssets.loadCubemapAsync(
 			"./assets/cubemaps/craterlake_ft.tga",
 			"./assets/cubemaps/craterlake_bk.tga",
 			"./assets/cubemaps/craterlake_up.tga",
@@ -114,7 +116,7 @@ namespace Vxl
 			TextureFormat::RGB8,
 			TexturePixelType::UNSIGNED_BYTE,
 			AnisotropicMode::NONE
-		);
+		).getIndex();
 
 		// FBO Gbuffer
 		{
@@ -380,7 +382,7 @@ namespace Vxl
 		//
 
 		// Import Mesh
-		mesh_jiggy = Model::LoadMesh("jiggy", "./assets/models/jiggy.obj", true, 0.2f);
+		mesh_jiggy = Model::LoadMeshAsync("jiggy", "./assets/models/jiggy.obj", true, 0.2f).getIndex();
 
 		mesh_manyQuads = SceneAssets.createMesh(DrawType::TRIANGLES);
 		Mesh* _mesh = Assets.getMesh(mesh_manyQuads);
@@ -713,6 +715,8 @@ namespace Vxl
 
 	void Scene_Game::Update()
 	{
+		VXL_PROFILE_SCOPE("Scene_Game::Update");
+
 		DEV_SHOW_BOOL("show_bool", false);
 		DEV_SHOW_FLOAT("show_float", 5.0f);
 		DEV_SHOW_DOUBLE("show_float", 8.0);
@@ -737,8 +741,6 @@ namespace Vxl
 		DEV_GET_VECTOR("edit_vec4d", vec4d(0, 1, 2, 3));
 		DEV_GET_COLOR("edit_color4f", Color4F(0, 1, 0.5f, 1));
 
-		CPUTimer::StartTimer("UPDATE");
-
 		if (Input.getKeyDown(KeyCode::ESCAPE))
 			Window.Close();
 
@@ -973,8 +975,6 @@ namespace Vxl
 		//		material_gbuffer->m_Wireframe = DEVCONSOLE_GET_BOOL("Gbuffer Wireframe", false);
 		//	}
 
-		CPUTimer::EndTimer("UPDATE");
-
 		gizmo.m_pivotAxisAligned = DEV_GET_BOOL("PivotAxisAligned", false);
 		gizmo.m_translateSnapping = DEV_GET_BOOL("TranslateSnapping", false);
 		gizmo.m_rotateSnapping = DEV_GET_BOOL("RotateSnapping", false);
@@ -1048,27 +1048,25 @@ namespace Vxl
 
 		// Render Gbuffer Information
 		{
-			GPUTimer::StartTimer("Gbuffer");
-			CPUTimer::StartTimer("Gbuffer");
+			VXL_PROFILE_SCOPE("Gbuffer");
+			VXL_PROFILE_GPU_SCOPE("Gbuffer");
 			//
 			fbo_gbuffer->bind();
 			fbo_gbuffer->clearBuffers();
 			//
 			RenderManager.sortMaterials();
 			RenderManager.sortEntities();
+			RenderManager.cullEntities();
 			//
 			RenderManager.renderOpaque(ShaderMaterialType::CORE);
 			RenderManager.renderTransparent(ShaderMaterialType::CORE);
-			//
-			CPUTimer::EndTimer("Gbuffer");
-			GPUTimer::EndTimer();
 		}
 
 		// Render Debugging Information
 		if(RenderManager.m_editorMode)
 		{
-			GPUTimer::StartTimer("Editor");
-			CPUTimer::StartTimer("Editor");
+			VXL_PROFILE_SCOPE("Editor");
+			VXL_PROFILE_GPU_SCOPE("Editor");
 			//
 			fbo_editor->bind();
 			fbo_editor->clearBuffers();
@@ -1084,69 +1082,8 @@ namespace Vxl
 				Graphics::SetDepthWrite(true);
 				Graphics::SetDepthRead(true);
 
-				if(programDebugRender->m_uniform_useModel.has_value())
-					programDebugRender->m_uniform_useModel.value().send(true);
-				
-				// Spheres
-				Mesh* meshSphere = Assets.getMesh(Primitives.GetSphereUV_Cheap());
-				if (meshSphere)
-				{
-					for (const auto& object : Debug.m_spheres)
-					{
-						if(programDebugRender->m_uniform_color.has_value())
-							programDebugRender->m_uniform_color.value().send(object.color);
-
-						if (programDebugRender->m_uniform_mvp.has_value())
-						{
-							Camera* camera = Assets.getCamera(RenderManager.m_mainCamera);
-							if(camera)
-								programDebugRender->m_uniform_mvp.value().sendMatrix(camera->getViewProjection() * object.model, true);
-						}
-						
-						meshSphere->draw();
-					}
-				}
-
-				// Cubes
-				Mesh* meshCube = Assets.getMesh(Primitives.GetCube());
-				if (meshCube)
-				{
-					for (const auto& object : Debug.m_cubes)
-					{
-						if (programDebugRender->m_uniform_color.has_value())
-							programDebugRender->m_uniform_color.value().send(object.color);
-
-						if (programDebugRender->m_uniform_mvp.has_value())
-						{
-							Camera* camera = Assets.getCamera(RenderManager.m_mainCamera);
-							if (camera)
-								programDebugRender->m_uniform_mvp.value().sendMatrix(camera->getViewProjection() * object.model, true);
-						}
-
-						meshCube->draw();
-					}
-				}
-
-				// Lines
-				Mesh* mesh_ArrowZ = Assets.getMesh(Primitives.GetArrowZNoTail());
-				if (mesh_ArrowZ)
-				{
-					for (const auto& object : Debug.m_arrowLines)
-					{
-						if (programDebugRender->m_uniform_color.has_value())
-							programDebugRender->m_uniform_color.value().send(object.color);
-
-						if (programDebugRender->m_uniform_mvp.has_value())
-						{
-							Camera* camera = Assets.getCamera(RenderManager.m_mainCamera);
-							if (camera)
-								programDebugRender->m_uniform_mvp.value().sendMatrix(camera->getViewProjection() * object.model, true);
-						}
-
-						mesh_ArrowZ->draw();
-					}
-				}
-
+				// One instanced draw per shape type
+				Debug.RenderShapes(programDebugRender);
 			}
 			// Lines
 			{
@@ -1181,49 +1118,8 @@ namespace Vxl
 				programLineRender->sendUniform("useVertexColors", false);
 				programLineRender->sendUniform("useVertexWidth", false);
 				
-				// Spheres Outline
-				Mesh* meshLines_CircleAllAxis = Assets.getMesh(Primitives.GetLines_CircleAllAxis_Unit());
-				if (meshLines_CircleAllAxis)
-				{
-					for (const auto& object : Debug.m_spheresLines)
-					{
-						if (programLineRender->m_uniform_color.has_value())
-							programLineRender->m_uniform_color.value().send(object.color);
-
-						if (programLineRender->m_uniform_mvp.has_value())
-						{
-							Camera* camera = Assets.getCamera(RenderManager.m_mainCamera);
-							if (camera)
-								programLineRender->m_uniform_mvp.value().sendMatrix(camera->getViewProjection() * object.model, true);
-						}
-
-						programLineRender->sendUniform("globalWidth", object.width);
-
-						meshLines_CircleAllAxis->draw();
-					}
-				}
-
-				// Cubes Outline
-				Mesh* meshLines_Cube = Assets.getMesh(Primitives.GetLines_Cube());
-				if (meshLines_Cube)
-				{
-					for (const auto& object : Debug.m_cubesLines)
-					{
-						if (programLineRender->m_uniform_color.has_value())
-							programLineRender->m_uniform_color.value().send(object.color);
-
-						if (programLineRender->m_uniform_mvp.has_value())
-						{
-							Camera* camera = Assets.getCamera(RenderManager.m_mainCamera);
-							if (camera)
-								programLineRender->m_uniform_mvp.value().sendMatrix(camera->getViewProjection() * object.model, true);
-						}
-
-						programLineRender->sendUniform("globalWidth", object.width);
-
-						meshLines_Cube->draw();
-					}
-				}
+				// Spheres Outline [cube outlines are part of the world lines]
+				Debug.RenderShapeOutlines(programLineRender);
 
 				// Screenspace Lines
 				Debug.RenderScreenLines();
@@ -1231,10 +1127,6 @@ namespace Vxl
 				// State
 				Graphics::SetDepthRead(true);
 			}
-
-			//
-			CPUTimer::EndTimer("Editor");
-			GPUTimer::EndTimer();
 		}
 
 		//	// Remember Depth gbuffer depth
@@ -1310,49 +1202,58 @@ namespace Vxl
 		//Editor.UpdateSelectionInfo();
 
 
-		// Render ColorID Selection Information
+		// Selection
 		if (Input.getMouseButtonDown(MouseButton::LEFT) && !Window.IsCursorOnImguiWindow() && Window.GetCursor() == CursorMode::NORMAL)
 		{
-			fbo_colorPicker->bind();
-			fbo_colorPicker->clearBuffers();
-			//
-			RenderManager.sortMaterials();
-			RenderManager.sortEntities();
-			//
-			RenderManager.renderOpaque(ShaderMaterialType::COLORID);
-			RenderManager.renderTransparent(ShaderMaterialType::COLORID);
+			bool hit = false;
+			SceneNodeIndex sceneNodeIndex = -1;
 
-			// Read Selected Pixel
-			RawArray<uint8_t> data = fbo_colorPicker->readPixelsFromMouse(0, 1, 1);
-			if (!data.isEmpty())
+			// Render ColorID Selection Information
+			if (RenderManager.m_colorIDPicking)
 			{
-				uint32_t sceneNodeIndex = Util::Conversion::uchars_to_uint(data.start);
-				data.deallocate();
+				fbo_colorPicker->bind();
+				fbo_colorPicker->clearBuffers();
+				//
+				RenderManager.sortMaterials();
+				RenderManager.sortEntities();
+				RenderManager.cullEntities();
+				//
+				RenderManager.renderOpaque(ShaderMaterialType::COLORID);
+				RenderManager.renderTransparent(ShaderMaterialType::COLORID);
+
+				// Read Selected Pixel
+				RawArray<uint8_t> data = fbo_colorPicker->readPixelsFromMouse(0, 1, 1);
+				if (!data.isEmpty())
+				{
+					sceneNodeIndex = Util::Conversion::uchars_to_uint(data.start);
+					data.deallocate();
+					hit = true;
+				}
+			}
+			// Raycast against entity triangles
+			else
+			{
+				PickResult pick = RenderManager.pickEntity(Input.getMousePosScreenspace(true));
+				sceneNodeIndex = pick.m_sceneNode;
+				hit = pick.m_hit;
+			}
 
-				// Toggle selection based on node state
-				SceneNode* sceneNode = Assets.getSceneNode(sceneNodeIndex);
-				if (sceneNode)
+			// Toggle selection based on node state
+			SceneNode* sceneNode = hit ? Assets.getSceneNode(sceneNodeIndex) : nullptr;
+			if (sceneNode && sceneNode->m_isSelectable)
+			{
+				if (Input.getKey(KeyCode::LEFT_CONTROL))
 				{
-					if (sceneNode->m_isSelectable)
-					{
-						if (Input.getKey(KeyCode::LEFT_CONTROL))
-						{
-							if (!sceneNode->IsSelected())
-								Editor.addSelection(sceneNodeIndex);
-							else
-								Editor.removeSelection(sceneNodeIndex);
-						}
-						else
-						{
-							Editor.clearSelection();
-							Editor.addSelection(sceneNodeIndex);
-						}
-					}
+					if (!sceneNode->IsSelected())
+						Editor.addSelection(sceneNodeIndex);
 					else
-						Editor.clearSelection();
+						Editor.removeSelection(sceneNodeIndex);
 				}
 				else
+				{
 					Editor.clearSelection();
+					Editor.addSelection(sceneNodeIndex);
+				}
 			}
 			else
 				Editor.clearSelection();